@@ -32,6 +32,12 @@ let package = Package(
                 .headerSearchPath("."),
                 .define("CONFIG_VERSION", to: "\"2025-01-14\""),
                 .define("_GNU_SOURCE"),
+                // Inline caches for property access in the interpreter loop.
+                // Remove to save code and context memory in size-constrained builds.
+                .define("CONFIG_INLINE_CACHE"),
+                // Sampling profiler and opcode counters (MQJSContext.startProfiling).
+                // Costs one test per executed opcode; remove for maximum speed.
+                .define("CONFIG_PROFILER"),
                 // Optimize for size in release builds (embedded use case)
                 .unsafeFlags(["-Os"], .when(configuration: .release))
             ]
@@ -44,6 +50,30 @@ let package = Package(
             path: "Sources/MQuickJS"
         ),
 
+        // Regenerates the stdlib ROM table (Sources/CMQuickJS/include/mqjs_stdlib.h):
+        // swift package --allow-writing-to-package-directory generate-stdlib [--config file]
+        .plugin(
+            name: "GenerateStdlib",
+            capability: .command(
+                intent: .custom(
+                    verb: "generate-stdlib",
+                    description: "Regenerate the JavaScript standard library ROM table"
+                ),
+                permissions: [
+                    .writeToPackageDirectory(reason: "Writes Sources/CMQuickJS/include/mqjs_stdlib.h")
+                ]
+            ),
+            path: "Plugins/GenerateStdlib"
+        ),
+
+        // Engine, bridge and conversion benchmarks:
+        // swift run -c release MQuickJSBenchmarks [--filter name] [--format text|json|csv]
+        .executableTarget(
+            name: "MQuickJSBenchmarks",
+            dependencies: ["MQuickJS"],
+            path: "Sources/MQuickJSBenchmarks"
+        ),
+
         // Test target
         .testTarget(
             name: "MQuickJSTests",
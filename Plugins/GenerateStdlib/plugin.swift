@@ -0,0 +1,26 @@
+import Foundation
+import PackagePlugin
+
+/// Regenerates `Sources/CMQuickJS/include/mqjs_stdlib.h` with `scripts/stdlib/mquickjs_build.py`.
+///
+/// ```
+/// swift package --allow-writing-to-package-directory generate-stdlib --config my.conf
+/// ```
+///
+/// The arguments are passed to the generator (`--config`, `--check`, `-o`).
+@main
+struct GenerateStdlib: CommandPlugin {
+    func performCommand(context: PluginContext, arguments: [String]) async throws {
+        let script = context.package.directory.appending(subpath: "scripts/stdlib/mquickjs_build.py")
+
+        let process = Process()
+        process.executableURL = URL(fileURLWithPath: "/usr/bin/env")
+        process.arguments = ["python3", script.string] + arguments
+        try process.run()
+        process.waitUntilExit()
+
+        if process.terminationReason != .exit || process.terminationStatus != 0 {
+            Diagnostics.error("mquickjs_build.py failed with status \(process.terminationStatus)")
+        }
+    }
+}
@@ -29,6 +29,14 @@
 
 #include "cutils.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define USE_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON
+#endif
+
 void pstrcpy(char *buf, int buf_size, const char *str)
 {
     int c;
@@ -176,3 +184,253 @@ int __utf8_get(const uint8_t *p, size_t *plen)
     *plen = len;
     return c;
 }
+
+/* byte string scanning. The vector loops handle 16 bytes at a time and
+   the remaining bytes are handled by the portable code. */
+
+#ifdef USE_NEON
+/* 4 bits per byte of 'mask' whose bytes are 0x00 or 0xff */
+static inline uint64_t neon_mask_bits(uint8x16_t mask)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+}
+#endif
+
+/* return TRUE if all the bytes are < 0x80 */
+BOOL ascii_check(const uint8_t *buf, size_t len)
+{
+    size_t i = 0;
+#if defined(USE_SSE2)
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+        if (_mm_movemask_epi8(v) != 0)
+            return FALSE;
+    }
+#elif defined(USE_NEON)
+    for(; i + 16 <= len; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(buf + i)) >= 0x80)
+            return FALSE;
+    }
+#endif
+    for(; i < len; i++) {
+        if (buf[i] >= 0x80)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* return the first occurrence of 'needle' in 'buf' or NULL if not found */
+const uint8_t *mem_find(const uint8_t *buf, size_t len,
+                        const uint8_t *needle, size_t needle_len)
+{
+    const uint8_t *p;
+    size_t i, last;
+    
+    if (needle_len == 0)
+        return buf;
+    if (needle_len > len)
+        return NULL;
+    /* last possible match position */
+    last = len - needle_len;
+    i = 0;
+    if (needle_len >= 2) {
+        /* test the first and last bytes of the needle at 16 positions */
+#if defined(USE_SSE2)
+        __m128i c0 = _mm_set1_epi8(needle[0]);
+        __m128i c1 = _mm_set1_epi8(needle[needle_len - 1]);
+        for(; i + 15 <= last; i += 16) {
+            __m128i v0 = _mm_loadu_si128((const __m128i *)(buf + i));
+            __m128i v1 = _mm_loadu_si128((const __m128i *)(buf + i + needle_len - 1));
+            unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v0, c0),
+                                                                _mm_cmpeq_epi8(v1, c1)));
+            while (mask != 0) {
+                p = buf + i + ctz32(mask);
+                if (!memcmp(p + 1, needle + 1, needle_len - 2))
+                    return p;
+                mask &= mask - 1;
+            }
+        }
+#elif defined(USE_NEON)
+        uint8x16_t c0 = vdupq_n_u8(needle[0]);
+        uint8x16_t c1 = vdupq_n_u8(needle[needle_len - 1]);
+        for(; i + 15 <= last; i += 16) {
+            uint8x16_t v0 = vld1q_u8(buf + i);
+            uint8x16_t v1 = vld1q_u8(buf + i + needle_len - 1);
+            uint64_t mask = neon_mask_bits(vandq_u8(vceqq_u8(v0, c0), vceqq_u8(v1, c1)));
+            while (mask != 0) {
+                p = buf + i + (ctz64(mask) >> 2);
+                if (!memcmp(p + 1, needle + 1, needle_len - 2))
+                    return p;
+                mask &= ~((uint64_t)0xf << (ctz64(mask) & ~3));
+            }
+        }
+#endif
+    }
+    while (i <= last) {
+        p = memchr(buf + i, needle[0], last - i + 1);
+        if (!p)
+            break;
+        if (!memcmp(p + 1, needle + 1, needle_len - 1))
+            return p;
+        i = p - buf + 1;
+    }
+    return NULL;
+}
+
+/* return the last occurrence of 'needle' in 'buf' or NULL if not found */
+const uint8_t *mem_rfind(const uint8_t *buf, size_t len,
+                         const uint8_t *needle, size_t needle_len)
+{
+    const uint8_t *p;
+    
+    if (needle_len > len)
+        return NULL;
+    if (needle_len == 0)
+        return buf + len;
+    for(p = buf + len - needle_len;; p--) {
+        if (p[0] == needle[0] && !memcmp(p + 1, needle + 1, needle_len - 1))
+            return p;
+        if (p == buf)
+            break;
+    }
+    return NULL;
+}
+
+/* convert the ASCII letters to lower or upper case. Other bytes
+   (including the UTF-8 sequences) are copied unmodified. */
+void ascii_convert_case(uint8_t *dst, const uint8_t *src, size_t len,
+                        BOOL to_lower)
+{
+    size_t i = 0;
+    int c, first = to_lower ? 'A' : 'a';
+#if defined(USE_SSE2)
+    {
+        /* map the range [first, first + 25] to [-128, -103] */
+        __m128i bias = _mm_set1_epi8((char)(0x80 - first));
+        __m128i limit = _mm_set1_epi8(-128 + 26);
+        __m128i delta = _mm_set1_epi8(0x20);
+        for(; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+            __m128i mask = _mm_cmplt_epi8(_mm_add_epi8(v, bias), limit);
+            mask = _mm_and_si128(mask, delta);
+            if (to_lower)
+                v = _mm_add_epi8(v, mask);
+            else
+                v = _mm_sub_epi8(v, mask);
+            _mm_storeu_si128((__m128i *)(dst + i), v);
+        }
+    }
+#elif defined(USE_NEON)
+    {
+        uint8x16_t vfirst = vdupq_n_u8(first);
+        uint8x16_t limit = vdupq_n_u8(26);
+        uint8x16_t delta = vdupq_n_u8(0x20);
+        for(; i + 16 <= len; i += 16) {
+            uint8x16_t v = vld1q_u8(src + i);
+            uint8x16_t mask = vandq_u8(vcltq_u8(vsubq_u8(v, vfirst), limit), delta);
+            if (to_lower)
+                v = vaddq_u8(v, mask);
+            else
+                v = vsubq_u8(v, mask);
+            vst1q_u8(dst + i, v);
+        }
+    }
+#endif
+    for(; i < len; i++) {
+        c = src[i];
+        if ((unsigned)(c - first) < 26)
+            c ^= 0x20;
+        dst[i] = c;
+    }
+}
+
+/* return the length of the prefix of 'buf' made of JSON white space
+   (space, tab, line feed, carriage return) */
+size_t json_skip_ws(const uint8_t *buf, size_t len)
+{
+    size_t i = 0;
+    int c;
+#if defined(USE_SSE2)
+    {
+        __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+        __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+        for(; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+            __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+            unsigned int mask = ~_mm_movemask_epi8(ws) & 0xffff;
+            if (mask != 0)
+                return i + ctz32(mask);
+        }
+    }
+#elif defined(USE_NEON)
+    {
+        uint8x16_t sp = vdupq_n_u8(' '), tab = vdupq_n_u8('\t');
+        uint8x16_t lf = vdupq_n_u8('\n'), cr = vdupq_n_u8('\r');
+        for(; i + 16 <= len; i += 16) {
+            uint8x16_t v = vld1q_u8(buf + i);
+            uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(v, sp), vceqq_u8(v, tab)),
+                                     vorrq_u8(vceqq_u8(v, lf), vceqq_u8(v, cr)));
+            uint64_t mask = ~neon_mask_bits(ws);
+            if (mask != 0)
+                return i + (ctz64(mask) >> 2);
+        }
+    }
+#endif
+    for(; i < len; i++) {
+        c = buf[i];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+    }
+    return i;
+}
+
+/* return the length of the prefix of 'buf' which can be copied as is
+   from or to a JSON string: it stops at '"', '\\', the control
+   characters and, if 'stop_non_ascii' is TRUE, the bytes >= 0x80 */
+size_t json_string_span(const uint8_t *buf, size_t len, BOOL stop_non_ascii)
+{
+    size_t i = 0;
+    int c;
+#if defined(USE_SSE2)
+    {
+        __m128i quote = _mm_set1_epi8('\"'), bslash = _mm_set1_epi8('\\');
+        __m128i ctrl = _mm_set1_epi8(0x1f);
+        for(; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+            /* v <= 0x1f (unsigned) */
+            __m128i special = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl);
+            unsigned int mask;
+            special = _mm_or_si128(special, _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                         _mm_cmpeq_epi8(v, bslash)));
+            mask = _mm_movemask_epi8(special);
+            if (stop_non_ascii)
+                mask |= _mm_movemask_epi8(v);
+            if (mask != 0)
+                return i + ctz32(mask);
+        }
+    }
+#elif defined(USE_NEON)
+    {
+        uint8x16_t quote = vdupq_n_u8('\"'), bslash = vdupq_n_u8('\\');
+        uint8x16_t ctrl = vdupq_n_u8(0x20), high = vdupq_n_u8(0x80);
+        for(; i + 16 <= len; i += 16) {
+            uint8x16_t v = vld1q_u8(buf + i);
+            uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, bslash)),
+                                          vcltq_u8(v, ctrl));
+            uint64_t mask;
+            if (stop_non_ascii)
+                special = vorrq_u8(special, vcgeq_u8(v, high));
+            mask = neon_mask_bits(special);
+            if (mask != 0)
+                return i + (ctz64(mask) >> 2);
+        }
+    }
+#endif
+    for(; i < len; i++) {
+        c = buf[i];
+        if (c < 0x20 || c == '\"' || c == '\\' || (c >= 0x80 && stop_non_ascii))
+            break;
+    }
+    return i;
+}
@@ -301,6 +301,17 @@ static force_inline int utf8_get(const uint8_t *buf, size_t *plen)
     }
 }
 
+/* byte string scanning (SSE2 or NEON when available) */
+BOOL ascii_check(const uint8_t *buf, size_t len);
+const uint8_t *mem_find(const uint8_t *buf, size_t len,
+                        const uint8_t *needle, size_t needle_len);
+const uint8_t *mem_rfind(const uint8_t *buf, size_t len,
+                         const uint8_t *needle, size_t needle_len);
+void ascii_convert_case(uint8_t *dst, const uint8_t *src, size_t len,
+                        BOOL to_lower);
+size_t json_skip_ws(const uint8_t *buf, size_t len);
+size_t json_string_span(const uint8_t *buf, size_t len, BOOL stop_non_ascii);
+
 static inline int from_hex(int c)
 {
     if (c >= '0' && c <= '9')
@@ -42,7 +42,6 @@
    - reduce max memory usage
    - free format: could add shortcut if exact result
    - use 64 bit limb_t when possible
-   - use another algorithm for free format dtoa in base 10 (ryu ?)
 */
 
 #define USE_POW5_TABLE
@@ -529,14 +528,45 @@ static void mul_log2_radix_test(void)
 }
 #endif
 
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint32_t u32_pow10_table[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000,
+};
+
+/* number of decimal digits of n (1 for n = 0) */
+static inline int u32_digits(uint32_t n)
+{
+    int l;
+    n |= 1;
+    /* 1233 / 4096 ~ log10(2) */
+    l = ((32 - clz32(n)) * 1233) >> 12;
+    return l + 1 - (n < u32_pow10_table[l]);
+}
+
+/* write the 'len' low decimal digits of 'n', two at a time */
 static void u32toa_len(char *buf, uint32_t n, size_t len)
 {
-    int digit, i;
-    for(i = len - 1; i >= 0; i--) {
-        digit = n % 10;
-        n = n / 10;
-        buf[i] = digit + '0';
+    char *q = buf + len;
+    while (len >= 2) {
+        q -= 2;
+        memcpy(q, digit_pairs + (n % 100) * 2, 2);
+        n /= 100;
+        len -= 2;
     }
+    if (len != 0)
+        q[-1] = n % 10 + '0';
 }
 
 /* for power of 2 radixes. len >= 1 */
@@ -589,16 +619,13 @@ static void limb_to_a(char *buf, limb_t n, unsigned int radix, int len)
 
 size_t u32toa(char *buf, uint32_t n)
 {
-    char buf1[10], *q;
     size_t len;
-    
-    q = buf1 + sizeof(buf1);
-    do {
-        *--q = n % 10 + '0';
-        n /= 10;
-    } while (n != 0);
-    len = buf1 + sizeof(buf1) - q;
-    memcpy(buf, q, len);
+    if (n < 10) {
+        buf[0] = n + '0';
+        return 1;
+    }
+    len = u32_digits(n);
+    u32toa_len(buf, n, len);
     return len;
 }
 
@@ -628,11 +655,7 @@ size_t u64toa(char *buf, uint64_t n)
             n2 = n1 / 1000000000;
             n1 = n1 % 1000000000;
             /* at most two digits */
-            if (n2 >= 10) {
-                *q++ = n2 / 10 + '0';
-                n2 %= 10;
-            }
-            *q++ = n2 + '0';
+            q += u32toa(q, n2);
             u32toa_len(q, n1, 9);
             q += 9;
         } else {
@@ -1104,6 +1127,372 @@ static void dtoa_free(void *ptr)
 }
 #endif
 
+/* Shortest radix 10 conversion (Grisu3, Florian Loitsch, "Printing
+   Floating-Point Numbers Quickly and Accurately with Integers",
+   PLDI 2010). It gives the shortest and closest digits for ~99.5% of
+   the doubles using 64 bit integer arithmetic only and reports the
+   other cases, which then use the exact algorithm. */
+
+typedef struct {
+    uint64_t f;
+    int e;
+} DiyFp; /* f * 2^e */
+
+typedef struct {
+    uint64_t f; /* normalized significand of 10^k */
+    int16_t e; /* binary exponent */
+    int16_t k; /* decimal exponent */
+} DTOACachedPower;
+
+/* 10^k for k = -348 + 8 * i, rounded to nearest */
+static const DTOACachedPower dtoa_cached_powers[87] = {
+    { 0xfa8fd5a0081c0288, -1220, -348 },
+    { 0xbaaee17fa23ebf76, -1193, -340 },
+    { 0x8b16fb203055ac76, -1166, -332 },
+    { 0xcf42894a5dce35ea, -1140, -324 },
+    { 0x9a6bb0aa55653b2d, -1113, -316 },
+    { 0xe61acf033d1a45df, -1087, -308 },
+    { 0xab70fe17c79ac6ca, -1060, -300 },
+    { 0xff77b1fcbebcdc4f, -1034, -292 },
+    { 0xbe5691ef416bd60c, -1007, -284 },
+    { 0x8dd01fad907ffc3c, -980, -276 },
+    { 0xd3515c2831559a83, -954, -268 },
+    { 0x9d71ac8fada6c9b5, -927, -260 },
+    { 0xea9c227723ee8bcb, -901, -252 },
+    { 0xaecc49914078536d, -874, -244 },
+    { 0x823c12795db6ce57, -847, -236 },
+    { 0xc21094364dfb5637, -821, -228 },
+    { 0x9096ea6f3848984f, -794, -220 },
+    { 0xd77485cb25823ac7, -768, -212 },
+    { 0xa086cfcd97bf97f4, -741, -204 },
+    { 0xef340a98172aace5, -715, -196 },
+    { 0xb23867fb2a35b28e, -688, -188 },
+    { 0x84c8d4dfd2c63f3b, -661, -180 },
+    { 0xc5dd44271ad3cdba, -635, -172 },
+    { 0x936b9fcebb25c996, -608, -164 },
+    { 0xdbac6c247d62a584, -582, -156 },
+    { 0xa3ab66580d5fdaf6, -555, -148 },
+    { 0xf3e2f893dec3f126, -529, -140 },
+    { 0xb5b5ada8aaff80b8, -502, -132 },
+    { 0x87625f056c7c4a8b, -475, -124 },
+    { 0xc9bcff6034c13053, -449, -116 },
+    { 0x964e858c91ba2655, -422, -108 },
+    { 0xdff9772470297ebd, -396, -100 },
+    { 0xa6dfbd9fb8e5b88f, -369, -92 },
+    { 0xf8a95fcf88747d94, -343, -84 },
+    { 0xb94470938fa89bcf, -316, -76 },
+    { 0x8a08f0f8bf0f156b, -289, -68 },
+    { 0xcdb02555653131b6, -263, -60 },
+    { 0x993fe2c6d07b7fac, -236, -52 },
+    { 0xe45c10c42a2b3b06, -210, -44 },
+    { 0xaa242499697392d3, -183, -36 },
+    { 0xfd87b5f28300ca0e, -157, -28 },
+    { 0xbce5086492111aeb, -130, -20 },
+    { 0x8cbccc096f5088cc, -103, -12 },
+    { 0xd1b71758e219652c, -77, -4 },
+    { 0x9c40000000000000, -50, 4 },
+    { 0xe8d4a51000000000, -24, 12 },
+    { 0xad78ebc5ac620000, 3, 20 },
+    { 0x813f3978f8940984, 30, 28 },
+    { 0xc097ce7bc90715b3, 56, 36 },
+    { 0x8f7e32ce7bea5c70, 83, 44 },
+    { 0xd5d238a4abe98068, 109, 52 },
+    { 0x9f4f2726179a2245, 136, 60 },
+    { 0xed63a231d4c4fb27, 162, 68 },
+    { 0xb0de65388cc8ada8, 189, 76 },
+    { 0x83c7088e1aab65db, 216, 84 },
+    { 0xc45d1df942711d9a, 242, 92 },
+    { 0x924d692ca61be758, 269, 100 },
+    { 0xda01ee641a708dea, 295, 108 },
+    { 0xa26da3999aef774a, 322, 116 },
+    { 0xf209787bb47d6b85, 348, 124 },
+    { 0xb454e4a179dd1877, 375, 132 },
+    { 0x865b86925b9bc5c2, 402, 140 },
+    { 0xc83553c5c8965d3d, 428, 148 },
+    { 0x952ab45cfa97a0b3, 455, 156 },
+    { 0xde469fbd99a05fe3, 481, 164 },
+    { 0xa59bc234db398c25, 508, 172 },
+    { 0xf6c69a72a3989f5c, 534, 180 },
+    { 0xb7dcbf5354e9bece, 561, 188 },
+    { 0x88fcf317f22241e2, 588, 196 },
+    { 0xcc20ce9bd35c78a5, 614, 204 },
+    { 0x98165af37b2153df, 641, 212 },
+    { 0xe2a0b5dc971f303a, 667, 220 },
+    { 0xa8d9d1535ce3b396, 694, 228 },
+    { 0xfb9b7cd9a4a7443c, 720, 236 },
+    { 0xbb764c4ca7a44410, 747, 244 },
+    { 0x8bab8eefb6409c1a, 774, 252 },
+    { 0xd01fef10a657842c, 800, 260 },
+    { 0x9b10a4e5e9913129, 827, 268 },
+    { 0xe7109bfba19c0c9d, 853, 276 },
+    { 0xac2820d9623bf429, 880, 284 },
+    { 0x80444b5e7aa7cf85, 907, 292 },
+    { 0xbf21e44003acdd2d, 933, 300 },
+    { 0x8e679c2f5e44ff8f, 960, 308 },
+    { 0xd433179d9c8cb841, 986, 316 },
+    { 0x9e19db92b4e31ba9, 1013, 324 },
+    { 0xeb96bf6ebadf77d9, 1039, 332 },
+    { 0xaf87023b9bf0ee6b, 1066, 340 },};
+
+#define DTOA_CACHED_POWERS_OFFSET 348
+#define DTOA_CACHED_POWERS_STEP 8
+
+/* return a * b / 2^64, rounded to nearest */
+static DiyFp diy_fp_mul(DiyFp a, DiyFp b)
+{
+    uint64_t a1, a0, b1, b0, ac, bc, ad, bd, t;
+    DiyFp r;
+
+    a1 = a.f >> 32;
+    a0 = (uint32_t)a.f;
+    b1 = b.f >> 32;
+    b0 = (uint32_t)b.f;
+    ac = a1 * b1;
+    bc = a0 * b1;
+    ad = a1 * b0;
+    bd = a0 * b0;
+    t = (bd >> 32) + (uint32_t)ad + (uint32_t)bc + ((uint64_t)1 << 31);
+    r.f = ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+    r.e = a.e + b.e + 64;
+    return r;
+}
+
+static DiyFp diy_fp_normalize(DiyFp a)
+{
+    int l = clz64(a.f);
+    a.f <<= l;
+    a.e -= l;
+    return a;
+}
+
+static BOOL grisu_round_weed(char *buf, int len, uint64_t dist_high_w,
+                             uint64_t unsafe_interval, uint64_t rest,
+                             uint64_t ten_kappa, uint64_t unit)
+{
+    uint64_t small_dist = dist_high_w - unit;
+    uint64_t big_dist = dist_high_w + unit;
+
+    /* move the last digit down while it gets closer to 'w' */
+    while (rest < small_dist &&
+           unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_dist ||
+            small_dist - rest >= rest + ten_kappa - small_dist)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+    /* the closest digits cannot be decided */
+    if (rest < big_dist &&
+        unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_dist ||
+         big_dist - rest > rest + ten_kappa - big_dist))
+        return FALSE;
+    /* the result must be safely inside the rounding interval */
+    return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+}
+
+/* generate the shortest digits of a number in [low, high] closest to
+   'w'. The three numbers have the same exponent in [-60, -32]. */
+static BOOL grisu_digit_gen(char *buf, int *plen, int *pkappa,
+                            DiyFp low, DiyFp w, DiyFp high)
+{
+    uint64_t unit, too_low, too_high, unsafe_interval, one, mask;
+    uint64_t fractionals, rest;
+    uint32_t integrals, divisor;
+    int shift, kappa, len, digit;
+
+    /* the cached power and the boundaries are off by at most 1 unit */
+    unit = 1;
+    too_low = low.f - unit;
+    too_high = high.f + unit;
+    unsafe_interval = too_high - too_low;
+    shift = -w.e;
+    one = (uint64_t)1 << shift;
+    mask = one - 1;
+    integrals = too_high >> shift;
+    fractionals = too_high & mask;
+
+    /* integrals < 2^32 */
+    kappa = 10;
+    while (kappa > 0 && integrals < u32_pow10_table[kappa - 1])
+        kappa--;
+    len = 0;
+    while (kappa > 0) {
+        divisor = u32_pow10_table[kappa - 1];
+        digit = integrals / divisor;
+        buf[len++] = digit + '0';
+        integrals %= divisor;
+        kappa--;
+        rest = ((uint64_t)integrals << shift) + fractionals;
+        if (rest < unsafe_interval) {
+            *plen = len;
+            *pkappa = kappa;
+            return grisu_round_weed(buf, len, too_high - w.f,
+                                    unsafe_interval, rest,
+                                    (uint64_t)divisor << shift, unit);
+        }
+    }
+    for(;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        digit = fractionals >> shift;
+        buf[len++] = digit + '0';
+        fractionals &= mask;
+        kappa--;
+        if (fractionals < unsafe_interval) {
+            *plen = len;
+            *pkappa = kappa;
+            return grisu_round_weed(buf, len, (too_high - w.f) * unit,
+                                    unsafe_interval, fractionals, one, unit);
+        }
+    }
+}
+
+/* 'm' and 'e' are the IEEE 754 fields of a finite non zero
+   number. Return the digits in 'buf' (at most 17) and 'pK' such as
+   the number is digits * 10^K, or FALSE if the exact algorithm must
+   be used. */
+static BOOL grisu3(char *buf, int *plen, int *pK, uint64_t m, int e)
+{
+    DiyFp v, w, m_plus, m_minus, c;
+    const DTOACachedPower *cp;
+    int k, kappa;
+
+    if (e == 0) {
+        v.f = m;
+        v.e = 1 - 1075;
+    } else {
+        v.f = m | ((uint64_t)1 << 52);
+        v.e = e - 1075;
+    }
+    w = diy_fp_normalize(v);
+
+    /* boundaries of the rounding interval */
+    m_plus.f = (v.f << 1) + 1;
+    m_plus.e = v.e - 1;
+    m_plus = diy_fp_normalize(m_plus);
+    if (m == 0 && e > 1) {
+        /* the lower boundary is closer */
+        m_minus.f = (v.f << 2) - 1;
+        m_minus.e = v.e - 2;
+    } else {
+        m_minus.f = (v.f << 1) - 1;
+        m_minus.e = v.e - 1;
+    }
+    m_minus.f <<= m_minus.e - m_plus.e;
+    m_minus.e = m_plus.e;
+
+    /* select 10^-k such as the scaled exponents are in [-60, -32]:
+       k = ceil((-60 - (w.e + 64) + 63) * log10(2)) */
+    k = -(int)(((int64_t)(w.e + 61) * 1292913987) >> 32);
+    cp = &dtoa_cached_powers[(DTOA_CACHED_POWERS_OFFSET + k - 1) /
+                             DTOA_CACHED_POWERS_STEP + 1];
+    c.f = cp->f;
+    c.e = cp->e;
+
+    if (!grisu_digit_gen(buf, plen, &kappa, diy_fp_mul(m_minus, c),
+                         diy_fp_mul(w, c), diy_fp_mul(m_plus, c)))
+        return FALSE;
+    *pK = kappa - cp->k;
+    return TRUE;
+}
+
+/* return the length or -1 if the exact algorithm is necessary */
+int js_dtoa_shortest(char *buf, double d, int flags)
+{
+    uint64_t a, m;
+    int e, len, E, K, i, exp_mode;
+    char digits[18], *q;
+
+    a = float64_as_uint64(d);
+    e = (a >> 52) & 0x7ff;
+    m = a & (((uint64_t)1 << 52) - 1);
+    q = buf;
+    if (e == 0x7ff) {
+        if (m != 0) {
+            memcpy(q, "NaN", 3);
+            q += 3;
+            goto done;
+        }
+        if (a >> 63)
+            *q++ = '-';
+        memcpy(q, "Infinity", 8);
+        q += 8;
+        goto done;
+    }
+    if ((a >> 63) && (e | m) == 0 && !(flags & JS_DTOA_MINUS_ZERO))
+        a = 0;
+    if (a >> 63)
+        *q++ = '-';
+    exp_mode = flags & JS_DTOA_EXP_MASK;
+    if ((e | m) == 0) {
+        len = 1;
+        digits[0] = '0';
+        K = 0;
+    } else {
+#ifdef USE_FAST_INT
+        if (e >= 1075 - 52 && e <= 1075 &&
+            exp_mode != JS_DTOA_EXP_ENABLED) {
+            uint64_t m1 = m | ((uint64_t)1 << 52);
+            int sh = 1075 - e;
+            if ((m1 & (((uint64_t)1 << sh) - 1)) == 0) {
+                q += u64toa(q, m1 >> sh);
+                goto done;
+            }
+        }
+#endif
+        if (!grisu3(digits, &len, &K, m, e))
+            return -1;
+        /* remove the trailing zeros */
+        while (digits[len - 1] == '0') {
+            len--;
+            K++;
+        }
+    }
+
+    /* same layout as js_dtoa() */
+    E = len + K;
+    if (exp_mode == JS_DTOA_EXP_ENABLED ||
+        (exp_mode == JS_DTOA_EXP_AUTO && (E <= -6 || E > 21))) {
+        *q++ = digits[0];
+        if (len > 1) {
+            *q++ = '.';
+            memcpy(q, digits + 1, len - 1);
+            q += len - 1;
+        }
+        *q++ = 'e';
+        E--;
+        if (E < 0) {
+            *q++ = '-';
+            E = -E;
+        } else {
+            *q++ = '+';
+        }
+        q += u32toa(q, E);
+    } else if (E <= 0) {
+        *q++ = '0';
+        *q++ = '.';
+        for(i = 0; i < -E; i++)
+            *q++ = '0';
+        memcpy(q, digits, len);
+        q += len;
+    } else if (E < len) {
+        memcpy(q, digits, E);
+        q += E;
+        *q++ = '.';
+        memcpy(q, digits + E, len - E);
+        q += len - E;
+    } else {
+        memcpy(q, digits, len);
+        q += len;
+        for(i = 0; i < E - len; i++)
+            *q++ = '0';
+    }
+ done:
+    *q = '\0';
+    return q - buf;
+}
+
 /* return the length */
 int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
             JSDTOATempMem *tmp_mem)
@@ -1114,6 +1503,12 @@ int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
     mpb_t *tmp1, *mant_max;
     int fmt = flags & JS_DTOA_FORMAT_MASK;
 
+    if (radix == 10 && fmt == JS_DTOA_FORMAT_FREE) {
+        l = js_dtoa_shortest(buf, d, flags);
+        if (l >= 0)
+            return l;
+    }
+
     tmp1 = dtoa_malloc(&mptr, sizeof(mpb_t) + sizeof(limb_t) * DBIGNUM_LEN_MAX);
     mant_max = dtoa_malloc(&mptr, sizeof(mpb_t) + sizeof(limb_t) * MANT_LEN_MAX);
     assert((mptr - tmp_mem->mem) <= sizeof(JSDTOATempMem) / sizeof(mptr[0]));
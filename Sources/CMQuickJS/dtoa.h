@@ -67,6 +67,10 @@ int js_dtoa_max_len(double d, int radix, int n_digits, int flags);
 /* return the string length */
 int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
             JSDTOATempMem *tmp_mem);
+/* fast path for radix = 10 and JS_DTOA_FORMAT_FREE which needs no
+   temporary memory. Return the string length or -1 if js_dtoa() must
+   be used. */
+int js_dtoa_shortest(char *buf, double d, int flags);
 double js_atod(const char *str, const char **pnext, int radix, int flags,
                JSATODTempMem *tmp_mem);
 
@@ -40,6 +40,31 @@ void mqjs_set_native_callback(MQJSNativeCallback callback);
 /* Create a native function bound to a Swift closure */
 JSValue mqjs_new_native_function(JSContext *ctx, int32_t function_id);
 
+/* Native class support */
+
+/* Callback type for Swift to release the instance of a collected object */
+typedef void (*MQJSFinalizerCallback)(void *instance);
+
+/* Set the finalizer callback (called once from Swift during init) */
+void mqjs_set_finalizer_callback(MQJSFinalizerCallback callback);
+
+/* Swift class constructor trampoline */
+JSValue js_swift_constructor_trampoline(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
+int32_t mqjs_get_swift_constructor_trampoline_index(void);
+
+/* Number of classes that can be registered (class IDs from JS_CLASS_USER) */
+int32_t mqjs_get_user_class_count(void);
+
+/* Create a constructor bound to a Swift closure (throws if called without new) */
+JSValue mqjs_new_native_constructor(JSContext *ctx, int32_t function_id);
+
+/* Create an object of class_id holding a retained Swift instance, released
+   by the finalizer callback when the object is collected */
+JSValue mqjs_new_class_instance(JSContext *ctx, int32_t class_id, void *instance);
+
+/* Get the Swift instance of an object (NULL if the object is not of class_id) */
+void *mqjs_get_class_instance(JSContext *ctx, JSValue obj, int32_t class_id);
+
 /* Context opaque pointer accessors */
 void mqjs_set_context_opaque(JSContext *ctx, void *opaque);
 void *mqjs_get_context_opaque(JSContext *ctx);
@@ -50,7 +75,120 @@ JSValue mqjs_get_exception(void);
 /* Helper to throw an internal error (macro not accessible from Swift) */
 JSValue mqjs_throw_internal_error(JSContext *ctx, const char *message);
 
+/* Helper to throw a type error */
+JSValue mqjs_throw_type_error(JSContext *ctx, const char *message);
+
 /* Set the prototype of an object */
 int mqjs_set_prototype(JSContext *ctx, JSValue obj, JSValue proto);
 
+/* Bulk construction */
+
+/* Create a plain object in one call. The values are the n values last pushed
+   with JS_PushArg() (in key order) and are popped from the stack, which keeps
+   them rooted while the keys are interned. keys holds the n UTF-8 keys back to
+   back, key_lens their byte lengths. */
+JSValue mqjs_new_object_from_props(JSContext *ctx, const char *keys,
+                                   const uint32_t *key_lens, int n);
+
+/* Create an array from the n values last pushed with JS_PushArg() */
+JSValue mqjs_new_array_from_values(JSContext *ctx, int n);
+
+/* Batch calls */
+
+/* Maximum number of argument columns of mqjs_call_batch() */
+#define MQJS_BATCH_MAX_COLUMNS 16
+
+/* Column and result types of mqjs_call_batch() */
+enum {
+    MQJS_BATCH_FLOAT64,  /* values is a double array */
+    MQJS_BATCH_INT32,    /* values is an int32_t array */
+    MQJS_BATCH_UTF8,     /* values holds the UTF-8 strings back to back, string i
+                            being the bytes offsets[i] to offsets[i + 1] */
+    MQJS_BATCH_ELEMENTS, /* elements of array (an Array or a typed array) */
+};
+
+/* One argument column of a batch call */
+typedef struct {
+    int32_t type;
+    const void *values;
+    const size_t *offsets;
+    JSValue array;
+} MQJSBatchColumn;
+
+/* Call func count times with this_val and one argument per column, storing
+   the result of call i converted to result_type (MQJS_BATCH_FLOAT64 or
+   MQJS_BATCH_INT32) in results[i]. Returns 0, or -1 with a pending exception;
+   *pdone is set to the number of completed calls. */
+int mqjs_call_batch(JSContext *ctx, JSValue func, JSValue this_val,
+                    const MQJSBatchColumn *columns, int column_count,
+                    size_t count, int32_t result_type, void *results,
+                    size_t *pdone);
+
+/* JSON */
+
+/* Parse len bytes of UTF-8 JSON text (not necessarily NUL-terminated) like
+   JSON.parse(). Returns JS_EXCEPTION with a pending SyntaxError if invalid. */
+JSValue mqjs_json_parse_utf8(JSContext *ctx, const char *buf, size_t len);
+
+/* Binary data support */
+
+/* Create an ArrayBuffer holding a copy of len bytes from buf */
+JSValue mqjs_new_array_buffer_copy(JSContext *ctx, const void *buf, size_t len);
+
+/* Create a typed array of class_id (JS_CLASS_UINT8C_ARRAY..JS_CLASS_FLOAT64_ARRAY)
+   viewing the whole ArrayBuffer */
+JSValue mqjs_new_typed_array(JSContext *ctx, int class_id, JSValue buffer);
+
+/* Borrow the bytes of an ArrayBuffer or typed array (NULL if neither).
+   Only valid until the next allocation in the context. */
+uint8_t *mqjs_get_array_buffer_ptr(JSContext *ctx, JSValue val, size_t *plen);
+
+/* Memory statistics */
+
+/* Fill st with the heap usage and GC counters. With count_blocks != 0, also
+   walk the heap to count the blocks per memory tag (JS_MTAG_x). */
+void mqjs_get_memory_stats(JSContext *ctx, JSMemoryStats *st, int count_blocks);
+
+/* Shared bytecode images */
+
+/* Map a file written from JS_PrepareBytecode() output (header followed by the
+   data) and relocate it for this process. The returned image is read-only and
+   can be passed to JS_LoadBytecode() by any number of contexts on any thread.
+   ctx is only used to look up the stdlib atoms and must not have loaded
+   bytecode itself. Returns NULL if the file cannot be mapped or is not valid
+   bytecode for this build; *psize is set to the image size. */
+uint8_t *mqjs_map_bytecode_file(JSContext *ctx, const char *filename, size_t *psize);
+
+/* Same as mqjs_map_bytecode_file() for bytecode held in memory, which is
+   copied once into the new image */
+uint8_t *mqjs_map_bytecode(JSContext *ctx, const uint8_t *buf, size_t size);
+
+/* Release an image once no context using it exists anymore */
+void mqjs_unmap_bytecode(uint8_t *image, size_t size);
+
+/* Maximum tag length of mqjs_map_bytecode_cache_file() */
+#define MQJS_BYTECODE_TAG_MAX 64
+
+/* Same as mqjs_map_bytecode_file() for a file holding the image followed by a
+   tag_len byte tag. Returns NULL unless the file ends with the given tag. */
+uint8_t *mqjs_map_bytecode_cache_file(JSContext *ctx, const char *filename,
+                                      const uint8_t *tag, size_t tag_len,
+                                      size_t *psize);
+
+/* SHA-256 */
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t buffer[64];
+} MQJSSHA256;
+
+void mqjs_sha256_init(MQJSSHA256 *s);
+void mqjs_sha256_update(MQJSSHA256 *s, const void *data, size_t len);
+void mqjs_sha256_final(MQJSSHA256 *s, uint8_t digest[32]);
+
+/* Digest identifying the engine version, word size and stdlib that bytecode
+   images depend on. Images are only valid for the build with the same id. */
+void mqjs_get_build_id(uint8_t digest[32]);
+
 #endif /* MQJS_BRIDGE_H */
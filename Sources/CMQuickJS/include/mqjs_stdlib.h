@@ -1,16 +1,22 @@
 /* this file is automatically generated - do not edit */
+/* generated by scripts/stdlib/mquickjs_build.py from scripts/stdlib/mqjs_stdlib.py */
 
 #include "mquickjs_priv.h"
 
 /* Forward declarations for functions referenced in this file */
 JSValue js_date_now(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
 JSValue js_print(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
+JSValue js_performance_now(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
+JSValue js_gc(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
 JSValue js_load(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
 JSValue js_setTimeout(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
 JSValue js_clearTimeout(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
-JSValue js_gc(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
-JSValue js_performance_now(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv);
 JSValue js_swift_trampoline(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
+JSValue js_swift_constructor_trampoline(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
+
+/* C function table indices for JS_NewCFunctionParams() */
+#define JS_CFUNCTION_swift_trampoline 152
+#define JS_CFUNCTION_swift_constructor_trampoline 153
 
 static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   /* atom_table */
@@ -513,82 +519,87 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "subarray" (offset=496) */
   0x7961727261627573,
   0x0000000000000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (17 << (JS_MTAG_BITS + 3)), /* "BYTES_PER_ELEMENT" (offset=499) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "fill" (offset=499) */
+  0x000000006c6c6966,
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "copyWithin" (offset=501) */
+  0x6874695779706f63,
+  0x0000000000006e69,
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (17 << (JS_MTAG_BITS + 3)), /* "BYTES_PER_ELEMENT" (offset=504) */
   0x45505f5345545942,
   0x4e454d454c455f52,
   0x0000000000000054,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (9 << (JS_MTAG_BITS + 3)), /* "Int8Array" (offset=503) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (9 << (JS_MTAG_BITS + 3)), /* "Int8Array" (offset=508) */
   0x6172724138746e49,
   0x0000000000000079,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Uint8Array" (offset=506) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Uint8Array" (offset=511) */
   0x72724138746e6955,
   0x0000000000007961,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Int16Array" (offset=509) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Int16Array" (offset=514) */
   0x7272413631746e49,
   0x0000000000007961,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "Uint16Array" (offset=512) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "Uint16Array" (offset=517) */
   0x72413631746e6955,
   0x0000000000796172,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Int32Array" (offset=515) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "Int32Array" (offset=520) */
   0x7272413233746e49,
   0x0000000000007961,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "Uint32Array" (offset=518) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "Uint32Array" (offset=523) */
   0x72413233746e6955,
   0x0000000000796172,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "Float32Array" (offset=521) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "Float32Array" (offset=526) */
   0x41323374616f6c46,
   0x0000000079617272,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "Float64Array" (offset=524) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "Float64Array" (offset=529) */
   0x41343674616f6c46,
   0x0000000079617272,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "isNaN" (offset=527) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "isNaN" (offset=532) */
   0x0000004e614e7369,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "isFinite" (offset=529) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "isFinite" (offset=534) */
   0x6574696e69467369,
   0x0000000000000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "globalThis" (offset=532) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "globalThis" (offset=537) */
   0x68546c61626f6c67,
   0x0000000000007369,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "console" (offset=535) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "console" (offset=540) */
   0x00656c6f736e6f63,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "performance" (offset=537) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (11 << (JS_MTAG_BITS + 3)), /* "performance" (offset=542) */
   0x616d726f66726570,
   0x000000000065636e,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "print" (offset=540) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "print" (offset=545) */
   0x000000746e697270,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "gc" (offset=542) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "gc" (offset=547) */
   0x0000000000006367,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "load" (offset=544) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "load" (offset=549) */
   0x0000000064616f6c,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "setTimeout" (offset=546) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "setTimeout" (offset=551) */
   0x6f656d6954746573,
   0x0000000000007475,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "clearTimeout" (offset=549) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "clearTimeout" (offset=554) */
   0x6d69547261656c63,
   0x0000000074756f65,
 
-  /* sorted atom table (offset=552) */
-  JS_VALUE_ARRAY_HEADER(231),
+  /* sorted atom table (offset=557) */
+  JS_VALUE_ARRAY_HEADER(233),
   JS_ROM_VALUE(97), /* empty */
   JS_ROM_VALUE(147), /* _Infinity */
   JS_ROM_VALUE(117), /* _eval_ */
   JS_ROM_VALUE(115), /* _ret_ */
   JS_ROM_VALUE(299), /* Array */
   JS_ROM_VALUE(469), /* ArrayBuffer */
-  JS_ROM_VALUE(499), /* BYTES_PER_ELEMENT */
+  JS_ROM_VALUE(504), /* BYTES_PER_ELEMENT */
   JS_ROM_VALUE(242), /* Boolean */
   JS_ROM_VALUE(402), /* Date */
   JS_ROM_VALUE(352), /* E */
   JS_ROM_VALUE(224), /* EPSILON */
   JS_ROM_VALUE(152), /* Error */
   JS_ROM_VALUE(448), /* EvalError */
-  JS_ROM_VALUE(521), /* Float32Array */
-  JS_ROM_VALUE(524), /* Float64Array */
+  JS_ROM_VALUE(526), /* Float32Array */
+  JS_ROM_VALUE(529), /* Float64Array */
   JS_ROM_VALUE(181), /* Function */
   JS_ROM_VALUE(144), /* Infinity */
-  JS_ROM_VALUE(509), /* Int16Array */
-  JS_ROM_VALUE(515), /* Int32Array */
-  JS_ROM_VALUE(503), /* Int8Array */
+  JS_ROM_VALUE(514), /* Int16Array */
+  JS_ROM_VALUE(520), /* Int32Array */
+  JS_ROM_VALUE(508), /* Int8Array */
   JS_ROM_VALUE(466), /* InternalError */
   JS_ROM_VALUE(406), /* JSON */
   JS_ROM_VALUE(354), /* LN10 */
@@ -616,9 +627,9 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(460), /* TypeError */
   JS_ROM_VALUE(482), /* TypedArray */
   JS_ROM_VALUE(463), /* URIError */
-  JS_ROM_VALUE(512), /* Uint16Array */
-  JS_ROM_VALUE(518), /* Uint32Array */
-  JS_ROM_VALUE(506), /* Uint8Array */
+  JS_ROM_VALUE(517), /* Uint16Array */
+  JS_ROM_VALUE(523), /* Uint32Array */
+  JS_ROM_VALUE(511), /* Uint8Array */
   JS_ROM_VALUE(478), /* Uint8ClampedArray */
   JS_ROM_VALUE(154), /* __proto__ */
   JS_ROM_VALUE(342), /* abs */
@@ -642,14 +653,15 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(255), /* charAt */
   JS_ROM_VALUE(257), /* charCodeAt */
   JS_ROM_VALUE(62), /* class */
-  JS_ROM_VALUE(549), /* clearTimeout */
+  JS_ROM_VALUE(554), /* clearTimeout */
   JS_ROM_VALUE(392), /* clz32 */
   JS_ROM_VALUE(260), /* codePointAt */
   JS_ROM_VALUE(268), /* concat */
-  JS_ROM_VALUE(535), /* console */
+  JS_ROM_VALUE(540), /* console */
   JS_ROM_VALUE(64), /* const */
   JS_ROM_VALUE(133), /* constructor */
   JS_ROM_VALUE(37), /* continue */
+  JS_ROM_VALUE(501), /* copyWithin */
   JS_ROM_VALUE(370), /* cos */
   JS_ROM_VALUE(174), /* create */
   JS_ROM_VALUE(57), /* debugger */
@@ -666,6 +678,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(68), /* export */
   JS_ROM_VALUE(70), /* extends */
   JS_ROM_VALUE(2), /* false */
+  JS_ROM_VALUE(499), /* fill */
   JS_ROM_VALUE(325), /* filter */
   JS_ROM_VALUE(52), /* finally */
   JS_ROM_VALUE(429), /* flags */
@@ -676,7 +689,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(249), /* fromCodePoint */
   JS_ROM_VALUE(394), /* fround */
   JS_ROM_VALUE(54), /* function */
-  JS_ROM_VALUE(542), /* gc */
+  JS_ROM_VALUE(547), /* gc */
   JS_ROM_VALUE(126), /* get */
   JS_ROM_VALUE(493), /* get buffer */
   JS_ROM_VALUE(475), /* get byteLength */
@@ -690,7 +703,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(426), /* get source */
   JS_ROM_VALUE(445), /* get stack */
   JS_ROM_VALUE(168), /* getPrototypeOf */
-  JS_ROM_VALUE(532), /* globalThis */
+  JS_ROM_VALUE(537), /* globalThis */
   JS_ROM_VALUE(178), /* hasOwnProperty */
   JS_ROM_VALUE(6), /* if */
   JS_ROM_VALUE(76), /* implements */
@@ -703,15 +716,15 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(26), /* instanceof */
   JS_ROM_VALUE(79), /* interface */
   JS_ROM_VALUE(301), /* isArray */
-  JS_ROM_VALUE(529), /* isFinite */
-  JS_ROM_VALUE(527), /* isNaN */
+  JS_ROM_VALUE(534), /* isFinite */
+  JS_ROM_VALUE(532), /* isNaN */
   JS_ROM_VALUE(307), /* join */
   JS_ROM_VALUE(176), /* keys */
   JS_ROM_VALUE(415), /* lastIndex */
   JS_ROM_VALUE(272), /* lastIndexOf */
   JS_ROM_VALUE(136), /* length */
   JS_ROM_VALUE(82), /* let */
-  JS_ROM_VALUE(544), /* load */
+  JS_ROM_VALUE(549), /* load */
   JS_ROM_VALUE(384), /* log */
   JS_ROM_VALUE(400), /* log10 */
   JS_ROM_VALUE(398), /* log2 */
@@ -731,10 +744,10 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(408), /* parse */
   JS_ROM_VALUE(207), /* parseFloat */
   JS_ROM_VALUE(204), /* parseInt */
-  JS_ROM_VALUE(537), /* performance */
+  JS_ROM_VALUE(542), /* performance */
   JS_ROM_VALUE(305), /* pop */
   JS_ROM_VALUE(386), /* pow */
-  JS_ROM_VALUE(540), /* print */
+  JS_ROM_VALUE(545), /* print */
   JS_ROM_VALUE(86), /* private */
   JS_ROM_VALUE(88), /* protected */
   JS_ROM_VALUE(130), /* prototype */
@@ -754,7 +767,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(252), /* set length */
   JS_ROM_VALUE(187), /* set prototype */
   JS_ROM_VALUE(171), /* setPrototypeOf */
-  JS_ROM_VALUE(546), /* setTimeout */
+  JS_ROM_VALUE(551), /* setTimeout */
   JS_ROM_VALUE(311), /* shift */
   JS_ROM_VALUE(340), /* sign */
   JS_ROM_VALUE(368), /* sin */
@@ -801,7 +814,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(60), /* with */
   JS_ROM_VALUE(95), /* yield */
 
-  /* properties (offset=784) */
+  /* properties (offset=791) */
   JS_VALUE_ARRAY_HEADER(24),
   6 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -827,7 +840,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_OBJECT << 1,
   (15 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=809) */
+  /* properties (offset=816) */
   JS_VALUE_ARRAY_HEADER(13),
   3 << 1, /* n_props */
   1 << 1, /* hash_mask */
@@ -842,14 +855,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_OBJECT - 1) << 1,
   (7 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=823) */
+  /* class (offset=830) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(784),
+  JS_ROM_VALUE(791),
   1,
-  JS_ROM_VALUE(809),
+  JS_ROM_VALUE(816),
   JS_NULL,
 
-  /* properties (offset=828) */
+  /* properties (offset=835) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -857,22 +870,22 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_CLOSURE << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=835) */
+  /* getset (offset=842) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 10),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 11),
 
-  /* getset (offset=838) */
+  /* getset (offset=845) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 12),
   JS_UNDEFINED,
 
-  /* getset (offset=841) */
+  /* getset (offset=848) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 13),
   JS_UNDEFINED,
 
-  /* properties (offset=844) */
+  /* properties (offset=851) */
   JS_VALUE_ARRAY_HEADER(30),
   8 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -881,7 +894,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   18 << 1,
   24 << 1,
   JS_ROM_VALUE(130) /* prototype */,
-  JS_ROM_VALUE(835),
+  JS_ROM_VALUE(842),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(190) /* call */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 14),
@@ -896,54 +909,54 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 17),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(136) /* length */,
-  JS_ROM_VALUE(838),
+  JS_ROM_VALUE(845),
   (12 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(150) /* name */,
-  JS_ROM_VALUE(841),
+  JS_ROM_VALUE(848),
   (15 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_CLOSURE - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=875) */
+  /* class (offset=882) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(828),
+  JS_ROM_VALUE(835),
   9,
-  JS_ROM_VALUE(844),
+  JS_ROM_VALUE(851),
   JS_NULL,
 
-  /* float64 (offset=880) */
+  /* float64 (offset=887) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x7fefffffffffffff,
 
-  /* float64 (offset=882) */
+  /* float64 (offset=889) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x0000000000000001,
 
-  /* float64 (offset=884) */
+  /* float64 (offset=891) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x7ff8000000000000,
 
-  /* float64 (offset=886) */
+  /* float64 (offset=893) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xfff0000000000000,
 
-  /* float64 (offset=888) */
+  /* float64 (offset=895) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x7ff0000000000000,
 
-  /* float64 (offset=890) */
+  /* float64 (offset=897) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3cb0000000000000,
 
-  /* float64 (offset=892) */
+  /* float64 (offset=899) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x433fffffffffffff,
 
-  /* float64 (offset=894) */
+  /* float64 (offset=901) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xc33fffffffffffff,
 
-  /* properties (offset=896) */
+  /* properties (offset=903) */
   JS_VALUE_ARRAY_HEADER(43),
   11 << 1, /* n_props */
   7 << 1, /* hash_mask */
@@ -962,33 +975,33 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 20),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(210) /* MAX_VALUE */,
-  JS_ROM_VALUE(880),
+  JS_ROM_VALUE(887),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(213) /* MIN_VALUE */,
-  JS_ROM_VALUE(882),
+  JS_ROM_VALUE(889),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(142) /* NaN */,
-  JS_ROM_VALUE(884),
+  JS_ROM_VALUE(891),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(216) /* NEGATIVE_INFINITY */,
-  JS_ROM_VALUE(886),
+  JS_ROM_VALUE(893),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(220) /* POSITIVE_INFINITY */,
-  JS_ROM_VALUE(888),
+  JS_ROM_VALUE(895),
   (10 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(224) /* EPSILON */,
-  JS_ROM_VALUE(890),
+  JS_ROM_VALUE(897),
   (25 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(226) /* MAX_SAFE_INTEGER */,
-  JS_ROM_VALUE(892),
+  JS_ROM_VALUE(899),
   (16 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(230) /* MIN_SAFE_INTEGER */,
-  JS_ROM_VALUE(894),
+  JS_ROM_VALUE(901),
   (22 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_NUMBER << 1,
   (34 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=940) */
+  /* properties (offset=947) */
   JS_VALUE_ARRAY_HEADER(21),
   5 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1011,14 +1024,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_NUMBER - 1) << 1,
   (9 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=962) */
+  /* class (offset=969) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(896),
+  JS_ROM_VALUE(903),
   18,
-  JS_ROM_VALUE(940),
+  JS_ROM_VALUE(947),
   JS_NULL,
 
-  /* properties (offset=967) */
+  /* properties (offset=974) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1026,7 +1039,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_BOOLEAN << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=974) */
+  /* properties (offset=981) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1034,14 +1047,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_BOOLEAN - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=981) */
+  /* class (offset=988) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(967),
-  25,
   JS_ROM_VALUE(974),
+  25,
+  JS_ROM_VALUE(981),
   JS_NULL,
 
-  /* properties (offset=986) */
+  /* properties (offset=993) */
   JS_VALUE_ARRAY_HEADER(13),
   3 << 1, /* n_props */
   1 << 1, /* hash_mask */
@@ -1056,12 +1069,12 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_STRING << 1,
   (4 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1000) */
+  /* getset (offset=1007) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 29),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 30),
 
-  /* properties (offset=1003) */
+  /* properties (offset=1010) */
   JS_VALUE_ARRAY_HEADER(70),
   20 << 1, /* n_props */
   7 << 1, /* hash_mask */
@@ -1074,7 +1087,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   43 << 1,
   61 << 1,
   JS_ROM_VALUE(136) /* length */,
-  JS_ROM_VALUE(1000),
+  JS_ROM_VALUE(1007),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(255) /* charAt */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 31),
@@ -1133,14 +1146,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_STRING - 1) << 1,
   (40 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1074) */
+  /* class (offset=1081) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(986),
+  JS_ROM_VALUE(993),
   26,
-  JS_ROM_VALUE(1003),
+  JS_ROM_VALUE(1010),
   JS_NULL,
 
-  /* properties (offset=1079) */
+  /* properties (offset=1086) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1151,28 +1164,28 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1089) */
+  /* getset (offset=1096) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 51),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 52),
 
-  /* properties (offset=1092) */
-  JS_VALUE_ARRAY_HEADER(79),
-  23 << 1, /* n_props */
+  /* properties (offset=1099) */
+  JS_VALUE_ARRAY_HEADER(76),
+  22 << 1, /* n_props */
   7 << 1, /* hash_mask */
   67 << 1,
   46 << 1,
   58 << 1,
   0 << 1,
-  76 << 1,
   73 << 1,
   70 << 1,
+  64 << 1,
   43 << 1,
   JS_ROM_VALUE(268) /* concat */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 53),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(136) /* length */,
-  JS_ROM_VALUE(1089),
+  JS_ROM_VALUE(1096),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(303) /* push */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 54),
@@ -1228,55 +1241,52 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(329) /* reduceRight */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 71),
   (55 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(327) /* reduce */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 70),
-  (64 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(332) /* sort */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 72),
   (10 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_ARRAY - 1) << 1,
   (61 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1172) */
+  /* class (offset=1176) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1079),
+  JS_ROM_VALUE(1086),
   49,
-  JS_ROM_VALUE(1092),
+  JS_ROM_VALUE(1099),
   JS_NULL,
 
-  /* float64 (offset=1177) */
+  /* float64 (offset=1181) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x4005bf0a8b145769,
 
-  /* float64 (offset=1179) */
+  /* float64 (offset=1183) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x40026bb1bbb55516,
 
-  /* float64 (offset=1181) */
+  /* float64 (offset=1185) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3fe62e42fefa39ef,
 
-  /* float64 (offset=1183) */
+  /* float64 (offset=1187) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3ff71547652b82fe,
 
-  /* float64 (offset=1185) */
+  /* float64 (offset=1189) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3fdbcb7b1526e50e,
 
-  /* float64 (offset=1187) */
+  /* float64 (offset=1191) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x400921fb54442d18,
 
-  /* float64 (offset=1189) */
+  /* float64 (offset=1193) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3fe6a09e667f3bcd,
 
-  /* float64 (offset=1191) */
+  /* float64 (offset=1195) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x3ff6a09e667f3bcd,
 
-  /* properties (offset=1193) */
+  /* properties (offset=1197) */
   JS_VALUE_ARRAY_HEADER(109),
   33 << 1, /* n_props */
   7 << 1, /* hash_mask */
@@ -1313,28 +1323,28 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 80),
   (19 << 1) | (JS_PROP_NORMAL << 30),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_STRING_CHAR, 69) /* E */,
-  JS_ROM_VALUE(1177),
+  JS_ROM_VALUE(1181),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(354) /* LN10 */,
-  JS_ROM_VALUE(1179),
+  JS_ROM_VALUE(1183),
   (25 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(356) /* LN2 */,
-  JS_ROM_VALUE(1181),
+  JS_ROM_VALUE(1185),
   (28 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(358) /* LOG2E */,
-  JS_ROM_VALUE(1183),
+  JS_ROM_VALUE(1187),
   (31 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(360) /* LOG10E */,
-  JS_ROM_VALUE(1185),
+  JS_ROM_VALUE(1189),
   (22 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(362) /* PI */,
-  JS_ROM_VALUE(1187),
+  JS_ROM_VALUE(1191),
   (37 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(364) /* SQRT1_2 */,
-  JS_ROM_VALUE(1189),
+  JS_ROM_VALUE(1193),
   (40 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(366) /* SQRT2 */,
-  JS_ROM_VALUE(1191),
+  JS_ROM_VALUE(1195),
   (43 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(368) /* sin */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 81),
@@ -1387,14 +1397,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(400) /* log10 */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 97),
   (94 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1303) */
+  /* class (offset=1307) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1193),
+  JS_ROM_VALUE(1197),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=1308) */
+  /* properties (offset=1312) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1405,7 +1415,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_DATE << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1318) */
+  /* properties (offset=1322) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1413,14 +1423,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_DATE - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1325) */
+  /* class (offset=1329) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1308),
+  JS_ROM_VALUE(1312),
   98,
-  JS_ROM_VALUE(1318),
+  JS_ROM_VALUE(1322),
   JS_NULL,
 
-  /* properties (offset=1330) */
+  /* properties (offset=1334) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1431,14 +1441,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(410) /* stringify */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 101),
   (3 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1340) */
+  /* class (offset=1344) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1330),
+  JS_ROM_VALUE(1334),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=1345) */
+  /* properties (offset=1349) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1446,22 +1456,22 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_REGEXP << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1352) */
+  /* getset (offset=1356) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 103),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 104),
 
-  /* getset (offset=1355) */
+  /* getset (offset=1359) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 105),
   JS_UNDEFINED,
 
-  /* getset (offset=1358) */
+  /* getset (offset=1362) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 106),
   JS_UNDEFINED,
 
-  /* properties (offset=1361) */
+  /* properties (offset=1365) */
   JS_VALUE_ARRAY_HEADER(24),
   6 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1470,13 +1480,13 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   6 << 1,
   15 << 1,
   JS_ROM_VALUE(415) /* lastIndex */,
-  JS_ROM_VALUE(1352),
+  JS_ROM_VALUE(1356),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(424) /* source */,
-  JS_ROM_VALUE(1355),
+  JS_ROM_VALUE(1359),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(429) /* flags */,
-  JS_ROM_VALUE(1358),
+  JS_ROM_VALUE(1362),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(434) /* exec */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 107),
@@ -1487,14 +1497,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_REGEXP - 1) << 1,
   (12 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1386) */
+  /* class (offset=1390) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1345),
+  JS_ROM_VALUE(1349),
   102,
-  JS_ROM_VALUE(1361),
+  JS_ROM_VALUE(1365),
   JS_NULL,
 
-  /* properties (offset=1391) */
+  /* properties (offset=1395) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1502,17 +1512,17 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1398) */
+  /* getset (offset=1402) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 110),
   JS_UNDEFINED,
 
-  /* getset (offset=1401) */
+  /* getset (offset=1405) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 111),
   JS_UNDEFINED,
 
-  /* properties (offset=1404) */
+  /* properties (offset=1408) */
   JS_VALUE_ARRAY_HEADER(21),
   5 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1527,22 +1537,22 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(152) /* Error */,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(438) /* message */,
-  JS_ROM_VALUE(1398),
+  JS_ROM_VALUE(1402),
   (9 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(443) /* stack */,
-  JS_ROM_VALUE(1401),
+  JS_ROM_VALUE(1405),
   (6 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_ERROR - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1426) */
+  /* class (offset=1430) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1391),
+  JS_ROM_VALUE(1395),
   109,
-  JS_ROM_VALUE(1404),
+  JS_ROM_VALUE(1408),
   JS_NULL,
 
-  /* properties (offset=1431) */
+  /* properties (offset=1435) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1550,7 +1560,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_EVAL_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1438) */
+  /* properties (offset=1442) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1561,14 +1571,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_EVAL_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1448) */
+  /* class (offset=1452) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1431),
+  JS_ROM_VALUE(1435),
   113,
-  JS_ROM_VALUE(1438),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1442),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1453) */
+  /* properties (offset=1457) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1576,7 +1586,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_RANGE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1460) */
+  /* properties (offset=1464) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1587,14 +1597,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_RANGE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1470) */
+  /* class (offset=1474) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1453),
+  JS_ROM_VALUE(1457),
   114,
-  JS_ROM_VALUE(1460),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1464),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1475) */
+  /* properties (offset=1479) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1602,7 +1612,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_REFERENCE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1482) */
+  /* properties (offset=1486) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1613,14 +1623,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_REFERENCE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1492) */
+  /* class (offset=1496) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1475),
+  JS_ROM_VALUE(1479),
   115,
-  JS_ROM_VALUE(1482),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1486),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1497) */
+  /* properties (offset=1501) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1628,7 +1638,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_SYNTAX_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1504) */
+  /* properties (offset=1508) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1639,14 +1649,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_SYNTAX_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1514) */
+  /* class (offset=1518) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1497),
+  JS_ROM_VALUE(1501),
   116,
-  JS_ROM_VALUE(1504),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1508),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1519) */
+  /* properties (offset=1523) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1654,7 +1664,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_TYPE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1526) */
+  /* properties (offset=1530) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1665,14 +1675,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_TYPE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1536) */
+  /* class (offset=1540) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1519),
+  JS_ROM_VALUE(1523),
   117,
-  JS_ROM_VALUE(1526),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1530),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1541) */
+  /* properties (offset=1545) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1680,7 +1690,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_URI_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1548) */
+  /* properties (offset=1552) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1691,14 +1701,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_URI_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1558) */
+  /* class (offset=1562) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1541),
+  JS_ROM_VALUE(1545),
   118,
-  JS_ROM_VALUE(1548),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1552),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1563) */
+  /* properties (offset=1567) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1706,7 +1716,7 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_INTERNAL_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1570) */
+  /* properties (offset=1574) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1717,14 +1727,14 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_INTERNAL_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1580) */
+  /* class (offset=1584) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1563),
+  JS_ROM_VALUE(1567),
   119,
-  JS_ROM_VALUE(1570),
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1574),
+  JS_ROM_VALUE(1430),
 
-  /* properties (offset=1585) */
+  /* properties (offset=1589) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1732,30 +1742,30 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_ARRAY_BUFFER << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1592) */
+  /* getset (offset=1596) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 121),
   JS_UNDEFINED,
 
-  /* properties (offset=1595) */
+  /* properties (offset=1599) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
   JS_ROM_VALUE(472) /* byteLength */,
-  JS_ROM_VALUE(1592),
+  JS_ROM_VALUE(1596),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_ARRAY_BUFFER - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1605) */
+  /* class (offset=1609) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1585),
+  JS_ROM_VALUE(1589),
   120,
-  JS_ROM_VALUE(1595),
+  JS_ROM_VALUE(1599),
   JS_NULL,
 
-  /* properties (offset=1610) */
+  /* properties (offset=1614) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1763,454 +1773,473 @@ static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_TYPED_ARRAY << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1617) */
+  /* getset (offset=1621) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 123),
   JS_UNDEFINED,
 
-  /* getset (offset=1620) */
+  /* getset (offset=1624) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 124),
   JS_UNDEFINED,
 
-  /* getset (offset=1623) */
+  /* getset (offset=1627) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 125),
   JS_UNDEFINED,
 
-  /* getset (offset=1626) */
+  /* getset (offset=1630) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 126),
   JS_UNDEFINED,
 
-  /* properties (offset=1629) */
-  JS_VALUE_ARRAY_HEADER(30),
-  8 << 1, /* n_props */
-  3 << 1, /* hash_mask */
-  27 << 1,
-  24 << 1,
-  21 << 1,
+  /* properties (offset=1633) */
+  JS_VALUE_ARRAY_HEADER(49),
+  13 << 1, /* n_props */
+  7 << 1, /* hash_mask */
+  0 << 1,
+  34 << 1,
+  37 << 1,
+  0 << 1,
+  46 << 1,
+  31 << 1,
+  40 << 1,
   0 << 1,
   JS_ROM_VALUE(136) /* length */,
-  JS_ROM_VALUE(1617),
+  JS_ROM_VALUE(1621),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(472) /* byteLength */,
-  JS_ROM_VALUE(1620),
-  (6 << 1) | (JS_PROP_GETSET << 30),
+  JS_ROM_VALUE(1624),
+  (10 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(485) /* byteOffset */,
-  JS_ROM_VALUE(1623),
+  JS_ROM_VALUE(1627),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(491) /* buffer */,
-  JS_ROM_VALUE(1626),
+  JS_ROM_VALUE(1630),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(307) /* join */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 56),
-  (15 << 1) | (JS_PROP_NORMAL << 30),
+  (19 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(99) /* toString */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 57),
-  (18 << 1) | (JS_PROP_NORMAL << 30),
+  (22 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(496) /* subarray */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 127),
-  (9 << 1) | (JS_PROP_NORMAL << 30),
+  (13 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(332) /* sort */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 128),
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(128) /* set */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 129),
+  (28 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(499) /* fill */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 130),
+  (25 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(263) /* slice */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 131),
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(501) /* copyWithin */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 132),
+  (16 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_TYPED_ARRAY - 1) << 1,
-  (12 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1660) */
+  (43 << 1) | (JS_PROP_SPECIAL << 30),
+  /* class (offset=1683) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1610),
+  JS_ROM_VALUE(1614),
   122,
-  JS_ROM_VALUE(1629),
+  JS_ROM_VALUE(1633),
   JS_NULL,
 
-  /* properties (offset=1665) */
+  /* properties (offset=1688) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_UINT8C_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1675) */
+  /* properties (offset=1698) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT8C_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1685) */
+  /* class (offset=1708) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1665),
-  128,
-  JS_ROM_VALUE(1675),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1688),
+  133,
+  JS_ROM_VALUE(1698),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1690) */
+  /* properties (offset=1713) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_INT8_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1700) */
+  /* properties (offset=1723) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_INT8_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1710) */
+  /* class (offset=1733) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1690),
-  129,
-  JS_ROM_VALUE(1700),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1713),
+  134,
+  JS_ROM_VALUE(1723),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1715) */
+  /* properties (offset=1738) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_UINT8_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1725) */
+  /* properties (offset=1748) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   1 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT8_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1735) */
+  /* class (offset=1758) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1715),
-  130,
-  JS_ROM_VALUE(1725),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1738),
+  135,
+  JS_ROM_VALUE(1748),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1740) */
+  /* properties (offset=1763) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   2 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_INT16_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1750) */
+  /* properties (offset=1773) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   2 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_INT16_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1760) */
+  /* class (offset=1783) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1740),
-  131,
-  JS_ROM_VALUE(1750),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1763),
+  136,
+  JS_ROM_VALUE(1773),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1765) */
+  /* properties (offset=1788) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   2 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_UINT16_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1775) */
+  /* properties (offset=1798) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   2 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT16_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1785) */
+  /* class (offset=1808) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1765),
-  132,
-  JS_ROM_VALUE(1775),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1788),
+  137,
+  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1790) */
+  /* properties (offset=1813) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_INT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1800) */
+  /* properties (offset=1823) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_INT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1810) */
+  /* class (offset=1833) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1790),
-  133,
-  JS_ROM_VALUE(1800),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1813),
+  138,
+  JS_ROM_VALUE(1823),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1815) */
+  /* properties (offset=1838) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_UINT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1825) */
+  /* properties (offset=1848) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1835) */
+  /* class (offset=1858) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1815),
-  134,
-  JS_ROM_VALUE(1825),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1838),
+  139,
+  JS_ROM_VALUE(1848),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1840) */
+  /* properties (offset=1863) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_FLOAT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1850) */
+  /* properties (offset=1873) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   4 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_FLOAT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1860) */
+  /* class (offset=1883) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1840),
-  135,
-  JS_ROM_VALUE(1850),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1863),
+  140,
+  JS_ROM_VALUE(1873),
+  JS_ROM_VALUE(1683),
 
-  /* properties (offset=1865) */
+  /* properties (offset=1888) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   8 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(130) /* prototype */,
   JS_CLASS_FLOAT64_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1875) */
+  /* properties (offset=1898) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
-  JS_ROM_VALUE(499) /* BYTES_PER_ELEMENT */,
+  JS_ROM_VALUE(504) /* BYTES_PER_ELEMENT */,
   8 << 1,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(133) /* constructor */,
   (uint32_t)(-JS_CLASS_FLOAT64_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1885) */
+  /* class (offset=1908) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1865),
-  136,
-  JS_ROM_VALUE(1875),
-  JS_ROM_VALUE(1660),
+  JS_ROM_VALUE(1888),
+  141,
+  JS_ROM_VALUE(1898),
+  JS_ROM_VALUE(1683),
 
-  /* float64 (offset=1890) */
+  /* float64 (offset=1913) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x7ff0000000000000,
 
-  /* float64 (offset=1892) */
+  /* float64 (offset=1915) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x7ff8000000000000,
 
-  /* properties (offset=1894) */
+  /* properties (offset=1917) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
   3 << 1,
   JS_ROM_VALUE(384) /* log */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 137),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 142),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1901) */
+  /* class (offset=1924) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1894),
+  JS_ROM_VALUE(1917),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=1906) */
+  /* properties (offset=1929) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
   3 << 1,
   JS_ROM_VALUE(404) /* now */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 138),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 143),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1913) */
+  /* class (offset=1936) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1906),
+  JS_ROM_VALUE(1929),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* global object properties (offset=1918) */
+  /* global object properties (offset=1941) */
   JS_VALUE_ARRAY_HEADER(88),
   JS_ROM_VALUE(163) /* Object */,
-  JS_ROM_VALUE(823),
+  JS_ROM_VALUE(830),
   JS_ROM_VALUE(181) /* Function */,
-  JS_ROM_VALUE(875),
+  JS_ROM_VALUE(882),
   JS_ROM_VALUE(202) /* Number */,
-  JS_ROM_VALUE(962),
+  JS_ROM_VALUE(969),
   JS_ROM_VALUE(242) /* Boolean */,
-  JS_ROM_VALUE(981),
+  JS_ROM_VALUE(988),
   JS_ROM_VALUE(244) /* String */,
-  JS_ROM_VALUE(1074),
+  JS_ROM_VALUE(1081),
   JS_ROM_VALUE(299) /* Array */,
-  JS_ROM_VALUE(1172),
+  JS_ROM_VALUE(1176),
   JS_ROM_VALUE(334) /* Math */,
-  JS_ROM_VALUE(1303),
+  JS_ROM_VALUE(1307),
   JS_ROM_VALUE(402) /* Date */,
-  JS_ROM_VALUE(1325),
+  JS_ROM_VALUE(1329),
   JS_ROM_VALUE(406) /* JSON */,
-  JS_ROM_VALUE(1340),
+  JS_ROM_VALUE(1344),
   JS_ROM_VALUE(413) /* RegExp */,
-  JS_ROM_VALUE(1386),
+  JS_ROM_VALUE(1390),
   JS_ROM_VALUE(152) /* Error */,
-  JS_ROM_VALUE(1426),
+  JS_ROM_VALUE(1430),
   JS_ROM_VALUE(448) /* EvalError */,
-  JS_ROM_VALUE(1448),
+  JS_ROM_VALUE(1452),
   JS_ROM_VALUE(451) /* RangeError */,
-  JS_ROM_VALUE(1470),
+  JS_ROM_VALUE(1474),
   JS_ROM_VALUE(454) /* ReferenceError */,
-  JS_ROM_VALUE(1492),
+  JS_ROM_VALUE(1496),
   JS_ROM_VALUE(457) /* SyntaxError */,
-  JS_ROM_VALUE(1514),
+  JS_ROM_VALUE(1518),
   JS_ROM_VALUE(460) /* TypeError */,
-  JS_ROM_VALUE(1536),
+  JS_ROM_VALUE(1540),
   JS_ROM_VALUE(463) /* URIError */,
-  JS_ROM_VALUE(1558),
+  JS_ROM_VALUE(1562),
   JS_ROM_VALUE(466) /* InternalError */,
-  JS_ROM_VALUE(1580),
+  JS_ROM_VALUE(1584),
   JS_ROM_VALUE(469) /* ArrayBuffer */,
-  JS_ROM_VALUE(1605),
+  JS_ROM_VALUE(1609),
   JS_ROM_VALUE(478) /* Uint8ClampedArray */,
-  JS_ROM_VALUE(1685),
-  JS_ROM_VALUE(503) /* Int8Array */,
-  JS_ROM_VALUE(1710),
-  JS_ROM_VALUE(506) /* Uint8Array */,
-  JS_ROM_VALUE(1735),
-  JS_ROM_VALUE(509) /* Int16Array */,
-  JS_ROM_VALUE(1760),
-  JS_ROM_VALUE(512) /* Uint16Array */,
-  JS_ROM_VALUE(1785),
-  JS_ROM_VALUE(515) /* Int32Array */,
-  JS_ROM_VALUE(1810),
-  JS_ROM_VALUE(518) /* Uint32Array */,
-  JS_ROM_VALUE(1835),
-  JS_ROM_VALUE(521) /* Float32Array */,
-  JS_ROM_VALUE(1860),
-  JS_ROM_VALUE(524) /* Float64Array */,
-  JS_ROM_VALUE(1885),
+  JS_ROM_VALUE(1708),
+  JS_ROM_VALUE(508) /* Int8Array */,
+  JS_ROM_VALUE(1733),
+  JS_ROM_VALUE(511) /* Uint8Array */,
+  JS_ROM_VALUE(1758),
+  JS_ROM_VALUE(514) /* Int16Array */,
+  JS_ROM_VALUE(1783),
+  JS_ROM_VALUE(517) /* Uint16Array */,
+  JS_ROM_VALUE(1808),
+  JS_ROM_VALUE(520) /* Int32Array */,
+  JS_ROM_VALUE(1833),
+  JS_ROM_VALUE(523) /* Uint32Array */,
+  JS_ROM_VALUE(1858),
+  JS_ROM_VALUE(526) /* Float32Array */,
+  JS_ROM_VALUE(1883),
+  JS_ROM_VALUE(529) /* Float64Array */,
+  JS_ROM_VALUE(1908),
   JS_ROM_VALUE(204) /* parseInt */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 19),
   JS_ROM_VALUE(207) /* parseFloat */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 20),
   JS_ROM_VALUE(119) /* eval */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 139),
-  JS_ROM_VALUE(527) /* isNaN */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 140),
-  JS_ROM_VALUE(529) /* isFinite */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 141),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 144),
+  JS_ROM_VALUE(532) /* isNaN */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 145),
+  JS_ROM_VALUE(534) /* isFinite */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 146),
   JS_ROM_VALUE(144) /* Infinity */,
-  JS_ROM_VALUE(1890),
+  JS_ROM_VALUE(1913),
   JS_ROM_VALUE(142) /* NaN */,
-  JS_ROM_VALUE(1892),
+  JS_ROM_VALUE(1915),
   JS_ROM_VALUE(108) /* undefined */,
   JS_UNDEFINED,
-  JS_ROM_VALUE(532) /* globalThis */,
+  JS_ROM_VALUE(537) /* globalThis */,
   JS_NULL,
-  JS_ROM_VALUE(535) /* console */,
-  JS_ROM_VALUE(1901),
-  JS_ROM_VALUE(537) /* performance */,
-  JS_ROM_VALUE(1913),
-  JS_ROM_VALUE(540) /* print */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 142),
-  JS_ROM_VALUE(542) /* gc */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 143),
-  JS_ROM_VALUE(544) /* load */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 144),
-  JS_ROM_VALUE(546) /* setTimeout */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 145),
-  JS_ROM_VALUE(549) /* clearTimeout */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 146),
+  JS_ROM_VALUE(540) /* console */,
+  JS_ROM_VALUE(1924),
+  JS_ROM_VALUE(542) /* performance */,
+  JS_ROM_VALUE(1936),
+  JS_ROM_VALUE(545) /* print */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 147),
+  JS_ROM_VALUE(547) /* gc */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 148),
+  JS_ROM_VALUE(549) /* load */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 149),
+  JS_ROM_VALUE(551) /* setTimeout */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 150),
+  JS_ROM_VALUE(554) /* clearTimeout */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 151),
 };
 
 static const JSCFunctionDef js_c_function_table[] = {
@@ -2598,32 +2627,47 @@ static const JSCFunctionDef js_c_function_table[] = {
   { { .generic = js_typed_array_subarray },
     JS_ROM_VALUE(496) /* subarray */,
     JS_CFUNC_generic, 2, 0 },
+  { { .generic = js_typed_array_sort },
+    JS_ROM_VALUE(332) /* sort */,
+    JS_CFUNC_generic, 1, 0 },
+  { { .generic = js_typed_array_set },
+    JS_ROM_VALUE(128) /* set */,
+    JS_CFUNC_generic, 1, 0 },
+  { { .generic = js_typed_array_fill },
+    JS_ROM_VALUE(499) /* fill */,
+    JS_CFUNC_generic, 1, 0 },
+  { { .generic = js_typed_array_slice },
+    JS_ROM_VALUE(263) /* slice */,
+    JS_CFUNC_generic, 2, 0 },
+  { { .generic = js_typed_array_copyWithin },
+    JS_ROM_VALUE(501) /* copyWithin */,
+    JS_CFUNC_generic, 2, 0 },
   { { .constructor_magic = js_typed_array_constructor },
     JS_ROM_VALUE(478) /* Uint8ClampedArray */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_UINT8C_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(503) /* Int8Array */,
+    JS_ROM_VALUE(508) /* Int8Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_INT8_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(506) /* Uint8Array */,
+    JS_ROM_VALUE(511) /* Uint8Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_UINT8_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(509) /* Int16Array */,
+    JS_ROM_VALUE(514) /* Int16Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_INT16_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(512) /* Uint16Array */,
+    JS_ROM_VALUE(517) /* Uint16Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_UINT16_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(515) /* Int32Array */,
+    JS_ROM_VALUE(520) /* Int32Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_INT32_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(518) /* Uint32Array */,
+    JS_ROM_VALUE(523) /* Uint32Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_UINT32_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(521) /* Float32Array */,
+    JS_ROM_VALUE(526) /* Float32Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_FLOAT32_ARRAY },
   { { .constructor_magic = js_typed_array_constructor },
-    JS_ROM_VALUE(524) /* Float64Array */,
+    JS_ROM_VALUE(529) /* Float64Array */,
     JS_CFUNC_constructor_magic, 3, JS_CLASS_FLOAT64_ARRAY },
   { { .generic = js_print },
     JS_ROM_VALUE(384) /* log */,
@@ -2635,31 +2679,32 @@ static const JSCFunctionDef js_c_function_table[] = {
     JS_ROM_VALUE(119) /* eval */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_global_isNaN },
-    JS_ROM_VALUE(527) /* isNaN */,
+    JS_ROM_VALUE(532) /* isNaN */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_global_isFinite },
-    JS_ROM_VALUE(529) /* isFinite */,
+    JS_ROM_VALUE(534) /* isFinite */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_print },
-    JS_ROM_VALUE(540) /* print */,
+    JS_ROM_VALUE(545) /* print */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_gc },
-    JS_ROM_VALUE(542) /* gc */,
+    JS_ROM_VALUE(547) /* gc */,
     JS_CFUNC_generic, 0, 0 },
   { { .generic = js_load },
-    JS_ROM_VALUE(544) /* load */,
+    JS_ROM_VALUE(549) /* load */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_setTimeout },
-    JS_ROM_VALUE(546) /* setTimeout */,
+    JS_ROM_VALUE(551) /* setTimeout */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_clearTimeout },
-    JS_ROM_VALUE(549) /* clearTimeout */,
+    JS_ROM_VALUE(554) /* clearTimeout */,
     JS_CFUNC_generic, 1, 0 },
-  /* Swift function trampoline - NOTE: This is manually added and will need
-     to be regenerated properly with the stdlib build tool */
   { { .generic_params = js_swift_trampoline },
-    JS_NULL /* __swiftTrampoline */,
+    JS_NULL /* swift_trampoline */,
     JS_CFUNC_generic_params, 0, 0 },
+  { { .constructor_params = js_swift_constructor_trampoline },
+    JS_NULL /* swift_constructor_trampoline */,
+    JS_CFUNC_constructor_params, 0, 0 },
 };
 
 #ifndef JS_CLASS_COUNT
@@ -2667,16 +2712,18 @@ static const JSCFunctionDef js_c_function_table[] = {
 #endif
 
 static const JSCFinalizer js_c_finalizer_table[JS_CLASS_COUNT - JS_CLASS_USER] = {
+#ifdef JS_USER_CLASS_FINALIZERS
+  JS_USER_CLASS_FINALIZERS
+#endif
 };
 
 __attribute__((weak)) const JSSTDLibraryDef js_stdlib = {
   js_stdlib_table,
   js_c_function_table,
   js_c_finalizer_table,
-  2007,
+  2030,
   64,
-  552,
-  1918,
+  557,
+  1941,
   JS_CLASS_COUNT,
 };
-
@@ -223,6 +223,7 @@ typedef enum JSCFunctionDefEnum {  /* XXX: should rename for namespace isolation
     JS_CFUNC_constructor_magic,
     JS_CFUNC_generic_params,
     JS_CFUNC_f_f,
+    JS_CFUNC_constructor_params,
 } JSCFunctionDefEnum;
 
 typedef union JSCFunctionType {
@@ -232,6 +233,7 @@ typedef union JSCFunctionType {
     JSValue (*constructor_magic)(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, int magic);
     JSValue (*generic_params)(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
     double (*f_f)(double f);
+    JSValue (*constructor_params)(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
 } JSCFunctionType;
 
 typedef struct JSCFunctionDef {
@@ -263,9 +265,37 @@ JSContext *JS_NewContext(void *mem_start, size_t mem_size, const JSSTDLibraryDef
    the embedded version */
 JSContext *JS_NewContext2(void *mem_start, size_t mem_size, const JSSTDLibraryDef *stdlib_def, JS_BOOL prepare_compilation);
 void JS_FreeContext(JSContext *ctx);
+/* save/restore the context state by copying the start of its memory
+   block (no code must be running and no GC reference in use) */
+size_t JS_GetContextImageSize(JSContext *ctx);
+int JS_RestoreContextImage(JSContext *ctx, const void *image, size_t image_size);
+/* enumerate the user class objects of the heap (no memory must be allocated) */
+typedef void JSUserObjectFunc(JSContext *ctx, void *arg, int class_id, void *opaque);
+void JS_EnumUserObjects(JSContext *ctx, JSUserObjectFunc *func, void *arg);
+/* move the context to another memory block (no code must be
+   running). Return the new context or NULL if error. */
+JSContext *JS_RelocateContext(JSContext *ctx, void *mem_start, size_t mem_size);
 void JS_SetContextOpaque(JSContext *ctx, void *opaque);
 void *JS_GetContextOpaque(JSContext *ctx);
 void JS_SetInterruptHandler(JSContext *ctx, JSInterruptHandler *interrupt_handler);
+void JS_SetInterruptInterval(JSContext *ctx, int interval);
+
+typedef struct {
+    const char *func_name; /* empty string if anonymous */
+    const char *filename; /* NULL for a native function */
+    int line_num; /* 0 if unknown */
+} JSProfileFrame;
+
+/* receive a sample of the call stack, innermost frame first. The
+   strings are only valid during the call, which must not use the
+   context. */
+typedef void JSProfileHandler(JSContext *ctx, void *opaque,
+                              const JSProfileFrame *frames, int frame_count);
+/* return -1 if the profiler is not compiled in (CONFIG_PROFILER) */
+int JS_SetProfiler(JSContext *ctx, JSProfileHandler *handler,
+                   int sample_interval, uint64_t *opcode_counts);
+int JS_GetOpcodeCount(void);
+const char *JS_GetOpcodeName(int opcode);
 void JS_SetRandomSeed(JSContext *ctx, uint64_t seed);
 JSValue JS_GetGlobalObject(JSContext *ctx);
 JSValue JS_Throw(JSContext *ctx, JSValue obj);
@@ -279,15 +309,43 @@ JSValue __js_printf_like(3, 4) JS_ThrowError(JSContext *ctx, JSObjectClassEnum e
 JSValue JS_ThrowOutOfMemory(JSContext *ctx);
 JSValue JS_GetPropertyStr(JSContext *ctx, JSValue this_obj, const char *str);
 JSValue JS_GetPropertyUint32(JSContext *ctx, JSValue obj, uint32_t idx);
+/* return the number of elements of an array or typed array, -1 otherwise */
+int JS_GetArrayLength(JSContext *ctx, JSValue obj);
+/* enumerate the own properties of an object in creation order (array
+   elements excluded). '*ppos' must be set to 0 before the first
+   call. Return 1 and set '*pkey' (string or integer) and '*pval', 0
+   at the end or -1 if a getter raised an exception. */
+int JS_GetOwnPropertyNext(JSContext *ctx, JSValue obj, int *ppos,
+                          JSValue *pkey, JSValue *pval);
 JSValue JS_SetPropertyStr(JSContext *ctx, JSValue this_obj,
                           const char *str, JSValue val);
 JSValue JS_SetPropertyUint32(JSContext *ctx, JSValue this_obj,
                              uint32_t idx, JSValue val);
+/* define an accessor property ('getter' or 'setter' may be undefined) */
+JSValue JS_DefinePropertyGetSetStr(JSContext *ctx, JSValue this_obj,
+                                   const char *str, JSValue getter,
+                                   JSValue setter);
+/* pre-interned property keys: the key returned by JS_NewPropertyKey()
+   is an atom or an integer and must be kept alive with a GC reference
+   to be reused with JS_{Get,Set,Has}PropertyKey(). */
+JSValue JS_NewPropertyKey(JSContext *ctx, const char *buf, size_t buf_len);
+JSValue JS_GetPropertyKey(JSContext *ctx, JSValue this_obj, JSValue prop);
+JSValue JS_SetPropertyKey(JSContext *ctx, JSValue this_obj,
+                          JSValue prop, JSValue val);
+JS_BOOL JS_HasPropertyKey(JSContext *ctx, JSValue this_obj, JSValue prop);
 JSValue JS_NewObjectClassUser(JSContext *ctx, int class_id);
+/* define a user class at run time (for classes without ROM definition):
+   the objects of class 'class_id' inherit from 'proto' */
+void JS_SetUserClass(JSContext *ctx, int class_id, JSValue ctor, JSValue proto);
 JSValue JS_NewObject(JSContext *ctx);
 JSValue JS_NewArray(JSContext *ctx, int initial_len);
 /* create a C function with an object parameter (closure) */
 JSValue JS_NewCFunctionParams(JSContext *ctx, int func_idx, JSValue params);
+/* create an ArrayBuffer containing a copy of buf[0..len-1] */
+JSValue JS_NewArrayBufferCopy(JSContext *ctx, const uint8_t *buf, size_t len);
+/* return the bytes of an ArrayBuffer or typed array (NULL if
+   neither). The pointer is only valid until the next allocation. */
+uint8_t *JS_GetArrayBuffer(JSContext *ctx, size_t *plen, JSValue obj);
 
 #define JS_EVAL_RETVAL    (1 << 0) /* return the last value instead of undefined (slower code) */
 #define JS_EVAL_REPL      (1 << 1) /* implicitly defined global variables in assignments */
@@ -301,9 +359,43 @@ JSValue JS_Run(JSContext *ctx, JSValue val);
 JSValue JS_Eval(JSContext *ctx, const char *input, size_t input_len,
                 const char *filename, int eval_flags);
 void JS_GC(JSContext *ctx);
+void JS_GCCollect(JSContext *ctx);
+void JS_GCCompact(JSContext *ctx);
+void JS_SetGCCompactThreshold(JSContext *ctx, int percent);
+void JS_SetGCAllocationBudget(JSContext *ctx, size_t size);
+int JS_GetGCFragmentation(JSContext *ctx);
+
+#define JS_MEMORY_STATS_TAG_COUNT 8 /* indexed by the JS_MTAG_x memory tags */
+
+typedef struct {
+    size_t memory_size; /* size of the context memory */
+    size_t heap_size; /* bytes between the start and the end of the heap */
+    size_t heap_used; /* heap_size minus the free blocks inside the heap */
+    size_t free_size; /* free blocks + space between the heap and the stack */
+    size_t stack_size; /* bytes in use on the stack */
+    size_t high_water; /* max heap_used + stack_size seen at GC time */
+    uint32_t gc_count;
+    uint32_t gc_compact_count;
+    uint64_t gc_time_ns; /* cumulative time spent in the GC */
+    size_t gc_last_moved_size; /* bytes moved by the last compaction */
+    size_t gc_live_size; /* heap_used after the last GC */
+    uint32_t oom_count; /* number of out of memory errors */
+    uint64_t float64_count; /* number of float64 blocks allocated since the
+                               context was created (numbers which are
+                               neither short integers nor short floats).
+                               Never decreases: it is not the number of
+                               blocks still alive */
+    /* only set when counting the blocks */
+    uint32_t block_count[JS_MEMORY_STATS_TAG_COUNT];
+    size_t block_size[JS_MEMORY_STATS_TAG_COUNT];
+} JSMemoryStats;
+
+void JS_GetMemoryStats(JSContext *ctx, JSMemoryStats *st, JS_BOOL count_blocks);
 JSValue JS_NewStringLen(JSContext *ctx, const char *buf, size_t buf_len);
 JSValue JS_NewString(JSContext *ctx, const char *buf);
 const char *JS_ToCStringLen(JSContext *ctx, size_t *plen, JSValue val, JSCStringBuf *buf);
+const char *JS_ToUTF8StringLen(JSContext *ctx, size_t *plen, JS_BOOL *pis_utf8,
+                               JSValue val, JSCStringBuf *buf);
 const char *JS_ToCString(JSContext *ctx, JSValue val, JSCStringBuf *buf);
 JSValue JS_ToString(JSContext *ctx, JSValue val);
 int JS_ToInt32(JSContext *ctx, int *pres, JSValue val);
@@ -314,6 +406,15 @@ int JS_ToNumber(JSContext *ctx, double *pres, JSValue val);
 char *JS_GetErrorStr(JSContext *ctx, char *buf, size_t buf_size);
 int JS_StackCheck(JSContext *ctx, uint32_t len);
 void JS_PushArg(JSContext *ctx, JSValue val);
+JSValue JS_PopArg(JSContext *ctx);
+void JS_DropArgs(JSContext *ctx, int n);
+/* build an array or a plain object from the 'n' values last pushed
+   with JS_PushArg() (in push order) and remove them from the
+   stack. 'keys' holds the 'n' UTF-8 keys one after the other,
+   'key_lens[i]' bytes each. */
+JSValue JS_NewArrayFromArgs(JSContext *ctx, int n);
+JSValue JS_NewObjectFromArgs(JSContext *ctx, const char *keys,
+                             const uint32_t *key_lens, int n);
 #define FRAME_CF_CTOR           (1 << 16) /* also ored with argc in
                                              C constructors */
 JSValue JS_Call(JSContext *ctx, int call_flags);
@@ -363,6 +464,11 @@ int JS_RelocateBytecode(JSContext *ctx,
    it. warning: the bytecode is not checked so it should come from a
    trusted source. */
 JSValue JS_LoadBytecode(JSContext *ctx, const uint8_t *buf);
+/* return TRUE if JS_LoadBytecode() can be called on this context:
+   no atom must have been defined in RAM yet and a ROM atom table
+   slot must still be free (n_rom_atom_tables < N_ROM_ATOM_TABLES_MAX,
+   the standard library already uses one slot) */
+JS_BOOL JS_CanLoadBytecode(JSContext *ctx);
 
 /* debug functions */
 void JS_SetLogFunc(JSContext *ctx, JSWriteFunc *write_func);
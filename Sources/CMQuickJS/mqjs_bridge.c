@@ -4,11 +4,29 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "mquickjs_priv.h"
+#include "mqjs_bridge.h"
 
 /* Forward declarations for functions referenced in mqjs_stdlib.h */
 JSValue js_swift_trampoline(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
+JSValue js_swift_constructor_trampoline(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv, JSValue params);
+static void js_swift_finalizer(JSContext *ctx, void *opaque);
+
+/* Class IDs reserved for the classes registered from Swift. They all use
+   the same finalizer, which releases the Swift instance of the object. */
+#ifndef MQJS_USER_CLASS_COUNT
+#define MQJS_USER_CLASS_COUNT 32
+#endif
+#define JS_CLASS_COUNT (JS_CLASS_USER + MQJS_USER_CLASS_COUNT)
+#define JS_USER_CLASS_FINALIZERS [0 ... MQJS_USER_CLASS_COUNT - 1] = js_swift_finalizer,
 
 #include "mqjs_stdlib.h"
 
@@ -188,8 +206,7 @@ JSValue js_swift_trampoline(JSContext *ctx, JSValue *this_val,
 
 /* Helper to get the Swift trampoline function index */
 int32_t mqjs_get_swift_trampoline_index(void) {
-    /* The trampoline is at index 147 in c_function_table */
-    return 147;
+    return JS_CFUNCTION_swift_trampoline;
 }
 
 /* Create a native function bound to a Swift closure */
@@ -202,6 +219,80 @@ JSValue mqjs_new_native_function(JSContext *ctx, int32_t function_id) {
     return JS_NewCFunctionParams(ctx, trampoline_idx, params);
 }
 
+/* ============================================================================
+ * Native Class Support
+ * ============================================================================ */
+
+/*
+ * Callback type for Swift to release the instance of a Swift class object
+ * collected by the GC (or discarded with the context). It must not use
+ * the context.
+ */
+typedef void (*MQJSFinalizerCallback)(void *instance);
+
+/* Callback releasing a Swift instance - set by Swift */
+static MQJSFinalizerCallback g_finalizer_callback = NULL;
+
+/* Set the finalizer callback (called from Swift) */
+void mqjs_set_finalizer_callback(MQJSFinalizerCallback callback) {
+    g_finalizer_callback = callback;
+}
+
+/* Finalizer of the Swift classes: the opaque is the retained instance */
+static void js_swift_finalizer(JSContext *ctx, void *opaque) {
+    if (opaque && g_finalizer_callback) {
+        g_finalizer_callback(opaque);
+    }
+}
+
+/*
+ * Swift class constructor trampoline - called for `new ClassName(...)`.
+ *
+ * Dispatches to the Swift constructor like js_swift_trampoline; the Swift
+ * side creates the object with mqjs_new_class_instance().
+ */
+JSValue js_swift_constructor_trampoline(JSContext *ctx, JSValue *this_val,
+                                        int argc, JSValue *argv, JSValue params)
+{
+    if (!(argc & FRAME_CF_CTOR)) {
+        return JS_ThrowTypeError(ctx, "must be called with new");
+    }
+    return js_swift_trampoline(ctx, this_val, argc & ~FRAME_CF_CTOR, argv, params);
+}
+
+/* Number of classes that can be registered from Swift */
+int32_t mqjs_get_user_class_count(void) {
+    return MQJS_USER_CLASS_COUNT;
+}
+
+/* Helper to get the Swift constructor trampoline function index */
+int32_t mqjs_get_swift_constructor_trampoline_index(void) {
+    return JS_CFUNCTION_swift_constructor_trampoline;
+}
+
+/* Create a constructor bound to a Swift closure */
+JSValue mqjs_new_native_constructor(JSContext *ctx, int32_t function_id) {
+    JSValue params = JS_NewInt32(ctx, function_id);
+    return JS_NewCFunctionParams(ctx, mqjs_get_swift_constructor_trampoline_index(), params);
+}
+
+/* Create an object of a Swift class holding a retained Swift instance */
+JSValue mqjs_new_class_instance(JSContext *ctx, int32_t class_id, void *instance) {
+    JSValue obj = JS_NewObjectClassUser(ctx, class_id);
+    if (!JS_IsException(obj)) {
+        JS_SetOpaque(ctx, obj, instance);
+    }
+    return obj;
+}
+
+/* Get the Swift instance of an object, or NULL if it is not of class_id */
+void *mqjs_get_class_instance(JSContext *ctx, JSValue obj, int32_t class_id) {
+    if (JS_GetClassID(ctx, obj) != class_id) {
+        return NULL;
+    }
+    return JS_GetOpaque(ctx, obj);
+}
+
 /* Get context opaque pointer */
 void *mqjs_get_context_opaque(JSContext *ctx) {
     return JS_GetContextOpaque(ctx);
@@ -222,6 +313,11 @@ JSValue mqjs_throw_internal_error(JSContext *ctx, const char *message) {
     return JS_ThrowInternalError(ctx, "%s", message);
 }
 
+/* Helper to throw a type error (macro not accessible from Swift) */
+JSValue mqjs_throw_type_error(JSContext *ctx, const char *message) {
+    return JS_ThrowTypeError(ctx, "%s", message);
+}
+
 /* Set the prototype of an object using Object.setPrototypeOf semantics */
 int mqjs_set_prototype(JSContext *ctx, JSValue obj, JSValue proto) {
     /* Use js_object_setPrototypeOf which takes (ctx, this_val, argc, argv) */
@@ -237,3 +333,418 @@ int mqjs_set_prototype(JSContext *ctx, JSValue obj, JSValue proto) {
 
     return 0;
 }
+
+/* ============================================================================
+ * Bulk Construction
+ * ============================================================================ */
+
+/* Create a plain object from the n values on top of the stack */
+JSValue mqjs_new_object_from_props(JSContext *ctx, const char *keys,
+                                   const uint32_t *key_lens, int n) {
+    return JS_NewObjectFromArgs(ctx, keys, key_lens, n);
+}
+
+/* Create an array from the n values on top of the stack */
+JSValue mqjs_new_array_from_values(JSContext *ctx, int n) {
+    return JS_NewArrayFromArgs(ctx, n);
+}
+
+/* ============================================================================
+ * Batch Calls
+ * ============================================================================ */
+
+/* Argument i of a batch column */
+static JSValue mqjs_batch_arg(JSContext *ctx, const MQJSBatchColumn *col,
+                              JSValue array, size_t i) {
+    switch (col->type) {
+    case MQJS_BATCH_FLOAT64:
+        return JS_NewFloat64(ctx, ((const double *)col->values)[i]);
+    case MQJS_BATCH_INT32:
+        return JS_NewInt32(ctx, ((const int32_t *)col->values)[i]);
+    case MQJS_BATCH_UTF8:
+        return JS_NewStringLen(ctx, (const char *)col->values + col->offsets[i],
+                               col->offsets[i + 1] - col->offsets[i]);
+    case MQJS_BATCH_ELEMENTS:
+        return JS_GetPropertyUint32(ctx, array, i);
+    default:
+        return JS_ThrowTypeError(ctx, "invalid batch column");
+    }
+}
+
+/*
+ * Call func once per row of the columns, the columns giving the arguments.
+ *
+ * The arguments are created and pushed directly on the JS stack and the
+ * results are converted into the results buffer, so no value outlives its
+ * call and the GC only runs when the heap fills up. Returns 0, or -1 with
+ * a pending exception. *pdone is set to the number of completed calls.
+ */
+int mqjs_call_batch(JSContext *ctx, JSValue func, JSValue this_val,
+                    const MQJSBatchColumn *columns, int column_count,
+                    size_t count, int32_t result_type, void *results,
+                    size_t *pdone) {
+    JSGCRef func_ref, this_val_ref, array_refs[MQJS_BATCH_MAX_COLUMNS];
+    JSValue arg, res;
+    size_t i = 0;
+    int j, len, ret = -1;
+
+    *pdone = 0;
+    if (column_count < 0 || column_count > MQJS_BATCH_MAX_COLUMNS) {
+        JS_ThrowRangeError(ctx, "too many batch columns");
+        return -1;
+    }
+    if (!JS_IsFunction(ctx, func)) {
+        JS_ThrowTypeError(ctx, "not a function");
+        return -1;
+    }
+    for(j = 0; j < column_count; j++) {
+        if (columns[j].type != MQJS_BATCH_ELEMENTS)
+            continue;
+        len = JS_GetArrayLength(ctx, columns[j].array);
+        if (len < 0) {
+            JS_ThrowTypeError(ctx, "batch column is not an array");
+            return -1;
+        }
+        if ((size_t)len < count) {
+            JS_ThrowRangeError(ctx, "batch column is too short");
+            return -1;
+        }
+    }
+
+    JS_PUSH_VALUE(ctx, func);
+    JS_PUSH_VALUE(ctx, this_val);
+    for(j = 0; j < column_count; j++) {
+        JS_PushGCRef(ctx, &array_refs[j]);
+        array_refs[j].val = columns[j].array;
+    }
+
+    for(i = 0; i < count; i++) {
+        if (JS_StackCheck(ctx, column_count + 2))
+            goto done;
+        /* arguments are pushed in reverse order */
+        for(j = column_count - 1; j >= 0; j--) {
+            arg = mqjs_batch_arg(ctx, &columns[j], array_refs[j].val, i);
+            if (JS_IsException(arg)) {
+                JS_DropArgs(ctx, column_count - 1 - j);
+                goto done;
+            }
+            JS_PushArg(ctx, arg);
+        }
+        JS_PushArg(ctx, func_ref.val);
+        JS_PushArg(ctx, this_val_ref.val);
+        res = JS_Call(ctx, column_count);
+        if (JS_IsException(res))
+            goto done;
+        if (result_type == MQJS_BATCH_INT32) {
+            if (JS_ToInt32(ctx, &((int32_t *)results)[i], res))
+                goto done;
+        } else {
+            if (JS_ToNumber(ctx, &((double *)results)[i], res))
+                goto done;
+        }
+    }
+    ret = 0;
+ done:
+    *pdone = i;
+    for(j = column_count - 1; j >= 0; j--)
+        JS_PopGCRef(ctx, &array_refs[j]);
+    JS_POP_VALUE(ctx, this_val);
+    JS_POP_VALUE(ctx, func);
+    return ret;
+}
+
+/* ============================================================================
+ * JSON
+ * ============================================================================ */
+
+/* Parse len bytes of UTF-8 JSON text. The parser reads the bytes in place, so
+   they need not be NUL-terminated and are not copied. */
+JSValue mqjs_json_parse_utf8(JSContext *ctx, const char *buf, size_t len) {
+    return JS_Parse(ctx, buf, len, "<input>", JS_EVAL_JSON);
+}
+
+/* ============================================================================
+ * Binary Data Support
+ * ============================================================================ */
+
+/* Create an ArrayBuffer holding a copy of len bytes from buf */
+JSValue mqjs_new_array_buffer_copy(JSContext *ctx, const void *buf, size_t len) {
+    return JS_NewArrayBufferCopy(ctx, buf, len);
+}
+
+/* Create a typed array of the given class viewing the whole ArrayBuffer */
+JSValue mqjs_new_typed_array(JSContext *ctx, int class_id, JSValue buffer) {
+    JSValue argv[3];
+
+    if (class_id < JS_CLASS_UINT8C_ARRAY || class_id > JS_CLASS_FLOAT64_ARRAY) {
+        return JS_ThrowTypeError(ctx, "invalid typed array class");
+    }
+
+    argv[0] = buffer;
+    argv[1] = JS_NewInt32(ctx, 0);
+    argv[2] = JS_UNDEFINED;
+    return js_typed_array_constructor(ctx, NULL, 3 | FRAME_CF_CTOR, argv, class_id);
+}
+
+/*
+ * Get the bytes of an ArrayBuffer or typed array without copying.
+ *
+ * Returns NULL if the value is neither. The pointer points into the GC heap
+ * and is only valid until the next allocation in the context.
+ */
+uint8_t *mqjs_get_array_buffer_ptr(JSContext *ctx, JSValue val, size_t *plen) {
+    *plen = 0;
+    return JS_GetArrayBuffer(ctx, plen, val);
+}
+
+/* ============================================================================
+ * Memory statistics
+ * ============================================================================ */
+
+/* Fill st with the heap usage and GC counters (cheap unless count_blocks
+   is set, which walks the heap for the per tag block counts) */
+void mqjs_get_memory_stats(JSContext *ctx, JSMemoryStats *st, int count_blocks) {
+    JS_GetMemoryStats(ctx, st, count_blocks != 0);
+}
+
+/* ============================================================================
+ * Shared bytecode images
+ * ============================================================================ */
+
+/*
+ * Relocating a bytecode image only depends on its address and on the stdlib
+ * atoms, which are static and the same in every context. So an image relocated
+ * once can be loaded in place by any number of contexts. The image is made
+ * read-only after relocation: the interpreter treats it as ROM and never writes
+ * to it, so its pages are shared by all the contexts (and threads) using it.
+ */
+
+#ifndef _WIN32
+static uint8_t *mqjs_relocate_mapping(JSContext *ctx, uint8_t *image, size_t size) {
+    if (!JS_IsBytecode(image, size) ||
+        JS_RelocateBytecode(ctx, image, (uint32_t)size) != 0 ||
+        mprotect(image, size, PROT_READ) != 0) {
+        munmap(image, size);
+        return NULL;
+    }
+    return image;
+}
+#endif
+
+/* Map the bytecode file and relocate it. The relocated pages become private
+   copies; the other pages (strings, bytecode instructions) stay shared with
+   the page cache. */
+uint8_t *mqjs_map_bytecode_file(JSContext *ctx, const char *filename, size_t *psize) {
+#ifndef _WIN32
+    struct stat st;
+    uint8_t *image;
+    int fd;
+
+    *psize = 0;
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > UINT32_MAX) {
+        close(fd);
+        return NULL;
+    }
+    image = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+        return NULL;
+    image = mqjs_relocate_mapping(ctx, image, st.st_size);
+    if (image)
+        *psize = st.st_size;
+    return image;
+#else
+    *psize = 0;
+    return NULL;
+#endif
+}
+
+/* Copy the bytecode into a new mapping and relocate it */
+uint8_t *mqjs_map_bytecode(JSContext *ctx, const uint8_t *buf, size_t size) {
+#ifndef _WIN32
+    uint8_t *image;
+
+    if (size == 0 || (uint64_t)size > UINT32_MAX)
+        return NULL;
+    image = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (image == MAP_FAILED)
+        return NULL;
+    memcpy(image, buf, size);
+    return mqjs_relocate_mapping(ctx, image, size);
+#else
+    return NULL;
+#endif
+}
+
+/* Release an image returned by mqjs_map_bytecode_file() or mqjs_map_bytecode() */
+void mqjs_unmap_bytecode(uint8_t *image, size_t size) {
+#ifndef _WIN32
+    if (image)
+        munmap(image, size);
+#endif
+}
+
+/* Map the first size bytes of a bytecode cache entry, after checking that the
+   entry ends with the expected tag. The tag is read from the same file
+   descriptor as the mapping, so it describes the mapped image. */
+uint8_t *mqjs_map_bytecode_cache_file(JSContext *ctx, const char *filename,
+                                      const uint8_t *tag, size_t tag_len,
+                                      size_t *psize) {
+#ifndef _WIN32
+    struct stat st;
+    uint8_t stored[MQJS_BYTECODE_TAG_MAX];
+    uint8_t *image;
+    size_t size;
+    int fd;
+
+    *psize = 0;
+    if (tag_len == 0 || tag_len > sizeof(stored))
+        return NULL;
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= (off_t)tag_len ||
+        (uint64_t)st.st_size > UINT32_MAX ||
+        pread(fd, stored, tag_len, st.st_size - tag_len) != (ssize_t)tag_len ||
+        memcmp(stored, tag, tag_len) != 0) {
+        close(fd);
+        return NULL;
+    }
+    size = st.st_size - tag_len;
+    image = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+        return NULL;
+    image = mqjs_relocate_mapping(ctx, image, size);
+    if (image)
+        *psize = size;
+    return image;
+#else
+    *psize = 0;
+    return NULL;
+#endif
+}
+
+/* ============================================================================
+ * SHA-256 (FIPS 180-4), used to key bytecode cache entries
+ * ============================================================================ */
+
+static const uint32_t mqjs_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define MQJS_ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void mqjs_sha256_block(MQJSSHA256 *s, const uint8_t *p) {
+    uint32_t w[64], a, b, c, d, e, f, g, h, t1, t2;
+    int i;
+
+    for (i = 0; i < 16; i++)
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) |
+               ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+    for (i = 16; i < 64; i++) {
+        uint32_t s0 = MQJS_ROTR32(w[i - 15], 7) ^ MQJS_ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = MQJS_ROTR32(w[i - 2], 17) ^ MQJS_ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    a = s->state[0]; b = s->state[1]; c = s->state[2]; d = s->state[3];
+    e = s->state[4]; f = s->state[5]; g = s->state[6]; h = s->state[7];
+    for (i = 0; i < 64; i++) {
+        t1 = h + (MQJS_ROTR32(e, 6) ^ MQJS_ROTR32(e, 11) ^ MQJS_ROTR32(e, 25)) +
+            ((e & f) ^ (~e & g)) + mqjs_sha256_k[i] + w[i];
+        t2 = (MQJS_ROTR32(a, 2) ^ MQJS_ROTR32(a, 13) ^ MQJS_ROTR32(a, 22)) +
+            ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    s->state[0] += a; s->state[1] += b; s->state[2] += c; s->state[3] += d;
+    s->state[4] += e; s->state[5] += f; s->state[6] += g; s->state[7] += h;
+}
+
+void mqjs_sha256_init(MQJSSHA256 *s) {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(s->state, init, sizeof(init));
+    s->length = 0;
+}
+
+void mqjs_sha256_update(MQJSSHA256 *s, const void *data, size_t len) {
+    const uint8_t *p = data;
+    size_t used = s->length % 64, n;
+
+    s->length += len;
+    if (used != 0) {
+        n = len < 64 - used ? len : 64 - used;
+        memcpy(s->buffer + used, p, n);
+        p += n;
+        len -= n;
+        if (used + n < 64)
+            return;
+        mqjs_sha256_block(s, s->buffer);
+    }
+    for (; len >= 64; p += 64, len -= 64)
+        mqjs_sha256_block(s, p);
+    memcpy(s->buffer, p, len);
+}
+
+void mqjs_sha256_final(MQJSSHA256 *s, uint8_t digest[32]) {
+    uint64_t bits = s->length * 8;
+    uint8_t pad[72];
+    size_t used = s->length % 64, pad_len;
+    int i;
+
+    pad_len = (used < 56 ? 56 : 120) - used;
+    memset(pad, 0, sizeof(pad));
+    pad[0] = 0x80;
+    for (i = 0; i < 8; i++)
+        pad[pad_len + i] = (uint8_t)(bits >> (56 - 8 * i));
+    mqjs_sha256_update(s, pad, pad_len + 8);
+    for (i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(s->state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(s->state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(s->state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)s->state[i];
+    }
+}
+
+/* Digest of what bytecode images depend on besides the script: the engine
+   version, the word size and the stdlib ROM table (atom offsets, object
+   layouts, C function indexes). Pointers into the table are hashed as
+   offsets so the digest does not depend on where the table is loaded. */
+void mqjs_get_build_id(uint8_t digest[32]) {
+    const JSSTDLibraryDef *def = mqjs_get_stdlib();
+    uintptr_t base = (uintptr_t)def->stdlib_table;
+    uintptr_t end = base + def->stdlib_table_len * sizeof(JSWord);
+    uint32_t header[5];
+    MQJSSHA256 s;
+    uint32_t i;
+
+    mqjs_sha256_init(&s);
+    mqjs_sha256_update(&s, CONFIG_VERSION, strlen(CONFIG_VERSION));
+    header[0] = JS_BYTECODE_MAGIC;
+    header[1] = sizeof(JSWord);
+    header[2] = def->sorted_atoms_offset;
+    header[3] = def->global_object_offset;
+    header[4] = def->class_count;
+    mqjs_sha256_update(&s, header, sizeof(header));
+    for (i = 0; i < def->stdlib_table_len; i++) {
+        JSWord w = def->stdlib_table[i];
+        if ((uintptr_t)w >= base && (uintptr_t)w <= end)
+            w = (JSWord)((uintptr_t)w - base) | ((JSWord)1 << (JSW * 8 - 1));
+        mqjs_sha256_update(&s, &w, sizeof(w));
+    }
+    mqjs_sha256_final(&s, digest);
+}
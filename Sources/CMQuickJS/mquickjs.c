@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <math.h>
 #include <setjmp.h>
+#include <time.h>
 
 #include "cutils.h"
 #include "dtoa.h"
@@ -182,10 +183,18 @@ typedef struct JSROMClass {
 #define N_ROM_ATOM_TABLES_MAX 2
 
 /* must be large enough to have a negligible runtime cost and small
-   enough to call the interrupt callback often. */
+   enough to call the interrupt callback often. Can be changed per
+   context with JS_SetInterruptInterval(). */
 #define JS_INTERRUPT_COUNTER_INIT 10000
+#define JS_INTERRUPT_COUNTER_MAX  0x7fff
 
 #define JS_STRING_POS_CACHE_SIZE 2
+/* number of regexps compiled by the RegExp constructor which are kept
+   for reuse */
+#define JS_REGEXP_CACHE_SIZE 8
+/* minimum string length for which 'local += str' keeps a string
+   builder (see OP_append) */
+#define JS_STRING_BUILDER_MIN_LEN 256
 #define JS_STRING_POS_CACHE_MIN_LEN 16 
 
 typedef enum {
@@ -200,6 +209,35 @@ typedef struct {
     uint32_t str_pos[2]; /* 0 = UTF-8 pos (in bytes), 1 = UTF-16 pos */
 } JSStringPosCacheEntry;
 
+#ifdef CONFIG_INLINE_CACHE
+/* number of inline cache entries for OP_get_field/OP_put_field. Must
+   be a power of two. */
+#define JS_INLINE_CACHE_SIZE 64
+
+/* Monomorphic cache of an own property lookup, indexed by the address
+   of the instruction. The entries are only hints: a hit is validated
+   against the property array of the object, so they hold no GC
+   reference. */
+typedef struct {
+    const uint8_t *pc; /* instruction address, NULL if unused */
+    JSValue props; /* identity of the property array */
+    JSValue hash_mask; /* hash mask of the property array */
+    uint32_t prop_idx; /* JSProperty offset in the property array, in JSValue */
+    uint32_t epoch; /* value of ctx->ic_epoch when filled */
+} JSInlineCacheEntry;
+#endif
+
+typedef struct {
+    uint32_t gc_count;
+    uint32_t compact_count;
+    uint64_t gc_time_ns; /* cumulative time spent in the GC */
+    uint32_t last_moved_size; /* bytes moved by the last compaction */
+    uint32_t high_water; /* max heap + stack usage seen at GC time */
+    uint32_t live_size; /* used heap size after the last GC */
+    uint32_t oom_count; /* number of out of memory errors */
+    uint64_t float64_count; /* float64 blocks allocated since creation, never decremented */
+} JSGCStats;
+
 struct JSContext {
     /* memory map:
        Stack
@@ -215,11 +253,23 @@ struct JSContext {
     JSValue *fp; /* current frame pointer, stack_top if none */
     uint32_t min_free_size; /* min free size between heap_free and the
                                bottom of the stack */
+    uint8_t *gc_free_list; /* free blocks reusable by js_malloc(), in
+                              address order */
+    uint32_t gc_free_size; /* total size in bytes of the free blocks
+                              below heap_free */
+    uint32_t gc_alloc_budget; /* if != 0, run the GC after this number
+                                 of bytes have been allocated */
+    uint32_t gc_alloc_size; /* bytes allocated since the last GC */
+    uint8_t gc_compact_threshold; /* fragmentation in percent above
+                                     which the automatic GC compacts the
+                                     heap. 0 = always compact */
+    JSGCStats gc_stats; /* see JS_GetMemoryStats() */
     BOOL in_out_of_memory : 8; /* != 0 if generating the out of memory object */
     uint8_t n_rom_atom_tables;
     uint8_t string_pos_cache_counter; /* used for string_pos_cache[] update */
     uint16_t class_count; /* number of classes including user classes */
     int16_t interrupt_counter;
+    int16_t interrupt_interval; /* reset value of interrupt_counter */
     BOOL current_exception_is_uncatchable : 8;
     struct JSParseState *parse_state; /* != NULL during JS_Eval() */
     int unique_strings_len;
@@ -235,11 +285,32 @@ struct JSContext {
     JSInterruptHandler *interrupt_handler;
     JSWriteFunc *write_func; /* for the various dump functions */
     void *opaque;
+#ifdef CONFIG_PROFILER
+    JSProfileHandler *prof_handler; /* != NULL if sampling is enabled */
+    uint64_t *prof_opcode_counts; /* != NULL if counting the executed opcodes */
+    int16_t prof_interval; /* sampling interval in interrupt counter ticks */
+    int prof_ticks; /* ticks since the interrupt handler was called */
+#endif
     JSValue *class_obj; /* same as class_proto + class_count */
     JSStringPosCacheEntry string_pos_cache[JS_STRING_POS_CACHE_SIZE];
+    /* weak reference to the JSByteArray of the string being built by
+       'local += str' or JS_NULL (see OP_append) */
+    JSValue string_builder;
+    uint32_t string_builder_len;
+    BOOL string_builder_is_ascii;
+#ifdef CONFIG_INLINE_CACHE
+    /* incremented when property arrays are rehashed, compacted or moved */
+    uint32_t ic_epoch;
+    JSInlineCacheEntry ic[JS_INLINE_CACHE_SIZE];
+#endif
                                            
     /* must only contain JSValue from this point (see JS_GC()) */
-    JSValue unique_strings; /* JSValueArray of sorted strings or JS_NULL */
+    JSValue unique_strings; /* JSValueArray of strings in insertion
+                               order (sorted by JS_PrepareBytecode())
+                               or JS_NULL */
+    JSValue unique_strings_hash; /* JSByteArray indexing unique_strings
+                                    or JS_NULL, must come after
+                                    unique_strings */
     
     JSValue current_exception; /* currently pending exception, must
                                   come after unique_strings */
@@ -249,6 +320,12 @@ struct JSContext {
     JSValue empty_props; /* empty prop list, for objects with no properties */
     JSValue global_obj;
     JSValue minus_zero; /* minus zero float64 value */
+    JSValue nan; /* NaN float64 value */
+    JSValue infinity; /* +Infinity float64 value */
+    JSValue minus_infinity; /* -Infinity float64 value */
+    JSValue regexp_cache; /* JSValueArray of JS_REGEXP_CACHE_SIZE (source,
+                             byte code) pairs, most recent first, or
+                             JS_NULL */
     JSValue class_proto[]; /* prototype for each class (class_count
                               element, then class_count elements for
                               class_obj */
@@ -364,19 +441,27 @@ typedef struct JSFunctionBytecode {
 } JSFunctionBytecode;
 
 static JSValue js_resize_value_array(JSContext *ctx, JSValue val, int new_size);
+static JSValueArray *js_alloc_value_array(JSContext *ctx, int init_base, int new_size);
 static int get_mblock_size(const void *ptr);
+static void set_free_block(void *ptr, uint32_t size);
 static JSValue JS_NewObjectProtoClass(JSContext *ctx, JSValue proto, int class_id, int extra_size);
 static void js_shrink_byte_array(JSContext *ctx, JSValue *pval, int new_size);
 static void build_backtrace(JSContext *ctx, JSValue error_obj,
                             const char *filename, int line_num, int col_num, int skip_level);
 static JSValue JS_ToPropertyKey(JSContext *ctx, JSValue val);
+static JSValue js_json_parse_source(JSContext *ctx, JSValue source_str,
+                                    const uint8_t *input, size_t input_len,
+                                    const char *filename);
 static JSByteArray *js_alloc_byte_array(JSContext *ctx, int size);
 static JSValue js_new_c_function_proto(JSContext *ctx, int func_idx, JSValue proto, BOOL has_params,
                                        JSValue params);
-static int JS_ToUint8Clamp(JSContext *ctx, int *pres, JSValue val);
 static JSValue js_set_prototype_internal(JSContext *ctx, JSValue obj, JSValue proto);
 static JSValue js_resize_byte_array(JSContext *ctx, JSValue val, int new_size);
 static JSValueArray *js_alloc_props(JSContext *ctx, int n);
+static void rqsort_idx(size_t nmemb,
+                       int (*cmp)(size_t, size_t, void *),
+                       void (*swap)(size_t, size_t, void *),
+                       void *opaque);
 
 typedef enum OPCodeFormat {
 #define FMT(f) OP_FMT_ ## f,
@@ -495,7 +580,71 @@ static int js_get_mtag(void *ptr)
     return ((JSMemBlockHeader *)ptr)->mtag;
 }
 
-static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
+typedef enum {
+    JS_GC_COMPACT_NEVER,
+    JS_GC_COMPACT_AUTO, /* only if the fragmentation is above gc_compact_threshold */
+    JS_GC_COMPACT_ALWAYS,
+} JSGCCompactEnum;
+
+static void JS_GC2(JSContext *ctx, BOOL keep_atoms, JSGCCompactEnum compact);
+static void gc_compact(JSContext *ctx);
+
+/* free blocks of at least this size are put in the free list */
+#define JS_FREE_LIST_MIN_SIZE (4 * JSW)
+/* maximum number of free list blocks examined by an allocation */
+#define JS_FREE_LIST_MAX_PROBES 8
+
+/* pointer to the next block of the free list, stored after the header */
+#define FREE_BLOCK_NEXT(ptr) (*(uint8_t **)((uint8_t *)(ptr) + sizeof(JSFreeBlock)))
+
+static inline BOOL has_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
+{
+    return ((uint8_t *)stack_bottom - ctx->heap_free) >= size + ctx->min_free_size;
+}
+
+/* allocate 'size' bytes (multiple of JSW) from the free list. Return
+   NULL if no suitable block is found. */
+static void *js_malloc_free_list(JSContext *ctx, uint32_t size)
+{
+    uint8_t **pnext, *ptr, *rem_ptr, *next;
+    uint32_t block_size, rem_size;
+    int n;
+    
+    pnext = &ctx->gc_free_list;
+    for(n = 0; n < JS_FREE_LIST_MAX_PROBES; n++) {
+        ptr = *pnext;
+        if (!ptr)
+            break;
+        block_size = get_mblock_size(ptr);
+        if (block_size >= size) {
+            next = FREE_BLOCK_NEXT(ptr);
+            rem_size = block_size - size;
+            if (rem_size >= JS_FREE_LIST_MIN_SIZE) {
+                /* the end of the block stays in the free list */
+                rem_ptr = ptr + size;
+                set_free_block(rem_ptr, rem_size);
+                FREE_BLOCK_NEXT(rem_ptr) = next;
+                *pnext = rem_ptr;
+            } else {
+                if (rem_size != 0)
+                    set_free_block(ptr + size, rem_size);
+                *pnext = next;
+            }
+            ctx->gc_free_size -= size;
+            return ptr;
+        }
+        pnext = &FREE_BLOCK_NEXT(ptr);
+    }
+    return NULL;
+}
+
+/* Ensure that 'size' bytes are available between heap_free and
+   'stack_bottom', running the GC if needed. If 'pfree' is not NULL,
+   the allocation can also be done in the free list after a
+   collection: '*pfree' is then set to the allocated block. Return -1
+   if not enough memory. */
+static int check_free_mem2(JSContext *ctx, JSValue *stack_bottom, uint32_t size,
+                           void **pfree)
 {
 #ifdef DEBUG_GC
     assert(ctx->sp >= stack_bottom);
@@ -504,9 +653,17 @@ static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
         JS_GC(ctx);
     }
 #endif
-    if (((uint8_t *)stack_bottom - ctx->heap_free) < size + ctx->min_free_size) {
-        JS_GC(ctx);
-        if (((uint8_t *)stack_bottom - ctx->heap_free) < size + ctx->min_free_size) {
+    if (!has_free_mem(ctx, stack_bottom, size)) {
+        JS_GC2(ctx, TRUE, JS_GC_COMPACT_AUTO);
+        if (pfree && ctx->gc_free_list) {
+            *pfree = js_malloc_free_list(ctx, size);
+            if (*pfree)
+                return 0;
+        }
+        /* the free blocks are not usable: compact them */
+        if (!has_free_mem(ctx, stack_bottom, size) && ctx->gc_free_size != 0)
+            gc_compact(ctx);
+        if (!has_free_mem(ctx, stack_bottom, size)) {
             JS_ThrowOutOfMemory(ctx);
             return -1;
         }
@@ -514,6 +671,11 @@ static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
     return 0;
 }
 
+static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
+{
+    return check_free_mem2(ctx, stack_bottom, size, NULL);
+}
+
 /* check that 'len' values can be pushed on the stack. Return 0 if OK,
    -1 if not enough space. May trigger a GC(). */
 int JS_StackCheck(JSContext *ctx, uint32_t len)
@@ -536,11 +698,23 @@ static void *js_malloc(JSContext *ctx, uint32_t size, int mtag)
         return NULL;
     size = (size + JSW - 1) & ~(JSW - 1);
 
-    if (check_free_mem(ctx, ctx->stack_bottom, size))
-        return NULL;
-    
-    p = (JSMemBlockHeader *)ctx->heap_free;
-    ctx->heap_free += size;
+    if (unlikely(ctx->gc_alloc_budget != 0)) {
+        ctx->gc_alloc_size += size;
+        if (ctx->gc_alloc_size >= ctx->gc_alloc_budget)
+            JS_GC2(ctx, TRUE, JS_GC_COMPACT_AUTO);
+    }
+
+    p = NULL;
+    if (unlikely(ctx->gc_free_list != NULL))
+        p = js_malloc_free_list(ctx, size);
+    if (!p) {
+        if (check_free_mem2(ctx, ctx->stack_bottom, size, (void **)&p))
+            return NULL;
+        if (!p) {
+            p = (JSMemBlockHeader *)ctx->heap_free;
+            ctx->heap_free += size;
+        }
+    }
 
     p->mtag = mtag;
     p->gc_mark = 0;
@@ -601,6 +775,7 @@ static void *js_shrink(JSContext *ctx, void *ptr, uint32_t new_size)
     if (diff == 0)
         return ptr;
     set_free_block((uint8_t *)ptr + new_size, diff);
+    ctx->gc_free_size += diff;
     /* add a new free block after 'ptr' */
     return ptr;
 }
@@ -940,6 +1115,7 @@ JSValue JS_ThrowOutOfMemory(JSContext *ctx)
     if (ctx->in_out_of_memory)
         return JS_Throw(ctx, JS_NULL);
     ctx->in_out_of_memory = TRUE;
+    ctx->gc_stats.oom_count++;
     ctx->min_free_size = JS_MIN_CRITICAL_FREE_SIZE;
     val = JS_ThrowInternalError(ctx, "out of memory");
     ctx->in_out_of_memory = FALSE;
@@ -980,6 +1156,7 @@ static JSValue js_alloc_float64(JSContext *ctx, double d)
     if (!f)
         return JS_EXCEPTION;
     f->u.dval = d;
+    ctx->gc_stats.float64_count++;
     return JS_VALUE_FROM_PTR(f);
 }
 
@@ -997,7 +1174,13 @@ static JSValue __JS_NewFloat64(JSContext *ctx, double d)
         return js_to_short_float(d);
     } else
 #endif
-    {
+    if (isnan(d)) {
+        /* NaN is propagated by most operations, so it must not
+           allocate at each step. Its bit pattern is not visible. */
+        return ctx->nan;
+    } else if (isinf(d)) {
+        return d > 0 ? ctx->infinity : ctx->minus_infinity;
+    } else {
         return js_alloc_float64(ctx, d);
     }
 }
@@ -1189,6 +1372,45 @@ static force_inline BOOL JS_IsIntOrShortFloat(JSValue val)
 #endif
 }
 
+/* return TRUE and its value in '*pd' if 'val' is a number (short
+   integer, short float or float64 block) */
+static force_inline BOOL js_get_number_fast(double *pd, JSValue val)
+{
+    if (JS_IsInt(val)) {
+        *pd = JS_VALUE_GET_INT(val);
+        return TRUE;
+    }
+#ifdef JS_USE_SHORT_FLOAT
+    if (JS_IsShortFloat(val)) {
+        *pd = js_get_short_float(val);
+        return TRUE;
+    }
+#endif
+    if (JS_IsPtr(val)) {
+        JSFloat64 *p = JS_VALUE_TO_PTR(val);
+        if (p->mtag == JS_MTAG_FLOAT64) {
+            *pd = p->u.dval;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* used by the interpreter when the operands are not both short
+   integers: return TRUE if they are both numbers */
+static force_inline BOOL js_get_float64_operands(double *pd1, double *pd2,
+                                                 JSValue op1, JSValue op2)
+{
+#ifdef JS_USE_SHORT_FLOAT
+    if (likely(JS_VALUE_IS_BOTH_SHORT_FLOAT(op1, op2))) {
+        *pd1 = js_get_short_float(op1);
+        *pd2 = js_get_short_float(op2);
+        return TRUE;
+    }
+#endif
+    return js_get_number_fast(pd1, op1) && js_get_number_fast(pd2, op2);
+}
+
 BOOL JS_IsNumber(JSContext *ctx, JSValue val)
 {
     if (JS_IsIntOrShortFloat(val)) {
@@ -1257,12 +1479,7 @@ static force_inline int utf8_char_len(int c)
 
 static BOOL is_ascii_string(const char *buf, size_t len)
 {
-    size_t i;
-    for(i = 0; i < len; i++) {
-        if ((uint8_t)buf[i] > 0x7f)
-            return FALSE;
-    }
-    return TRUE;
+    return ascii_check((const uint8_t *)buf, len);
 }
 
 static JSString *get_string_ptr(JSContext *ctx, JSStringCharBuf *buf,
@@ -1784,6 +2001,68 @@ static JSValue JS_ConcatString(JSContext *ctx, JSValue val1, JSValue val2)
     return string_buffer_end(ctx, b);
 }
 
+/* String builder: 'local += str' appends in place to a JSByteArray
+   with spare capacity which is kept in the local variable until the
+   variable is read. Reading it with OP_get_loc or OP_get_var_ref
+   converts the buffer to a string in place, so the byte array is never
+   visible to the rest of the engine. At most one builder is active by
+   context. */
+
+/* convert the active string builder to a string. No memory
+   allocation. */
+static no_inline void js_string_builder_end(JSContext *ctx)
+{
+    JSByteArray *arr = JS_VALUE_TO_PTR(ctx->string_builder);
+    int len = ctx->string_builder_len;
+
+    arr->buf[len] = '\0';
+    /* len >= JS_STRING_BUILDER_MIN_LEN so the conversion is done in place */
+    js_byte_array_to_string(ctx, ctx->string_builder, len,
+                            ctx->string_builder_is_ascii);
+    ctx->string_builder = JS_NULL;
+}
+
+/* '*pval += str' where '*pval' is the string builder and 'str' is a
+   string (both are GC roots). Return the new builder (its value may
+   change) or JS_EXCEPTION. */
+static JSValue js_string_builder_append(JSContext *ctx, JSValue *pval, JSValue *pstr)
+{
+    StringBuffer b_s, *b = &b_s;
+
+    b->buffer = *pval;
+    b->len = ctx->string_builder_len;
+    b->is_ascii = ctx->string_builder_is_ascii;
+    if (string_buffer_concat_str(ctx, b, *pstr))
+        return JS_EXCEPTION; /* the builder is left unmodified */
+    ctx->string_builder = b->buffer;
+    ctx->string_builder_len = b->len;
+    ctx->string_builder_is_ascii = b->is_ascii;
+    return b->buffer;
+}
+
+/* start a new string builder containing '*pval' and '*pstr' which are
+   strings. Return the builder or JS_EXCEPTION. */
+static JSValue js_string_builder_new(JSContext *ctx, JSValue *pval, JSValue *pstr,
+                                     uint32_t len)
+{
+    StringBuffer b_s, *b = &b_s;
+
+    if (ctx->string_builder != JS_NULL)
+        js_string_builder_end(ctx);
+    if (len > JS_STRING_LEN_MAX)
+        return JS_ThrowInternalError(ctx, "string too long");
+    /* leave room for as many bytes as the current length */
+    if (string_buffer_init(ctx, b, len + min_int(len, JS_STRING_LEN_MAX - len) + 1))
+        return JS_EXCEPTION;
+    /* no memory allocation */
+    string_buffer_concat_str(ctx, b, *pval);
+    string_buffer_concat_str(ctx, b, *pstr);
+    ctx->string_builder = b->buffer;
+    ctx->string_builder_len = b->len;
+    ctx->string_builder_is_ascii = b->is_ascii;
+    return b->buffer;
+}
+
 static BOOL js_string_eq(JSContext *ctx, JSValue val1, JSValue val2)
 {
     JSStringCharBuf buf1, buf2;
@@ -1993,15 +2272,155 @@ static JSValue find_atom(JSContext *ctx, int *pidx, const JSValueArray *arr, int
     return JS_NULL;
 }
 
+/* The RAM unique strings are indexed by an open addressing hash table
+   of uint32_t entries (index + 1 in unique_strings, 0 if free) whose
+   size is a power of two. The entries are indexes, so compaction keeps
+   the table valid. It is rebuilt when the GC removes dead strings. */
+#define JS_UNIQUE_STRINGS_HASH_MIN_SIZE 16
+
+static uint32_t hash_string_bytes(const uint8_t *buf, int len)
+{
+    uint32_t h;
+    int i;
+    /* FNV-1a */
+    h = 2166136261;
+    for(i = 0; i < len; i++)
+        h = (h ^ buf[i]) * 16777619;
+    return h;
+}
+
+/* return the entry of the string in the hash table, or the free entry
+   where it should be inserted */
+static uint32_t *unique_strings_hash_find(JSContext *ctx, const uint8_t *buf,
+                                          int len, uint32_t h)
+{
+    JSByteArray *harr = JS_VALUE_TO_PTR(ctx->unique_strings_hash);
+    uint32_t *tab = (uint32_t *)harr->buf;
+    uint32_t mask, idx;
+    JSValueArray *arr;
+    JSString *p;
+
+    mask = harr->size / sizeof(uint32_t) - 1;
+    for(;;) {
+        idx = tab[h & mask];
+        if (idx == 0)
+            break;
+        arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+        p = JS_VALUE_TO_PTR(arr->arr[idx - 1]);
+        if (p->len == len && !memcmp(p->buf, buf, len))
+            break;
+        h++;
+    }
+    return &tab[h & mask];
+}
+
+/* fill the hash table from unique_strings. No memory allocation. */
+static void unique_strings_hash_rebuild(JSContext *ctx)
+{
+    JSByteArray *harr = JS_VALUE_TO_PTR(ctx->unique_strings_hash);
+    JSValueArray *arr;
+    JSString *p;
+    int i;
+
+    memset(harr->buf, 0, harr->size);
+    if (JS_IsNull(ctx->unique_strings))
+        return;
+    arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+    for(i = 0; i < ctx->unique_strings_len; i++) {
+        p = JS_VALUE_TO_PTR(arr->arr[i]);
+        *unique_strings_hash_find(ctx, p->buf, p->len,
+                                  hash_string_bytes(p->buf, p->len)) = i + 1;
+    }
+}
+
+/* ensure that the hash table can index 'len' strings with a load
+   factor <= 0.75 */
+static int unique_strings_hash_reserve(JSContext *ctx, int len)
+{
+    JSByteArray *harr;
+    int size;
+
+    if (!JS_IsNull(ctx->unique_strings_hash)) {
+        harr = JS_VALUE_TO_PTR(ctx->unique_strings_hash);
+        if (harr->size / sizeof(uint32_t) * 3 >= 4 * len)
+            return 0;
+    }
+    size = JS_UNIQUE_STRINGS_HASH_MIN_SIZE;
+    while (size * 3 < 4 * len)
+        size *= 2;
+    harr = js_alloc_byte_array(ctx, size * sizeof(uint32_t));
+    if (!harr)
+        return -1;
+    /* a GC may have run: index the current table */
+    ctx->unique_strings_hash = JS_VALUE_FROM_PTR(harr);
+    unique_strings_hash_rebuild(ctx);
+    return 0;
+}
+
+/* ensure that unique_strings has room for one more string */
+static int unique_strings_reserve(JSContext *ctx)
+{
+    JSValueArray *arr, *new_arr;
+    int size;
+
+    if (!JS_IsNull(ctx->unique_strings)) {
+        arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+        if (ctx->unique_strings_len < arr->size)
+            return 0;
+    }
+    size = max_int(JS_UNIQUE_STRINGS_HASH_MIN_SIZE,
+                   ctx->unique_strings_len + ctx->unique_strings_len / 2);
+    new_arr = js_alloc_value_array(ctx, 0, size);
+    if (!new_arr)
+        return -1;
+    /* the GC may have removed strings from the table (or freed it),
+       so copy it after the allocation */
+    if (!JS_IsNull(ctx->unique_strings)) {
+        arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+        memcpy(new_arr->arr, arr->arr, ctx->unique_strings_len * sizeof(JSValue));
+    }
+    ctx->unique_strings = JS_VALUE_FROM_PTR(new_arr);
+    return 0;
+}
+
+static int unique_strings_sort_cmp(size_t i1, size_t i2, void *opaque)
+{
+    JSContext *ctx = opaque;
+    JSValueArray *arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+    return js_string_compare(ctx, arr->arr[i1], arr->arr[i2]);
+}
+
+static void unique_strings_sort_swap(size_t i1, size_t i2, void *opaque)
+{
+    JSContext *ctx = opaque;
+    JSValueArray *arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+    JSValue tmp;
+    tmp = arr->arr[i1];
+    arr->arr[i1] = arr->arr[i2];
+    arr->arr[i2] = tmp;
+}
+
+/* sort the unique strings so that they can be used as a ROM atom
+   table (see find_atom()). No memory allocation. */
+static void unique_strings_sort(JSContext *ctx)
+{
+    if (JS_IsNull(ctx->unique_strings))
+        return;
+    rqsort_idx(ctx->unique_strings_len, unique_strings_sort_cmp,
+               unique_strings_sort_swap, ctx);
+    if (!JS_IsNull(ctx->unique_strings_hash))
+        unique_strings_hash_rebuild(ctx);
+}
+
 /* if 'val' is not a string, it is returned */
-/* XXX: use hash table */
 static JSValue JS_MakeUniqueString(JSContext *ctx, JSValue val)
 {
     JSString *p;
-    int a, is_numeric, i;
+    int a, is_numeric, i, ret;
     JSValueArray *arr;
     const JSValueArray *arr1;
-    JSValue val1, new_tab;
+    JSValue val1;
+    uint32_t h, *entry;
     JSGCRef val_ref;
     
     if (!JS_IsPtr(val))
@@ -2010,7 +2429,26 @@ static JSValue JS_MakeUniqueString(JSContext *ctx, JSValue val)
     if (p->mtag != JS_MTAG_STRING || p->is_unique)
         return val;
 
-    /* not unique: find it in the ROM or RAM sorted unique string table */
+    /* not unique: find it in the RAM unique string table */
+    h = hash_string_bytes(p->buf, p->len);
+    if (unlikely(JS_IsNull(ctx->unique_strings_hash)) &&
+        ctx->unique_strings_len != 0) {
+        JS_PUSH_VALUE(ctx, val);
+        ret = unique_strings_hash_reserve(ctx, ctx->unique_strings_len);
+        JS_POP_VALUE(ctx, val);
+        if (ret)
+            return JS_EXCEPTION;
+        p = JS_VALUE_TO_PTR(val);
+    }
+    if (!JS_IsNull(ctx->unique_strings_hash)) {
+        entry = unique_strings_hash_find(ctx, p->buf, p->len, h);
+        if (*entry != 0) {
+            arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+            return arr->arr[*entry - 1];
+        }
+    }
+
+    /* then in the ROM sorted unique string tables */
     for(i = 0; i < ctx->n_rom_atom_tables; i++) {
         arr1 = ctx->rom_atom_tables[i];
         if (arr1) {
@@ -2020,32 +2458,27 @@ static JSValue JS_MakeUniqueString(JSContext *ctx, JSValue val)
         }
     }
     
-    arr = JS_VALUE_TO_PTR( ctx->unique_strings);
-    val1 = find_atom(ctx, &a, arr, ctx->unique_strings_len, val); 
-    if (!JS_IsNull(val1))
-        return val1;
-    
     JS_PUSH_VALUE(ctx, val);
     is_numeric = js_is_numeric_string(ctx, val);
     JS_POP_VALUE(ctx, val);
     if (is_numeric < 0)
         return JS_EXCEPTION;
     
-    /* not found: add it in the table */
+    /* not found: add it in the table. The hash table is allocated
+       first because a GC rebuilds it but shrinks unique_strings */
     JS_PUSH_VALUE(ctx, val);
-    new_tab = js_resize_value_array(ctx, ctx->unique_strings,
-                                 ctx->unique_strings_len + 1);
+    ret = unique_strings_hash_reserve(ctx, ctx->unique_strings_len + 1);
+    if (!ret)
+        ret = unique_strings_reserve(ctx);
     JS_POP_VALUE(ctx, val);
-    if (JS_IsException(new_tab))
+    if (ret)
         return JS_EXCEPTION;
-    ctx->unique_strings = new_tab;
-    arr = JS_VALUE_TO_PTR( ctx->unique_strings);
-    memmove(&arr->arr[a + 1], &arr->arr[a],
-            sizeof(arr->arr[0]) * (ctx->unique_strings_len - a));
-    arr->arr[a] = val;
+    arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+    arr->arr[ctx->unique_strings_len] = val;
     p = JS_VALUE_TO_PTR(val);
     p->is_unique = TRUE;
     p->is_numeric = is_numeric;
+    *unique_strings_hash_find(ctx, p->buf, p->len, h) = ctx->unique_strings_len + 1;
     ctx->unique_strings_len++;
     return val;
 }
@@ -2124,6 +2557,48 @@ const char *JS_ToCString(JSContext *ctx, JSValue val, JSCStringBuf *buf)
     return JS_ToCStringLen(ctx, NULL, val, buf);
 }
 
+/* Same as JS_ToCStringLen() but also set '*pis_utf8' to FALSE if the
+   string contains unpaired surrogates, whose encoding is not valid
+   UTF-8. */
+const char *JS_ToUTF8StringLen(JSContext *ctx, size_t *plen, JS_BOOL *pis_utf8,
+                               JSValue val, JSCStringBuf *buf)
+{
+    const uint8_t *p, *p_end;
+    size_t len;
+    BOOL is_utf8;
+    
+    val = JS_ToString(ctx, val);
+    if (JS_IsException(val))
+        return NULL;
+    if (JS_VALUE_GET_SPECIAL_TAG(val) == JS_TAG_STRING_CHAR) {
+        int c = JS_VALUE_GET_SPECIAL_VALUE(val);
+        len = get_short_string(buf->buf, val);
+        p = buf->buf;
+        is_utf8 = (c < 0xd800 || c > 0xdfff);
+    } else {
+        JSString *r = JS_VALUE_TO_PTR(val);
+        p = r->buf;
+        len = r->len;
+        is_utf8 = TRUE;
+        if (!r->is_ascii) {
+            /* the surrogates are encoded as 0xed 0xa0-0xbf 0x80-0xbf */
+            const uint8_t *q = p;
+            p_end = p + len;
+            while ((q = memchr(q, 0xed, p_end - q)) != NULL) {
+                if (q[1] >= 0xa0) {
+                    is_utf8 = FALSE;
+                    break;
+                }
+                q++;
+            }
+        }
+    }
+    if (plen)
+        *plen = len;
+    *pis_utf8 = is_utf8;
+    return (const char *)p;
+}
+
 char *JS_GetErrorStr(JSContext *ctx, char *buf, size_t buf_size)
 {
     const char *str;
@@ -2138,6 +2613,16 @@ char *JS_GetErrorStr(JSContext *ctx, char *buf, size_t buf_size)
     JS_POP_VALUE(ctx, obj);
     if (!str)
         str = "";
+    /* a compilation context has no Error.prototype.toString: use the
+       bare message */
+    if (*str == '\0' && JS_IsError(ctx, obj)) {
+        p = JS_VALUE_TO_PTR(obj);
+        if (JS_IsString(ctx, p->u.error.message)) {
+            str = JS_ToCString(ctx, p->u.error.message, &str_buf);
+            if (!str)
+                str = "";
+        }
+    }
     pstrcpy(buf, buf_size, str);
     if (JS_IsError(ctx, obj)) {
         p = JS_VALUE_TO_PTR(obj);
@@ -2408,6 +2893,15 @@ JSValue JS_NewObjectClassUser(JSContext *ctx, int class_id)
     return JS_VALUE_FROM_PTR(p);
 }
 
+/* define the user class 'class_id' at run time: the objects created
+   with JS_NewObjectClassUser() inherit from 'proto'. */
+void JS_SetUserClass(JSContext *ctx, int class_id, JSValue ctor, JSValue proto)
+{
+    assert(class_id >= JS_CLASS_USER && class_id < ctx->class_count);
+    ctx->class_obj[class_id] = ctor;
+    ctx->class_proto[class_id] = proto;
+}
+
 JSValue JS_NewObject(JSContext *ctx)
 {
     return JS_NewObjectClass(ctx, JS_CLASS_OBJECT, 0);
@@ -2492,6 +2986,57 @@ static inline JSProperty *find_own_property(JSContext *ctx,
     return find_own_property_inlined(ctx, p, prop);
 }
 
+#ifdef CONFIG_INLINE_CACHE
+/* invalidate all the inline cache entries */
+static void ic_invalidate(JSContext *ctx)
+{
+    if (unlikely(++ctx->ic_epoch == 0)) {
+        memset(ctx->ic, 0, sizeof(ctx->ic));
+        ctx->ic_epoch = 1;
+    }
+}
+
+/* Return the own property 'prop' of 'p' if it is cached for the
+   instruction at 'pc', NULL otherwise. '*pce' is set to the entry to
+   update after a miss. */
+static force_inline JSProperty *ic_find_own_property(JSContext *ctx, const uint8_t *pc,
+                                                     JSObject *p, JSValue prop,
+                                                     JSInlineCacheEntry **pce)
+{
+    JSInlineCacheEntry *ce;
+    JSValueArray *arr;
+    JSProperty *pr;
+    uintptr_t h;
+
+    h = (uintptr_t)pc;
+    h ^= h >> 6;
+    ce = &ctx->ic[h & (JS_INLINE_CACHE_SIZE - 1)];
+    *pce = ce;
+    if (ce->pc == pc && ce->props == p->props && ce->epoch == ctx->ic_epoch) {
+        arr = JS_VALUE_TO_PTR(p->props);
+        /* the array may have been freed and reallocated at the same
+           address: check that 'prop_idx' is still a property slot */
+        if (arr->arr[1] == ce->hash_mask && ce->prop_idx < arr->size) {
+            pr = (JSProperty *)&arr->arr[ce->prop_idx];
+            if (pr->key == prop)
+                return pr;
+        }
+    }
+    return NULL;
+}
+
+static inline void ic_update(JSContext *ctx, JSInlineCacheEntry *ce, const uint8_t *pc,
+                             JSObject *p, JSProperty *pr)
+{
+    JSValueArray *arr = JS_VALUE_TO_PTR(p->props);
+    ce->pc = pc;
+    ce->props = p->props;
+    ce->hash_mask = arr->arr[1];
+    ce->prop_idx = (JSValue *)pr - arr->arr;
+    ce->epoch = ctx->ic_epoch;
+}
+#endif
+
 static JSValue get_special_prop(JSContext *ctx, JSValue val)
 {
     int idx;
@@ -2503,6 +3048,151 @@ static JSValue get_special_prop(JSContext *ctx, JSValue val)
         return ctx->class_obj[-idx - 1];
 }
 
+#define JS_TYPED_ARRAY_COUNT (JS_CLASS_FLOAT64_ARRAY - JS_CLASS_UINT8C_ARRAY + 1)
+
+static uint8_t typed_array_size_log2[JS_TYPED_ARRAY_COUNT] = {
+    0, 0, 0, 1, 1, 2, 2, 2, 3
+};
+
+/* ToInt32() of a float64 (modulo 2^32) */
+static inline int32_t js_double_to_int32(double d)
+{
+    uint64_t u, v;
+    int e;
+    int32_t ret;
+
+    u = float64_as_uint64(d);
+    e = (u >> 52) & 0x7ff;
+    if (likely(e <= (1023 + 30))) {
+        /* fast case */
+        ret = (int32_t)d;
+    } else if (e <= (1023 + 30 + 53)) {
+        /* remainder modulo 2^32 */
+        v = (u & (((uint64_t)1 << 52) - 1)) | ((uint64_t)1 << 52);
+        v = v << ((e - 1023) - 52 + 32);
+        ret = v >> 32;
+        /* take the sign into account */
+        if (u >> 63)
+            ret = -ret;
+    } else {
+        ret = 0; /* also handles NaN and +inf */
+    }
+    return ret;
+}
+
+static inline int js_double_to_uint8_clamp(double d)
+{
+    if (d < 0 || isnan(d))
+        return 0;
+    else if (d > 255)
+        return 255;
+    else
+        return js_lrint(d);
+}
+
+/* 'idx' must be lower than the typed array length. The result may be
+   an allocated float64. */
+static JSValue js_typed_array_get_value(JSContext *ctx, JSObject *p, uint32_t idx)
+{
+    JSObject *pbuffer;
+    JSByteArray *arr;
+
+    idx += p->u.typed_array.offset;
+    pbuffer = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
+    arr = JS_VALUE_TO_PTR(pbuffer->u.array_buffer.byte_buffer);
+    switch(p->class_id) {
+    default:
+    case JS_CLASS_UINT8C_ARRAY:
+    case JS_CLASS_UINT8_ARRAY:
+        return JS_NewShortInt(*((uint8_t *)arr->buf + idx));
+    case JS_CLASS_INT8_ARRAY:
+        return JS_NewShortInt(*((int8_t *)arr->buf + idx));
+    case JS_CLASS_INT16_ARRAY:
+        return JS_NewShortInt(*((int16_t *)arr->buf + idx));
+    case JS_CLASS_UINT16_ARRAY:
+        return JS_NewShortInt(*((uint16_t *)arr->buf + idx));
+    case JS_CLASS_INT32_ARRAY:
+        return JS_NewInt32(ctx, *((int32_t *)arr->buf + idx));
+    case JS_CLASS_UINT32_ARRAY:
+        return JS_NewUint32(ctx, *((uint32_t *)arr->buf + idx));
+    case JS_CLASS_FLOAT32_ARRAY:
+        return JS_NewFloat64(ctx, *((float *)arr->buf + idx));
+    case JS_CLASS_FLOAT64_ARRAY:
+        return JS_NewFloat64(ctx, *((double *)arr->buf + idx));
+    }
+}
+
+static inline double js_typed_array_get_double(int class_id, const uint8_t *ptr)
+{
+    switch(class_id) {
+    default:
+    case JS_CLASS_UINT8C_ARRAY:
+    case JS_CLASS_UINT8_ARRAY:
+        return *(uint8_t *)ptr;
+    case JS_CLASS_INT8_ARRAY:
+        return *(int8_t *)ptr;
+    case JS_CLASS_INT16_ARRAY:
+        return *(int16_t *)ptr;
+    case JS_CLASS_UINT16_ARRAY:
+        return *(uint16_t *)ptr;
+    case JS_CLASS_INT32_ARRAY:
+        return *(int32_t *)ptr;
+    case JS_CLASS_UINT32_ARRAY:
+        return *(uint32_t *)ptr;
+    case JS_CLASS_FLOAT32_ARRAY:
+        return *(float *)ptr;
+    case JS_CLASS_FLOAT64_ARRAY:
+        return *(double *)ptr;
+    }
+}
+
+/* store the number 'd' converted to the element type of 'class_id' */
+static inline void js_typed_array_store_double(int class_id, uint8_t *ptr, double d)
+{
+    switch(class_id) {
+    default:
+    case JS_CLASS_UINT8C_ARRAY:
+        *ptr = js_double_to_uint8_clamp(d);
+        break;
+    case JS_CLASS_INT8_ARRAY:
+    case JS_CLASS_UINT8_ARRAY:
+        *ptr = js_double_to_int32(d);
+        break;
+    case JS_CLASS_INT16_ARRAY:
+    case JS_CLASS_UINT16_ARRAY:
+        *(uint16_t *)ptr = js_double_to_int32(d);
+        break;
+    case JS_CLASS_INT32_ARRAY:
+    case JS_CLASS_UINT32_ARRAY:
+        *(uint32_t *)ptr = js_double_to_int32(d);
+        break;
+    case JS_CLASS_FLOAT32_ARRAY:
+        *(float *)ptr = d;
+        break;
+    case JS_CLASS_FLOAT64_ARRAY:
+        *(double *)ptr = d;
+        break;
+    }
+}
+
+/* pointer to the first element of a typed array. It is only valid
+   until the next memory allocation. */
+static uint8_t *js_typed_array_get_ptr(JSObject *p)
+{
+    JSObject *pbuffer = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
+    JSByteArray *arr = JS_VALUE_TO_PTR(pbuffer->u.array_buffer.byte_buffer);
+    return arr->buf + ((size_t)p->u.typed_array.offset <<
+                       typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY]);
+}
+
+/* 'idx' must be lower than the typed array length */
+static void js_typed_array_set_double(JSObject *p, uint32_t idx, double d)
+{
+    int size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+    js_typed_array_store_double(p->class_id, js_typed_array_get_ptr(p) +
+                                ((size_t)idx << size_log2), d);
+}
+
 /* return the value or:
    - exception 
    - tail call : returned in case of getter and handle_getset =
@@ -2577,33 +3267,8 @@ static JSValue JS_GetPropertyInternal(JSContext *ctx, JSValue obj, JSValue prop,
                    p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
             if (JS_IsInt(prop)) {
                 uint32_t idx = JS_VALUE_GET_INT(prop);
-                JSObject *pbuffer;
-                JSByteArray *arr;
-                if (idx < p->u.typed_array.len) {
-                    idx += p->u.typed_array.offset;
-                    pbuffer = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
-                    arr = JS_VALUE_TO_PTR(pbuffer->u.array_buffer.byte_buffer);
-                    switch(p->class_id) {
-                    default:
-                    case JS_CLASS_UINT8C_ARRAY:
-                    case JS_CLASS_UINT8_ARRAY:
-                        return JS_NewShortInt(*((uint8_t *)arr->buf + idx));
-                    case JS_CLASS_INT8_ARRAY:
-                        return JS_NewShortInt(*((int8_t *)arr->buf + idx));
-                    case JS_CLASS_INT16_ARRAY:
-                        return JS_NewShortInt(*((int16_t *)arr->buf + idx));
-                    case JS_CLASS_UINT16_ARRAY:
-                        return JS_NewShortInt(*((uint16_t *)arr->buf + idx));
-                    case JS_CLASS_INT32_ARRAY:
-                        return JS_NewInt32(ctx, *((int32_t *)arr->buf + idx));
-                    case JS_CLASS_UINT32_ARRAY:
-                        return JS_NewUint32(ctx, *((uint32_t *)arr->buf + idx));
-                    case JS_CLASS_FLOAT32_ARRAY:
-                        return JS_NewFloat64(ctx, *((float *)arr->buf + idx));
-                    case JS_CLASS_FLOAT64_ARRAY:
-                        return JS_NewFloat64(ctx, *((double *)arr->buf + idx));
-                    }
-                }
+                if (idx < p->u.typed_array.len)
+                    return js_typed_array_get_value(ctx, p, idx);
             } else if (JS_IsNumericProperty(ctx, prop)) {
                 return JS_UNDEFINED;
             }
@@ -2755,6 +3420,11 @@ static void js_rehash_props(JSContext *ctx, JSObject *p, BOOL gc_rehash)
     hash_mask = JS_VALUE_GET_INT(arr->arr[1]);
     if (hash_mask == 0 && gc_rehash)
         return; /* no need to rehash if single hash entry */
+#ifdef CONFIG_INLINE_CACHE
+    /* during GC, the whole cache is invalidated by gc_compact_heap() */
+    if (!gc_rehash)
+        ic_invalidate(ctx);
+#endif
     prop_count = JS_VALUE_GET_INT(arr->arr[0]);
     for(i = 0; i <= hash_mask; i++) {
         arr->arr[2 + i] = JS_NewShortInt(0);
@@ -2793,6 +3463,9 @@ static void js_compact_props(JSContext *ctx, JSObject *p)
 
    hash_mask = JS_VALUE_GET_INT(arr->arr[1]);
    hash_size_log2 = get_prop_hash_size_log2(prop_count);
+#ifdef CONFIG_INLINE_CACHE
+   ic_invalidate(ctx);
+#endif
    new_hash_mask = min_int(hash_mask, (1 << hash_size_log2) - 1);
    new_size = 2 + new_hash_mask + 1 + 3 * prop_count;
    if (new_size >= arr->size)
@@ -2869,6 +3542,75 @@ static int get_first_free(JSValueArray *arr)
     return first_free;
 }
 
+/* return the number of elements of an array or typed array, -1 otherwise */
+int JS_GetArrayLength(JSContext *ctx, JSValue obj)
+{
+    JSObject *p;
+    int class_id;
+
+    class_id = JS_GetClassID(ctx, obj);
+    if (class_id < 0)
+        return -1;
+    p = JS_VALUE_TO_PTR(obj);
+    if (class_id == JS_CLASS_ARRAY)
+        return p->u.array.len;
+    else if (class_id >= JS_CLASS_UINT8C_ARRAY && class_id <= JS_CLASS_FLOAT64_ARRAY)
+        return p->u.typed_array.len;
+    else
+        return -1;
+}
+
+/* Enumerate the own properties of 'obj' in creation order, without
+   the array elements. '*ppos' must be set to 0 before the first
+   call. Return 1 and set '*pkey' (a string or an integer) and '*pval'
+   for the next property, 0 when there are no more properties or -1
+   if a getter raised an exception. Only getters allocate memory. */
+int JS_GetOwnPropertyNext(JSContext *ctx, JSValue obj, int *ppos,
+                          JSValue *pkey, JSValue *pval)
+{
+    JSObject *p;
+    JSValueArray *arr;
+    JSProperty *pr;
+    JSValue key, val;
+    int hash_mask, pos, first_free;
+    JSGCRef key_ref;
+
+    if (!JS_IsObject(ctx, obj))
+        return 0;
+    p = JS_VALUE_TO_PTR(obj);
+    arr = JS_VALUE_TO_PTR(p->props);
+    hash_mask = JS_VALUE_GET_INT(arr->arr[1]);
+    first_free = get_first_free(arr);
+    for(pos = *ppos;; pos++) {
+        if (2 + hash_mask + 1 + 3 * pos >= first_free) {
+            *ppos = pos;
+            return 0;
+        }
+        pr = (JSProperty *)&arr->arr[2 + hash_mask + 1 + 3 * pos];
+        /* exclude deleted properties */
+        if (pr->key != JS_UNINITIALIZED)
+            break;
+    }
+    *ppos = pos + 1;
+    key = pr->key;
+    if (pr->prop_type == JS_PROP_NORMAL) {
+        val = pr->value;
+    } else if (pr->prop_type == JS_PROP_VARREF) {
+        JSVarRef *pv = JS_VALUE_TO_PTR(pr->value);
+        val = pv->u.value;
+    } else {
+        /* getter or special property */
+        JS_PUSH_VALUE(ctx, key);
+        val = JS_GetProperty(ctx, obj, key);
+        JS_POP_VALUE(ctx, key);
+        if (JS_IsException(val))
+            return -1;
+    }
+    *pkey = key;
+    *pval = val;
+    return 1;
+}
+
 /* It is assumed that the property does not already exists. */
 static JSProperty *js_create_property(JSContext *ctx, JSValue obj,
                                       JSValue prop)
@@ -3188,60 +3930,22 @@ static JSValue JS_SetPropertyInternal(JSContext *ctx, JSValue this_obj,
                p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
         if (JS_IsInt(prop)) {
             uint32_t idx = JS_VALUE_GET_INT(prop);
-            int v;
             double d;
-            JSObject *pbuffer;
-            JSByteArray *arr;
-            JSGCRef val_ref, this_obj_ref;
+            int ret;
+            JSGCRef this_obj_ref;
 
+            /* ToNumber() is done before the bound check as it may
+               have side effects */
             JS_PUSH_VALUE(ctx, this_obj);
-            JS_PUSH_VALUE(ctx, val);
-            switch(p->class_id) {
-            case JS_CLASS_UINT8C_ARRAY:
-                if (JS_ToUint8Clamp(ctx, &v, val))
-                    return JS_EXCEPTION;
-                break;
-            case JS_CLASS_FLOAT32_ARRAY:
-            case JS_CLASS_FLOAT64_ARRAY:
-                if (JS_ToNumber(ctx, &d, val))
-                    return JS_EXCEPTION;
-                break;
-            default:
-                if (JS_ToInt32(ctx, &v, val))
-                    return JS_EXCEPTION;
-                break;
-            }
-            JS_POP_VALUE(ctx, val);
+            ret = JS_ToNumber(ctx, &d, val);
             JS_POP_VALUE(ctx, this_obj);
+            if (ret)
+                return JS_EXCEPTION;
             
             p = JS_VALUE_TO_PTR(this_obj);
             if (idx >= p->u.typed_array.len)
                 goto invalid_array_subscript;
-            idx += p->u.typed_array.offset;
-            pbuffer = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
-            arr = JS_VALUE_TO_PTR(pbuffer->u.array_buffer.byte_buffer);
-            switch(p->class_id) {
-            default:
-            case JS_CLASS_UINT8C_ARRAY:
-            case JS_CLASS_INT8_ARRAY:
-            case JS_CLASS_UINT8_ARRAY:
-                *((uint8_t *)arr->buf + idx) = v;
-                break;
-            case JS_CLASS_INT16_ARRAY:
-            case JS_CLASS_UINT16_ARRAY:
-                *((uint16_t *)arr->buf + idx) = v;
-                break;
-            case JS_CLASS_INT32_ARRAY:
-            case JS_CLASS_UINT32_ARRAY:
-                *((uint32_t *)arr->buf + idx) = v;
-                break;
-            case JS_CLASS_FLOAT32_ARRAY:
-                *((float *)arr->buf + idx) = d;
-                break;
-            case JS_CLASS_FLOAT64_ARRAY:
-                *((double *)arr->buf + idx) = d;
-                break;
-            }
+            js_typed_array_set_double(p, idx, d);
             return JS_UNDEFINED;
         } else if (JS_IsNumericProperty(ctx, prop)) {
         invalid_array_subscript:
@@ -3356,6 +4060,28 @@ JSValue JS_SetPropertyStr(JSContext *ctx, JSValue this_obj,
     return JS_SetPropertyInternal(ctx, this_obj, prop, val, FALSE);
 }
 
+JSValue JS_DefinePropertyGetSetStr(JSContext *ctx, JSValue this_obj,
+                                   const char *str, JSValue getter,
+                                   JSValue setter)
+{
+    JSValue prop;
+    JSGCRef this_obj_ref, getter_ref, setter_ref;
+    
+    JS_PUSH_VALUE(ctx, this_obj);
+    JS_PUSH_VALUE(ctx, getter);
+    JS_PUSH_VALUE(ctx, setter);
+    prop = JS_NewString(ctx, str);
+    if (!JS_IsException(prop)) {
+        prop = JS_ToPropertyKey(ctx, prop);
+    }
+    JS_POP_VALUE(ctx, setter);
+    JS_POP_VALUE(ctx, getter);
+    JS_POP_VALUE(ctx, this_obj);
+    if (JS_IsException(prop))
+        return prop;
+    return JS_DefinePropertyGetSet(ctx, this_obj, prop, getter, setter);
+}
+
 JSValue JS_SetPropertyUint32(JSContext *ctx, JSValue this_obj,
                              uint32_t idx, JSValue val)
 {
@@ -3364,6 +4090,46 @@ JSValue JS_SetPropertyUint32(JSContext *ctx, JSValue this_obj,
     return JS_SetPropertyInternal(ctx, this_obj, JS_NewShortInt(idx), val, FALSE);
 }
 
+/* Return the property key (an atom or an integer) of the UTF-8 string
+   'buf'. The key is a unique string: it must be kept alive with a GC
+   reference to be reused. */
+JSValue JS_NewPropertyKey(JSContext *ctx, const char *buf, size_t buf_len)
+{
+    JSValue prop;
+    prop = JS_NewStringLen(ctx, buf, buf_len);
+    if (JS_IsException(prop))
+        return prop;
+    return JS_ToPropertyKey(ctx, prop);
+}
+
+/* 'prop' must be a key returned by JS_NewPropertyKey(). No memory is
+   allocated besides the one done by getters. */
+JSValue JS_GetPropertyKey(JSContext *ctx, JSValue this_obj, JSValue prop)
+{
+    return JS_GetProperty(ctx, this_obj, prop);
+}
+
+JSValue JS_SetPropertyKey(JSContext *ctx, JSValue this_obj,
+                          JSValue prop, JSValue val)
+{
+    return JS_SetPropertyInternal(ctx, this_obj, prop, val, FALSE);
+}
+
+/* return TRUE if 'this_obj' or its prototype chain has the property
+   'prop' (same as the 'in' operator) */
+JS_BOOL JS_HasPropertyKey(JSContext *ctx, JSValue this_obj, JSValue prop)
+{
+    int len;
+
+    /* fast array elements are not in the property table */
+    if (JS_IsInt(prop)) {
+        len = JS_GetArrayLength(ctx, this_obj);
+        if (len >= 0 && JS_VALUE_GET_INT(prop) >= 0)
+            return JS_VALUE_GET_INT(prop) < len;
+    }
+    return JS_HasProperty(ctx, this_obj, prop);
+}
+
 /* return JS_FALSE, JS_TRUE or JS_EXCEPTION. Return false only if the
    property is not configurable which is never the case here. */
 static JSValue JS_DeleteProperty(JSContext *ctx, JSValue this_obj,
@@ -3555,6 +4321,9 @@ JSContext *JS_NewContext2(void *mem_start, size_t mem_size, const JSSTDLibraryDe
     ctx->stack_bottom = ctx->sp;
     ctx->fp = ctx->sp;
     ctx->min_free_size = JS_MIN_FREE_SIZE;
+    ctx->interrupt_interval = JS_INTERRUPT_COUNTER_INIT;
+    ctx->unique_strings_hash = JS_NULL;
+    ctx->regexp_cache = JS_NULL;
 #ifdef DEBUG_GC
     ctx->dummy_block = JS_NULL;
     ctx->unique_strings = JS_NULL;
@@ -3563,6 +4332,10 @@ JSContext *JS_NewContext2(void *mem_start, size_t mem_size, const JSSTDLibraryDe
     ctx->write_func = dummy_write_func;
     for(i = 0; i < JS_STRING_POS_CACHE_SIZE; i++)
         ctx->string_pos_cache[i].str = JS_NULL;
+    ctx->string_builder = JS_NULL;
+#ifdef CONFIG_INLINE_CACHE
+    ctx->ic_epoch = 1;
+#endif
 
     if (prepare_compilation) {
         int atom_table_len;
@@ -3630,6 +4403,9 @@ JSContext *JS_NewContext2(void *mem_start, size_t mem_size, const JSSTDLibraryDe
 
     ctx->global_obj = JS_NewObject(ctx);
     ctx->minus_zero = js_alloc_float64(ctx, -0.0); /* XXX: use a ROM value instead */
+    ctx->nan = js_alloc_float64(ctx, NAN);
+    ctx->infinity = js_alloc_float64(ctx, INFINITY);
+    ctx->minus_infinity = js_alloc_float64(ctx, -INFINITY);
         
     if (!prepare_compilation) {
         stdlib_init(ctx, (JSValueArray *)(stdlib_def->stdlib_table + stdlib_def->global_object_offset));
@@ -3643,23 +4419,119 @@ JSContext *JS_NewContext(void *mem_start, size_t mem_size, const JSSTDLibraryDef
     return JS_NewContext2(mem_start, mem_size, stdlib_def, FALSE);
 }
 
+/* call the user C finalizer of the memory block 'ptr' if it is a user
+   class object */
+static inline void js_finalize_mblock(JSContext *ctx, void *ptr)
+{
+    JSObject *p = ptr;
+    if (p->mtag == JS_MTAG_OBJECT && p->class_id >= JS_CLASS_USER &&
+        ctx->c_finalizer_table[p->class_id - JS_CLASS_USER] != NULL) {
+        ctx->c_finalizer_table[p->class_id - JS_CLASS_USER](ctx, p->u.user.opaque);
+    }
+}
+
+/* call the user C finalizers of all the objects of the heap */
+static void js_finalize_heap(JSContext *ctx)
+{
+    uint8_t *ptr;
+    
+    for(ptr = ctx->heap_base; ptr < ctx->heap_free;
+        ptr += get_mblock_size(ptr)) {
+        js_finalize_mblock(ctx, ptr);
+    }
+}
+
 void JS_FreeContext(JSContext *ctx)
 {
-    /* call the user C finalizers */
+    js_finalize_heap(ctx);
+}
+
+/* Call 'func' for each user class object of the heap. No memory must
+   be allocated by 'func'. */
+void JS_EnumUserObjects(JSContext *ctx, JSUserObjectFunc *func, void *arg)
+{
     uint8_t *ptr;
-    int size;
     JSObject *p;
     
-    ptr = ctx->heap_base;
-    while (ptr < ctx->heap_free) {
-        size = get_mblock_size(ptr);
+    for(ptr = ctx->heap_base; ptr < ctx->heap_free;
+        ptr += get_mblock_size(ptr)) {
         p = (JSObject *)ptr;
-        if (p->mtag == JS_MTAG_OBJECT && p->class_id >= JS_CLASS_USER &&
-            ctx->c_finalizer_table[p->class_id - JS_CLASS_USER] != NULL) {
-            ctx->c_finalizer_table[p->class_id - JS_CLASS_USER](ctx, p->u.user.opaque);
-        }
-        ptr += size;
+        if (p->mtag == JS_MTAG_OBJECT && p->class_id >= JS_CLASS_USER)
+            func(ctx, arg, p->class_id, p->u.user.opaque);
+    }
+}
+
+static void js_rebase_context(JSContext *ctx, uint8_t *stack_top);
+
+/* The context, its heap and its stack are all stored in the memory
+   block given to JS_NewContext(). When no code is running, copying the
+   block up to 'heap_free' and copying it back later at the same address
+   restores the context state. Return the size of this image in bytes,
+   or 0 if it cannot be saved now (a call is in progress or GC
+   references are in use). */
+size_t JS_GetContextImageSize(JSContext *ctx)
+{
+    if (ctx->sp != (JSValue *)ctx->stack_top ||
+        ctx->top_gc_ref != NULL || ctx->last_gc_ref != NULL)
+        return 0;
+    return ctx->heap_free - (uint8_t *)ctx;
+}
+
+/* Restore an image of 'image_size' bytes saved from the same context
+   (see JS_GetContextImageSize()), possibly before it was moved with
+   JS_RelocateContext(). The random state and the embedder settings
+   (opaque, interrupt handler, log function, GC tuning, profiler) and the GC
+   statistics are kept. No GC reference must be in use. The user C
+   finalizers of the current objects are called and the user objects of
+   the image are restored as is: their opaque values must still be
+   valid. Return 0 if OK, -1 if the image does not fit in the memory
+   block. */
+int JS_RestoreContextImage(JSContext *ctx, const void *image, size_t image_size)
+{
+    uint8_t *stack_top = ctx->stack_top;
+    const JSContext *image_ctx = image;
+    uint64_t random_state = ctx->random_state;
+    void *opaque = ctx->opaque;
+    JSInterruptHandler *interrupt_handler = ctx->interrupt_handler;
+    int interrupt_interval = ctx->interrupt_interval;
+    JSWriteFunc *write_func = ctx->write_func;
+    uint32_t gc_alloc_budget = ctx->gc_alloc_budget;
+    uint8_t gc_compact_threshold = ctx->gc_compact_threshold;
+    JSGCStats gc_stats = ctx->gc_stats;
+#ifdef CONFIG_PROFILER
+    JSProfileHandler *prof_handler = ctx->prof_handler;
+    uint64_t *prof_opcode_counts = ctx->prof_opcode_counts;
+    int prof_interval = ctx->prof_interval;
+#endif
+
+    if (image_size < sizeof(JSContext) ||
+        image_ctx->class_count != ctx->class_count ||
+        image_size + ctx->min_free_size > stack_top - (uint8_t *)ctx)
+        return -1;
+    js_finalize_heap(ctx);
+    memcpy(ctx, image, image_size);
+    if (ctx->heap_base != (uint8_t *)(ctx->class_proto + 2 * ctx->class_count) ||
+        ctx->stack_top != stack_top) {
+        js_rebase_context(ctx, stack_top);
     }
+    ctx->random_state = random_state;
+    ctx->opaque = opaque;
+    ctx->interrupt_handler = interrupt_handler;
+    ctx->interrupt_interval = interrupt_interval;
+    ctx->write_func = write_func;
+    ctx->gc_alloc_budget = gc_alloc_budget;
+    ctx->gc_compact_threshold = gc_compact_threshold;
+    ctx->gc_alloc_size = 0;
+    ctx->gc_stats = gc_stats;
+#ifdef CONFIG_PROFILER
+    ctx->prof_handler = prof_handler;
+    ctx->prof_opcode_counts = prof_opcode_counts;
+    ctx->prof_interval = prof_interval;
+#endif
+#ifdef CONFIG_INLINE_CACHE
+    ic_invalidate(ctx);
+#endif
+    return 0;
 }
 
 void JS_SetContextOpaque(JSContext *ctx, void *opaque)
@@ -3677,6 +4549,17 @@ void JS_SetInterruptHandler(JSContext *ctx, JSInterruptHandler *interrupt_handle
     ctx->interrupt_handler = interrupt_handler;
 }
 
+/* Call the interrupt handler every 'interval' function calls and
+   backward jumps (1 to 32767, default = 10000). Smaller values make
+   interruption more precise at the cost of more handler calls. */
+void JS_SetInterruptInterval(JSContext *ctx, int interval)
+{
+    interval = max_int(1, min_int(interval, JS_INTERRUPT_COUNTER_MAX));
+    ctx->interrupt_interval = interval;
+    if (ctx->interrupt_counter > interval)
+        ctx->interrupt_counter = interval;
+}
+
 void JS_SetLogFunc(JSContext *ctx, JSWriteFunc *write_func)
 {
     ctx->write_func = write_func;
@@ -4088,6 +4971,13 @@ static JSValue js_dtoa2(JSContext *ctx, double d, int radix, int n_digits, int f
     JSByteArray *tmp_arr, *p;
 
     len_max = js_dtoa_max_len(d, radix, n_digits, flags);
+    if (radix == 10 && (flags & JS_DTOA_FORMAT_MASK) == JS_DTOA_FORMAT_FREE &&
+        len_max < 32) {
+        char buf[32];
+        len = js_dtoa_shortest(buf, d, flags);
+        if (len >= 0)
+            return JS_NewStringLen(ctx, buf, len);
+    }
     p = js_alloc_byte_array(ctx, len_max + 1);
     if (!p)
         return JS_EXCEPTION;
@@ -4343,18 +5233,7 @@ static int JS_ToInt32Internal(JSContext *ctx, int *pres, JSValue val, BOOL sat_f
             /* fast case */
             ret = (int32_t)d;
         } else if (!sat_flag) {
-            if (e <= (1023 + 30 + 53)) {
-                uint64_t v;
-                /* remainder modulo 2^32 */
-                v = (u & (((uint64_t)1 << 52) - 1)) | ((uint64_t)1 << 52);
-                v = v << ((e - 1023) - 52 + 32);
-                ret = v >> 32;
-                /* take the sign into account */
-                if (u >> 63)
-                    ret = -ret;
-            } else {
-                ret = 0; /* also handles NaN and +inf */
-            }
+            ret = js_double_to_int32(d);
         } else {
             if (e == 2047 && (u & (((uint64_t)1 << 52) - 1)) != 0) {
                 /* nan */
@@ -4414,54 +5293,6 @@ static int JS_ToInt32Clamp(JSContext *ctx, int *pres, JSValue val,
     return res;
 }
 
-static int JS_ToUint8Clamp(JSContext *ctx, int *pres, JSValue val)
-{
-    int32_t ret;
-    double d;
-
-    if (JS_IsInt(val)) {
-        ret = JS_VALUE_GET_INT(val);
-        if (ret < 0)
-            ret = 0;
-        else if (ret > 255)
-            ret = 255;
-    } else
-#ifdef JS_USE_SHORT_FLOAT
-    if (JS_IsShortFloat(val)) {
-        d = js_get_short_float(val);
-        goto handle_float64;
-    } else
-#endif
-    if (JS_IsPtr(val)) {
-    handle_number:
-        if (JS_ToNumber(ctx, &d, val)) {
-            *pres = 0;
-            return -1;
-        }
-#ifdef JS_USE_SHORT_FLOAT
-    handle_float64:
-#endif        
-        if (d < 0 || isnan(d))
-            ret = 0;
-        else if (d > 255)
-            ret = 255;
-        else
-            ret = js_lrint(d);
-    } else {
-        switch(JS_VALUE_GET_SPECIAL_TAG(val)) {
-        case JS_TAG_BOOL:
-        case JS_TAG_NULL:
-        case JS_TAG_UNDEFINED:
-            ret = JS_VALUE_GET_SPECIAL_VALUE(val);
-            break;
-        default:
-            goto handle_number;
-        }
-    }
-    *pres = ret;
-    return 0;
-}
-
 static int js_get_length32(JSContext *ctx, uint32_t *pres, JSValue obj)
 {
     JSValue len_val;
@@ -4505,6 +5336,39 @@ static no_inline JSValue js_add_slow(JSContext *ctx)
     }
 }
 
+/* 'local += v' (see OP_append): same as js_add_slow() but appends in
+   place if the local variable contains the string builder. */
+static no_inline JSValue js_append_slow(JSContext *ctx)
+{
+    JSValue *op1, *op2;
+    JSStringCharBuf buf1, buf2;
+    uint32_t len;
+    
+    op1 = &ctx->sp[1];
+    op2 = &ctx->sp[0];
+    if (*op1 == ctx->string_builder && JS_IsPtr(*op1)) {
+        if (!JS_IsString(ctx, *op2)) {
+            *op2 = JS_ToPrimitive(ctx, *op2, HINT_NONE);
+            if (JS_IsException(*op2))
+                return JS_EXCEPTION;
+            *op2 = JS_ToString(ctx, *op2);
+            if (JS_IsException(*op2))
+                return JS_EXCEPTION;
+            /* the variable may have been read by the conversion */
+            if (*op1 != ctx->string_builder)
+                return JS_ConcatString(ctx, *op1, *op2);
+        }
+        return js_string_builder_append(ctx, op1, op2);
+    }
+    if (JS_IsString(ctx, *op1) && JS_IsString(ctx, *op2)) {
+        len = (uint32_t)get_string_ptr(ctx, &buf1, *op1)->len +
+            get_string_ptr(ctx, &buf2, *op2)->len;
+        if (len >= JS_STRING_BUILDER_MIN_LEN)
+            return js_string_builder_new(ctx, op1, op2, len);
+    }
+    return js_add_slow(ctx);
+}
+
 static no_inline JSValue js_binary_arith_slow(JSContext *ctx, OPCodeEnum op)
 {
     double d1, d2, r;
@@ -5044,9 +5908,110 @@ static JSValue js_call_constructor_start(JSContext *ctx, JSValue func)
         pc = ((JSByteArray *)JS_VALUE_TO_PTR(b->byte_code))->buf + JS_VALUE_GET_INT(fp[FRAME_OFFSET_CUR_PC]); \
     } while (0)
 
+#ifdef CONFIG_PROFILER
+#define JS_PROFILE_MAX_FRAMES 64
+
+/* Report the current call stack to the profile handler. No memory is
+   allocated. */
+static void js_profile_sample(JSContext *ctx)
+{
+    JSProfileFrame frames[JS_PROFILE_MAX_FRAMES];
+    JSCStringBuf str_bufs[JS_PROFILE_MAX_FRAMES][2];
+    JSProfileFrame *f;
+    JSFunctionBytecode *b;
+    JSValue *fp;
+    int n, pc, col_num;
+
+    n = 0;
+    fp = ctx->fp;
+    while (fp != (JSValue *)ctx->stack_top && n < JS_PROFILE_MAX_FRAMES) {
+        f = &frames[n];
+        f->func_name = get_func_name(ctx, fp[FRAME_OFFSET_FUNC_OBJ], &str_bufs[n][0], &b);
+        if (!f->func_name)
+            f->func_name = "";
+        if (b) {
+            f->filename = JS_ToCString(ctx, b->filename, &str_bufs[n][1]);
+            pc = JS_VALUE_GET_INT(fp[FRAME_OFFSET_CUR_PC]);
+            /* the caller frames are at pc + 1 of a call, but the
+               innermost one may also be at the target of a jump */
+            f->line_num = find_line_col(&col_num, b, pc - 1);
+            if (f->line_num == 0)
+                f->line_num = find_line_col(&col_num, b, pc);
+        } else {
+            f->filename = NULL;
+            f->line_num = 0;
+        }
+        n++;
+        fp = VALUE_TO_SP(ctx, fp[FRAME_OFFSET_SAVED_FP]);
+    }
+    if (n != 0)
+        ctx->prof_handler(ctx, ctx->opaque, frames, n);
+}
+
+static const char * const js_opcode_names[OP_COUNT] = {
+#define FMT(f)
+#define DEF(id, size, n_pop, n_push, f) #id,
+#define def(id, size, n_pop, n_push, f)
+#include "mquickjs_opcode.h"
+#undef def
+#undef DEF
+#undef FMT
+};
+#endif
+
+/* Enable sampling of the call stack every 'sample_interval' interrupt
+   counter ticks (function calls and backward jumps, at most 32767). The stack is passed to 'handler', or
+   sampling is disabled if it is NULL. If 'opcode_counts' is not NULL,
+   the executed opcodes are counted in this array of
+   JS_GetOpcodeCount() elements (slower). Return -1 if the profiler is
+   not compiled in. */
+int JS_SetProfiler(JSContext *ctx, JSProfileHandler *handler,
+                   int sample_interval, uint64_t *opcode_counts)
+{
+#ifdef CONFIG_PROFILER
+    ctx->prof_handler = handler;
+    ctx->prof_opcode_counts = opcode_counts;
+    ctx->prof_interval = max_int(1, min_int(sample_interval, JS_INTERRUPT_COUNTER_MAX));
+    ctx->prof_ticks = 0;
+    if (handler)
+        ctx->interrupt_counter = ctx->prof_interval;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int JS_GetOpcodeCount(void)
+{
+    return OP_COUNT;
+}
+
+/* return NULL if the profiler is not compiled in */
+const char *JS_GetOpcodeName(int opcode)
+{
+#ifdef CONFIG_PROFILER
+    if (opcode < 0 || opcode >= OP_COUNT)
+        return NULL;
+    return js_opcode_names[opcode];
+#else
+    return NULL;
+#endif
+}
+
 static JSValue __js_poll_interrupt(JSContext *ctx)
 {
-    ctx->interrupt_counter = JS_INTERRUPT_COUNTER_INIT;
+    ctx->interrupt_counter = ctx->interrupt_interval;
+#ifdef CONFIG_PROFILER
+    if (ctx->prof_handler) {
+        js_profile_sample(ctx);
+        /* the interrupt handler is still called at the usual rate */
+        ctx->interrupt_counter = ctx->prof_interval;
+        ctx->prof_ticks += ctx->prof_interval;
+        if (ctx->prof_ticks < ctx->interrupt_interval)
+            return JS_UNDEFINED;
+        ctx->prof_ticks = 0;
+    }
+#endif
     if (ctx->interrupt_handler && ctx->interrupt_handler(ctx, ctx->opaque)) {
         JS_ThrowInternalError(ctx, "interrupted");
         ctx->current_exception_is_uncatchable = TRUE;
@@ -5075,15 +6040,83 @@ void JS_PushArg(JSContext *ctx, JSValue val)
     *--ctx->sp = val;
 }
 
-/* Usage:
-   if (JS_StackCheck(ctx, n + 2)) ...
-   JS_PushArg(ctx, arg[n - 1]);
-   ...
-   JS_PushArg(ctx, arg[0]);
-   JS_PushArg(ctx, func);
-   JS_PushArg(ctx, this_obj);
-   res = JS_Call(ctx, n);
-*/
+/* remove and return the value last pushed with JS_PushArg() */
+JSValue JS_PopArg(JSContext *ctx)
+{
+    return *ctx->sp++;
+}
+
+/* remove the 'n' values last pushed with JS_PushArg() */
+void JS_DropArgs(JSContext *ctx, int n)
+{
+    ctx->sp += n;
+}
+
+/* Create an array from the 'n' values last pushed with JS_PushArg(),
+   the first pushed value being the first element. The values are
+   removed from the stack. */
+JSValue JS_NewArrayFromArgs(JSContext *ctx, int n)
+{
+    JSValue val;
+    JSObject *p;
+    JSValueArray *arr;
+    int i;
+
+    val = JS_NewArray(ctx, n);
+    if (!JS_IsException(val) && n > 0) {
+        p = JS_VALUE_TO_PTR(val);
+        arr = JS_VALUE_TO_PTR(p->u.array.tab);
+        for(i = 0; i < n; i++)
+            arr->arr[i] = ctx->sp[n - 1 - i];
+    }
+    ctx->sp += n;
+    return val;
+}
+
+/* Create a plain object from 'n' properties. The keys are stored one
+   after the other in 'keys' (UTF-8, 'key_lens[i]' bytes each) and the
+   values are the 'n' values last pushed with JS_PushArg(), in the
+   same order. The property table is sized once for the 'n'
+   properties. The values are removed from the stack. If a key is
+   repeated, its last value is kept. */
+JSValue JS_NewObjectFromArgs(JSContext *ctx, const char *keys,
+                             const uint32_t *key_lens, int n)
+{
+    JSValue obj, prop, res = JS_UNDEFINED;
+    JSGCRef obj_ref;
+    int i;
+
+    obj = JS_NewObjectPrealloc(ctx, n);
+    if (JS_IsException(obj))
+        goto done;
+    for(i = 0; i < n; i++) {
+        JS_PUSH_VALUE(ctx, obj);
+        prop = JS_NewStringLen(ctx, keys, key_lens[i]);
+        if (!JS_IsException(prop))
+            prop = JS_ToPropertyKey(ctx, prop);
+        if (!JS_IsException(prop))
+            res = JS_DefinePropertyValue(ctx, obj_ref.val, prop, ctx->sp[n - 1 - i]);
+        JS_POP_VALUE(ctx, obj);
+        if (JS_IsException(prop) || JS_IsException(res)) {
+            obj = JS_EXCEPTION;
+            break;
+        }
+        keys += key_lens[i];
+    }
+ done:
+    ctx->sp += n;
+    return obj;
+}
+
+/* Usage:
+   if (JS_StackCheck(ctx, n + 2)) ...
+   JS_PushArg(ctx, arg[n - 1]);
+   ...
+   JS_PushArg(ctx, arg[0]);
+   JS_PushArg(ctx, func);
+   JS_PushArg(ctx, this_obj);
+   res = JS_Call(ctx, n);
+*/
 JSValue JS_Call(JSContext *ctx, int call_flags)
 {
     JSValue *fp, *sp, val = JS_UNDEFINED, *initial_fp;
@@ -5109,9 +6142,20 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
 #define CASE(op)        case op
 #define DEFAULT         default
 #define BREAK           break
+/* reading a local variable ends the string builder it may contain */
+#define GET_LOC(v) do {                                   \
+        JSValue v1 = (v);                                 \
+        if (unlikely(v1 == ctx->string_builder) && JS_IsPtr(v1))  \
+            js_string_builder_end(ctx);                 \
+        *--sp = v1;                                     \
+    } while (0)
     
     for(;;) {
         opcode = *pc++;
+#ifdef CONFIG_PROFILER
+        if (unlikely(ctx->prof_opcode_counts != NULL))
+            ctx->prof_opcode_counts[opcode]++;
+#endif
 #ifdef DUMP_EXEC
         {
             JSByteArray *arr;
@@ -5382,9 +6426,14 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                         call_flags = JS_VALUE_GET_INT(sp[FRAME_OFFSET_CALL_FLAGS]);
                         if ((call_flags & FRAME_CF_CTOR) &&
                             (fd->def_type != JS_CFUNC_constructor &&
-                             fd->def_type != JS_CFUNC_constructor_magic)) {
+                             fd->def_type != JS_CFUNC_constructor_magic &&
+                             fd->def_type != JS_CFUNC_constructor_params)) {
                             sp += 2; /* go back to the caller frame */
+                            /* the error allocation may trigger a gc */
+                            ctx->sp = sp;
+                            ctx->fp = fp;
                             val = JS_ThrowTypeError(ctx, "not a constructor");
+                            RESTORE();
                             goto exception;
                         }
 
@@ -5396,6 +6445,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                         if (n) {
                             val = JS_EXCEPTION;
                             sp += 2; /* go back to the caller frame */
+                            RESTORE();
                             goto exception;
                         }
                         pushed_argc = argc;
@@ -5425,6 +6475,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                                                    fp + FRAME_OFFSET_ARG0, fd->magic);
                             break;
                         case JS_CFUNC_generic_params:
+                        case JS_CFUNC_constructor_params:
                             p = JS_VALUE_TO_PTR(fp[FRAME_OFFSET_FUNC_OBJ]);
                             val = fd->func.generic_params(ctx, &fp[FRAME_OFFSET_THIS_OBJ],
                                                           call_flags & (FRAME_CF_CTOR | FRAME_CF_ARGC_MASK),
@@ -5520,7 +6571,11 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     } else {
                     not_a_function:
                         sp += 2; /* go back to the caller frame */
+                        /* the error allocation may trigger a gc */
+                        ctx->sp = sp;
+                        ctx->fp = fp;
                         val = JS_ThrowTypeError(ctx, "not a function");
+                        RESTORE();
                         goto exception;
                     }
                 }
@@ -5680,6 +6735,14 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
             BREAK;
 
         CASE(OP_get_loc):
+            {
+                int idx;
+                idx = get_u16(pc);
+                pc += 2;
+                GET_LOC(fp[FRAME_OFFSET_VAR0 - idx]);
+            }
+            BREAK;
+        CASE(OP_get_loc_nocheck):
             {
                 int idx;
                 idx = get_u16(pc);
@@ -5714,11 +6777,11 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
             }
             BREAK;
             
-        CASE(OP_get_loc0): *--sp = fp[FRAME_OFFSET_VAR0 - 0]; BREAK;
-        CASE(OP_get_loc1): *--sp = fp[FRAME_OFFSET_VAR0 - 1]; BREAK;
-        CASE(OP_get_loc2): *--sp = fp[FRAME_OFFSET_VAR0 - 2]; BREAK;
-        CASE(OP_get_loc3): *--sp = fp[FRAME_OFFSET_VAR0 - 3]; BREAK;
-        CASE(OP_get_loc8): *--sp = fp[FRAME_OFFSET_VAR0 - *pc++]; BREAK;
+        CASE(OP_get_loc0): GET_LOC(fp[FRAME_OFFSET_VAR0 - 0]); BREAK;
+        CASE(OP_get_loc1): GET_LOC(fp[FRAME_OFFSET_VAR0 - 1]); BREAK;
+        CASE(OP_get_loc2): GET_LOC(fp[FRAME_OFFSET_VAR0 - 2]); BREAK;
+        CASE(OP_get_loc3): GET_LOC(fp[FRAME_OFFSET_VAR0 - 3]); BREAK;
+        CASE(OP_get_loc8): GET_LOC(fp[FRAME_OFFSET_VAR0 - *pc++]); BREAK;
             
         CASE(OP_put_loc0): fp[FRAME_OFFSET_VAR0 - 0] = *sp++; BREAK;
         CASE(OP_put_loc1): fp[FRAME_OFFSET_VAR0 - 1] = *sp++; BREAK;
@@ -5749,6 +6812,8 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     val = pv->u.value;
                 else
                     val = *pv->u.pvalue;
+                if (unlikely(val == ctx->string_builder) && JS_IsPtr(val))
+                    js_string_builder_end(ctx);
                 if (unlikely(val == JS_TAG_UNINITIALIZED) &&
                     opcode == OP_get_var_ref) {
                     JSValueArray *ext_vars = JS_VALUE_TO_PTR(b->ext_vars);
@@ -5832,8 +6897,18 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     /* fast case */
                     JSObject *p = JS_VALUE_TO_PTR(obj);
                     JSProperty *pr;
+#ifdef CONFIG_INLINE_CACHE
+                    JSInlineCacheEntry *ce;
+#endif
                     if (unlikely(p->mtag != JS_MTAG_OBJECT))
                         goto get_field_slow;
+#ifdef CONFIG_INLINE_CACHE
+                    pr = ic_find_own_property(ctx, pc, p, prop, &ce);
+                    if (likely(pr && pr->prop_type == JS_PROP_NORMAL)) {
+                        val = pr->value;
+                        goto get_field_done;
+                    }
+#endif
                     for(;;) {
                         /* no array check is necessary because 'prop' is
                            guaranted not to be a numeric property */
@@ -5845,6 +6920,11 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                                    object */
                                 goto get_field_slow;
                             } else {
+#ifdef CONFIG_INLINE_CACHE
+                                /* only own properties are cached */
+                                if (obj == sp[0])
+                                    ic_update(ctx, ce, pc, p, pr);
+#endif
                                 val = pr->value;
                                 break;
                             }
@@ -5866,6 +6946,9 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                         goto exception;
                     }
                 }
+#ifdef CONFIG_INLINE_CACHE
+            get_field_done:
+#endif
                 pc += 2;
                 sp[0] = val;
             }
@@ -5931,8 +7014,17 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     /* fast case */
                     JSObject *p = JS_VALUE_TO_PTR(obj);
                     JSProperty *pr;
+#ifdef CONFIG_INLINE_CACHE
+                    JSInlineCacheEntry *ce;
+#endif
                     if (unlikely(p->mtag != JS_MTAG_OBJECT))
                         goto put_field_slow;
+#ifdef CONFIG_INLINE_CACHE
+                    /* only RAM properties are cached by put_field */
+                    pr = ic_find_own_property(ctx, pc, p, prop, &ce);
+                    if (likely(pr && pr->prop_type == JS_PROP_NORMAL))
+                        goto put_field_fast;
+#endif
                     /* no array check is necessary because 'prop' is
                        guaranted not to be a numeric property */
                     /* XXX: slow due to short ints */
@@ -5944,6 +7036,10 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     /* XXX: slow */
                     if (unlikely(JS_IS_ROM_PTR(ctx, pr)))
                         goto put_field_slow;
+#ifdef CONFIG_INLINE_CACHE
+                    ic_update(ctx, ce, pc, p, pr);
+                put_field_fast:
+#endif
                     pr->value = sp[0];
                     sp += 2;
                 } else {
@@ -5975,20 +7071,30 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                 obj = sp[0];
                 if (JS_IsPtr(obj) && JS_IsInt(prop)) {
                     /* fast case with array */
-                    /* XXX: optimize typed arrays too ? */
                     JSObject *p = JS_VALUE_TO_PTR(obj);
                     uint32_t idx;
                     JSValueArray *arr;
                     if (unlikely(p->mtag != JS_MTAG_OBJECT))
                         goto get_array_el_slow;
-                    if (unlikely(p->class_id != JS_CLASS_ARRAY))
-                        goto get_array_el_slow;
                     idx = JS_VALUE_GET_INT(prop);
-                    if (unlikely(idx >= p->u.array.len))
+                    if (likely(p->class_id == JS_CLASS_ARRAY)) {
+                        if (unlikely(idx >= p->u.array.len))
+                            goto get_array_el_slow;
+                        arr = JS_VALUE_TO_PTR(p->u.array.tab);
+                        val = arr->arr[idx];
+                    } else if (p->class_id >= JS_CLASS_UINT8C_ARRAY &&
+                               p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
+                        /* typed arrays have no indexed own properties */
+                        if (unlikely(idx >= p->u.typed_array.len))
+                            goto get_array_el_slow;
+                        SAVE();
+                        val = js_typed_array_get_value(ctx, p, idx);
+                        RESTORE();
+                        if (unlikely(JS_IsException(val)))
+                            goto exception;
+                    } else {
                         goto get_array_el_slow;
-                        
-                    arr = JS_VALUE_TO_PTR(p->u.array.tab);
-                    val = arr->arr[idx];
+                    }
                 } else {
                 get_array_el_slow:
                     SAVE();
@@ -6017,27 +7123,43 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                 prop = sp[1];
                 if (JS_IsPtr(obj) && JS_IsInt(prop)) {
                     /* fast case with array */
-                    /* XXX: optimize typed arrays too ? */
                     JSObject *p = JS_VALUE_TO_PTR(obj);
                     uint32_t idx;
                     JSValueArray *arr;
                     if (unlikely(p->mtag != JS_MTAG_OBJECT))
                         goto put_array_el_slow;
-                    if (unlikely(p->class_id != JS_CLASS_ARRAY))
-                        goto put_array_el_slow;
                     idx = JS_VALUE_GET_INT(prop);
-                    arr = JS_VALUE_TO_PTR(p->u.array.tab);
-                    if (unlikely(idx >= p->u.array.len)) {
-                        if (idx == p->u.array.len &&
-                            p->u.array.tab != JS_NULL &&
-                            idx < arr->size) {
+                    if (likely(p->class_id == JS_CLASS_ARRAY)) {
+                        arr = JS_VALUE_TO_PTR(p->u.array.tab);
+                        if (unlikely(idx >= p->u.array.len)) {
+                            if (idx == p->u.array.len &&
+                                p->u.array.tab != JS_NULL &&
+                                idx < arr->size) {
+                                arr->arr[idx] = sp[0];
+                                p->u.array.len = idx + 1;
+                            } else {
+                                goto put_array_el_slow;
+                            }
+                        } else {
                             arr->arr[idx] = sp[0];
-                            p->u.array.len = idx + 1;
+                        }
+                    } else if (p->class_id >= JS_CLASS_UINT8C_ARRAY &&
+                               p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
+                        double d;
+                        if (unlikely(idx >= p->u.typed_array.len))
+                            goto put_array_el_slow;
+                        /* only numbers: the conversion has no side
+                           effect and does not allocate */
+                        if (JS_IsInt(sp[0])) {
+                            d = JS_VALUE_GET_INT(sp[0]);
+                        } else if (JS_IsNumber(ctx, sp[0])) {
+                            JS_ToNumber(ctx, &d, sp[0]);
                         } else {
                             goto put_array_el_slow;
                         }
+                        js_typed_array_set_double(p, idx, d);
                     } else {
-                        arr->arr[idx] = sp[0];
+                        goto put_array_el_slow;
                     }
                     sp += 3;
                 } else {
@@ -6103,8 +7225,10 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
             BREAK;
             
         CASE(OP_add):
+        CASE(OP_append):
             {
                 JSValue op1, op2;
+                double d1, d2;
                 op1 = sp[1];
                 op2 = sp[0];
                 if (likely(JS_VALUE_IS_BOTH_INT(op1, op2))) {
@@ -6114,10 +7238,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     sp[1] = (uint32_t)r;
                 } else 
 #ifdef JS_USE_SHORT_FLOAT
-                if (JS_VALUE_IS_BOTH_SHORT_FLOAT(op1, op2)) {
-                    double d1, d2;
-                    d1 = js_get_short_float(op1);
-                    d2 = js_get_short_float(op2);
+                if (js_get_float64_operands(&d1, &d2, op1, op2)) {
                     dr = d1 + d2;
                     sp++;
                     goto float_result;
@@ -6126,7 +7247,10 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                 {
                 add_slow:
                     SAVE();
-                    val = js_add_slow(ctx);
+                    if (opcode == OP_append)
+                        val = js_append_slow(ctx);
+                    else
+                        val = js_add_slow(ctx);
                     RESTORE();
                     if (JS_IsException(val))
                         goto exception;
@@ -6138,6 +7262,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
         CASE(OP_sub):
             {
                 JSValue op1, op2;
+                double d1, d2;
                 op1 = sp[1];
                 op2 = sp[0];
                 if (likely(JS_VALUE_IS_BOTH_INT(op1, op2))) {
@@ -6147,10 +7272,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     sp[1] = (uint32_t)r;
                 } else
 #ifdef JS_USE_SHORT_FLOAT
-                if (JS_VALUE_IS_BOTH_SHORT_FLOAT(op1, op2)) {
-                    double d1, d2;
-                    d1 = js_get_short_float(op1);
-                    d2 = js_get_short_float(op2);
+                if (js_get_float64_operands(&d1, &d2, op1, op2)) {
                     dr = d1 - d2;
                     sp++;
                     goto float_result;
@@ -6165,6 +7287,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
         CASE(OP_mul):
             {
                 JSValue op1, op2;
+                double d1, d2;
                 op1 = sp[1];
                 op2 = sp[0];
                 if (likely(JS_VALUE_IS_BOTH_INT(op1, op2))) {
@@ -6190,10 +7313,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     }
                 } else
 #ifdef JS_USE_SHORT_FLOAT
-                if (JS_VALUE_IS_BOTH_SHORT_FLOAT(op1, op2)) {
-                    double d1, d2;
-                    d1 = js_get_short_float(op1);
-                    d2 = js_get_short_float(op2);
+                if (js_get_float64_operands(&d1, &d2, op1, op2)) {
                     dr = d1 * d2;
                     sp++;
                     goto float_result;
@@ -6208,6 +7328,7 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
         CASE(OP_div):
             {
                 JSValue op1, op2;
+                double d1, d2;
                 op1 = sp[1];
                 op2 = sp[0];
                 if (likely(JS_VALUE_IS_BOTH_INT(op1, op2))) {
@@ -6221,7 +7342,15 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                         goto exception;
                     sp[1] = val;
                     sp++;
-                } else {
+                } else
+#ifdef JS_USE_SHORT_FLOAT
+                if (js_get_float64_operands(&d1, &d2, op1, op2)) {
+                    dr = d1 / d2;
+                    sp++;
+                    goto float_result;
+                } else
+#endif
+                {
                     goto binary_arith_slow;
                 }
             }
@@ -6306,9 +7435,10 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                             val = JS_NewShortInt(0);
                         }
                     } else {
-                        /* slow case: need to allocate it */
+                        /* slow case: NaN, infinities or not in the
+                           short float range */
                         SAVE();
-                        val = js_alloc_float64(ctx, dr);
+                        val = __JS_NewFloat64(ctx, dr);
                         RESTORE();
                         if (JS_IsException(val))
                             goto exception;
@@ -6331,7 +7461,14 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     if (unlikely(v1 == JS_SHORTINT_MAX))
                         goto unary_arith_slow;
                     sp[0] = JS_NewShortInt(v1 + 1);
-                } else {
+                } else
+#if defined(JS_USE_SHORT_FLOAT)
+                if (js_get_number_fast(&dr, op1)) {
+                    dr += 1;
+                    goto float_result;
+                } else
+#endif
+                {
                     goto unary_arith_slow;
                 }
             }
@@ -6346,7 +7483,14 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
                     if (unlikely(v1 == JS_SHORTINT_MIN))
                         goto unary_arith_slow;
                     sp[0] = JS_NewShortInt(v1 - 1);
-                } else {
+                } else
+#if defined(JS_USE_SHORT_FLOAT)
+                if (js_get_number_fast(&dr, op1)) {
+                    dr -= 1;
+                    goto float_result;
+                } else
+#endif
+                {
                 unary_arith_slow:
                     SAVE();
                     val = js_unary_arith_slow(ctx, opcode);
@@ -6511,11 +7655,16 @@ JSValue JS_Call(JSContext *ctx, int call_flags)
             CASE(opcode):                                  \
                 {                                         \
                 JSValue op1, op2;                         \
+                double d1, d2;                            \
                 op1 = sp[1];                                   \
                 op2 = sp[0];                                   \
                 if (likely(JS_VALUE_IS_BOTH_INT(op1, op2))) {           \
                     sp[1] = JS_NewBool(JS_VALUE_GET_INT(op1) binary_op JS_VALUE_GET_INT(op2)); \
                     sp++;                                               \
+                } else if (js_get_float64_operands(&d1, &d2, op1, op2)) { \
+                    /* NaN compares as unordered and -0 == +0 */        \
+                    sp[1] = JS_NewBool(d1 binary_op d2);                \
+                    sp++;                                               \
                 } else {                                                \
                     SAVE();                                             \
                     val = slow_call;                                    \
@@ -6645,11 +7794,21 @@ static void js_dump_array(JSContext *ctx, JSValueArray *arr, int len)
 static JSValue js_find_class_name(JSContext *ctx, int class_id)
 {
     const JSCFunctionDef *fd;
-    fd = ctx->c_function_table;
-    while ((fd->def_type != JS_CFUNC_constructor_magic &&
-            fd->def_type != JS_CFUNC_constructor) ||
-           fd->magic != class_id) {
-        fd++;
+    if (class_id >= JS_CLASS_USER) {
+        /* the constructor of a user class is not necessarily in the
+           ROM (see JS_SetUserClass()) */
+        JSObject *p = js_get_object_class(ctx, ctx->class_obj[class_id],
+                                          JS_CLASS_C_FUNCTION);
+        if (!p)
+            return JS_NULL;
+        fd = &ctx->c_function_table[p->u.cfunc.idx];
+    } else {
+        fd = ctx->c_function_table;
+        while ((fd->def_type != JS_CFUNC_constructor_magic &&
+                fd->def_type != JS_CFUNC_constructor) ||
+               fd->magic != class_id) {
+            fd++;
+        }
     }
     return reloc_c_func_name(ctx, fd->name);
 }
@@ -7248,7 +8407,6 @@ typedef struct JSParseState {
     char error_msg[64];
 } JSParseState;
 
-static int js_parse_json_value(JSParseState *s, int state, int dummy_param);
 static JSValue js_parse_regexp(JSParseState *s, int eval_flags);
 static size_t js_parse_regexp_flags(int *pre_flags, const uint8_t *buf);
 static int re_parse_alternative(JSParseState *s, int state, int dummy_param);
@@ -9024,7 +10182,6 @@ typedef enum {
     PARSE_FUNC_js_parse_postfix_expr,
     PARSE_FUNC_js_parse_statement,
     PARSE_FUNC_js_parse_block,
-    PARSE_FUNC_js_parse_json_value,
     PARSE_FUNC_re_parse_alternative,
     PARSE_FUNC_re_parse_disjunction,
 } ParseExprFuncEnum;
@@ -9968,27 +11125,46 @@ static int js_parse_assign_expr(JSParseState *s, int state, int parse_flags)
         op_source_pos = s->token.source_pos;
         next_token(s);
         get_lvalue(s, &opcode, &var_idx, &source_pos, (op != '='));
+        if (op == TOK_PLUS_ASSIGN && opcode == OP_get_loc) {
+            /* a string builder in the variable is kept for OP_append */
+            remove_last_op(s);
+            emit_op_pos(s, OP_get_loc_nocheck, source_pos);
+            emit_u16(s, var_idx);
+        }
 
         PARSE_CALL_SAVE6(s, 0, js_parse_assign_expr, parse_flags & ~PF_DROP,
                          op, opcode, var_idx, parse_flags,
                          op_source_pos, source_pos);
 
-        if (op != '=') {
-            static const uint8_t assign_opcodes[] = {
-                OP_mul, OP_div, OP_mod, OP_add, OP_sub,
-                OP_shl, OP_sar, OP_shr, OP_and, OP_xor, OP_or,
-                OP_pow,
-            };
-            emit_op_pos(s, assign_opcodes[op - TOK_MUL_ASSIGN], op_source_pos);
-        }
-
-        if (may_drop_result(s, parse_flags)) {
-            special = PUT_LVALUE_NOKEEP_TOP;
-            s->dropped_result = TRUE;
+        if (op == TOK_PLUS_ASSIGN && opcode == OP_get_loc) {
+            emit_op_pos(s, OP_append, op_source_pos);
+            put_lvalue(s, opcode, var_idx, source_pos, PUT_LVALUE_NOKEEP_TOP);
+            if (may_drop_result(s, parse_flags)) {
+                s->dropped_result = TRUE;
+            } else {
+                /* OP_get_loc ends the string builder */
+                emit_var(s, OP_get_loc, var_idx, source_pos);
+                /* the result is not an lvalue */
+                s->last_opcode_pos = -1;
+            }
         } else {
-            special = PUT_LVALUE_KEEP_TOP;
+            if (op != '=') {
+                static const uint8_t assign_opcodes[] = {
+                    OP_mul, OP_div, OP_mod, OP_add, OP_sub,
+                    OP_shl, OP_sar, OP_shr, OP_and, OP_xor, OP_or,
+                    OP_pow,
+                };
+                emit_op_pos(s, assign_opcodes[op - TOK_MUL_ASSIGN], op_source_pos);
+            }
+            
+            if (may_drop_result(s, parse_flags)) {
+                special = PUT_LVALUE_NOKEEP_TOP;
+                s->dropped_result = TRUE;
+            } else {
+                special = PUT_LVALUE_KEEP_TOP;
+            }
+            put_lvalue(s, opcode, var_idx, source_pos, special);
         }
-        put_lvalue(s, opcode, var_idx, source_pos, special);
     }
     return PARSE_STATE_RET;
 }
@@ -10826,7 +12002,6 @@ static JSParseFunc *parse_func_table[] = {
     js_parse_postfix_expr,
     js_parse_statement,
     js_parse_block,
-    js_parse_json_value,
     re_parse_alternative,
     re_parse_disjunction,
 };
@@ -11470,146 +12645,6 @@ static void js_parse_local_functions(JSParseState *s, JSValue *pfunc)
     }
 }
 
-/* return the parsed value in s->token.value */
-/* XXX: use exact JSON white space definition */
-static int js_parse_json_value(JSParseState *s, int state, int dummy_param)
-{
-    JSContext *ctx = s->ctx;
-    const uint8_t *p;
-    JSValue val;
-
-    PARSE_START2();
-    
-    p = s->source_buf + s->buf_pos;
-    p += skip_spaces((const char *)p);
-    s->buf_pos = p - s->source_buf;
-    if ((*p >= '0' && *p <= '9') || *p == '-') {
-        double d;
-        JSByteArray *tmp_arr;
-        tmp_arr = js_alloc_byte_array(s->ctx, sizeof(JSATODTempMem));
-        if (!tmp_arr)
-            js_parse_error_mem(s);
-        p = s->source_buf + s->buf_pos;
-        d = js_atod((const char *)p, (const char **)&p, 10, 0,
-                    (JSATODTempMem *)tmp_arr->buf);
-        js_free(s->ctx, tmp_arr);
-        if (isnan(d))
-            js_parse_error(s, "invalid number literal");
-        val = JS_NewFloat64(s->ctx, d);
-    } else if (*p == 't' &&
-               p[1] == 'r' && p[2] == 'u' && p[3] == 'e') {
-        p += 4;
-        val = JS_TRUE;
-    } else if (*p == 'f' &&
-               p[1] == 'a' && p[2] == 'l' && p[3] == 's' && p[4] == 'e') {
-        p += 5;
-        val = JS_FALSE;
-    } else if (*p == 'n' &&
-               p[1] == 'u' && p[2] == 'l' && p[3] == 'l') {
-        p += 4;
-        val = JS_NULL;
-    } else if (*p == '\"') {
-        uint32_t pos;
-        pos = p + 1 - s->source_buf;
-        val = js_parse_string(s, &pos, '\"');
-        p = s->source_buf + pos;
-    } else if (*p == '[') {
-        JSValue val2;
-        uint32_t idx;
-        
-        val = JS_NewArray(ctx, 0);
-        if (JS_IsException(val))
-            js_parse_error_mem(s);
-        PARSE_PUSH_VAL(s, val); /* 'val' is not usable after this call */
-        p = s->source_buf + s->buf_pos + 1;
-        p += skip_spaces((const char *)p);
-        if (*p != ']') {
-            idx = 0;
-            for(;;) {
-                s->buf_pos = p - s->source_buf;
-                PARSE_PUSH_INT(s, idx);
-                PARSE_CALL(s, 0, js_parse_json_value, 0);
-                PARSE_POP_INT(s, idx);
-                val2 = s->token.value;
-                val2 = JS_SetPropertyUint32(ctx, *ctx->sp, idx, val2);
-                if (JS_IsException(val2))
-                    js_parse_error_mem(s);
-                idx++;
-                p = s->source_buf + s->buf_pos;
-                p += skip_spaces((const char *)p);
-                if (*p != ',')
-                    break;
-                p++;
-            }
-        }
-        if (*p != ']')
-            js_parse_error(s, "expecting ']'");
-        p++;
-        PARSE_POP_VAL(s, val);
-    } else if (*p == '{') {
-        JSValue val2, prop;
-        uint32_t pos;
-        
-        val = JS_NewObject(ctx);
-        if (JS_IsException(val))
-            js_parse_error_mem(s);
-        PARSE_PUSH_VAL(s, val); /* 'val' is not usable after this call */
-        p = s->source_buf + s->buf_pos + 1;
-        p += skip_spaces((const char *)p);
-        if (*p != '}') {
-            for(;;) {
-                p += skip_spaces((const char *)p);
-                s->buf_pos = p - s->source_buf;
-                if (*p != '\"')
-                    js_parse_error(s, "expecting '\"'");
-                pos = p + 1 - s->source_buf;
-                prop = js_parse_string(s, &pos, '\"');
-                prop = JS_ToPropertyKey(ctx, prop);
-                if (JS_IsException(prop))
-                    js_parse_error_mem(s);
-                p = s->source_buf + pos;
-                p += skip_spaces((const char *)p);
-                if (*p != ':')
-                    js_parse_error(s, "expecting ':'");
-                p++;
-                s->buf_pos = p - s->source_buf;
-                PARSE_PUSH_VAL(s, prop);
-                PARSE_CALL(s, 1, js_parse_json_value, 0);
-                val2 = s->token.value;
-                PARSE_POP_VAL(s, prop);
-                val2 = JS_DefinePropertyValue(ctx, *ctx->sp, prop, val2);
-                if (JS_IsException(val2))
-                    js_parse_error_mem(s);
-                p = s->source_buf + s->buf_pos;
-                p += skip_spaces((const char *)p);
-                if (*p != ',')
-                    break;
-                p++;
-            }
-        }
-        if (*p != '}')
-            js_parse_error(s, "expecting '}'");
-        p++;
-        PARSE_POP_VAL(s, val);
-    } else {
-        js_parse_error(s, "unexpected character");
-    }
-    s->buf_pos = p - s->source_buf;
-    s->token.value = val;
-    return PARSE_STATE_RET;
-}
-
-static JSValue js_parse_json(JSParseState *s)
-{
-    s->buf_pos = 0;
-    js_parse_call(s, PARSE_FUNC_js_parse_json_value, 0);
-    s->buf_pos += skip_spaces((const char *)(s->source_buf + s->buf_pos));
-    if (s->buf_pos != s->buf_len) {
-        js_parse_error(s, "unexpected character");
-    }
-    return s->token.value;
-}
-
 /* source_str must be a string or JS_NULL. (input, input_len) is
    meaningful only if source_str is JS_NULL. */
 static JSValue JS_Parse2(JSContext *ctx, JSValue source_str,
@@ -11622,6 +12657,11 @@ static JSValue JS_Parse2(JSContext *ctx, JSValue source_str,
     JSGCRef top_func_ref, *saved_top_gc_ref;
     uint8_t str_buf[5];
     
+    if (eval_flags & JS_EVAL_JSON) {
+        return js_json_parse_source(ctx, source_str, (const uint8_t *)input,
+                                    input_len, filename);
+    }
+
     /* XXX: start gc at the start of parsing ? */
     /* XXX: if the parse state is too large, move it to JSContext */
     s = &parse_state;
@@ -11659,16 +12699,14 @@ static JSValue JS_Parse2(JSContext *ctx, JSValue source_str,
         ctx->stack_bottom = ctx->sp;
         
         line_num = get_line_col(&col_num, s->source_buf,
-                                (eval_flags & (JS_EVAL_JSON | JS_EVAL_REGEXP)) ?
+                                (eval_flags & JS_EVAL_REGEXP) ?
                                 s->buf_pos : s->token.source_pos);
         val = JS_ThrowError(ctx, JS_CLASS_SYNTAX_ERROR, "%s", s->error_msg);
         build_backtrace(ctx, ctx->current_exception, filename, line_num + 1, col_num + 1, 0);
         return val;
     }
 
-    if (eval_flags & JS_EVAL_JSON) {
-        top_func = js_parse_json(s);
-    } else if (eval_flags & JS_EVAL_REGEXP) {
+    if (eval_flags & JS_EVAL_REGEXP) {
         top_func = js_parse_regexp(s, eval_flags >> JS_EVAL_REGEXP_FLAGS_SHIFT);
     } else {
         s->filename_str = JS_NewString(ctx, filename);
@@ -12081,6 +13119,12 @@ static void gc_mark_all(JSContext *ctx, BOOL keep_atoms)
             ctx->unique_strings = JS_NULL;
         }
     }
+    /* the indexes of the unique strings changed */
+    if (!JS_IsNull(ctx->unique_strings_hash)) {
+        JSByteArray *harr = JS_VALUE_TO_PTR(ctx->unique_strings_hash);
+        harr->gc_mark = 1;
+        unique_strings_hash_rebuild(ctx);
+    }
 
     /* update the weak references in the string position cache  */
     {
@@ -12092,13 +13136,18 @@ static void gc_mark_all(JSContext *ctx, BOOL keep_atoms)
                 ce->str = JS_NULL;
         }
     }
+    if (!gc_mb_is_marked(ctx->string_builder))
+        ctx->string_builder = JS_NULL;
     
-    /* reset the gc marks and mark the free blocks as free */
+    /* reset the gc marks, mark the free blocks as free and rebuild
+       the free list */
     {
-        uint8_t *ptr, *ptr1;
+        uint8_t *ptr, *ptr1, **pnext;
         int size;
         JSFreeBlock *b;
 
+        pnext = &ctx->gc_free_list;
+        ctx->gc_free_size = 0;
         ptr = ctx->heap_base;
         while (ptr < ctx->heap_free) {
             size = get_mblock_size(ptr);
@@ -12106,22 +13155,31 @@ static void gc_mark_all(JSContext *ctx, BOOL keep_atoms)
             if (b->gc_mark) {
                 b->gc_mark = 0;
             } else {
-                JSObject *p = (void *)ptr;
                 /* call the user finalizer if needed */
-                if (p->mtag == JS_MTAG_OBJECT && p->class_id >= JS_CLASS_USER &&
-                    ctx->c_finalizer_table[p->class_id - JS_CLASS_USER] != NULL) {
-                    ctx->c_finalizer_table[p->class_id - JS_CLASS_USER](ctx, p->u.user.opaque);
-                }
-                /* merge all the consecutive free blocks */
+                js_finalize_mblock(ctx, ptr);
+                /* merge all the consecutive free blocks (each dead
+                   object among them must be finalized too) */
                 ptr1 = ptr + size;
                 while (ptr1 < ctx->heap_free && ((JSFreeBlock *)ptr1)->gc_mark == 0) {
+                    js_finalize_mblock(ctx, ptr1);
                     ptr1 += get_mblock_size(ptr1);
                 }
+                if (ptr1 == ctx->heap_free) {
+                    /* free space at the end of the heap */
+                    ctx->heap_free = ptr;
+                    break;
+                }
                 size = ptr1 - ptr;
                 set_free_block(b, size);
+                ctx->gc_free_size += size;
+                if (size >= JS_FREE_LIST_MIN_SIZE) {
+                    *pnext = ptr;
+                    pnext = &FREE_BLOCK_NEXT(ptr);
+                }
             }
             ptr += size;
         }
+        *pnext = NULL;
     }
 }
 
@@ -12172,7 +13230,12 @@ static void gc_update_threaded_pointers(JSContext *ctx,
     }
 }
 
-static void gc_thread_block(JSContext *ctx, void *ptr)
+typedef void JSGCVisitFunc(JSContext *ctx, JSValue *pval, void *opaque);
+
+/* call 'visit' on every field of the memory block 'ptr' which may
+   reference another memory block */
+static force_inline void gc_visit_block(JSContext *ctx, void *ptr,
+                                        JSGCVisitFunc *visit, void *opaque)
 {
     int mtag;
     
@@ -12181,30 +13244,30 @@ static void gc_thread_block(JSContext *ctx, void *ptr)
     case JS_MTAG_OBJECT:
         {
             JSObject *p = ptr;
-            gc_thread_pointer(ctx, &p->proto);
-            gc_thread_pointer(ctx, &p->props);
+            visit(ctx, &p->proto, opaque);
+            visit(ctx, &p->props, opaque);
             switch(p->class_id) {
             case JS_CLASS_CLOSURE:
                 {
                     int i;
-                    gc_thread_pointer(ctx, &p->u.closure.func_bytecode);
+                    visit(ctx, &p->u.closure.func_bytecode, opaque);
                     for(i = 0; i < p->extra_size - 1; i++)
-                        gc_thread_pointer(ctx, &p->u.closure.var_refs[i]);
+                        visit(ctx, &p->u.closure.var_refs[i], opaque);
                 }
                 break;
             case JS_CLASS_C_FUNCTION:
                 if (p->extra_size > 1)
-                    gc_thread_pointer(ctx, &p->u.cfunc.params);
+                    visit(ctx, &p->u.cfunc.params, opaque);
                 break;
             case JS_CLASS_ARRAY:
-                gc_thread_pointer(ctx, &p->u.array.tab);
+                visit(ctx, &p->u.array.tab, opaque);
                 break;
             case JS_CLASS_ERROR:
-                gc_thread_pointer(ctx, &p->u.error.message);
-                gc_thread_pointer(ctx, &p->u.error.stack);
+                visit(ctx, &p->u.error.message, opaque);
+                visit(ctx, &p->u.error.stack, opaque);
                 break;
             case JS_CLASS_ARRAY_BUFFER:
-                gc_thread_pointer(ctx, &p->u.array_buffer.byte_buffer);
+                visit(ctx, &p->u.array_buffer.byte_buffer, opaque);
                 break;
             case JS_CLASS_UINT8C_ARRAY:
             case JS_CLASS_INT8_ARRAY:
@@ -12215,11 +13278,11 @@ static void gc_thread_block(JSContext *ctx, void *ptr)
             case JS_CLASS_UINT32_ARRAY:
             case JS_CLASS_FLOAT32_ARRAY:
             case JS_CLASS_FLOAT64_ARRAY:
-                gc_thread_pointer(ctx, &p->u.typed_array.buffer);
+                visit(ctx, &p->u.typed_array.buffer, opaque);
                 break;
             case JS_CLASS_REGEXP:
-                gc_thread_pointer(ctx, &p->u.regexp.source);
-                gc_thread_pointer(ctx, &p->u.regexp.byte_code);
+                visit(ctx, &p->u.regexp.source, opaque);
+                visit(ctx, &p->u.regexp.byte_code, opaque);
                 break;
             }
         }
@@ -12229,26 +13292,26 @@ static void gc_thread_block(JSContext *ctx, void *ptr)
             JSValueArray *p = ptr;
             int i;
             for(i = 0; i < p->size; i++) {
-                gc_thread_pointer(ctx, &p->arr[i]);
+                visit(ctx, &p->arr[i], opaque);
             }
         }
         break;
     case JS_MTAG_VARREF:
         {
             JSVarRef *p = ptr;
-            gc_thread_pointer(ctx, &p->u.value);
+            visit(ctx, &p->u.value, opaque);
         }
         break;
     case JS_MTAG_FUNCTION_BYTECODE:
         {
             JSFunctionBytecode *b = ptr;
-            gc_thread_pointer(ctx, &b->func_name);
-            gc_thread_pointer(ctx, &b->byte_code);
-            gc_thread_pointer(ctx, &b->cpool);
-            gc_thread_pointer(ctx, &b->vars);
-            gc_thread_pointer(ctx, &b->ext_vars);
-            gc_thread_pointer(ctx, &b->filename);
-            gc_thread_pointer(ctx, &b->pc2line);
+            visit(ctx, &b->func_name, opaque);
+            visit(ctx, &b->byte_code, opaque);
+            visit(ctx, &b->cpool, opaque);
+            visit(ctx, &b->vars, opaque);
+            visit(ctx, &b->ext_vars, opaque);
+            visit(ctx, &b->filename, opaque);
+            visit(ctx, &b->pc2line, opaque);
         }
         break;
     default:
@@ -12256,11 +13319,22 @@ static void gc_thread_block(JSContext *ctx, void *ptr)
     }
 }
 
+static void gc_thread_pointer_visit(JSContext *ctx, JSValue *pval, void *opaque)
+{
+    gc_thread_pointer(ctx, pval);
+}
+
+static void gc_thread_block(JSContext *ctx, void *ptr)
+{
+    gc_visit_block(ctx, ptr, gc_thread_pointer_visit, NULL);
+}
+
 /* Heap compaction using Jonkers algorithm */
 static void gc_compact_heap(JSContext *ctx)
 {
     uint8_t *ptr, *new_ptr;
     int size;
+    uint32_t moved_size;
     JSValue *sp, *sp_end;
     
     /* thread all the external pointers */
@@ -12276,6 +13350,7 @@ static void gc_compact_heap(JSContext *ctx)
             gc_thread_pointer(ctx, &ce->str);
         }
     }
+    gc_thread_pointer(ctx, &ctx->string_builder);
     
     for(sp = ctx->sp; sp < (JSValue *)ctx->stack_top; sp++) {
         gc_thread_pointer(ctx, sp);
@@ -12318,18 +13393,21 @@ static void gc_compact_heap(JSContext *ctx)
        final position */
     new_ptr = ctx->heap_base;
     ptr = ctx->heap_base;
+    moved_size = 0;
     while (ptr < ctx->heap_free) {
         gc_update_threaded_pointers(ctx, ptr, new_ptr);
         size = get_mblock_size(ptr);
         if (js_get_mtag(ptr) != JS_MTAG_FREE) {
             if (new_ptr != ptr) {
                 memmove(new_ptr, ptr, size);
+                moved_size += size;
             }
             new_ptr += size;
         }
         ptr += size;
     }
     ctx->heap_free = new_ptr;
+    ctx->gc_stats.last_moved_size = moved_size;
 
     /* update the source pointer in the parser */
     if (ctx->parse_state) {
@@ -12350,10 +13428,57 @@ static void gc_compact_heap(JSContext *ctx)
         }
         ptr += size;
     }
+
+    /* no free block is left */
+    ctx->gc_free_list = NULL;
+    ctx->gc_free_size = 0;
+}
+
+static void gc_compact(JSContext *ctx)
+{
+    ctx->gc_stats.compact_count++;
+    gc_compact_heap(ctx);
+#ifdef CONFIG_INLINE_CACHE
+    /* the property arrays and the bytecode may have moved */
+    ic_invalidate(ctx);
+#endif
+}
+
+/* percentage of the free memory which is in free blocks inside the
+   heap instead of the contiguous area before the stack */
+static int gc_get_fragmentation(JSContext *ctx)
+{
+    size_t free_size;
+    free_size = ctx->gc_free_size + ((uint8_t *)ctx->stack_bottom - ctx->heap_free);
+    if (free_size == 0)
+        return 0;
+    return (int)((uint64_t)ctx->gc_free_size * 100 / free_size);
+}
+
+static uint64_t js_get_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* bytes of heap and stack in use, not counting the free blocks */
+static uint32_t gc_get_used_size(JSContext *ctx)
+{
+    return (ctx->heap_free - ctx->heap_base) - ctx->gc_free_size +
+        (ctx->stack_top - (uint8_t *)ctx->sp);
+}
+
+static void gc_update_high_water(JSContext *ctx)
+{
+    ctx->gc_stats.high_water = max_uint32(ctx->gc_stats.high_water,
+                                          gc_get_used_size(ctx));
 }
 
-static void JS_GC2(JSContext *ctx, BOOL keep_atoms)
+static void JS_GC2(JSContext *ctx, BOOL keep_atoms, JSGCCompactEnum compact)
 {
+    uint64_t start_time;
+    
 #ifdef DUMP_GC
     js_printf(ctx, "GC   : heap size=%u/%u stack_size=%u\n",
            (uint32_t)(ctx->heap_free - ctx->heap_base),
@@ -12377,8 +13502,23 @@ static void JS_GC2(JSContext *ctx, BOOL keep_atoms)
         }
     }
 #endif
+    start_time = js_get_time_ns();
+    gc_update_high_water(ctx);
+    ctx->gc_stats.gc_count++;
+    ctx->gc_alloc_size = 0;
     gc_mark_all(ctx, keep_atoms);
-    gc_compact_heap(ctx);
+    if (compact == JS_GC_COMPACT_ALWAYS ||
+        (compact == JS_GC_COMPACT_AUTO &&
+         gc_get_fragmentation(ctx) >= ctx->gc_compact_threshold)) {
+        gc_compact(ctx);
+    } else {
+#ifdef CONFIG_INLINE_CACHE
+        /* freed property arrays may be reallocated */
+        ic_invalidate(ctx);
+#endif
+    }
+    ctx->gc_stats.live_size = (ctx->heap_free - ctx->heap_base) - ctx->gc_free_size;
+    ctx->gc_stats.gc_time_ns += js_get_time_ns() - start_time;
 #ifdef DUMP_GC
     js_printf(ctx, "AFTER: heap size=%u/%u stack_size=%u\n",
            (uint32_t)(ctx->heap_free - ctx->heap_base),
@@ -12389,46 +13529,240 @@ static void JS_GC2(JSContext *ctx, BOOL keep_atoms)
 
 void JS_GC(JSContext *ctx)
 {
-    JS_GC2(ctx, TRUE);
+    JS_GC2(ctx, TRUE, JS_GC_COMPACT_ALWAYS);
 }
 
-/* bytecode saving and loading */
+/* collect the garbage without moving the live objects. The memory of
+   the dead objects is reused by later allocations. */
+void JS_GCCollect(JSContext *ctx)
+{
+    JS_GC2(ctx, TRUE, JS_GC_COMPACT_NEVER);
+}
 
-#define JS_BYTECODE_VERSION_32 0x0001
-/* bit 15 of bytecode version is a 64-bit indicator */
-#define JS_BYTECODE_VERSION (JS_BYTECODE_VERSION_32 | ((JSW & 8) << 12))
+/* compact the heap without collecting garbage */
+void JS_GCCompact(JSContext *ctx)
+{
+    uint64_t start_time = js_get_time_ns();
+    gc_compact(ctx);
+    ctx->gc_stats.gc_time_ns += js_get_time_ns() - start_time;
+}
 
-void JS_PrepareBytecode(JSContext *ctx,
-                        JSBytecodeHeader *hdr,
-                        const uint8_t **pdata_buf, uint32_t *pdata_len,
-                        JSValue eval_code)
+/* Set the heap fragmentation (in percent of the heap size) above which
+   the automatic GC compacts the heap. With 0 (default), it always
+   compacts. Otherwise, the memory of the dead objects is reused in
+   place and compaction only runs when the fragmentation exceeds the
+   threshold or when a contiguous block cannot be found. */
+void JS_SetGCCompactThreshold(JSContext *ctx, int percent)
 {
-    JSGCRef eval_code_ref;
-    int i;
-    
-    /* remove all the objects except the compiled code */
-    ctx->empty_props = JS_NULL;
-    for(i = 0; i < ctx->class_count; i++) {
-        ctx->class_proto[i] = JS_NULL;
-        ctx->class_obj[i] = JS_NULL;
-    }
-    ctx->global_obj = JS_NULL;
-#ifdef DEBUG_GC
-    ctx->dummy_block = JS_NULL;
-#endif
-    
-    JS_PUSH_VALUE(ctx, eval_code);
-    JS_GC2(ctx, FALSE);
-    JS_POP_VALUE(ctx, eval_code);
+    ctx->gc_compact_threshold = max_int(0, min_int(percent, 100));
+}
 
-    hdr->magic = JS_BYTECODE_MAGIC;
-    hdr->version = JS_BYTECODE_VERSION;
-    hdr->base_addr = (uintptr_t)ctx->heap_base;
-    hdr->unique_strings =  ctx->unique_strings;
-    hdr->main_func = eval_code;
+/* Run the GC after every 'size' bytes of allocation instead of only
+   when the memory is exhausted (0 = disabled, default). Combined with
+   a compaction threshold, each collection stays short and the heap
+   rarely fills up in the middle of a computation. */
+void JS_SetGCAllocationBudget(JSContext *ctx, size_t size)
+{
+    ctx->gc_alloc_budget = size > UINT32_MAX ? UINT32_MAX : size;
+    ctx->gc_alloc_size = 0;
+}
 
-    *pdata_buf = ctx->heap_base;
-    *pdata_len = ctx->heap_free - ctx->heap_base;
+int JS_GetGCFragmentation(JSContext *ctx)
+{
+    return gc_get_fragmentation(ctx);
+}
+
+/* Fill 'st' with the memory usage and the GC counters. The counters
+   are maintained by the GC so this is cheap, except with
+   'count_blocks' = TRUE, which walks the heap to fill the per tag
+   block counts. */
+void JS_GetMemoryStats(JSContext *ctx, JSMemoryStats *st, BOOL count_blocks)
+{
+    uint8_t *ptr;
+    int mtag, size;
+    
+    memset(st, 0, sizeof(*st));
+    gc_update_high_water(ctx);
+    st->memory_size = ctx->stack_top - (uint8_t *)ctx;
+    st->heap_size = ctx->heap_free - ctx->heap_base;
+    st->heap_used = st->heap_size - ctx->gc_free_size;
+    st->free_size = ctx->gc_free_size + ((uint8_t *)ctx->sp - ctx->heap_free);
+    st->stack_size = ctx->stack_top - (uint8_t *)ctx->sp;
+    st->high_water = ctx->gc_stats.high_water;
+    st->gc_count = ctx->gc_stats.gc_count;
+    st->gc_compact_count = ctx->gc_stats.compact_count;
+    st->gc_time_ns = ctx->gc_stats.gc_time_ns;
+    st->gc_last_moved_size = ctx->gc_stats.last_moved_size;
+    st->gc_live_size = ctx->gc_stats.live_size;
+    st->oom_count = ctx->gc_stats.oom_count;
+    st->float64_count = ctx->gc_stats.float64_count;
+    if (count_blocks) {
+        assert(JS_MTAG_COUNT <= JS_MEMORY_STATS_TAG_COUNT);
+        ptr = ctx->heap_base;
+        while (ptr < ctx->heap_free) {
+            mtag = ((JSMemBlockHeader *)ptr)->mtag;
+            size = get_mblock_size(ptr);
+            st->block_count[mtag]++;
+            st->block_size[mtag] += size;
+            ptr += size;
+        }
+    }
+}
+
+/* context relocation */
+
+typedef struct {
+    uintptr_t start, end; /* old address range of the heap */
+    intptr_t delta; /* address offset between the old and new heap */
+} JSRebaseState;
+
+static void gc_rebase_pointer(JSContext *ctx, JSValue *pval, void *opaque)
+{
+    JSRebaseState *s = opaque;
+    JSValue val;
+    uintptr_t addr;
+
+    val = *pval;
+    if (!JS_IsPtr(val))
+        return;
+    addr = (uintptr_t)JS_VALUE_TO_PTR(val);
+    if (addr >= s->start && addr < s->end)
+        *pval = val + s->delta;
+}
+
+/* Update the pointers of a context whose memory (context structure
+   and heap) was copied from another address. The new memory block
+   ends at 'stack_top'. The stack must be empty. */
+static void js_rebase_context(JSContext *ctx, uint8_t *stack_top)
+{
+    JSRebaseState s;
+    uint8_t *heap_base, *ptr, **pnext;
+    JSValue *sp, *sp_end;
+    JSGCRef *ref;
+    int i, size;
+
+    heap_base = (uint8_t *)(ctx->class_proto + 2 * ctx->class_count);
+    s.start = (uintptr_t)ctx->heap_base;
+    s.end = (uintptr_t)ctx->heap_free;
+    s.delta = heap_base - ctx->heap_base;
+
+    ctx->heap_base = heap_base;
+    ctx->heap_free += s.delta;
+    ctx->stack_top = stack_top;
+    ctx->sp = (JSValue *)stack_top;
+    ctx->stack_bottom = ctx->sp;
+    ctx->fp = ctx->sp;
+    ctx->class_obj = ctx->class_proto + ctx->class_count;
+
+    /* roots */
+    sp_end = ctx->class_proto + 2 * ctx->class_count;
+    for(sp = &ctx->unique_strings; sp < sp_end; sp++) {
+        gc_rebase_pointer(ctx, sp, &s);
+    }
+    for(i = 0; i < JS_STRING_POS_CACHE_SIZE; i++) {
+        gc_rebase_pointer(ctx, &ctx->string_pos_cache[i].str, &s);
+    }
+    gc_rebase_pointer(ctx, &ctx->string_builder, &s);
+    for(ref = ctx->top_gc_ref; ref != NULL; ref = ref->prev) {
+        gc_rebase_pointer(ctx, &ref->val, &s);
+    }
+    for(ref = ctx->last_gc_ref; ref != NULL; ref = ref->prev) {
+        gc_rebase_pointer(ctx, &ref->val, &s);
+    }
+
+    /* memory blocks */
+    ptr = ctx->heap_base;
+    while (ptr < ctx->heap_free) {
+        size = get_mblock_size(ptr);
+        if (js_get_mtag(ptr) != JS_MTAG_FREE)
+            gc_visit_block(ctx, ptr, gc_rebase_pointer, &s);
+        ptr += size;
+    }
+    for(pnext = &ctx->gc_free_list; *pnext != NULL; pnext = &FREE_BLOCK_NEXT(*pnext)) {
+        *pnext += s.delta;
+    }
+
+    /* the property hash depends on the key addresses */
+    ptr = ctx->heap_base;
+    while (ptr < ctx->heap_free) {
+        size = get_mblock_size(ptr);
+        if (js_get_mtag(ptr) == JS_MTAG_OBJECT) {
+            js_rehash_props(ctx, (JSObject *)ptr, TRUE);
+        }
+        ptr += size;
+    }
+#ifdef CONFIG_INLINE_CACHE
+    memset(ctx->ic, 0, sizeof(ctx->ic));
+#endif
+}
+
+/* Move the context to the memory block 'mem_start' of 'mem_size'
+   bytes, e.g. to grow or shrink its memory. The heap is garbage
+   collected and copied, then its pointers are updated. No code must
+   be running, but GC references may be in use (their values are
+   updated). Return the new context, or NULL if the heap does not fit
+   in the new block or code is running, in which case the context is
+   unchanged. The old memory block can be freed afterwards. */
+JSContext *JS_RelocateContext(JSContext *ctx, void *mem_start, size_t mem_size)
+{
+    JSContext *new_ctx;
+    size_t used_size;
+
+    if (ctx->sp != (JSValue *)ctx->stack_top || ctx->parse_state != NULL)
+        return NULL;
+    mem_size = mem_size & ~(JSW - 1);
+    assert(((uintptr_t)mem_start & (JSW - 1)) == 0);
+    JS_GC(ctx);
+    used_size = ctx->heap_free - (uint8_t *)ctx;
+    if (used_size + ctx->min_free_size > mem_size)
+        return NULL;
+    new_ctx = mem_start;
+    memcpy(new_ctx, ctx, used_size);
+    js_rebase_context(new_ctx, (uint8_t *)mem_start + mem_size);
+    return new_ctx;
+}
+
+/* bytecode saving and loading */
+
+#define JS_BYTECODE_VERSION_32 0x0001
+/* bit 15 of bytecode version is a 64-bit indicator */
+#define JS_BYTECODE_VERSION (JS_BYTECODE_VERSION_32 | ((JSW & 8) << 12))
+
+void JS_PrepareBytecode(JSContext *ctx,
+                        JSBytecodeHeader *hdr,
+                        const uint8_t **pdata_buf, uint32_t *pdata_len,
+                        JSValue eval_code)
+{
+    JSGCRef eval_code_ref;
+    int i;
+    
+    /* remove all the objects except the compiled code */
+    ctx->empty_props = JS_NULL;
+    for(i = 0; i < ctx->class_count; i++) {
+        ctx->class_proto[i] = JS_NULL;
+        ctx->class_obj[i] = JS_NULL;
+    }
+    ctx->global_obj = JS_NULL;
+    ctx->unique_strings_hash = JS_NULL;
+    ctx->regexp_cache = JS_NULL;
+#ifdef DEBUG_GC
+    ctx->dummy_block = JS_NULL;
+#endif
+    
+    JS_PUSH_VALUE(ctx, eval_code);
+    JS_GC2(ctx, FALSE, JS_GC_COMPACT_ALWAYS);
+    JS_POP_VALUE(ctx, eval_code);
+    /* the saved table is used as a ROM atom table */
+    unique_strings_sort(ctx);
+
+    hdr->magic = JS_BYTECODE_MAGIC;
+    hdr->version = JS_BYTECODE_VERSION;
+    hdr->base_addr = (uintptr_t)ctx->heap_base;
+    hdr->unique_strings =  ctx->unique_strings;
+    hdr->main_func = eval_code;
+
+    *pdata_buf = ctx->heap_base;
+    *pdata_len = ctx->heap_free - ctx->heap_base;
 }
 
 #if JSW == 8
@@ -12747,18 +14081,21 @@ int JS_PrepareBytecode64to32(JSContext *ctx,
         ctx->class_obj[i] = JS_NULL;
     }
     ctx->global_obj = JS_NULL;
+    ctx->unique_strings_hash = JS_NULL;
+    ctx->regexp_cache = JS_NULL;
 #ifdef DEBUG_GC
     ctx->dummy_block = JS_NULL;
 #endif
     
     JS_PUSH_VALUE(ctx, eval_code);
 #ifdef JS_USE_SHORT_FLOAT
-    JS_GC2(ctx, FALSE);
+    JS_GC2(ctx, FALSE, JS_GC_COMPACT_ALWAYS);
     if (expand_short_floats(ctx))
         return -1;
 #else
     gc_mark_all(ctx, FALSE);
 #endif    
+    unique_strings_sort(ctx);
     if (gc_compact_heap_64to32(ctx))
         return -1;
     JS_POP_VALUE(ctx, eval_code);
@@ -12921,6 +14258,14 @@ JSValue JS_LoadBytecode(JSContext *ctx, const uint8_t *buf)
     return hdr->main_func;
 }
 
+/* return TRUE if JS_LoadBytecode() can still be called, i.e. no atom
+   was defined in RAM and a ROM atom table slot is available */
+BOOL JS_CanLoadBytecode(JSContext *ctx)
+{
+    return (ctx->unique_strings_len == 0 &&
+            ctx->n_rom_atom_tables < N_ROM_ATOM_TABLES_MAX);
+}
+
 /**********************************************************************/
 /* runtime */
 
@@ -13429,10 +14774,95 @@ JSValue js_string_concat(JSContext *ctx, JSValue *this_val,
     return string_buffer_end(ctx, b);
 }
 
+/* return TRUE if the UTF-16 matches of the string 'p' are the matches
+   of its UTF-8 bytes, i.e. if a match cannot start or end in the
+   middle of a surrogate pair */
+static BOOL js_string_is_byte_searchable(JSString *p)
+{
+    if (p->is_ascii || p->len < 3)
+        return TRUE;
+    return !is_utf8_right_surrogate(p->buf) &&
+        !is_utf8_left_surrogate(p->buf + p->len - 3);
+}
+
+/* return the first UTF-16 position >= start of 'needle' in 'str' or
+   -1 if not found */
+static int js_string_indexof(JSContext *ctx, JSValue str, JSValue needle,
+                             int start, int str_len, int needle_len)
+{
+    JSStringCharBuf buf1, buf2;
+    JSString *p1, *p2;
+    const uint8_t *q;
+    uint32_t pos;
+    int i, j;
+
+    p2 = get_string_ptr(ctx, &buf2, needle);
+    if (needle_len > 0 && start <= str_len - needle_len &&
+        js_string_is_byte_searchable(p2)) {
+        p1 = get_string_ptr(ctx, &buf1, str);
+        pos = js_string_utf16_to_utf8_pos(ctx, str, start);
+        /* skip the pair if 'start' is in the middle of a surrogate pair */
+        pos = (pos >> 1) + (pos & 1) * 4;
+        q = mem_find(p1->buf + pos, p1->len - pos, p2->buf, p2->len);
+        if (!q)
+            return -1;
+        return js_string_utf8_to_utf16_pos(ctx, str, (q - p1->buf) * 2);
+    }
+    
+    for(i = start; i <= str_len - needle_len; i++) {
+        for(j = 0; j < needle_len; j++) {
+            if (string_getc(ctx, str, i + j) !=
+                string_getc(ctx, needle, j)) {
+                goto next;
+            }
+            
+        }
+        return i;
+    next: ;
+    }
+    return -1;
+}
+
+/* return the last UTF-16 position <= start of 'needle' in 'str' or -1
+   if not found. 'start + needle_len' must be <= the string length. */
+static int js_string_lastindexof(JSContext *ctx, JSValue str, JSValue needle,
+                                 int start, int needle_len)
+{
+    JSStringCharBuf buf1, buf2;
+    JSString *p1, *p2;
+    const uint8_t *q;
+    uint32_t pos;
+    int i, j;
+
+    p2 = get_string_ptr(ctx, &buf2, needle);
+    if (needle_len > 0 && js_string_is_byte_searchable(p2)) {
+        p1 = get_string_ptr(ctx, &buf1, str);
+        /* a match cannot start in the middle of a surrogate pair */
+        pos = js_string_utf16_to_utf8_pos(ctx, str, start) >> 1;
+        q = mem_rfind(p1->buf, min_uint32(p1->len, pos + p2->len),
+                      p2->buf, p2->len);
+        if (!q)
+            return -1;
+        return js_string_utf8_to_utf16_pos(ctx, str, (q - p1->buf) * 2);
+    }
+
+    for(i = start; i >= 0; i--) {
+        for(j = 0; j < needle_len; j++) {
+            if (string_getc(ctx, str, i + j) !=
+                string_getc(ctx, needle, j)) {
+                goto next;
+            }
+        }
+        return i;
+    next: ;
+    }
+    return -1;
+}
+
 JSValue js_string_indexOf(JSContext *ctx, JSValue *this_val,
                           int argc, JSValue *argv, int lastIndexOf)
 {
-    int i, len, v_len, pos, start, stop, ret, inc, j;
+    int len, v_len, pos, ret;
 
     *this_val = JS_ToStringCheckObject(ctx, *this_val);
     if (JS_IsException(*this_val))
@@ -13442,6 +14872,7 @@ JSValue js_string_indexOf(JSContext *ctx, JSValue *this_val,
         return JS_EXCEPTION;
     len = js_string_len(ctx, *this_val);
     v_len = js_string_len(ctx, argv[0]);
+    ret = -1;
     if (lastIndexOf) {
         pos = len - v_len;
         if (argc > 1) {
@@ -13455,33 +14886,16 @@ JSValue js_string_indexOf(JSContext *ctx, JSValue *this_val,
                     pos = d;
             }
         }
-        start = pos;
-        stop = 0;
-        inc = -1;
+        if (len >= v_len)
+            ret = js_string_lastindexof(ctx, *this_val, argv[0], pos, v_len);
     } else {
         pos = 0;
         if (argc > 1) {
             if (JS_ToInt32Clamp(ctx, &pos, argv[1], 0, len, 0))
                 goto fail;
         }
-        start = pos;
-        stop = len - v_len;
-        inc = 1;
-    }
-    ret = -1;
-    if (len >= v_len && inc * (stop - start) >= 0) {
-        for (i = start;; i += inc) {
-            for(j = 0; j < v_len; j++) {
-                if (string_getc(ctx, *this_val, i + j) != string_getc(ctx, argv[0], j)) {
-                    goto next;
-                }
-            }
-            ret = i;
-            break;
-        next:
-            if (i == stop)
-                break;
-        }
+        if (len >= v_len)
+            ret = js_string_indexof(ctx, *this_val, argv[0], pos, len, v_len);
     }
     return JS_NewShortInt(ret);
 
@@ -13489,38 +14903,18 @@ fail:
     return JS_EXCEPTION;
 }
 
-static int js_string_indexof(JSContext *ctx, JSValue str, JSValue needle,
-                             int start, int str_len, int needle_len)
-{
-    int i, j;
-    for(i = start; i <= str_len - needle_len; i++) {
-        for(j = 0; j < needle_len; j++) {
-            if (string_getc(ctx, str, i + j) !=
-                string_getc(ctx, needle, j)) {
-                goto next;
-            }
-            
-        }
-        return i;
-    next: ;
-    }
-    return -1;
-}
-
 /* Note: ascii only */
 JSValue js_string_toLowerCase(JSContext *ctx, JSValue *this_val,
                               int argc, JSValue *argv, int to_lower)
 {
-    StringBuffer b_s, *b = &b_s;
-    int i, c, len;
-
+    JSStringCharBuf buf;
+    JSString *p, *p1;
+    
     *this_val = JS_ToStringCheckObject(ctx, *this_val);
     if (JS_IsException(*this_val))
         return *this_val;
-    len = js_string_len(ctx, *this_val);
-    string_buffer_init(ctx, b, len);
-    for(i = 0; i < len; i++) {
-        c = string_getc(ctx, *this_val, i);
+    if (JS_VALUE_GET_SPECIAL_TAG(*this_val) == JS_TAG_STRING_CHAR) {
+        int c = JS_VALUE_GET_SPECIAL_VALUE(*this_val);
         if (to_lower) {
             if (c >= 'A' && c <= 'Z')
                 c += 'a' - 'A';
@@ -13528,9 +14922,20 @@ JSValue js_string_toLowerCase(JSContext *ctx, JSValue *this_val,
             if (c >= 'a' && c <= 'z')
                 c += 'A' - 'a';
         }
-        string_buffer_putc(ctx, b, c);
+        return JS_NewStringChar(c);
     }
-    return string_buffer_end(ctx, b);
+    p = get_string_ptr(ctx, &buf, *this_val);
+    if (p->len == 0)
+        return *this_val;
+    /* only the ASCII letters are converted, so the UTF-8 bytes can be
+       converted one by one */
+    p1 = js_alloc_string(ctx, p->len);
+    if (!p1)
+        return JS_EXCEPTION;
+    p = JS_VALUE_TO_PTR(*this_val);
+    p1->is_ascii = p->is_ascii;
+    ascii_convert_case(p1->buf, p->buf, p->len, to_lower);
+    return JS_VALUE_FROM_PTR(p1);
 }
 
 /* c < 128 */
@@ -13563,23 +14968,54 @@ static force_inline BOOL unicode_is_space(uint32_t c)
 JSValue js_string_trim(JSContext *ctx, JSValue *this_val,
                        int argc, JSValue *argv, int magic)
 {
-    int a, b, len;
+    JSStringCharBuf buf;
+    JSString *p;
+    const uint8_t *ptr;
+    size_t clen;
+    int a, b, len, b1;
 
     *this_val = JS_ToStringCheckObject(ctx, *this_val);
     if (JS_IsException(*this_val))
         return *this_val;
-    len = js_string_len(ctx, *this_val);
+    /* the white space characters are not surrogates so the UTF-8
+       positions can be used */
+    p = get_string_ptr(ctx, &buf, *this_val);
+    ptr = p->buf;
+    len = p->len;
     a = 0;
     b = len;
     if (magic & 1) {
-        while (a < len && unicode_is_space(string_getc(ctx, *this_val, a)))
-            a++;
+        while (a < len) {
+            if (likely(ptr[a] < 0x80)) {
+                if (!unicode_is_space_ascii(ptr[a]))
+                    break;
+                a++;
+            } else {
+                if (!unicode_is_space_non_ascii(utf8_get(ptr + a, &clen)))
+                    break;
+                a += clen;
+            }
+        }
     }
     if (magic & 2) {
-        while (b > a && unicode_is_space(string_getc(ctx, *this_val, b - 1)))
-            b--;
+        while (b > a) {
+            if (likely(ptr[b - 1] < 0x80)) {
+                if (!unicode_is_space_ascii(ptr[b - 1]))
+                    break;
+                b--;
+            } else {
+                b1 = b - 1;
+                while ((ptr[b1] & 0xc0) == 0x80)
+                    b1--;
+                if (!unicode_is_space_non_ascii(utf8_get(ptr + b1, &clen)))
+                    break;
+                b = b1;
+            }
+        }
     }
-    return js_sub_string(ctx, *this_val, a, b);
+    if (a == 0 && b == len)
+        return *this_val;
+    return js_sub_string_utf8(ctx, *this_val, a * 2, b * 2);
 }
 
 /**********************************************************************/
@@ -14134,6 +15570,7 @@ JSValue js_array_join(JSContext *ctx, JSValue *this_val,
     JSObject *p;
     JSValueArray *arr;
     StringBuffer b_s, *b = &b_s;
+    JSGCRef sep_ref;
     
     if (!JS_IsObject(ctx, *this_val))
         return JS_ThrowTypeError(ctx, "not an object");
@@ -14154,10 +15591,12 @@ JSValue js_array_join(JSContext *ctx, JSValue *this_val,
         sep = JS_NewStringChar(',');
     }
     string_buffer_init(ctx, b, 0);
+    /* 'sep' must stay valid while the elements are converted */
+    JS_PUSH_VALUE(ctx, sep);
     for(i = 0; i < len; i++) {
         if (i > 0) {
-            if (string_buffer_concat(ctx, b, sep))
-                return JS_EXCEPTION;
+            if (string_buffer_concat_str(ctx, b, sep_ref.val))
+                goto exception;
         }
         if (is_array) {
             p = JS_VALUE_TO_PTR(*this_val);
@@ -14167,16 +15606,23 @@ JSValue js_array_join(JSContext *ctx, JSValue *this_val,
             else
                 val = JS_UNDEFINED;
         } else {
+            JSGCRef b_ref;
+            JS_PUSH_STRING_BUFFER(ctx, b);
             val = JS_GetPropertyUint32(ctx, *this_val, i);
+            JS_POP_STRING_BUFFER(ctx, b);
             if (JS_IsException(val))
-                return JS_EXCEPTION;
+                goto exception;
         }
         if (!JS_IsUndefined(val) && !JS_IsNull(val)) {
             if (string_buffer_concat(ctx, b, val))
-                return JS_EXCEPTION;
+                goto exception;
         }
     }
+    JS_POP_VALUE(ctx, sep);
     return string_buffer_end(ctx, b);
+ exception:
+    JS_POP_VALUE(ctx, sep);
+    return JS_EXCEPTION;
 }
 
 JSValue js_array_toString(JSContext *ctx, JSValue *this_val,
@@ -14611,102 +16057,420 @@ static void rqsort_idx(size_t nmemb,
     }
 }
 
+/* Adaptive stable merge sort (simplified TimSort without galloping).
+   The elements are accessed by index: [0, nmemb) are the elements to
+   sort and [nmemb, nmemb + nmemb / 2 + 1) is a temporary area. 'copy'
+   moves 'count' elements (the ranges may overlap). The comparison
+   function may be inconsistent: the result is then unspecified but
+   all the accesses stay in bounds. */
 typedef struct {
-    JSContext *ctx;
-    BOOL exception;
-    JSValue *parr;
-    JSValue *pfunc;
-} JSArraySortContext;
+    int (*cmp)(size_t i1, size_t i2, void *opaque);
+    void (*copy)(size_t dst, size_t src, size_t count, void *opaque);
+    void *opaque;
+    size_t tmp; /* index of the temporary area */
+} JSMergeSort;
 
-/* return -1, 0, 1  */
-static int js_array_sort_cmp(size_t i1, size_t i2, void *opaque)
+#define MSORT_MAX_RUNS 64
+
+/* reverse [lo, hi) using the first temporary element */
+static void msort_reverse(JSMergeSort *s, size_t lo, size_t hi)
 {
-    JSArraySortContext *s = opaque;
-    JSContext *ctx = s->ctx;
-    JSValueArray *arr;
-    int cmp, j1, j2;
-    
-    if (s->exception)
-        return 0;
+    while (hi - lo >= 2) {
+        hi--;
+        s->copy(s->tmp, lo, 1, s->opaque);
+        s->copy(lo, hi, 1, s->opaque);
+        s->copy(hi, s->tmp, 1, s->opaque);
+        lo++;
+    }
+}
 
-    arr = JS_VALUE_TO_PTR(*s->parr);
-    if (s->pfunc) {
-        JSValue res;
-        /* custom sort function is specified as returning 0 for identical
-         * objects: avoid method call overhead.
-         */
-        if (arr->arr[2 * i1] == arr->arr[2 * i2])
-            goto cmp_same;
-        if (JS_StackCheck(ctx, 4))
-            goto exception;
-        arr = JS_VALUE_TO_PTR(*s->parr);
+/* return the length of the run starting at 'lo'. A strictly
+   descending run is reversed. */
+static size_t msort_count_run(JSMergeSort *s, size_t lo, size_t hi)
+{
+    size_t i;
 
-        JS_PushArg(ctx, arr->arr[2 * i2]);
-        JS_PushArg(ctx, arr->arr[2 * i1]); /* arg0 */
-        JS_PushArg(ctx, *s->pfunc); /* func */
-        JS_PushArg(ctx, JS_UNDEFINED); /* this */
-        res = JS_Call(ctx, 2);
-        if (JS_IsException(res))
-            return JS_EXCEPTION;
-        if (JS_IsInt(res)) {
-            int val = JS_VALUE_GET_INT(res);
-            cmp = (val > 0) - (val < 0);
-        } else {
-            double val;
-            if (JS_ToNumber(ctx, &val, res))
-                goto exception;
-            cmp = (val > 0) - (val < 0);
-        }
+    i = lo + 1;
+    if (i >= hi)
+        return hi - lo;
+    if (s->cmp(i, lo, s->opaque) < 0) {
+        i++;
+        while (i < hi && s->cmp(i, i - 1, s->opaque) < 0)
+            i++;
+        msort_reverse(s, lo, i);
     } else {
-        JSValue str1, str2;
-        JSGCRef str1_ref;
+        i++;
+        while (i < hi && s->cmp(i, i - 1, s->opaque) >= 0)
+            i++;
+    }
+    return i - lo;
+}
 
-        str1 = arr->arr[2 * i1];
-        if (!JS_IsString(ctx, str1)) {
-            str1 = JS_ToString(ctx, str1);
-            if (JS_IsException(str1))
-                goto exception;
-            arr = JS_VALUE_TO_PTR(*s->parr);
-        }
-        str2 = arr->arr[2 * i2];
-        if (!JS_IsString(ctx, str2)) {
-            JS_PUSH_VALUE(ctx, str1);
-            str2 = JS_ToString(ctx, str2);
-            JS_POP_VALUE(ctx, str1);
-            if (JS_IsException(str2))
-                goto exception;
+/* sort [lo, hi) knowing that [lo, start) is sorted */
+static void msort_binary_insertion(JSMergeSort *s, size_t lo, size_t hi,
+                                   size_t start)
+{
+    size_t i, l, r, m;
+
+    for(i = start; i < hi; i++) {
+        /* find the position after the equal elements (stable) */
+        l = lo;
+        r = i;
+        while (l < r) {
+            m = l + (r - l) / 2;
+            if (s->cmp(i, m, s->opaque) < 0)
+                r = m;
+            else
+                l = m + 1;
+        }
+        if (l < i) {
+            s->copy(s->tmp, i, 1, s->opaque);
+            s->copy(l + 1, l, i - l, s->opaque);
+            s->copy(l, s->tmp, 1, s->opaque);
+        }
+    }
+}
+
+/* return the number of elements of [lo, hi) lower or equal to 'key' */
+static size_t msort_upper_bound(JSMergeSort *s, size_t key, size_t lo, size_t hi)
+{
+    size_t l = lo, r = hi, m;
+    while (l < r) {
+        m = l + (r - l) / 2;
+        if (s->cmp(key, m, s->opaque) < 0)
+            r = m;
+        else
+            l = m + 1;
+    }
+    return l - lo;
+}
+
+/* return the number of elements of [lo, hi) strictly lower than 'key' */
+static size_t msort_lower_bound(JSMergeSort *s, size_t key, size_t lo, size_t hi)
+{
+    size_t l = lo, r = hi, m;
+    while (l < r) {
+        m = l + (r - l) / 2;
+        if (s->cmp(m, key, s->opaque) < 0)
+            l = m + 1;
+        else
+            r = m;
+    }
+    return l - lo;
+}
+
+/* merge the consecutive sorted runs [a, a + na) and [a + na, a + na + nb) */
+static void msort_merge(JSMergeSort *s, size_t a, size_t na, size_t nb)
+{
+    size_t b, k, i, j, tmp;
+
+    b = a + na;
+    /* already in order: nothing to do (common for nearly sorted input) */
+    if (s->cmp(b, b - 1, s->opaque) >= 0)
+        return;
+    /* the elements of A lower or equal to B[0] are in place */
+    k = msort_upper_bound(s, b, a, b);
+    a += k;
+    na -= k;
+    /* the elements of B greater or equal to A[na - 1] are in place */
+    nb = msort_lower_bound(s, b - 1, b, b + nb);
+    if (na == 0 || nb == 0)
+        return;
+
+    tmp = s->tmp;
+    if (na <= nb) {
+        /* copy A to the temporary area and merge from the start */
+        s->copy(tmp, a, na, s->opaque);
+        i = 0;
+        j = b;
+        k = a;
+        while (i < na && j < b + nb) {
+            if (s->cmp(j, tmp + i, s->opaque) < 0)
+                s->copy(k++, j++, 1, s->opaque);
+            else
+                s->copy(k++, tmp + i++, 1, s->opaque);
+        }
+        if (i < na)
+            s->copy(k, tmp + i, na - i, s->opaque);
+    } else {
+        /* copy B to the temporary area and merge from the end */
+        s->copy(tmp, b, nb, s->opaque);
+        i = na; /* elements of A left */
+        j = nb; /* elements of B left */
+        k = b + nb;
+        while (i > 0 && j > 0) {
+            if (s->cmp(tmp + j - 1, a + i - 1, s->opaque) < 0) {
+                s->copy(--k, a + --i, 1, s->opaque);
+            } else {
+                s->copy(--k, tmp + --j, 1, s->opaque);
+            }
+        }
+        if (j > 0)
+            s->copy(a, tmp, j, s->opaque);
+    }
+}
+
+static size_t msort_min_run(size_t n)
+{
+    size_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+static void msort_idx(size_t nmemb,
+                      int (*cmp)(size_t, size_t, void *),
+                      void (*copy)(size_t, size_t, size_t, void *),
+                      void *opaque)
+{
+    JSMergeSort ss, *s = &ss;
+    size_t run_base[MSORT_MAX_RUNS], run_len[MSORT_MAX_RUNS];
+    size_t lo, n, min_run, force;
+    int n_runs, i;
+
+    if (nmemb < 2)
+        return;
+    s->cmp = cmp;
+    s->copy = copy;
+    s->opaque = opaque;
+    s->tmp = nmemb;
+    min_run = msort_min_run(nmemb);
+    n_runs = 0;
+    lo = 0;
+    while (lo < nmemb) {
+        n = msort_count_run(s, lo, nmemb);
+        if (n < min_run) {
+            force = min_int(min_run, nmemb - lo);
+            msort_binary_insertion(s, lo, lo + force, lo + n);
+            n = force;
+        }
+        run_base[n_runs] = lo;
+        run_len[n_runs] = n;
+        n_runs++;
+        lo += n;
+
+        /* keep the TimSort invariants on the run lengths so that the
+           merges are balanced and the stack depth is logarithmic */
+        while (n_runs > 1) {
+            i = n_runs - 2;
+            if ((i > 0 && run_len[i - 1] <= run_len[i] + run_len[i + 1]) ||
+                (i > 1 && run_len[i - 2] <= run_len[i - 1] + run_len[i])) {
+                if (run_len[i - 1] < run_len[i + 1])
+                    i--;
+            } else if (run_len[i] > run_len[i + 1]) {
+                break;
+            }
+            msort_merge(s, run_base[i], run_len[i], run_len[i + 1]);
+            run_len[i] += run_len[i + 1];
+            if (i + 2 < n_runs) {
+                run_base[i + 1] = run_base[i + 2];
+                run_len[i + 1] = run_len[i + 2];
+            }
+            n_runs--;
         }
-        cmp = js_string_compare(ctx, str1, str2);
     }
-    if (cmp != 0)
-        return cmp;
- cmp_same:
-    /* make sort stable: compare array offsets */
+    while (n_runs > 1) {
+        i = n_runs - 2;
+        if (i > 0 && run_len[i - 1] < run_len[i + 1])
+            i--;
+        msort_merge(s, run_base[i], run_len[i], run_len[i + 1]);
+        run_len[i] += run_len[i + 1];
+        if (i + 2 < n_runs) {
+            run_base[i + 1] = run_base[i + 2];
+            run_len[i + 1] = run_len[i + 2];
+        }
+        n_runs--;
+    }
+}
+
+/* sort comparison kinds */
+typedef enum {
+    JS_SORT_FUNC, /* call the comparison function */
+    JS_SORT_STRING, /* default array order: compare as strings */
+    JS_SORT_NUMBER, /* numeric order (default typed array order) */
+    JS_SORT_SUB, /* function(a, b) { return a - b; } on numbers */
+    JS_SORT_SUB_REV, /* function(a, b) { return b - a; } on numbers */
+} JSSortKindEnum;
+
+/* recognize the comparison functions returning a - b or b - a so that
+   they need not be called */
+static JSSortKindEnum js_get_sort_func_kind(JSContext *ctx, JSValue func)
+{
+    JSObject *p;
+    JSFunctionBytecode *b;
+    JSByteArray *byte_code;
+    const uint8_t *pc;
+
+    if (!JS_IsPtr(func))
+        return JS_SORT_FUNC;
+    p = JS_VALUE_TO_PTR(func);
+    if (p->mtag != JS_MTAG_OBJECT || p->class_id != JS_CLASS_CLOSURE)
+        return JS_SORT_FUNC;
+    b = JS_VALUE_TO_PTR(p->u.closure.func_bytecode);
+    if (b->arg_count != 2 || b->byte_code == JS_NULL)
+        return JS_SORT_FUNC;
+    byte_code = JS_VALUE_TO_PTR(b->byte_code);
+    if (byte_code->size != 4)
+        return JS_SORT_FUNC;
+    pc = byte_code->buf;
+    if (pc[2] != OP_sub || pc[3] != OP_return)
+        return JS_SORT_FUNC;
+    if (pc[0] == OP_get_arg0 && pc[1] == OP_get_arg1)
+        return JS_SORT_SUB;
+    else if (pc[0] == OP_get_arg1 && pc[1] == OP_get_arg0)
+        return JS_SORT_SUB_REV;
+    else
+        return JS_SORT_FUNC;
+}
+
+/* sign of 'a - b' as computed by the comparison functions */
+static inline int js_sort_sub_cmp(double a, double b)
+{
+    double d = a - b;
+    return (d > 0) - (d < 0);
+}
+
+/* total numeric order: -0 before +0 and NaN at the end */
+static inline int js_sort_number_cmp(double a, double b)
+{
+    if (a < b)
+        return -1;
+    if (a > b)
+        return 1;
+    if (a == b)
+        return (signbit(b) != 0) - (signbit(a) != 0);
+    return isnan(a) - isnan(b);
+}
+
+/* compare the decimal representations of two integers */
+static int js_int_string_compare(int a, int b)
+{
+    char buf1[16], buf2[16];
+    size_t len1, len2;
+    int res;
+
+    if (a == b)
+        return 0;
+    len1 = i32toa(buf1, a);
+    len2 = i32toa(buf2, b);
+    res = memcmp(buf1, buf2, min_int(len1, len2));
+    if (res != 0)
+        return res;
+    return (len1 > len2) - (len1 < len2);
+}
+
+typedef struct {
+    JSContext *ctx;
+    BOOL exception;
+    JSSortKindEnum kind;
+    JSValue *parr;
+    JSValue *pfunc;
+} JSArraySortContext;
+
+/* return < 0, 0, > 0 */
+static int js_array_sort_cmp(size_t i1, size_t i2, void *opaque)
+{
+    JSArraySortContext *s = opaque;
+    JSContext *ctx = s->ctx;
+    JSValueArray *arr;
+    JSValue v1, v2;
+    int cmp;
+    
+    if (s->exception)
+        return 0;
+
     arr = JS_VALUE_TO_PTR(*s->parr);
-    j1 = JS_VALUE_GET_INT(arr->arr[2 * i1 + 1]);
-    j2 = JS_VALUE_GET_INT(arr->arr[2 * i2 + 1]);
-    return (j1 > j2) - (j1 < j2);
+    v1 = arr->arr[i1];
+    v2 = arr->arr[i2];
+    switch(s->kind) {
+    case JS_SORT_SUB:
+    case JS_SORT_SUB_REV:
+        if (JS_IsInt(v1) && JS_IsInt(v2)) {
+            int a = JS_VALUE_GET_INT(v1), b = JS_VALUE_GET_INT(v2);
+            cmp = (a > b) - (a < b);
+        } else {
+            double a, b;
+            /* the elements are numbers: no exception */
+            JS_ToNumber(ctx, &a, v1);
+            JS_ToNumber(ctx, &b, v2);
+            cmp = js_sort_sub_cmp(a, b);
+        }
+        if (s->kind == JS_SORT_SUB_REV)
+            cmp = -cmp;
+        break;
+    case JS_SORT_FUNC:
+        {
+            JSValue res;
+            /* custom sort function is specified as returning 0 for identical
+             * objects: avoid method call overhead.
+             */
+            if (v1 == v2)
+                return 0;
+            if (JS_StackCheck(ctx, 4))
+                goto exception;
+            arr = JS_VALUE_TO_PTR(*s->parr);
+
+            JS_PushArg(ctx, arr->arr[i2]);
+            JS_PushArg(ctx, arr->arr[i1]); /* arg0 */
+            JS_PushArg(ctx, *s->pfunc); /* func */
+            JS_PushArg(ctx, JS_UNDEFINED); /* this */
+            res = JS_Call(ctx, 2);
+            if (JS_IsException(res))
+                goto exception;
+            if (JS_IsInt(res)) {
+                int val = JS_VALUE_GET_INT(res);
+                cmp = (val > 0) - (val < 0);
+            } else {
+                double val;
+                if (JS_ToNumber(ctx, &val, res))
+                    goto exception;
+                cmp = (val > 0) - (val < 0);
+            }
+        }
+        break;
+    default:
+        {
+            JSValue str1, str2;
+            JSGCRef str1_ref;
+
+            if (JS_IsInt(v1) && JS_IsInt(v2))
+                return js_int_string_compare(JS_VALUE_GET_INT(v1),
+                                             JS_VALUE_GET_INT(v2));
+            str1 = v1;
+            if (!JS_IsString(ctx, str1)) {
+                str1 = JS_ToString(ctx, str1);
+                if (JS_IsException(str1))
+                    goto exception;
+                arr = JS_VALUE_TO_PTR(*s->parr);
+            }
+            str2 = arr->arr[i2];
+            if (!JS_IsString(ctx, str2)) {
+                JS_PUSH_VALUE(ctx, str1);
+                str2 = JS_ToString(ctx, str2);
+                JS_POP_VALUE(ctx, str1);
+                if (JS_IsException(str2))
+                    goto exception;
+            }
+            cmp = js_string_compare(ctx, str1, str2);
+        }
+        break;
+    }
+    return cmp;
 
 exception:
     s->exception = TRUE;
     return 0;
 }
 
-static void js_array_sort_swap(size_t i1, size_t i2, void *opaque)
+static void js_array_sort_copy(size_t dst, size_t src, size_t count, void *opaque)
 {
     JSArraySortContext *s = opaque;
     JSValueArray *arr;
-    JSValue tmp, *tab;
     
     arr = JS_VALUE_TO_PTR(*s->parr);
-    tab = arr->arr;
-    tmp = tab[2 * i1];
-    tab[2 * i1] = tab[2 * i2];
-    tab[2 * i2] = tmp;
-
-    tmp = tab[2 * i1 + 1];
-    tab[2 * i1 + 1] = tab[2 * i2 + 1];
-    tab[2 * i2 + 1] = tmp;
+    memmove(arr->arr + dst, arr->arr + src, count * sizeof(JSValue));
 }
 
 JSValue js_array_sort(JSContext *ctx, JSValue *this_val,
@@ -14714,39 +16478,48 @@ JSValue js_array_sort(JSContext *ctx, JSValue *this_val,
 {
     JSValue *pfunc = &argv[0];
     JSObject *p;
-    JSValue tab_val;
+    JSValue tab_val, v;
     JSGCRef tab_val_ref;
     JSValueArray *tab, *arr;
     int i, len, n;
+    BOOL is_number;
     JSArraySortContext ss, *s = &ss;
     
     if (!JS_IsUndefined(*pfunc)) {
         if (!JS_IsFunction(ctx, *pfunc))
             return JS_ThrowTypeError(ctx, "not a function");
+        s->kind = js_get_sort_func_kind(ctx, *pfunc);
     } else {
         pfunc = NULL;
+        s->kind = JS_SORT_STRING;
     }
     p = js_get_array(ctx, *this_val);
     if (!p)
         return JS_EXCEPTION;
 
-    /* create a temporary array for sorting */
+    /* create a temporary array for sorting, followed by the temporary
+       area of the merge sort */
     len = p->u.array.len;
-    tab = js_alloc_value_array(ctx, 0, len * 2);
+    tab = js_alloc_value_array(ctx, 0, len + len / 2 + 1);
     if (!tab)
         return JS_EXCEPTION;
 
     p = JS_VALUE_TO_PTR(*this_val);
     arr = JS_VALUE_TO_PTR(p->u.array.tab);
     n = 0;
+    is_number = TRUE;
     for(i = 0; i < len; i++) {
-        if (!JS_IsUndefined(arr->arr[i])) {
-            tab->arr[2 * n] = arr->arr[i];
-            tab->arr[2 * n + 1] = JS_NewShortInt(i);
-            n++;
+        v = arr->arr[i];
+        if (!JS_IsUndefined(v)) {
+            tab->arr[n++] = v;
+            if (!JS_IsInt(v) && !JS_IsNumber(ctx, v))
+                is_number = FALSE;
         }
     }
-    /* the end of 'tab' is already filled with JS_UNDEFINED */
+    /* the comparison functions computing a - b are only equivalent to
+       a numeric comparison on numbers */
+    if ((s->kind == JS_SORT_SUB || s->kind == JS_SORT_SUB_REV) && !is_number)
+        s->kind = JS_SORT_FUNC;
     tab_val = JS_VALUE_FROM_PTR(tab);
     
     JS_PUSH_VALUE(ctx, tab_val);
@@ -14754,7 +16527,7 @@ JSValue js_array_sort(JSContext *ctx, JSValue *this_val,
     s->exception = FALSE;
     s->parr = &tab_val_ref.val;
     s->pfunc = pfunc;
-    rqsort_idx(n, js_array_sort_cmp, js_array_sort_swap, s);
+    msort_idx(n, js_array_sort_cmp, js_array_sort_copy, s);
     JS_POP_VALUE(ctx, tab_val);
     tab = JS_VALUE_TO_PTR(tab_val);
     if (s->exception) {
@@ -14767,7 +16540,7 @@ JSValue js_array_sort(JSContext *ctx, JSValue *this_val,
     /* XXX: could resize the array in case it was shrinked by the compare function */
     len = min_int(len, p->u.array.len);
     for(i = 0; i < len; i++) {
-        arr->arr[i] = tab->arr[2 * i];
+        arr->arr[i] = i < n ? tab->arr[i] : JS_UNDEFINED;
     }
     js_free(ctx, tab);
     return *this_val;
@@ -14940,12 +16713,6 @@ JSValue js_math_random(JSContext *ctx, JSValue *this_val,
 
 /* typed array */
 
-#define JS_TYPED_ARRAY_COUNT (JS_CLASS_FLOAT64_ARRAY - JS_CLASS_UINT8C_ARRAY + 1)
-
-static uint8_t typed_array_size_log2[JS_TYPED_ARRAY_COUNT] = {
-    0, 0, 0, 1, 1, 2, 2, 2, 3
-};
-
 static int JS_ToIndex(JSContext *ctx, uint64_t *plen, JSValue val)
 {
     int v;
@@ -14960,7 +16727,9 @@ static int JS_ToIndex(JSContext *ctx, uint64_t *plen, JSValue val)
     return 0;
 }
 
-JSValue js_array_buffer_alloc(JSContext *ctx, uint64_t len)
+/* if 'init_buf' is NULL, the buffer is zero initialized */
+static JSValue js_array_buffer_alloc2(JSContext *ctx, uint64_t len,
+                                      const uint8_t *init_buf)
 {
     JSByteArray *arr;
     JSValue buffer, obj;
@@ -14972,7 +16741,10 @@ JSValue js_array_buffer_alloc(JSContext *ctx, uint64_t len)
     arr = js_alloc_byte_array(ctx, len);
     if (!arr)
         return JS_EXCEPTION;
-    memset(arr->buf, 0, len);
+    if (init_buf)
+        memcpy(arr->buf, init_buf, len);
+    else
+        memset(arr->buf, 0, len);
     buffer = JS_VALUE_FROM_PTR(arr);
     JS_PUSH_VALUE(ctx, buffer);
     obj = JS_NewObjectClass(ctx, JS_CLASS_ARRAY_BUFFER, sizeof(JSArrayBuffer));
@@ -14984,6 +16756,17 @@ JSValue js_array_buffer_alloc(JSContext *ctx, uint64_t len)
     return obj;
 }
 
+JSValue js_array_buffer_alloc(JSContext *ctx, uint64_t len)
+{
+    return js_array_buffer_alloc2(ctx, len, NULL);
+}
+
+/* create an ArrayBuffer containing a copy of buf[0..len-1] */
+JSValue JS_NewArrayBufferCopy(JSContext *ctx, const uint8_t *buf, size_t len)
+{
+    return js_array_buffer_alloc2(ctx, len, buf);
+}
+
 JSValue js_array_buffer_constructor(JSContext *ctx, JSValue *this_val,
                                     int argc, JSValue *argv)
 {
@@ -15012,20 +16795,203 @@ JSValue js_typed_array_base_constructor(JSContext *ctx, JSValue *this_val,
     return JS_ThrowTypeError(ctx, "cannot be called");
 }
 
+/* TRUE if the elements of 'src_class_id' keep their value when their
+   bytes are copied to an array of class 'dst_class_id' */
+static BOOL js_typed_array_is_bytewise_copy(int dst_class_id, int src_class_id)
+{
+    if (dst_class_id == src_class_id)
+        return TRUE;
+    if (typed_array_size_log2[dst_class_id - JS_CLASS_UINT8C_ARRAY] !=
+        typed_array_size_log2[src_class_id - JS_CLASS_UINT8C_ARRAY] ||
+        dst_class_id == JS_CLASS_FLOAT32_ARRAY ||
+        src_class_id == JS_CLASS_FLOAT32_ARRAY)
+        return FALSE;
+    /* Uint8ClampedArray clamps the negative values */
+    return !(dst_class_id == JS_CLASS_UINT8C_ARRAY &&
+             src_class_id == JS_CLASS_INT8_ARRAY);
+}
+
+/* convert 'n' elements of class 'class_id' to float64 */
+static void js_typed_array_load_doubles(double *d, int class_id,
+                                        const uint8_t *ptr, size_t n)
+{
+    size_t i;
+#define LOAD_LOOP(type) for(i = 0; i < n; i++) d[i] = ((const type *)ptr)[i]
+    switch(class_id) {
+    default:
+    case JS_CLASS_UINT8C_ARRAY:
+    case JS_CLASS_UINT8_ARRAY:
+        LOAD_LOOP(uint8_t);
+        break;
+    case JS_CLASS_INT8_ARRAY:
+        LOAD_LOOP(int8_t);
+        break;
+    case JS_CLASS_INT16_ARRAY:
+        LOAD_LOOP(int16_t);
+        break;
+    case JS_CLASS_UINT16_ARRAY:
+        LOAD_LOOP(uint16_t);
+        break;
+    case JS_CLASS_INT32_ARRAY:
+        LOAD_LOOP(int32_t);
+        break;
+    case JS_CLASS_UINT32_ARRAY:
+        LOAD_LOOP(uint32_t);
+        break;
+    case JS_CLASS_FLOAT32_ARRAY:
+        LOAD_LOOP(float);
+        break;
+    case JS_CLASS_FLOAT64_ARRAY:
+        LOAD_LOOP(double);
+        break;
+    }
+#undef LOAD_LOOP
+}
+
+/* convert 'n' float64 to elements of class 'class_id' */
+static void js_typed_array_store_doubles(int class_id, uint8_t *ptr,
+                                         const double *d, size_t n)
+{
+    size_t i;
+    switch(class_id) {
+    default:
+    case JS_CLASS_UINT8C_ARRAY:
+        for(i = 0; i < n; i++)
+            ptr[i] = js_double_to_uint8_clamp(d[i]);
+        break;
+    case JS_CLASS_INT8_ARRAY:
+    case JS_CLASS_UINT8_ARRAY:
+        for(i = 0; i < n; i++)
+            ptr[i] = js_double_to_int32(d[i]);
+        break;
+    case JS_CLASS_INT16_ARRAY:
+    case JS_CLASS_UINT16_ARRAY:
+        for(i = 0; i < n; i++)
+            ((uint16_t *)ptr)[i] = js_double_to_int32(d[i]);
+        break;
+    case JS_CLASS_INT32_ARRAY:
+    case JS_CLASS_UINT32_ARRAY:
+        for(i = 0; i < n; i++)
+            ((uint32_t *)ptr)[i] = js_double_to_int32(d[i]);
+        break;
+    case JS_CLASS_FLOAT32_ARRAY:
+        for(i = 0; i < n; i++)
+            ((float *)ptr)[i] = d[i];
+        break;
+    case JS_CLASS_FLOAT64_ARRAY:
+        for(i = 0; i < n; i++)
+            ((double *)ptr)[i] = d[i];
+        break;
+    }
+}
+
+/* copy all the elements of the typed array '*psrc' to the typed array
+   '*pdst' from element 'offset'. The caller checks that they fit. The
+   same element types are copied with memmove(), the others are
+   converted by blocks through float64 so that the element classes are
+   only tested once per block. */
+static int js_typed_array_copy(JSContext *ctx, JSValue *pdst, uint32_t offset,
+                               JSValue *psrc)
+{
+    JSObject *pd, *ps;
+    JSByteArray *tmp;
+    uint8_t *dst, *src;
+    int dst_size_log2, src_size_log2;
+    uint32_t i, len, n;
+    double buf[256];
+
+    pd = JS_VALUE_TO_PTR(*pdst);
+    ps = JS_VALUE_TO_PTR(*psrc);
+    len = ps->u.typed_array.len;
+    dst_size_log2 = typed_array_size_log2[pd->class_id - JS_CLASS_UINT8C_ARRAY];
+    src_size_log2 = typed_array_size_log2[ps->class_id - JS_CLASS_UINT8C_ARRAY];
+    if (js_typed_array_is_bytewise_copy(pd->class_id, ps->class_id)) {
+        memmove(js_typed_array_get_ptr(pd) + ((size_t)offset << dst_size_log2),
+                js_typed_array_get_ptr(ps), (size_t)len << src_size_log2);
+        return 0;
+    }
+
+    tmp = NULL;
+    if (pd->u.typed_array.buffer == ps->u.typed_array.buffer) {
+        /* the source and destination may overlap: convert from a
+           copy */
+        tmp = js_alloc_byte_array(ctx, len << src_size_log2);
+        if (!tmp)
+            return -1;
+        pd = JS_VALUE_TO_PTR(*pdst);
+        ps = JS_VALUE_TO_PTR(*psrc);
+        memcpy(tmp->buf, js_typed_array_get_ptr(ps), len << src_size_log2);
+        src = tmp->buf;
+    } else {
+        src = js_typed_array_get_ptr(ps);
+    }
+    dst = js_typed_array_get_ptr(pd) + ((size_t)offset << dst_size_log2);
+    for(i = 0; i < len; i += n) {
+        n = min_uint32(len - i, countof(buf));
+        js_typed_array_load_doubles(buf, ps->class_id,
+                                    src + ((size_t)i << src_size_log2), n);
+        js_typed_array_store_doubles(pd->class_id,
+                                     dst + ((size_t)i << dst_size_log2), buf, n);
+    }
+    if (tmp)
+        js_free(ctx, tmp);
+    return 0;
+}
+
+/* copy the elements of the array like object '*psrc' to the typed
+   array '*pdst' from element 'offset' */
+static int js_typed_array_copy_from_object(JSContext *ctx, JSValue *pdst,
+                                           uint32_t offset, JSValue *psrc)
+{
+    JSObject *p;
+    JSValueArray *arr;
+    JSValue val;
+    uint32_t i, len;
+    double d;
+
+    if (js_get_length32(ctx, &len, *psrc))
+        return -1;
+    p = JS_VALUE_TO_PTR(*pdst);
+    if (len > p->u.typed_array.len - offset) {
+        JS_ThrowRangeError(ctx, "invalid length");
+        return -1;
+    }
+    for(i = 0; i < len; i++) {
+        p = JS_IsObject(ctx, *psrc) ? JS_VALUE_TO_PTR(*psrc) : NULL;
+        if (p && p->class_id == JS_CLASS_ARRAY && i < p->u.array.len) {
+            /* fast case */
+            arr = JS_VALUE_TO_PTR(p->u.array.tab);
+            val = arr->arr[i];
+        } else {
+            val = JS_GetProperty(ctx, *psrc, JS_NewShortInt(i));
+            if (JS_IsException(val))
+                return -1;
+        }
+        if (JS_ToNumber(ctx, &d, val))
+            return -1;
+        /* the length of a typed array never changes */
+        js_typed_array_set_double(JS_VALUE_TO_PTR(*pdst), offset + i, d);
+    }
+    return 0;
+}
+
 static JSValue js_typed_array_constructor_obj(JSContext *ctx, JSValue *this_val,
                                               int argc, JSValue *argv, int magic)
 {
-    int i, len;
+    int len, ret;
+    BOOL is_typed_array;
     JSValue val, obj;
     JSGCRef obj_ref;
     JSObject *p;
     
     p = JS_VALUE_TO_PTR(argv[0]);
+    is_typed_array = FALSE;
     if (p->class_id == JS_CLASS_ARRAY) {
         len = p->u.array.len;
     } else if (p->class_id >= JS_CLASS_UINT8C_ARRAY &&
                p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
         len = p->u.typed_array.len;
+        is_typed_array = TRUE;
     } else {
         return JS_ThrowTypeError(ctx, "unsupported object class");
     }
@@ -15034,18 +17000,14 @@ static JSValue js_typed_array_constructor_obj(JSContext *ctx, JSValue *this_val,
     if (JS_IsException(obj))
         return obj;
 
-    for(i = 0; i < len; i++) {
-        JS_PUSH_VALUE(ctx, obj);
-        val = JS_GetProperty(ctx, argv[0], JS_NewShortInt(i));
-        JS_POP_VALUE(ctx, obj);
-        if (JS_IsException(val))
-            return val;
-        JS_PUSH_VALUE(ctx, obj);
-        val = JS_SetPropertyInternal(ctx, obj, JS_NewShortInt(i), val, FALSE);
-        JS_POP_VALUE(ctx, obj);
-        if (JS_IsException(val))
-            return val;
-    }
+    JS_PUSH_VALUE(ctx, obj);
+    if (is_typed_array)
+        ret = js_typed_array_copy(ctx, &obj_ref.val, 0, &argv[0]);
+    else
+        ret = js_typed_array_copy_from_object(ctx, &obj_ref.val, 0, &argv[0]);
+    JS_POP_VALUE(ctx, obj);
+    if (ret)
+        return JS_EXCEPTION;
     return obj;
 }
 
@@ -15066,6 +17028,8 @@ JSValue js_typed_array_constructor(JSContext *ctx, JSValue *this_val,
         if (JS_ToIndex(ctx, &len, argv[0]))
             return JS_EXCEPTION;
         buffer = js_array_buffer_alloc(ctx, len << size_log2);
+        if (JS_IsException(buffer))
+            return buffer;
         offset = 0;
     } else {
         p = JS_VALUE_TO_PTR(argv[0]);
@@ -15123,6 +17087,35 @@ static JSObject *get_typed_array(JSContext *ctx, JSValue val)
     return p;
 }
 
+/* Return a pointer to the bytes of an ArrayBuffer or of the elements
+   of a typed array and store their length in bytes in '*plen'. Return
+   NULL if 'obj' is neither. The data is in the GC heap: the pointer is
+   only valid until the next memory allocation. */
+uint8_t *JS_GetArrayBuffer(JSContext *ctx, size_t *plen, JSValue obj)
+{
+    JSObject *p;
+    JSByteArray *arr;
+    int size_log2;
+
+    if (!JS_IsPtr(obj))
+        return NULL;
+    p = JS_VALUE_TO_PTR(obj);
+    if (p->mtag != JS_MTAG_OBJECT)
+        return NULL;
+    if (p->class_id == JS_CLASS_ARRAY_BUFFER) {
+        arr = JS_VALUE_TO_PTR(p->u.array_buffer.byte_buffer);
+        *plen = arr->size;
+        return arr->buf;
+    } else if (p->class_id >= JS_CLASS_UINT8C_ARRAY &&
+               p->class_id <= JS_CLASS_FLOAT64_ARRAY) {
+        size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+        *plen = (size_t)p->u.typed_array.len << size_log2;
+        return js_typed_array_get_ptr(p);
+    } else {
+        return NULL;
+    }
+}
+
 JSValue js_typed_array_get_length(JSContext *ctx, JSValue *this_val,
                                   int argc, JSValue *argv, int magic)
 {
@@ -15151,7 +17144,7 @@ JSValue js_typed_array_subarray(JSContext *ctx, JSValue *this_val,
 {
     JSObject *p, *p1;
     JSByteArray *arr;
-    int start, final, len;
+    int start, final, len, size_log2;
     uint32_t offset, count;
     JSValue obj;
     
@@ -15171,10 +17164,11 @@ JSValue js_typed_array_subarray(JSContext *ctx, JSValue *this_val,
     offset = p->u.typed_array.offset + start;
     count = max_int(final - start, 0);
 
-    /* check offset and count */
+    /* check offset and count (in bytes) */
     p1 = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
     arr = JS_VALUE_TO_PTR(p1->u.array_buffer.byte_buffer);
-    if (offset + count >= arr->size)
+    size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+    if ((((uint64_t)offset + count) << size_log2) > arr->size)
         return JS_ThrowRangeError(ctx, "invalid length");
         
     obj = JS_NewObjectClass(ctx, p->class_id, sizeof(JSTypedArray));
@@ -15188,118 +17182,1172 @@ JSValue js_typed_array_subarray(JSContext *ctx, JSValue *this_val,
     return obj;
 }
 
-/* Date */
+typedef struct {
+    JSContext *ctx;
+    BOOL exception;
+    JSSortKindEnum kind;
+    int class_id;
+    int size_log2;
+    size_t len;
+    JSValue *pobj; /* typed array */
+    JSValue *ptmp; /* byte array containing the temporary area */
+    JSValue *pfunc;
+} JSTypedArraySortContext;
+
+/* the pointers are only valid until the next memory allocation */
+static uint8_t *js_typed_array_sort_ptr(JSTypedArraySortContext *s, size_t i)
+{
+    JSObject *p, *pbuffer;
+    JSByteArray *arr;
+
+    if (i < s->len) {
+        p = JS_VALUE_TO_PTR(*s->pobj);
+        pbuffer = JS_VALUE_TO_PTR(p->u.typed_array.buffer);
+        arr = JS_VALUE_TO_PTR(pbuffer->u.array_buffer.byte_buffer);
+        i += p->u.typed_array.offset;
+    } else {
+        arr = JS_VALUE_TO_PTR(*s->ptmp);
+        i -= s->len;
+    }
+    return arr->buf + (i << s->size_log2);
+}
+
+static int js_typed_array_sort_cmp(size_t i1, size_t i2, void *opaque)
+{
+    JSTypedArraySortContext *s = opaque;
+    JSContext *ctx = s->ctx;
+    double a, b, val;
+    JSValue v, res;
+
+    if (s->exception)
+        return 0;
+    a = js_typed_array_get_double(s->class_id, js_typed_array_sort_ptr(s, i1));
+    b = js_typed_array_get_double(s->class_id, js_typed_array_sort_ptr(s, i2));
+    switch(s->kind) {
+    case JS_SORT_SUB:
+        return js_sort_sub_cmp(a, b);
+    case JS_SORT_SUB_REV:
+        return js_sort_sub_cmp(b, a);
+    case JS_SORT_FUNC:
+        if (JS_StackCheck(ctx, 4))
+            goto exception;
+        /* the stack space is reserved: the pushed values are GC roots */
+        v = JS_NewFloat64(ctx, b);
+        if (JS_IsException(v))
+            goto exception;
+        JS_PushArg(ctx, v);
+        v = JS_NewFloat64(ctx, a);
+        if (JS_IsException(v)) {
+            JS_PopArg(ctx);
+            goto exception;
+        }
+        JS_PushArg(ctx, v); /* arg0 */
+        JS_PushArg(ctx, *s->pfunc); /* func */
+        JS_PushArg(ctx, JS_UNDEFINED); /* this */
+        res = JS_Call(ctx, 2);
+        if (JS_IsException(res))
+            goto exception;
+        if (JS_IsInt(res)) {
+            int r = JS_VALUE_GET_INT(res);
+            return (r > 0) - (r < 0);
+        }
+        if (JS_ToNumber(ctx, &val, res))
+            goto exception;
+        return (val > 0) - (val < 0);
+    default:
+        return js_sort_number_cmp(a, b);
+    }
+ exception:
+    s->exception = TRUE;
+    return 0;
+}
+
+static void js_typed_array_sort_copy(size_t dst, size_t src, size_t count, void *opaque)
+{
+    JSTypedArraySortContext *s = opaque;
+    memmove(js_typed_array_sort_ptr(s, dst), js_typed_array_sort_ptr(s, src),
+            count << s->size_log2);
+}
+
+JSValue js_typed_array_sort(JSContext *ctx, JSValue *this_val,
+                            int argc, JSValue *argv)
+{
+    JSObject *p;
+    JSByteArray *tmp;
+    JSValue tmp_val;
+    JSGCRef tmp_val_ref;
+    JSTypedArraySortContext ss, *s = &ss;
+
+    p = get_typed_array(ctx, *this_val);
+    if (!p)
+        return JS_EXCEPTION;
+    if (!JS_IsUndefined(argv[0])) {
+        if (!JS_IsFunction(ctx, argv[0]))
+            return JS_ThrowTypeError(ctx, "not a function");
+        s->kind = js_get_sort_func_kind(ctx, argv[0]);
+    } else {
+        s->kind = JS_SORT_NUMBER;
+    }
+    p = JS_VALUE_TO_PTR(*this_val);
+    s->len = p->u.typed_array.len;
+    if (s->len < 2)
+        return *this_val;
+    s->class_id = p->class_id;
+    s->size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+
+    /* temporary area of the merge sort */
+    tmp = js_alloc_byte_array(ctx, (s->len / 2 + 1) << s->size_log2);
+    if (!tmp)
+        return JS_EXCEPTION;
+    tmp_val = JS_VALUE_FROM_PTR(tmp);
+
+    JS_PUSH_VALUE(ctx, tmp_val);
+    s->ctx = ctx;
+    s->exception = FALSE;
+    s->pobj = this_val;
+    s->ptmp = &tmp_val_ref.val;
+    s->pfunc = &argv[0];
+    msort_idx(s->len, js_typed_array_sort_cmp, js_typed_array_sort_copy, s);
+    JS_POP_VALUE(ctx, tmp_val);
+    js_free(ctx, JS_VALUE_TO_PTR(tmp_val));
+    if (s->exception)
+        return JS_EXCEPTION;
+    return *this_val;
+}
+
+JSValue js_typed_array_set(JSContext *ctx, JSValue *this_val,
+                           int argc, JSValue *argv)
+{
+    JSObject *p, *p1;
+    int offset, ret;
+
+    p = get_typed_array(ctx, *this_val);
+    if (!p)
+        return JS_EXCEPTION;
+    offset = 0;
+    if (argc > 1) {
+        if (JS_ToInt32Sat(ctx, &offset, argv[1]))
+            return JS_EXCEPTION;
+        if (offset < 0)
+            return JS_ThrowRangeError(ctx, "invalid offset");
+    }
+    /* ToObject(source): there are no wrapper objects, so primitives are
+       read as array-likes (a number has no length, a string has one element
+       per character) */
+    if (JS_IsUndefined(argv[0]) || JS_IsNull(argv[0]))
+        return JS_ThrowTypeError(ctx, "cannot convert to object");
+    p = JS_VALUE_TO_PTR(*this_val);
+    if (offset > p->u.typed_array.len)
+        return JS_ThrowRangeError(ctx, "invalid offset");
+    p1 = JS_IsObject(ctx, argv[0]) ? JS_VALUE_TO_PTR(argv[0]) : NULL;
+    if (p1 && p1->class_id >= JS_CLASS_UINT8C_ARRAY &&
+        p1->class_id <= JS_CLASS_FLOAT64_ARRAY) {
+        if (p1->u.typed_array.len > p->u.typed_array.len - offset)
+            return JS_ThrowRangeError(ctx, "invalid length");
+        ret = js_typed_array_copy(ctx, this_val, offset, &argv[0]);
+    } else {
+        ret = js_typed_array_copy_from_object(ctx, this_val, offset, &argv[0]);
+    }
+    if (ret)
+        return JS_EXCEPTION;
+    return JS_UNDEFINED;
+}
+
+JSValue js_typed_array_fill(JSContext *ctx, JSValue *this_val,
+                            int argc, JSValue *argv)
+{
+    JSObject *p;
+    int len, start, final, size_log2, i, count;
+    double d;
+    uint8_t *ptr;
+    union {
+        uint8_t u8[8];
+        uint16_t u16;
+        uint32_t u32;
+        uint64_t u64;
+    } v;
+
+    p = get_typed_array(ctx, *this_val);
+    if (!p)
+        return JS_EXCEPTION;
+    len = p->u.typed_array.len;
+    if (JS_ToNumber(ctx, &d, argv[0]))
+        return JS_EXCEPTION;
+    start = 0;
+    if (argc > 1) {
+        if (JS_ToInt32Clamp(ctx, &start, argv[1], 0, len, len))
+            return JS_EXCEPTION;
+    }
+    final = len;
+    if (argc > 2 && !JS_IsUndefined(argv[2])) {
+        if (JS_ToInt32Clamp(ctx, &final, argv[2], 0, len, len))
+            return JS_EXCEPTION;
+    }
+    count = final - start;
+    if (count <= 0)
+        return *this_val;
+
+    /* convert the value once, then replicate its bytes */
+    p = JS_VALUE_TO_PTR(*this_val);
+    size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+    v.u64 = 0;
+    js_typed_array_store_double(p->class_id, v.u8, d);
+    ptr = js_typed_array_get_ptr(p) + ((size_t)start << size_log2);
+    if (!memcmp(v.u8, v.u8 + 1, (1 << size_log2) - 1)) {
+        /* all the bytes are identical (e.g. zero) */
+        memset(ptr, v.u8[0], (size_t)count << size_log2);
+    } else {
+        switch(size_log2) {
+        case 1:
+            for(i = 0; i < count; i++)
+                ((uint16_t *)ptr)[i] = v.u16;
+            break;
+        case 2:
+            for(i = 0; i < count; i++)
+                ((uint32_t *)ptr)[i] = v.u32;
+            break;
+        default:
+            for(i = 0; i < count; i++)
+                ((uint64_t *)ptr)[i] = v.u64;
+            break;
+        }
+    }
+    return *this_val;
+}
+
+JSValue js_typed_array_slice(JSContext *ctx, JSValue *this_val,
+                             int argc, JSValue *argv)
+{
+    JSObject *p, *p1;
+    int start, final, len, count, size_log2;
+    JSValue val, obj;
+
+    p = get_typed_array(ctx, *this_val);
+    if (!p)
+        return JS_EXCEPTION;
+    len = p->u.typed_array.len;
+    if (JS_ToInt32Clamp(ctx, &start, argv[0], 0, len, len))
+        return JS_EXCEPTION;
+    final = len;
+    if (!JS_IsUndefined(argv[1])) {
+        if (JS_ToInt32Clamp(ctx, &final, argv[1], 0, len, len))
+            return JS_EXCEPTION;
+    }
+    count = max_int(final - start, 0);
+
+    p = JS_VALUE_TO_PTR(*this_val);
+    val = JS_NewShortInt(count);
+    obj = js_typed_array_constructor(ctx, NULL, 1 | FRAME_CF_CTOR, &val,
+                                     p->class_id);
+    if (JS_IsException(obj))
+        return obj;
+    p = JS_VALUE_TO_PTR(*this_val);
+    p1 = JS_VALUE_TO_PTR(obj);
+    size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+    memcpy(js_typed_array_get_ptr(p1),
+           js_typed_array_get_ptr(p) + ((size_t)start << size_log2),
+           (size_t)count << size_log2);
+    return obj;
+}
+
+JSValue js_typed_array_copyWithin(JSContext *ctx, JSValue *this_val,
+                                  int argc, JSValue *argv)
+{
+    JSObject *p;
+    int len, to, from, final, count, size_log2;
+    uint8_t *ptr;
+
+    p = get_typed_array(ctx, *this_val);
+    if (!p)
+        return JS_EXCEPTION;
+    len = p->u.typed_array.len;
+    if (JS_ToInt32Clamp(ctx, &to, argv[0], 0, len, len))
+        return JS_EXCEPTION;
+    if (JS_ToInt32Clamp(ctx, &from, argv[1], 0, len, len))
+        return JS_EXCEPTION;
+    final = len;
+    if (argc > 2 && !JS_IsUndefined(argv[2])) {
+        if (JS_ToInt32Clamp(ctx, &final, argv[2], 0, len, len))
+            return JS_EXCEPTION;
+    }
+    count = min_int(final - from, len - to);
+    if (count > 0) {
+        p = JS_VALUE_TO_PTR(*this_val);
+        size_log2 = typed_array_size_log2[p->class_id - JS_CLASS_UINT8C_ARRAY];
+        ptr = js_typed_array_get_ptr(p);
+        memmove(ptr + ((size_t)to << size_log2),
+                ptr + ((size_t)from << size_log2),
+                (size_t)count << size_log2);
+    }
+    return *this_val;
+}
+
+/* Date */
+
+JSValue js_date_constructor(JSContext *ctx, JSValue *this_val,
+                            int argc, JSValue *argv)
+{
+    return JS_ThrowTypeError(ctx, "only Date.now() is supported");
+}
+
+/* global */
+
+JSValue js_global_eval(JSContext *ctx, JSValue *this_val,
+                       int argc, JSValue *argv)
+{
+    JSValue val;
+    
+    if (!JS_IsString(ctx, argv[0]))
+        return argv[0];
+    val = JS_Parse2(ctx, argv[0], NULL, 0, "<input>", JS_EVAL_RETVAL);
+    if (JS_IsException(val))
+        return val;
+    return JS_Run(ctx, val);
+}
+
+JSValue js_global_isNaN(JSContext *ctx, JSValue *this_val,
+                        int argc, JSValue *argv)
+{
+    double d;
+    if (unlikely(JS_ToNumber(ctx, &d, argv[0])))
+        return JS_EXCEPTION;
+    return JS_NewBool(isnan(d));
+}
+
+JSValue js_global_isFinite(JSContext *ctx, JSValue *this_val,
+                                  int argc, JSValue *argv)
+{
+    double d;
+    if (unlikely(JS_ToNumber(ctx, &d, argv[0])))
+        return JS_EXCEPTION;
+    return JS_NewBool(isfinite(d));
+}
+
+/* JSON */
+
+/* JSON.parse() does not use the JavaScript parser: it works directly
+   on the UTF-8 bytes of the source. The values are accumulated on the
+   stack and each object or array is built in one step when it is
+   closed, so that the nesting depth is only limited by the stack
+   size. */
+
+typedef struct {
+    JSContext *ctx;
+    JSGCRef source_ref; /* source string or JS_NULL */
+    const uint8_t *input; /* source if source_ref.val is JS_NULL */
+    JSStringCharBuf source_cbuf;
+    const uint8_t *buf; /* source bytes: reloaded after each allocation */
+    size_t buf_len;
+    size_t pos;
+    const char *filename;
+} JSONParseState;
+
+#define JSON_STR_ESCAPE    (1 << 0) /* contains escape sequences */
+#define JSON_STR_NON_ASCII (1 << 1) /* contains non ASCII characters */
+
+static void json_reload(JSONParseState *s)
+{
+    JSString *p;
+    if (JS_IsNull(s->source_ref.val)) {
+        s->buf = s->input;
+    } else {
+        p = get_string_ptr(s->ctx, &s->source_cbuf, s->source_ref.val);
+        s->buf = p->buf;
+    }
+}
+
+static void json_skip_spaces(JSONParseState *s)
+{
+    s->pos += json_skip_ws(s->buf + s->pos, s->buf_len - s->pos);
+}
+
+/* throw a syntax error at the current position */
+static JSValue json_parse_error(JSONParseState *s, const char *msg)
+{
+    JSContext *ctx = s->ctx;
+    int line_num, col_num;
+    JSValue val;
+
+    line_num = get_line_col(&col_num, s->buf, s->pos);
+    val = JS_ThrowError(ctx, JS_CLASS_SYNTAX_ERROR, "%s", msg);
+    build_backtrace(ctx, ctx->current_exception, s->filename,
+                    line_num + 1, col_num + 1, 0);
+    return val;
+}
+
+/* reserve stack space for 'n' values. Return -1 if exception. */
+static int json_stack_reserve(JSONParseState *s, int n)
+{
+    JSContext *ctx = s->ctx;
+    if (likely(ctx->sp - ctx->stack_bottom >= JS_STACK_SLACK + n))
+        return 0;
+    if (JS_StackCheck(ctx, n + 64))
+        return -1;
+    json_reload(s);
+    return 0;
+}
+
+static int json_get_hex4(const uint8_t *p, size_t len)
+{
+    int c, h, i;
+    if (len < 4)
+        return -1;
+    c = 0;
+    for(i = 0; i < 4; i++) {
+        h = from_hex(p[i]);
+        if (h < 0)
+            return -1;
+        c = (c << 4) | h;
+    }
+    return c;
+}
+
+/* Scan the string starting after the quote at s->pos. If 'dst' is not
+   NULL, the decoded UTF-8 bytes are written to it. Return 0 and set
+   s->pos after the closing quote, or -1 with the error message in
+   *pmsg and s->pos at the error position. */
+static int json_scan_string(JSONParseState *s, uint8_t *dst, size_t *plen,
+                            int *pflags, const char **pmsg)
+{
+    const uint8_t *buf = s->buf;
+    size_t pos, len, n, clen, out_len;
+    int c, high, flags;
+    uint8_t tmp[UTF8_CHAR_LEN_MAX];
+
+    pos = s->pos;
+    len = s->buf_len;
+    out_len = 0;
+    flags = 0;
+    high = 0; /* previous character if it is a high surrogate */
+    for(;;) {
+        n = json_string_span(buf + pos, len - pos, TRUE);
+        if (n != 0) {
+            if (dst)
+                memcpy(dst + out_len, buf + pos, n);
+            out_len += n;
+            pos += n;
+            high = 0;
+        }
+        if (pos >= len) {
+            *pmsg = "unexpected end of string";
+            goto fail;
+        }
+        c = buf[pos];
+        if (c == '\"') {
+            pos++;
+            break;
+        } else if (c == '\\') {
+            flags |= JSON_STR_ESCAPE;
+            if (pos + 1 >= len) {
+                pos = len;
+                *pmsg = "unexpected end of string";
+                goto fail;
+            }
+            switch(buf[pos + 1]) {
+            case '\"':
+            case '\\':
+            case '/':
+                c = buf[pos + 1];
+                break;
+            case 'b':
+                c = '\b';
+                break;
+            case 'f':
+                c = '\f';
+                break;
+            case 'n':
+                c = '\n';
+                break;
+            case 'r':
+                c = '\r';
+                break;
+            case 't':
+                c = '\t';
+                break;
+            case 'u':
+                c = json_get_hex4(buf + pos + 2, len - pos - 2);
+                if (c < 0)
+                    goto invalid_escape;
+                pos += 6;
+                goto put_char;
+            default:
+            invalid_escape:
+                *pmsg = "invalid escape sequence";
+                goto fail;
+            }
+            pos += 2;
+        } else if (c < 0x20) {
+            *pmsg = "invalid character in string";
+            goto fail;
+        } else {
+            c = unicode_from_utf8(buf + pos, len - pos, &clen);
+            if (c < 0) {
+                *pmsg = "invalid UTF-8";
+                goto fail;
+            }
+            pos += clen;
+            if (c < 0xd800 || c >= 0xe000) {
+                flags |= JSON_STR_NON_ASCII;
+                if (dst)
+                    memcpy(dst + out_len, buf + pos - clen, clen);
+                out_len += clen;
+                high = 0;
+                continue;
+            }
+        }
+    put_char:
+        if (c >= 0x80)
+            flags |= JSON_STR_NON_ASCII;
+        if (c >= 0xdc00 && c < 0xe000 && high != 0) {
+            /* contract the surrogate pair to 4 bytes */
+            c = 0x10000 + ((high & 0x3ff) << 10) + (c & 0x3ff);
+            out_len -= 3;
+        }
+        out_len += unicode_to_utf8(dst ? dst + out_len : tmp, c);
+        if (c >= 0xd800 && c < 0xdc00)
+            high = c;
+        else
+            high = 0;
+    }
+    s->pos = pos;
+    *plen = out_len;
+    *pflags = flags;
+    return 0;
+ fail:
+    s->pos = pos;
+    return -1;
+}
+
+/* Return the unique string of the ASCII property key 'buf' if it
+   already exists, JS_NULL otherwise. Nothing is allocated, which
+   avoids creating a temporary string for the common keys. */
+static JSValue json_find_key(JSContext *ctx, const uint8_t *buf, size_t len)
+{
+    const JSValueArray *arr;
+    JSStringCharBuf cbuf;
+    JSString *p;
+    uint32_t *entry;
+    int i, a, b, m, r;
+
+    if (len == 0)
+        return js_get_atom(ctx, JS_ATOM_empty);
+    /* may be an integer key */
+    if (is_num(buf[0]) || buf[0] == '-' || len > JS_STRING_LEN_MAX)
+        return JS_NULL;
+    if (len == 1)
+        return JS_NewStringChar(buf[0]);
+
+    if (!JS_IsNull(ctx->unique_strings_hash)) {
+        entry = unique_strings_hash_find(ctx, buf, len,
+                                         hash_string_bytes(buf, len));
+        if (*entry != 0) {
+            arr = JS_VALUE_TO_PTR(ctx->unique_strings);
+            return arr->arr[*entry - 1];
+        }
+    }
+
+    /* same order as js_string_compare() because 'buf' is ASCII */
+    for(i = 0; i < ctx->n_rom_atom_tables; i++) {
+        arr = ctx->rom_atom_tables[i];
+        if (!arr)
+            continue;
+        a = 0;
+        b = arr->size - 1;
+        while (a <= b) {
+            m = (a + b) >> 1;
+            p = get_string_ptr(ctx, &cbuf, arr->arr[m]);
+            r = memcmp(buf, p->buf, min_int(len, p->len));
+            if (r == 0)
+                r = (len > p->len) - (len < p->len);
+            if (r == 0)
+                return arr->arr[m];
+            else if (r < 0)
+                b = m - 1;
+            else
+                a = m + 1;
+        }
+    }
+    return JS_NULL;
+}
+
+/* parse the string starting after the quote at s->pos. If 'is_key'
+   is TRUE, the corresponding property key is returned. */
+static JSValue json_parse_string(JSONParseState *s, BOOL is_key)
+{
+    JSContext *ctx = s->ctx;
+    size_t start, end, len, clen;
+    const char *msg;
+    uint8_t tmp[4];
+    JSString *p;
+    JSValue val;
+    int flags;
+
+    start = s->pos;
+    if (json_scan_string(s, NULL, &len, &flags, &msg))
+        return json_parse_error(s, msg);
+    end = s->pos;
+
+    if (!(flags & JSON_STR_ESCAPE)) {
+        if (is_key && !(flags & JSON_STR_NON_ASCII)) {
+            val = json_find_key(ctx, s->buf + start, len);
+            if (!JS_IsNull(val))
+                return val;
+        }
+        if (len <= sizeof(tmp))
+            memcpy(tmp, s->buf + start, len);
+    } else if (len <= sizeof(tmp)) {
+        s->pos = start;
+        json_scan_string(s, tmp, &len, &flags, &msg);
+    }
+    if (len == 0) {
+        return js_get_atom(ctx, JS_ATOM_empty);
+    } else if (len <= sizeof(tmp) && utf8_char_len(tmp[0]) == len) {
+        val = JS_NewStringChar(utf8_get(tmp, &clen));
+    } else {
+        p = js_alloc_string(ctx, len);
+        if (!p)
+            return JS_EXCEPTION;
+        json_reload(s);
+        if (len <= sizeof(tmp)) {
+            memcpy(p->buf, tmp, len);
+        } else if (!(flags & JSON_STR_ESCAPE)) {
+            memcpy(p->buf, s->buf + start, len);
+        } else {
+            s->pos = start;
+            json_scan_string(s, p->buf, &len, &flags, &msg);
+        }
+        p->is_ascii = !(flags & JSON_STR_NON_ASCII);
+        val = JS_VALUE_FROM_PTR(p);
+    }
+    s->pos = end;
+    if (is_key)
+        val = JS_ToPropertyKey(ctx, val);
+    return val;
+}
+
+static const double json_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* the integers are returned directly. The other numbers are computed
+   exactly from their mantissa when it has at most 53 bits and the
+   power of ten is exact, otherwise js_atod() is used. */
+static JSValue json_parse_number(JSONParseState *s)
+{
+    JSContext *ctx = s->ctx;
+    const uint8_t *buf = s->buf;
+    size_t pos, start, len;
+    uint64_t mant;
+    int n_digits, exp10, e, c, is_neg, is_int, is_exp_neg;
+    double d;
+
+    pos = s->pos;
+    len = s->buf_len;
+    is_neg = (buf[pos] == '-');
+    pos += is_neg;
+    start = pos;
+    if (pos >= len || !is_num(buf[pos]))
+        goto fail;
+    mant = 0;
+    n_digits = 0; /* number of significant digits */
+    exp10 = 0;
+    is_int = TRUE;
+    if (buf[pos] == '0') {
+        pos++;
+        /* no leading zeros */
+        if (pos < len && is_num(buf[pos]))
+            goto fail;
+    } else {
+        while (pos < len && is_num(buf[pos])) {
+            if (n_digits < 19)
+                mant = mant * 10 + (buf[pos] - '0');
+            n_digits++;
+            pos++;
+        }
+    }
+    if (pos < len && buf[pos] == '.') {
+        pos++;
+        is_int = FALSE;
+        if (pos >= len || !is_num(buf[pos]))
+            goto fail;
+        while (pos < len && is_num(buf[pos])) {
+            c = buf[pos] - '0';
+            if (n_digits != 0 || c != 0) {
+                if (n_digits < 19)
+                    mant = mant * 10 + c;
+                n_digits++;
+            }
+            exp10--;
+            pos++;
+        }
+    }
+    if (pos < len && (buf[pos] == 'e' || buf[pos] == 'E')) {
+        pos++;
+        is_int = FALSE;
+        is_exp_neg = FALSE;
+        if (pos < len && (buf[pos] == '+' || buf[pos] == '-')) {
+            is_exp_neg = (buf[pos] == '-');
+            pos++;
+        }
+        if (pos >= len || !is_num(buf[pos]))
+            goto fail;
+        e = 0;
+        while (pos < len && is_num(buf[pos])) {
+            if (e < 100000)
+                e = e * 10 + (buf[pos] - '0');
+            pos++;
+        }
+        if (is_exp_neg)
+            e = -e;
+        exp10 += e;
+    }
+    s->pos = pos;
+
+    if (is_int && n_digits <= 10 && mant <= JS_SHORTINT_MAX + is_neg &&
+        !(is_neg && mant == 0)) {
+        return JS_NewShortInt(is_neg ? -(int64_t)mant : (int64_t)mant);
+    } else if (n_digits == 0) {
+        d = 0;
+    } else if (n_digits <= 19 && mant <= ((uint64_t)1 << 53) &&
+               exp10 >= -22 && exp10 <= 22) {
+        d = (double)mant;
+        if (exp10 < 0)
+            d /= json_pow10[-exp10];
+        else
+            d *= json_pow10[exp10];
+    } else {
+        JSByteArray *tmp_arr;
+        char *str;
+        const char *next;
+
+        /* js_atod() needs a zero terminated string */
+        len = pos - start;
+        tmp_arr = js_alloc_byte_array(ctx, sizeof(JSATODTempMem) + len + 1);
+        if (!tmp_arr)
+            return JS_EXCEPTION;
+        json_reload(s);
+        str = (char *)tmp_arr->buf + sizeof(JSATODTempMem);
+        memcpy(str, s->buf + start, len);
+        str[len] = '\0';
+        d = js_atod(str, &next, 10, 0, (JSATODTempMem *)tmp_arr->buf);
+        js_free(ctx, tmp_arr);
+    }
+    if (is_neg)
+        d = -d;
+    return JS_NewFloat64(ctx, d);
+ fail:
+    s->pos = pos;
+    return json_parse_error(s, "invalid number literal");
+}
+
+/* build the object whose 'n' (key, value) pairs are below 'sp' */
+static JSValue json_build_object(JSContext *ctx, JSValue *sp, int n)
+{
+    JSValue obj, ret;
+    JSGCRef obj_ref;
+    int i;
+
+    obj = JS_NewObjectPrealloc(ctx, n);
+    if (JS_IsException(obj))
+        return obj;
+    for(i = 0; i < n; i++) {
+        JS_PUSH_VALUE(ctx, obj);
+        ret = JS_DefinePropertyValue(ctx, obj, sp[-1 - 2 * i], sp[-2 - 2 * i]);
+        JS_POP_VALUE(ctx, obj);
+        if (JS_IsException(ret))
+            return ret;
+    }
+    return obj;
+}
+
+/* build the array whose 'n' elements are below 'sp' */
+static JSValue json_build_array(JSContext *ctx, JSValue *sp, int n)
+{
+    JSValue val;
+    JSValueArray *arr;
+    JSObject *p;
+    int i;
+
+    val = JS_NewArray(ctx, n);
+    if (JS_IsException(val) || n == 0)
+        return val;
+    p = JS_VALUE_TO_PTR(val);
+    arr = JS_VALUE_TO_PTR(p->u.array.tab);
+    for(i = 0; i < n; i++)
+        arr->arr[i] = sp[-1 - i];
+    return val;
+}
+
+static BOOL json_match(JSONParseState *s, const char *str, size_t len)
+{
+    if (s->buf_len - s->pos < len || memcmp(s->buf + s->pos, str, len))
+        return FALSE;
+    s->pos += len;
+    return TRUE;
+}
+
+/* source_str must be a string or JS_NULL. (input, input_len) is
+   meaningful only if source_str is JS_NULL. */
+static JSValue js_json_parse_source(JSContext *ctx, JSValue source_str,
+                                    const uint8_t *input, size_t input_len,
+                                    const char *filename)
+{
+    JSONParseState s_s, *s = &s_s;
+    JSValue *stack_top, *saved_stack_bottom, *frame_sp, val;
+    int frame, c, tag;
+    BOOL is_object;
+
+    s->ctx = ctx;
+    s->input = input;
+    s->filename = filename;
+    s->pos = 0;
+    *JS_PushGCRef(ctx, &s->source_ref) = source_str;
+    if (JS_IsNull(source_str)) {
+        s->buf_len = input_len;
+    } else {
+        s->buf_len = get_string_ptr(ctx, &s->source_cbuf, source_str)->len;
+    }
+    json_reload(s);
+
+    stack_top = ctx->sp;
+    saved_stack_bottom = ctx->stack_bottom;
+    /* The current object or array is represented by a frame slot
+       containing the position of the parent frame and whether it is
+       an object. Its elements, or its (key, value) pairs, are pushed
+       after it. 'frame' is the position of the frame slot relative to
+       stack_top, 0 if none. */
+    frame = 0;
+
+ value:
+    if (json_stack_reserve(s, 1))
+        goto fail;
+    json_skip_spaces(s);
+    if (s->pos >= s->buf_len) {
+        json_parse_error(s, "unexpected end of input");
+        goto fail;
+    }
+    c = s->buf[s->pos];
+    switch(c) {
+    case '{':
+    case '[':
+        s->pos++;
+        *--ctx->sp = JS_NewShortInt(frame * 2 + (c == '{'));
+        frame = stack_top - ctx->sp;
+        json_skip_spaces(s);
+        if (s->pos < s->buf_len && s->buf[s->pos] == (c == '{' ? '}' : ']')) {
+            s->pos++;
+            goto close;
+        }
+        if (c == '{')
+            goto key;
+        else
+            goto value;
+    case '\"':
+        s->pos++;
+        val = json_parse_string(s, FALSE);
+        break;
+    case 't':
+        if (!json_match(s, "true", 4))
+            goto unexpected_char;
+        val = JS_TRUE;
+        break;
+    case 'f':
+        if (!json_match(s, "false", 5))
+            goto unexpected_char;
+        val = JS_FALSE;
+        break;
+    case 'n':
+        if (!json_match(s, "null", 4))
+            goto unexpected_char;
+        val = JS_NULL;
+        break;
+    default:
+        if (c != '-' && !is_num(c)) {
+        unexpected_char:
+            json_parse_error(s, "unexpected character");
+            goto fail;
+        }
+        val = json_parse_number(s);
+        break;
+    }
+    if (JS_IsException(val))
+        goto fail;
+    json_reload(s);
+    *--ctx->sp = val;
+
+ next:
+    if (frame == 0)
+        goto done;
+    is_object = JS_VALUE_GET_INT(stack_top[-frame]) & 1;
+    json_skip_spaces(s);
+    c = (s->pos < s->buf_len) ? s->buf[s->pos] : '\0';
+    if (c == ',') {
+        s->pos++;
+        if (is_object)
+            goto key;
+        else
+            goto value;
+    } else if (c == (is_object ? '}' : ']')) {
+        s->pos++;
+        goto close;
+    } else {
+        json_parse_error(s, is_object ? "expecting '}'" : "expecting ']'");
+        goto fail;
+    }
+
+ key:
+    if (json_stack_reserve(s, 1))
+        goto fail;
+    json_skip_spaces(s);
+    if (s->pos >= s->buf_len || s->buf[s->pos] != '\"') {
+        json_parse_error(s, "expecting '\"'");
+        goto fail;
+    }
+    s->pos++;
+    val = json_parse_string(s, TRUE);
+    if (JS_IsException(val))
+        goto fail;
+    json_reload(s);
+    *--ctx->sp = val;
+    json_skip_spaces(s);
+    if (s->pos >= s->buf_len || s->buf[s->pos] != ':') {
+        json_parse_error(s, "expecting ':'");
+        goto fail;
+    }
+    s->pos++;
+    goto value;
+
+ close:
+    frame_sp = stack_top - frame;
+    tag = JS_VALUE_GET_INT(*frame_sp);
+    if (tag & 1)
+        val = json_build_object(ctx, frame_sp, (frame_sp - ctx->sp) / 2);
+    else
+        val = json_build_array(ctx, frame_sp, frame_sp - ctx->sp);
+    if (JS_IsException(val))
+        goto fail;
+    json_reload(s);
+    ctx->sp = frame_sp;
+    *ctx->sp = val;
+    frame = tag >> 1;
+    goto next;
 
-JSValue js_date_constructor(JSContext *ctx, JSValue *this_val,
-                            int argc, JSValue *argv)
-{
-    return JS_ThrowTypeError(ctx, "only Date.now() is supported");
+ done:
+    json_skip_spaces(s);
+    if (s->pos != s->buf_len) {
+        json_parse_error(s, "unexpected character");
+        goto fail;
+    }
+    val = ctx->sp[0];
+    ctx->sp = stack_top;
+    ctx->stack_bottom = saved_stack_bottom;
+    JS_PopGCRef(ctx, &s->source_ref);
+    return val;
+ fail:
+    ctx->sp = stack_top;
+    ctx->stack_bottom = saved_stack_bottom;
+    JS_PopGCRef(ctx, &s->source_ref);
+    return JS_EXCEPTION;
 }
 
-/* global */
-
-JSValue js_global_eval(JSContext *ctx, JSValue *this_val,
-                       int argc, JSValue *argv)
+JSValue js_json_parse(JSContext *ctx, JSValue *this_val,
+                      int argc, JSValue *argv)
 {
     JSValue val;
-    
-    if (!JS_IsString(ctx, argv[0]))
-        return argv[0];
-    val = JS_Parse2(ctx, argv[0], NULL, 0, "<input>", JS_EVAL_RETVAL);
+
+    val = JS_ToString(ctx, argv[0]);
     if (JS_IsException(val))
         return val;
-    return JS_Run(ctx, val);
+    return js_json_parse_source(ctx, val, NULL, 0, "<input>");
 }
 
-JSValue js_global_isNaN(JSContext *ctx, JSValue *this_val,
-                        int argc, JSValue *argv)
+/* Return a pointer to 'n' free bytes at the end of the string buffer
+   or NULL in case of exception. They must be written before the next
+   allocation and s->len must be updated. */
+static uint8_t *string_buffer_reserve(JSContext *ctx, StringBuffer *s, int n)
 {
-    double d;
-    if (unlikely(JS_ToNumber(ctx, &d, argv[0])))
-        return JS_EXCEPTION;
-    return JS_NewBool(isnan(d));
-}
+    JSStringCharBuf buf;
+    JSByteArray *arr;
+    JSString *p;
+    JSValue str;
+    JSGCRef str_ref;
+    int len;
 
-JSValue js_global_isFinite(JSContext *ctx, JSValue *this_val,
-                                  int argc, JSValue *argv)
-{
-    double d;
-    if (unlikely(JS_ToNumber(ctx, &d, argv[0])))
-        return JS_EXCEPTION;
-    return JS_NewBool(isfinite(d));
+    if (JS_IsException(s->buffer))
+        return NULL;
+    if (JS_IsString(ctx, s->buffer)) {
+        /* single string in buffer: copy it to a byte array */
+        str = s->buffer;
+        len = get_string_ptr(ctx, &buf, str)->len;
+        if ((int64_t)len + n > JS_STRING_LEN_MAX)
+            goto too_long;
+        JS_PUSH_VALUE(ctx, str);
+        arr = js_alloc_byte_array(ctx, len + n + 1);
+        JS_POP_VALUE(ctx, str);
+        if (!arr) {
+            s->buffer = JS_EXCEPTION;
+            return NULL;
+        }
+        p = get_string_ptr(ctx, &buf, str);
+        memcpy(arr->buf, p->buf, len);
+        s->buffer = JS_VALUE_FROM_PTR(arr);
+        s->len = len;
+        s->is_ascii = p->is_ascii;
+    } else {
+        arr = JS_VALUE_TO_PTR(s->buffer);
+        if (s->len + n + 1 > arr->size) {
+            if ((int64_t)s->len + n > JS_STRING_LEN_MAX) {
+            too_long:
+                s->buffer = JS_ThrowInternalError(ctx, "string too long");
+                return NULL;
+            }
+            s->buffer = js_resize_byte_array(ctx, s->buffer, s->len + n + 1);
+            if (JS_IsException(s->buffer))
+                return NULL;
+            arr = JS_VALUE_TO_PTR(s->buffer);
+        }
+    }
+    return arr->buf + s->len;
 }
 
-/* JSON */
-
-JSValue js_json_parse(JSContext *ctx, JSValue *this_val,
-                      int argc, JSValue *argv)
+/* append 'len' ASCII characters */
+static int string_buffer_put_ascii(JSContext *ctx, StringBuffer *s,
+                                   const char *str, int len)
 {
-    JSValue val;
-    
-    val = JS_ToString(ctx, argv[0]);
-    if (JS_IsException(val))
-        return val;
-    return JS_Parse2(ctx, val, NULL, 0, "<input>", JS_EVAL_JSON);
+    uint8_t *q;
+    q = string_buffer_reserve(ctx, s, len);
+    if (!q)
+        return -1;
+    memcpy(q, str, len);
+    s->len += len;
+    return 0;
 }
 
-static int js_to_quoted_string(JSContext *ctx, StringBuffer *b, JSValue str)
+/* The spans without characters to escape are copied at once. The
+   lone surrogates are escaped so that the result is valid UTF-8. */
+static int js_json_quote(JSContext *ctx, StringBuffer *b, JSValue str)
 {
-    int i, c;
+    static const char hex_digits[] = "0123456789abcdef";
     JSStringCharBuf buf;
+    JSByteArray *arr;
     JSString *p;
     JSGCRef str_ref;
+    uint8_t *q;
+    int i, len, n, c, ret;
     size_t clen;
 
     JS_PUSH_VALUE(ctx, str);
-    string_buffer_putc(ctx, b, '\"');
-
+    ret = -1;
+    len = get_string_ptr(ctx, &buf, str)->len;
+    q = string_buffer_reserve(ctx, b, len + 2);
+    if (!q)
+        goto done;
+    p = get_string_ptr(ctx, &buf, str_ref.val);
+    *q++ = '\"';
     i = 0;
     for(;;) {
-        /* XXX: inefficient */
-        p = get_string_ptr(ctx, &buf, str_ref.val);
-        if (i >= p->len)
+        n = json_string_span(p->buf + i, len - i, !p->is_ascii);
+        memcpy(q, p->buf + i, n);
+        q += n;
+        i += n;
+        if (i >= len)
             break;
-        c = utf8_get(p->buf + i, &clen);
+        c = p->buf[i];
+        clen = 1;
+        if (c >= 0x80) {
+            c = utf8_get(p->buf + i, &clen);
+            if (c < 0xd800 || c >= 0xe000) {
+                memcpy(q, p->buf + i, clen);
+                q += clen;
+                i += clen;
+                continue;
+            }
+        }
+        /* the escape sequence takes at most 6 bytes */
+        arr = JS_VALUE_TO_PTR(b->buffer);
+        b->len = q - arr->buf;
+        q = string_buffer_reserve(ctx, b, 6 + (len - i - clen) + 1);
+        if (!q)
+            goto done;
+        p = get_string_ptr(ctx, &buf, str_ref.val);
         i += clen;
-
+        *q++ = '\\';
         switch(c) {
-        case '\t':
-            c = 't';
-            goto quote;
-        case '\r':
-            c = 'r';
-            goto quote;
-        case '\n':
-            c = 'n';
-            goto quote;
-        case '\b':
-            c = 'b';
-            goto quote;
-        case '\f':
-            c = 'f';
-            goto quote;
         case '\"':
         case '\\':
-        quote:
-            string_buffer_putc(ctx, b, '\\');
-            string_buffer_putc(ctx, b, c);
+            *q++ = c;
+            break;
+        case '\b':
+            *q++ = 'b';
+            break;
+        case '\f':
+            *q++ = 'f';
+            break;
+        case '\n':
+            *q++ = 'n';
+            break;
+        case '\r':
+            *q++ = 'r';
+            break;
+        case '\t':
+            *q++ = 't';
             break;
         default:
-            if (c < 32 || (c >= 0xd800 && c < 0xe000)) {
-                char buf[7];
-                js_snprintf(buf, sizeof(buf), "\\u%04x", c);
-                string_buffer_puts(ctx, b, buf);
-            } else {
-                string_buffer_putc(ctx, b, c);
-            }
+            *q++ = 'u';
+            *q++ = hex_digits[c >> 12];
+            *q++ = hex_digits[(c >> 8) & 0xf];
+            *q++ = hex_digits[(c >> 4) & 0xf];
+            *q++ = hex_digits[c & 0xf];
             break;
         }
     }
-    string_buffer_putc(ctx, b, '\"');
+    *q++ = '\"';
+    arr = JS_VALUE_TO_PTR(b->buffer);
+    b->len = q - arr->buf;
+    b->is_ascii &= p->is_ascii;
+    ret = 0;
+ done:
     JS_POP_VALUE(ctx, str);
-    return 0;
+    return ret;
 }
 
+/* append the property key followed by ':', preceded by ',' if
+   'sep' is TRUE */
+static int js_json_put_key(JSContext *ctx, StringBuffer *b, JSValue key,
+                           BOOL sep)
+{
+    JSGCRef key_ref;
+    char buf[24];
+    int len, ret;
+
+    if (JS_IsInt(key)) {
+        len = 0;
+        if (sep)
+            buf[len++] = ',';
+        buf[len++] = '\"';
+        len += i32toa(buf + len, JS_VALUE_GET_INT(key));
+        buf[len++] = '\"';
+        buf[len++] = ':';
+        return string_buffer_put_ascii(ctx, b, buf, len);
+    }
+    ret = 0;
+    JS_PUSH_VALUE(ctx, key);
+    if (sep)
+        ret = string_buffer_put_ascii(ctx, b, ",", 1);
+    if (!ret)
+        ret = js_json_quote(ctx, b, key);
+    JS_POP_VALUE(ctx, key);
+    if (!ret)
+        ret = string_buffer_put_ascii(ctx, b, ":", 1);
+    return ret;
+}
+
+/* Each value being output has a record on the stack:
+   [value, index, position]. For arrays, index is the next element.
+   For the other objects, index is the number of properties output and
+   position is the next typed array element or own property, JS_NULL
+   before the opening brace. */
 #define JSON_REC_SIZE 3
 
 static int check_circular_ref(JSContext *ctx, JSValue *stack_top, JSValue val)
@@ -15322,7 +18370,8 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
     StringBuffer b_s, *b = &b_s;
     JSGCRef b_ref;
     int idx, ret;
-    
+    char buf[32]; /* enough for js_dtoa_shortest() */
+
 #if 0
     if (JS_IsNumber(ctx, *pspace)) {
         int n;
@@ -15344,10 +18393,10 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
     JS_POP_STRING_BUFFER(ctx, b);
     if (ret)
         goto fail;
-    *--ctx->sp = JS_NULL; /* keys */
-    *--ctx->sp = JS_NewShortInt(0); /* prop index */
-    *--ctx->sp = argv[0]; /* object */
-    
+    *--ctx->sp = JS_NULL; /* position */
+    *--ctx->sp = JS_NewShortInt(0); /* index */
+    *--ctx->sp = argv[0]; /* value */
+
     while (ctx->sp < stack_top) {
         obj = ctx->sp[0];
         if (JS_IsFunction(ctx, obj)) {
@@ -15360,16 +18409,21 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                 JSValue val;
 
                 /* array */
-                if (idx == 0)
-                    string_buffer_putc(ctx, b, '[');
+                if (idx == 0) {
+                    if (string_buffer_put_ascii(ctx, b, "[", 1))
+                        goto fail;
+                }
                 p = JS_VALUE_TO_PTR(ctx->sp[0]);
                 if (idx >= p->u.array.len) {
                     /* end of array */
-                    string_buffer_putc(ctx, b, ']');
+                    if (string_buffer_put_ascii(ctx, b, "]", 1))
+                        goto fail;
                     ctx->sp += JSON_REC_SIZE;
                 } else {
-                    if (idx != 0)
-                        string_buffer_putc(ctx, b, ',');
+                    if (idx != 0) {
+                        if (string_buffer_put_ascii(ctx, b, ",", 1))
+                            goto fail;
+                    }
                     ctx->sp[1] = JS_NewShortInt(idx + 1);
                     JS_PUSH_STRING_BUFFER(ctx, b);
                     ret = JS_StackCheck(ctx, JSON_REC_SIZE);
@@ -15386,56 +18440,65 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                     *--ctx->sp = val;
                 }
             } else {
-                JSValueArray *arr;
-                JSValue val, prop;
+                JSValue val, key;
                 JSGCRef val_ref;
-                int saved_idx;
-                
-                /* object */
-                if (idx == 0) {
-                    string_buffer_putc(ctx, b, '{');
-                    ctx->sp[2] = js_object_keys(ctx, NULL, 1, &ctx->sp[0]);
-                    if (JS_IsException(ctx->sp[2]))
+                int pos, prop_pos, array_len;
+
+                /* object: the typed array elements, then the own
+                   properties, are enumerated without building the
+                   list of keys */
+                if (JS_IsNull(ctx->sp[2])) {
+                    if (string_buffer_put_ascii(ctx, b, "{", 1))
                         goto fail;
+                    ctx->sp[2] = JS_NewShortInt(0);
                 }
-                saved_idx = idx;
+                pos = JS_VALUE_GET_INT(ctx->sp[2]);
                 for(;;) {
-                    p = JS_VALUE_TO_PTR(ctx->sp[2]); /* keys */
-                    if (idx >= p->u.array.len) {
-                        /* end of object */
-                        string_buffer_putc(ctx, b, '}');
-                        ctx->sp += JSON_REC_SIZE;
-                        goto end_obj;
-                    } else {
-                        arr = JS_VALUE_TO_PTR(p->u.array.tab);
+                    p = JS_VALUE_TO_PTR(ctx->sp[0]);
+                    if (p->class_id >= JS_CLASS_UINT8C_ARRAY &&
+                        p->class_id <= JS_CLASS_FLOAT64_ARRAY)
+                        array_len = p->u.typed_array.len;
+                    else
+                        array_len = 0;
+                    if (pos < array_len) {
+                        key = JS_NewShortInt(pos);
                         JS_PUSH_STRING_BUFFER(ctx, b);
-                        prop = JS_ToPropertyKey(ctx, arr->arr[idx]);
-                        val = JS_GetProperty(ctx, ctx->sp[0], prop);
+                        val = JS_GetProperty(ctx, ctx->sp[0], key);
                         JS_POP_STRING_BUFFER(ctx, b);
                         if (JS_IsException(val))
                             goto fail;
-                        /* skip undefined properties */
-                        if (!JS_IsUndefined(val))
-                            break;
-                        idx++;
+                        pos++;
+                    } else {
+                        prop_pos = pos - array_len;
+                        JS_PUSH_STRING_BUFFER(ctx, b);
+                        ret = JS_GetOwnPropertyNext(ctx, ctx->sp[0], &prop_pos,
+                                                    &key, &val);
+                        JS_POP_STRING_BUFFER(ctx, b);
+                        if (ret < 0)
+                            goto fail;
+                        if (ret == 0) {
+                            /* end of object */
+                            if (string_buffer_put_ascii(ctx, b, "}", 1))
+                                goto fail;
+                            ctx->sp += JSON_REC_SIZE;
+                            goto end_obj;
+                        }
+                        pos = array_len + prop_pos;
                     }
+                    /* skip undefined and function properties */
+                    if (!JS_IsUndefined(val) && !JS_IsFunction(ctx, val))
+                        break;
                 }
-                if (saved_idx != 0)
-                    string_buffer_putc(ctx, b, ',');
                 ctx->sp[1] = JS_NewShortInt(idx + 1);
-                p = JS_VALUE_TO_PTR(ctx->sp[2]);
-                arr = JS_VALUE_TO_PTR(p->u.array.tab);
-                JS_PUSH_VALUE(ctx, val);
-                ret = js_to_quoted_string(ctx, b, arr->arr[idx]);
-                JS_POP_VALUE(ctx, val);
-                if (ret)
-                    goto fail;
-                string_buffer_putc(ctx, b, ':');
-                
+                ctx->sp[2] = JS_NewShortInt(pos);
+
                 JS_PUSH_VALUE(ctx, val);
-                JS_PUSH_STRING_BUFFER(ctx, b);
-                ret = JS_StackCheck(ctx, JSON_REC_SIZE);
-                JS_POP_STRING_BUFFER(ctx, b);
+                ret = js_json_put_key(ctx, b, key, idx != 0);
+                if (!ret) {
+                    JS_PUSH_STRING_BUFFER(ctx, b);
+                    ret = JS_StackCheck(ctx, JSON_REC_SIZE);
+                    JS_POP_STRING_BUFFER(ctx, b);
+                }
                 JS_POP_VALUE(ctx, val);
                 if (ret)
                     goto fail;
@@ -15446,6 +18509,11 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                 *--ctx->sp = val;
             end_obj: ;
             }
+        } else if (JS_IsInt(obj)) {
+            ret = i32toa(buf, JS_VALUE_GET_INT(obj));
+            if (string_buffer_put_ascii(ctx, b, buf, ret))
+                goto fail;
+            ctx->sp += JSON_REC_SIZE;
         } else if (JS_IsNumber(ctx, obj)) {
             double d;
             JS_PUSH_STRING_BUFFER(ctx, b);
@@ -15455,24 +18523,35 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                 goto fail;
             if (!isfinite(d))
                 goto output_null;
-            goto to_string;
+            ret = js_dtoa_shortest(buf, d, JS_DTOA_FORMAT_FREE);
+            if (ret >= 0)
+                ret = string_buffer_put_ascii(ctx, b, buf, ret);
+            else
+                ret = string_buffer_concat(ctx, b, obj);
+            if (ret)
+                goto fail;
+            ctx->sp += JSON_REC_SIZE;
         } else if (JS_IsBool(obj)) {
-        to_string:
-            if (string_buffer_concat(ctx, b, obj))
+            if (obj == JS_TRUE)
+                ret = string_buffer_put_ascii(ctx, b, "true", 4);
+            else
+                ret = string_buffer_put_ascii(ctx, b, "false", 5);
+            if (ret)
                 goto fail;
             ctx->sp += JSON_REC_SIZE;
         } else if (JS_IsString(ctx, obj)) {
-            if (js_to_quoted_string(ctx, b, obj))
+            if (js_json_quote(ctx, b, obj))
                 goto fail;
             ctx->sp += JSON_REC_SIZE;
         } else {
         output_null:
-            string_buffer_concat(ctx, b, js_get_atom(ctx, JS_ATOM_null));
+            if (string_buffer_put_ascii(ctx, b, "null", 4))
+                goto fail;
             ctx->sp += JSON_REC_SIZE;
         }
     }
     return string_buffer_end(ctx, b);
-    
+
  fail:
     ctx->sp = stack_top;
     return JS_EXCEPTION;
@@ -15521,6 +18600,23 @@ static const REOpCode reopcode_info[REOP_COUNT] = {
 
 #define RE_HEADER_LEN 4
 
+/* internal flag: the byte code is followed by a REScanInfo */
+#define RE_FLAG_SCAN_INFO  (1 << 15)
+
+#define RE_PREFIX_MAX 13
+
+/* Computed at compile time for the non sticky regexps which cannot
+   match the empty string: the interpreter only tries the start
+   positions whose first byte is in 'first_bytes' and which begin with
+   'prefix'. Stored at the end of the byte code. */
+typedef struct {
+    uint8_t first_bytes[32]; /* bitmap of the possible first bytes of a match */
+    uint8_t first_byte; /* only possible first byte if is_single_byte */
+    uint8_t is_single_byte;
+    uint8_t prefix_len; /* length of the literal prefix of all the matches */
+    uint8_t prefix[RE_PREFIX_MAX];
+} REScanInfo;
+
 #define CLASS_RANGE_BASE 0x40000000
 
 typedef enum {
@@ -15547,6 +18643,13 @@ static int lre_get_flags(const uint8_t *bc_buf)
     return get_u16(bc_buf + RE_HEADER_FLAGS);
 }
 
+static const REScanInfo *lre_get_scan_info(const JSByteArray *arr)
+{
+    if (!(lre_get_flags(arr->buf) & RE_FLAG_SCAN_INFO))
+        return NULL;
+    return (const REScanInfo *)(arr->buf + arr->size - sizeof(REScanInfo));
+}
+
 #ifdef DUMP_REOP
 static __maybe_unused void lre_dump_bytecode(const uint8_t *buf,
                                              int buf_len)
@@ -16652,11 +19755,197 @@ static int re_compute_register_count(JSParseState *s, uint8_t *bc_buf, int bc_bu
     return stack_size_max;
 }
 
+#define RE_SCAN_POS_MAX 64
+
+static void re_scan_add_range(REScanInfo *si, uint32_t low, uint32_t high)
+{
+    uint32_t c;
+    for(c = low; c < min_uint32(high, 0x80); c++)
+        si->first_bytes[c >> 3] |= 1 << (c & 7);
+    /* any UTF-8 lead byte for the non ASCII characters */
+    if (high > 0x80) {
+        for(c = 0xc0; c <= 0xff; c++)
+            si->first_bytes[c >> 3] |= 1 << (c & 7);
+    }
+}
+
+static int re_scan_add_pos(int *pos_tab, int *ppos_count, int pos)
+{
+    int i;
+    for(i = 0; i < *ppos_count; i++) {
+        if (pos_tab[i] == pos)
+            return 0;
+    }
+    if (*ppos_count >= RE_SCAN_POS_MAX)
+        return -1;
+    pos_tab[(*ppos_count)++] = pos;
+    return 0;
+}
+
+/* Compute the possible first bytes and the literal prefix of the
+   matches starting at 'start'. Return FALSE if any start position may
+   match (e.g. empty match or '.' as first atom). */
+static BOOL re_compute_scan_info(REScanInfo *si, const uint8_t *bc_buf,
+                                 int bc_buf_len, int start)
+{
+    int pos_tab[RE_SCAN_POS_MAX];
+    int pos_count, i, pos, opcode, len, n, count;
+    uint32_t target;
+
+    memset(si, 0, sizeof(*si));
+    pos_count = 0;
+    pos_tab[pos_count++] = start;
+    for(i = 0; i < pos_count; i++) {
+        pos = pos_tab[i];
+        for(;;) {
+            if (pos >= bc_buf_len)
+                return FALSE;
+            opcode = bc_buf[pos];
+            len = reopcode_info[opcode].size;
+            switch(opcode) {
+            case REOP_char1:
+            case REOP_char2:
+            case REOP_char3:
+            case REOP_char4:
+                re_scan_add_range(si, bc_buf[pos + 1], bc_buf[pos + 1] + 1);
+                goto next_pos;
+            case REOP_range8:
+                n = bc_buf[pos + 1];
+                for(count = 0; count < n; count++) {
+                    uint32_t high = bc_buf[pos + 2 + 2 * count + 1];
+                    if (count == n - 1 && high == 0xff)
+                        high = 0x110000;
+                    re_scan_add_range(si, bc_buf[pos + 2 + 2 * count], high);
+                }
+                goto next_pos;
+            case REOP_range:
+                n = get_u16(bc_buf + pos + 1);
+                for(count = 0; count < n; count++) {
+                    re_scan_add_range(si, get_u32(bc_buf + pos + 3 + 8 * count),
+                                      get_u32(bc_buf + pos + 3 + 8 * count + 4));
+                }
+                goto next_pos;
+            case REOP_space:
+                re_scan_add_range(si, '\t', '\r' + 1);
+                re_scan_add_range(si, ' ', ' ' + 1);
+                re_scan_add_range(si, 0x80, 0x110000);
+                goto next_pos;
+            case REOP_line_start:
+            case REOP_line_start_m:
+            case REOP_line_end:
+            case REOP_line_end_m:
+            case REOP_word_boundary:
+            case REOP_not_word_boundary:
+            case REOP_save_start:
+            case REOP_save_end:
+            case REOP_save_reset:
+            case REOP_set_i32:
+            case REOP_set_char_pos:
+            case REOP_check_advance:
+                /* no character is consumed */
+                pos += len;
+                break;
+            case REOP_goto:
+                target = pos + len + (int)get_u32(bc_buf + pos + 1);
+                if (re_scan_add_pos(pos_tab, &pos_count, target))
+                    return FALSE;
+                goto next_pos;
+            case REOP_split_goto_first:
+            case REOP_split_next_first:
+            case REOP_loop:
+            case REOP_loop_split_goto_first:
+            case REOP_loop_split_next_first:
+            case REOP_loop_check_adv_split_goto_first:
+            case REOP_loop_check_adv_split_next_first:
+                target = pos + len + (int)get_u32(bc_buf + pos + len - 4);
+                if (re_scan_add_pos(pos_tab, &pos_count, pos + len) ||
+                    re_scan_add_pos(pos_tab, &pos_count, target))
+                    return FALSE;
+                goto next_pos;
+            case REOP_lookahead:
+            case REOP_negative_lookahead:
+                /* the assertion does not consume characters: only
+                   the continuation is considered */
+                target = pos + len + (int)get_u32(bc_buf + pos + 1);
+                if (re_scan_add_pos(pos_tab, &pos_count, target))
+                    return FALSE;
+                goto next_pos;
+            default:
+                /* match (empty match), dot, any, back references, ... */
+                return FALSE;
+            }
+        }
+    next_pos: ;
+    }
+
+    count = 0;
+    for(i = 0; i < 256; i++) {
+        if ((si->first_bytes[i >> 3] >> (i & 7)) & 1) {
+            si->first_byte = i;
+            count++;
+        }
+    }
+    /* not worth scanning if most characters are possible */
+    if (count > 128)
+        return FALSE;
+    si->is_single_byte = (count == 1);
+
+    /* literal prefix: characters at the start of all the paths */
+    pos = start;
+    while (pos < bc_buf_len) {
+        opcode = bc_buf[pos];
+        len = reopcode_info[opcode].size;
+        if (opcode >= REOP_char1 && opcode <= REOP_char4) {
+            n = opcode - REOP_char1 + 1;
+            if (si->prefix_len + n > RE_PREFIX_MAX)
+                break;
+            memcpy(si->prefix + si->prefix_len, bc_buf + pos + 1, n);
+            si->prefix_len += n;
+        } else if (opcode != REOP_save_start && opcode != REOP_save_end &&
+                   opcode != REOP_save_reset && opcode != REOP_set_i32 &&
+                   opcode != REOP_line_start && opcode != REOP_line_start_m &&
+                   opcode != REOP_word_boundary &&
+                   opcode != REOP_not_word_boundary) {
+            break;
+        }
+        pos += len;
+    }
+    return TRUE;
+}
+
+/* return the first position >= cptr where a match can start or NULL
+   if none. A match consumes at least one character so 'cbuf_end' is
+   never returned. */
+static const uint8_t *re_scan_next(const REScanInfo *si, const uint8_t *cptr,
+                                   const uint8_t *cbuf_end)
+{
+    int c;
+
+    if (si->is_single_byte) {
+        for(;;) {
+            cptr = memchr(cptr, si->first_byte, cbuf_end - cptr);
+            if (!cptr || (cbuf_end - cptr) < si->prefix_len)
+                return NULL;
+            if (!memcmp(cptr, si->prefix, si->prefix_len))
+                return cptr;
+            cptr++;
+        }
+    } else {
+        for(; cptr < cbuf_end; cptr++) {
+            c = *cptr;
+            if ((si->first_bytes[c >> 3] >> (c & 7)) & 1)
+                return cptr;
+        }
+        return NULL;
+    }
+}
+
 /* return a JSByteArray. 'source' must be a string */
 static JSValue js_parse_regexp(JSParseState *s, int re_flags)
 {
     JSByteArray *arr;
-    int register_count;
+    int register_count, start_pos, i;
+    REScanInfo si;
     
     s->multi_line = ((re_flags & LRE_FLAG_MULTILINE) != 0);
     s->dotall = ((re_flags & LRE_FLAG_DOTALL) != 0);
@@ -16675,6 +19964,7 @@ static JSValue js_parse_regexp(JSParseState *s, int re_flags)
         re_emit_op(s, REOP_any);
         re_emit_op_u32(s, REOP_goto, -(5 + 1 + 5));
     }
+    start_pos = s->byte_code_len - RE_HEADER_LEN;
     re_emit_op_u8(s, REOP_save_start, 0);
 
     js_parse_call(s, PARSE_FUNC_re_parse_disjunction, 0);
@@ -16691,12 +19981,21 @@ static JSValue js_parse_regexp(JSParseState *s, int re_flags)
         re_compute_register_count(s, arr->buf + RE_HEADER_LEN,
                                   s->byte_code_len - RE_HEADER_LEN);
     arr->buf[RE_HEADER_REGISTER_COUNT] = register_count;
+
+    if (!(re_flags & LRE_FLAG_STICKY) &&
+        re_compute_scan_info(&si, arr->buf + RE_HEADER_LEN,
+                             s->byte_code_len - RE_HEADER_LEN, start_pos)) {
+        put_u16(arr->buf + RE_HEADER_FLAGS, re_flags | RE_FLAG_SCAN_INFO);
+        for(i = 0; i < sizeof(si); i++)
+            emit_u8(s, ((uint8_t *)&si)[i]);
+    }
     
     js_shrink_byte_array(s->ctx, &s->byte_code, s->byte_code_len);
 
 #ifdef DUMP_REOP
     arr = JS_VALUE_TO_PTR(s->byte_code);
-    lre_dump_bytecode(arr->buf, arr->size);
+    lre_dump_bytecode(arr->buf, arr->size -
+                      (lre_get_scan_info(arr) ? sizeof(REScanInfo) : 0));
 #endif
     
     return s->byte_code;
@@ -16772,10 +20071,12 @@ static int lre_exec(JSContext *ctx, JSValue capture_buf,
     JSValue *sp, *bp, *initial_sp, *saved_stack_bottom;
     JSByteArray *arr; /* temporary use */
     JSString *ps; /* temporary use */
+    const REScanInfo *si; /* temporary use */
     JSGCRef capture_buf_ref, byte_code_ref, str_ref;
 
     arr = JS_VALUE_TO_PTR(byte_code);
     pc = arr->buf;
+    si = lre_get_scan_info(arr);
     arr = JS_VALUE_TO_PTR(capture_buf);
     capture = (uint32_t *)arr->buf;
     capture_count = lre_get_capture_count(pc);
@@ -16784,6 +20085,11 @@ static int lre_exec(JSContext *ctx, JSValue capture_buf,
     cbuf = ps->buf;
     cbuf_end = cbuf + ps->len;
     cptr = cbuf + cindex;
+    if (si) {
+        cptr = re_scan_next(si, cptr, cbuf_end);
+        if (!cptr)
+            return 0;
+    }
 
     saved_stack_bottom = ctx->stack_bottom;
     initial_sp = ctx->sp;
@@ -17087,6 +20393,16 @@ static int lre_exec(JSContext *ctx, JSValue capture_buf,
         case REOP_any:
             if (cptr == cbuf_end)
                 goto no_match;
+            arr = JS_VALUE_TO_PTR(byte_code);
+            if (unlikely(pc == arr->buf + RE_HEADER_LEN + 6) &&
+                (si = lre_get_scan_info(arr)) != NULL) {
+                /* next start position in the search prologue: skip
+                   the positions which cannot match */
+                cptr = re_scan_next(si, cptr + 1, cbuf_end);
+                if (!cptr)
+                    goto no_match;
+                break;
+            }
             GET_CHAR(c, cptr, cbuf_end);
             break;
         case REOP_space:
@@ -17377,10 +20693,65 @@ static size_t js_parse_regexp_flags(int *pre_flags, const uint8_t *buf)
     return p - buf;
 }
 
+/* return the cached byte code of 'pattern' compiled with 're_flags'
+   or JS_NULL. The entry becomes the most recent one. */
+static JSValue js_regexp_cache_find(JSContext *ctx, JSValue pattern, int re_flags)
+{
+    JSValueArray *arr;
+    JSByteArray *barr;
+    JSValue source, byte_code;
+    int i;
+
+    if (JS_IsNull(ctx->regexp_cache))
+        return JS_NULL;
+    arr = JS_VALUE_TO_PTR(ctx->regexp_cache);
+    for(i = 0; i < JS_REGEXP_CACHE_SIZE; i++) {
+        source = arr->arr[2 * i];
+        if (JS_IsUndefined(source))
+            break;
+        byte_code = arr->arr[2 * i + 1];
+        barr = JS_VALUE_TO_PTR(byte_code);
+        if ((lre_get_flags(barr->buf) & ~RE_FLAG_SCAN_INFO) == re_flags &&
+            js_string_eq(ctx, source, pattern)) {
+            memmove(&arr->arr[2], &arr->arr[0], 2 * i * sizeof(JSValue));
+            arr->arr[0] = source;
+            arr->arr[1] = byte_code;
+            return byte_code;
+        }
+    }
+    return JS_NULL;
+}
+
+/* add a compiled regexp to the cache, dropping the least recent one */
+static int js_regexp_cache_add(JSContext *ctx, JSValue pattern, JSValue byte_code)
+{
+    JSValueArray *arr;
+    JSGCRef pattern_ref, byte_code_ref;
+
+    if (JS_IsNull(ctx->regexp_cache)) {
+        JS_PUSH_VALUE(ctx, pattern);
+        JS_PUSH_VALUE(ctx, byte_code);
+        arr = js_alloc_value_array(ctx, 0, 2 * JS_REGEXP_CACHE_SIZE);
+        JS_POP_VALUE(ctx, byte_code);
+        JS_POP_VALUE(ctx, pattern);
+        if (!arr)
+            return -1;
+        ctx->regexp_cache = JS_VALUE_FROM_PTR(arr);
+    }
+    arr = JS_VALUE_TO_PTR(ctx->regexp_cache);
+    memmove(&arr->arr[2], &arr->arr[0],
+            2 * (JS_REGEXP_CACHE_SIZE - 1) * sizeof(JSValue));
+    arr->arr[0] = pattern;
+    arr->arr[1] = byte_code;
+    return 0;
+}
+
 /* pattern and flags must be strings */
 static JSValue js_compile_regexp(JSContext *ctx, JSValue pattern, JSValue flags)
 {
     int re_flags;
+    JSValue byte_code;
+    JSGCRef pattern_ref, byte_code_ref;
     
     re_flags = 0;
     if (!JS_IsUndefined(flags)) {
@@ -17393,8 +20764,25 @@ static JSValue js_compile_regexp(JSContext *ctx, JSValue pattern, JSValue flags)
             return JS_ThrowSyntaxError(ctx, "invalid regular expression flags");
     }
 
-    return JS_Parse2(ctx, pattern, NULL, 0, "<regexp>",
-                     JS_EVAL_REGEXP | (re_flags << JS_EVAL_REGEXP_FLAGS_SHIFT));
+    /* the byte code is never modified so it can be shared by the
+       regexps created in a loop */
+    byte_code = js_regexp_cache_find(ctx, pattern, re_flags);
+    if (!JS_IsNull(byte_code))
+        return byte_code;
+    
+    JS_PUSH_VALUE(ctx, pattern);
+    byte_code = JS_Parse2(ctx, pattern, NULL, 0, "<regexp>",
+                          JS_EVAL_REGEXP | (re_flags << JS_EVAL_REGEXP_FLAGS_SHIFT));
+    JS_POP_VALUE(ctx, pattern);
+    if (JS_IsException(byte_code))
+        return byte_code;
+    JS_PUSH_VALUE(ctx, byte_code);
+    if (js_regexp_cache_add(ctx, pattern, byte_code)) {
+        JS_POP_VALUE(ctx, byte_code);
+        return JS_EXCEPTION;
+    }
+    JS_POP_VALUE(ctx, byte_code);
+    return byte_code;
 }
 
 static JSRegExp *js_get_regexp(JSContext *ctx, JSValue obj)
@@ -203,6 +203,9 @@ DEF(       put_arg0, 1, 1, 0, none_arg)  /* must follow get_arg */
 DEF(       put_arg1, 1, 1, 0, none_arg)
 DEF(       put_arg2, 1, 1, 0, none_arg)
 DEF(       put_arg3, 1, 1, 0, none_arg)
+/* 'local += v' with a string builder (see js_append_slow()) */
+DEF(get_loc_nocheck, 3, 0, 1, loc) /* does not end the string builder */
+DEF(         append, 1, 2, 1, none) /* same as add */
 #if 0
 DEF(      if_false8, 2, 1, 0, label8)
 DEF(       if_true8, 2, 1, 0, label8) /* must come after if_false8 */
@@ -230,6 +230,16 @@ JSValue js_typed_array_get_length(JSContext *ctx, JSValue *this_val,
                                   int argc, JSValue *argv, int magic);
 JSValue js_typed_array_subarray(JSContext *ctx, JSValue *this_val,
                                 int argc, JSValue *argv);
+JSValue js_typed_array_sort(JSContext *ctx, JSValue *this_val,
+                            int argc, JSValue *argv);
+JSValue js_typed_array_set(JSContext *ctx, JSValue *this_val,
+                           int argc, JSValue *argv);
+JSValue js_typed_array_fill(JSContext *ctx, JSValue *this_val,
+                            int argc, JSValue *argv);
+JSValue js_typed_array_slice(JSContext *ctx, JSValue *this_val,
+                             int argc, JSValue *argv);
+JSValue js_typed_array_copyWithin(JSContext *ctx, JSValue *this_val,
+                                  int argc, JSValue *argv);
 
 JSValue js_date_constructor(JSContext *ctx, JSValue *this_val,
                             int argc, JSValue *argv);
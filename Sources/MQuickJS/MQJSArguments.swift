@@ -0,0 +1,193 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Arguments
+
+/// A borrowed view of the arguments passed to a fast native function.
+///
+/// Arguments are read directly from the JavaScript stack, so no `MQJSValue` is
+/// allocated (and nothing is registered with the context) unless you ask for one
+/// with `value(at:)`. Missing arguments read as `undefined`.
+///
+/// ```swift
+/// try context.setFastFunction("add") { args in
+///     return .int32(try args.int32(at: 0) &+ args.int32(at: 1))
+/// }
+/// ```
+///
+/// - Important: The view is only valid for the duration of the native call. Do not
+///   store it or let it escape the closure.
+public struct MQJSArguments {
+    /// The context the function was called in
+    public unowned(unsafe) let context: MQJSContext
+
+    /// Pointer to the first argument on the JavaScript stack
+    private let argv: UnsafeMutablePointer<JSValue>?
+
+    /// Number of arguments passed by the caller
+    public let count: Int
+
+    internal init(context: MQJSContext, argc: Int32, argv: UnsafeMutablePointer<JSValue>?) {
+        self.context = context
+        self.argv = argv
+        self.count = argv == nil ? 0 : Int(max(argc, 0))
+    }
+
+    /// Returns true if there are no arguments
+    public var isEmpty: Bool {
+        return count == 0
+    }
+
+    /// Raw argument value (read from the stack each time, since the GC can move
+    /// the objects it references)
+    private func raw(_ index: Int) -> JSValue {
+        guard index >= 0, index < count, let argv = argv else {
+            return mqjs_get_undefined()
+        }
+        return argv[index]
+    }
+
+    // MARK: - Type Checking
+
+    /// Returns true if the argument is missing or `undefined`
+    public func isUndefined(at index: Int) -> Bool {
+        return JS_IsUndefined(raw(index)) != 0
+    }
+
+    /// Returns true if the argument is `null`
+    public func isNull(at index: Int) -> Bool {
+        return JS_IsNull(raw(index)) != 0
+    }
+
+    // MARK: - Typed Access
+
+    /// Converts an argument to Int32 (JavaScript `ToInt32` semantics).
+    ///
+    /// - Throws: MQJSError if the conversion throws in JavaScript
+    public func int32(at index: Int) throws -> Int32 {
+        var result: Int32 = 0
+        if JS_ToInt32(context.ctx, &result, raw(index)) != 0 {
+            throw try context.extractError()
+        }
+        return result
+    }
+
+    /// Converts an argument to Double (JavaScript `ToNumber` semantics).
+    ///
+    /// - Throws: MQJSError if the conversion throws in JavaScript
+    public func double(at index: Int) throws -> Double {
+        var result: Double = 0
+        if JS_ToNumber(context.ctx, &result, raw(index)) != 0 {
+            throw try context.extractError()
+        }
+        return result
+    }
+
+    /// Returns the argument as Bool, or nil if it is not a boolean
+    public func bool(at index: Int) -> Bool? {
+        let value = raw(index)
+        guard JS_IsBool(value) != 0 else { return nil }
+        return value == mqjs_get_true()
+    }
+
+    /// Converts an argument to a Swift String.
+    ///
+    /// - Throws: MQJSError if the conversion throws in JavaScript
+    public func utf8String(at index: Int) throws -> String {
+        return try withUTF8(at: index) { bytes in
+            String(decoding: bytes, as: UTF8.self)
+        }
+    }
+
+    /// Borrows the UTF-8 bytes of an argument converted to a string, without copying
+    /// when the argument already is a string.
+    ///
+    /// ```swift
+    /// try context.setFastFunction("log") { args in
+    ///     try args.withUTF8(at: 0) { bytes in
+    ///         logSink.write(bytes)
+    ///     }
+    ///     return .undefined
+    /// }
+    /// ```
+    ///
+    /// - Important: The bytes live in the JavaScript heap. Do not use the context
+    ///   inside `body` and do not let the pointer escape it.
+    /// - Throws: MQJSError if the conversion throws in JavaScript
+    public func withUTF8<R>(at index: Int, _ body: (UnsafeBufferPointer<UInt8>) throws -> R) throws -> R {
+        return try MQJSValue.withUTF8(raw(index), in: context, body)
+    }
+
+    /// Wraps an argument in an `MQJSValue` (allocates and registers a value).
+    public func value(at index: Int) -> MQJSValue {
+        return MQJSValue(context: context, jsValue: raw(index))
+    }
+}
+
+// MARK: - Results
+
+/// The result of a fast native function.
+///
+/// Results are converted to JavaScript directly, without going through `Any`.
+/// Literals can be returned as is:
+///
+/// ```swift
+/// try context.setFastFunction("answer") { _ in 42 }
+/// ```
+public enum MQJSNativeResult {
+    case undefined
+    case null
+    case bool(Bool)
+    case int32(Int32)
+    case double(Double)
+    case string(String)
+    case value(MQJSValue)
+
+    /// Convert to a JavaScript value (may be the exception value if allocation fails)
+    internal func toJSValue(in context: MQJSContext) -> JSValue {
+        switch self {
+        case .undefined:
+            return mqjs_get_undefined()
+        case .null:
+            return mqjs_get_null()
+        case .bool(let value):
+            return value ? mqjs_get_true() : mqjs_get_false()
+        case .int32(let value):
+            return JS_NewInt32(context.ctx, value)
+        case .double(let value):
+            return JS_NewFloat64(context.ctx, value)
+        case .string(var value):
+            return value.withUTF8 { bytes in
+                bytes.withMemoryRebound(to: CChar.self) { chars in
+                    JS_NewStringLen(context.ctx, chars.baseAddress, chars.count)
+                }
+            }
+        case .value(let value):
+            return value.jsValue
+        }
+    }
+}
+
+extension MQJSNativeResult: ExpressibleByBooleanLiteral {
+    public init(booleanLiteral value: Bool) {
+        self = .bool(value)
+    }
+}
+
+extension MQJSNativeResult: ExpressibleByIntegerLiteral {
+    public init(integerLiteral value: Int32) {
+        self = .int32(value)
+    }
+}
+
+extension MQJSNativeResult: ExpressibleByFloatLiteral {
+    public init(floatLiteral value: Double) {
+        self = .double(value)
+    }
+}
+
+extension MQJSNativeResult: ExpressibleByStringLiteral {
+    public init(stringLiteral value: String) {
+        self = .string(value)
+    }
+}
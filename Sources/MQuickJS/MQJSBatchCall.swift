@@ -0,0 +1,214 @@
+import Foundation
+import CMQuickJS
+
+/// The column descriptor of the C bridge
+private typealias CBatchColumn = CMQuickJS.MQJSBatchColumn
+
+// MARK: - Batch Columns
+
+/// One argument column of a batch call: call `i` receives element `i` of every column.
+public enum MQJSBatchColumn {
+    /// Numbers
+    case doubles([Double])
+    /// Integers
+    case int32s([Int32])
+    /// Strings, passed to the engine as UTF-8 bytes
+    case strings([String])
+    /// The elements of a JavaScript array or typed array
+    case elements(MQJSValue)
+
+    /// Number of values in the column
+    fileprivate func count(in context: MQJSContext) throws -> Int {
+        switch self {
+        case .doubles(let values):
+            return values.count
+        case .int32s(let values):
+            return values.count
+        case .strings(let values):
+            return values.count
+        case .elements(let array):
+            guard array.context === context else { throw MQJSError.invalidContext }
+            let length = JS_GetArrayLength(context.ctx, array.jsValue)
+            guard length >= 0 else {
+                throw MQJSError.typeConversionError("Batch column is not an array or typed array")
+            }
+            return Int(length)
+        }
+    }
+}
+
+// MARK: - Batch Calls
+
+extension MQJSValue {
+    /// Calls this function once per row of the columns, writing the results as numbers.
+    ///
+    /// All the calls happen in a single bridge crossing: the arguments are created
+    /// directly on the JavaScript stack from the column storage and no `MQJSValue` is
+    /// created per call.
+    ///
+    /// ```swift
+    /// let score = try context.eval("(function(price, qty, sku) { return price * qty; })")
+    /// var totals = [Double](repeating: 0, count: prices.count)
+    /// try totals.withUnsafeMutableBufferPointer { buffer in
+    ///     try score.callBatch([.doubles(prices), .int32s(quantities), .strings(skus)], into: buffer)
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - columns: The argument columns, each holding `results.count` values
+    ///   - results: Receives the result of call `i` converted to a number at index `i`
+    ///   - thisValue: The `this` value of the calls (default: `undefined`)
+    /// - Throws: `MQJSError.notAFunction` if this value is not callable,
+    ///           `MQJSError.typeConversionError` if a column has the wrong length, or
+    ///           MQJSError if a call throws. The results of the calls that completed
+    ///           before the error are already written.
+    public func callBatch(
+        _ columns: [MQJSBatchColumn],
+        into results: UnsafeMutableBufferPointer<Double>,
+        this thisValue: MQJSValue? = nil
+    ) throws {
+        try performBatchCall(
+            columns,
+            count: results.count,
+            resultType: Int32(MQJS_BATCH_FLOAT64),
+            results: UnsafeMutableRawPointer(results.baseAddress),
+            thisValue: thisValue
+        )
+    }
+
+    /// Calls this function once per row of the columns, writing the results as integers.
+    ///
+    /// The results are converted with `ToInt32` semantics, like `toInt32()`.
+    ///
+    /// - Parameters:
+    ///   - columns: The argument columns, each holding `results.count` values
+    ///   - results: Receives the result of call `i` converted to an integer at index `i`
+    ///   - thisValue: The `this` value of the calls (default: `undefined`)
+    /// - Throws: `MQJSError.notAFunction` if this value is not callable,
+    ///           `MQJSError.typeConversionError` if a column has the wrong length, or
+    ///           MQJSError if a call throws
+    public func callBatch(
+        _ columns: [MQJSBatchColumn],
+        into results: UnsafeMutableBufferPointer<Int32>,
+        this thisValue: MQJSValue? = nil
+    ) throws {
+        try performBatchCall(
+            columns,
+            count: results.count,
+            resultType: Int32(MQJS_BATCH_INT32),
+            results: UnsafeMutableRawPointer(results.baseAddress),
+            thisValue: thisValue
+        )
+    }
+
+    /// Calls this function once per row of the columns and returns the results as numbers.
+    ///
+    /// ```swift
+    /// let distance = try context.eval("(function(x, y) { return Math.sqrt(x * x + y * y); })")
+    /// let lengths = try distance.callBatch([.doubles(xs), .doubles(ys)])
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - columns: The argument columns, which must all have the same length
+    ///   - thisValue: The `this` value of the calls (default: `undefined`)
+    /// - Returns: The result of each call converted to a number
+    /// - Throws: `MQJSError.typeConversionError` if there are no columns or their
+    ///           lengths differ, or MQJSError if a call throws
+    public func callBatch(_ columns: [MQJSBatchColumn], this thisValue: MQJSValue? = nil) throws -> [Double] {
+        let ctx = try checkedContext()
+        guard let first = columns.first else {
+            throw MQJSError.typeConversionError("Batch call needs at least one column")
+        }
+        let count = try first.count(in: ctx)
+        var results = [Double](repeating: 0, count: count)
+        try results.withUnsafeMutableBufferPointer { buffer in
+            try callBatch(columns, into: buffer, this: thisValue)
+        }
+        return results
+    }
+
+    /// Validates the columns and runs the batch in the C bridge
+    private func performBatchCall(
+        _ columns: [MQJSBatchColumn],
+        count: Int,
+        resultType: Int32,
+        results: UnsafeMutableRawPointer?,
+        thisValue: MQJSValue?
+    ) throws {
+        let ctx = try checkedContext()
+        guard isFunction else { throw MQJSError.notAFunction }
+        guard columns.count <= Int(MQJS_BATCH_MAX_COLUMNS) else {
+            throw MQJSError.typeConversionError("Batch calls take at most \(MQJS_BATCH_MAX_COLUMNS) columns")
+        }
+        for (index, column) in columns.enumerated() {
+            let columnCount = try column.count(in: ctx)
+            guard columnCount == count else {
+                throw MQJSError.typeConversionError("Batch column \(index) has \(columnCount) values, expected \(count)")
+            }
+        }
+        if let thisValue = thisValue, thisValue.context !== ctx {
+            throw MQJSError.invalidContext
+        }
+        ctx.growMemoryIfNeeded()
+
+        let status = Self.withCColumns(columns[...], []) { cColumns -> Int32 in
+            var done = 0
+            return mqjs_call_batch(
+                ctx.ctx, jsValue, thisValue?.jsValue ?? mqjs_get_undefined(),
+                cColumns, Int32(cColumns.count), count, resultType, results, &done
+            )
+        }
+        if status != 0 {
+            throw try ctx.extractError()
+        }
+    }
+
+    /// Pins the storage of the columns and passes their C descriptors to body
+    private static func withCColumns<R>(
+        _ columns: ArraySlice<MQJSBatchColumn>,
+        _ prepared: [CBatchColumn],
+        _ body: ([CBatchColumn]) -> R
+    ) -> R {
+        guard let column = columns.first else {
+            return body(prepared)
+        }
+        let rest = columns.dropFirst()
+        let undefined = mqjs_get_undefined()
+
+        switch column {
+        case .doubles(let values):
+            return values.withUnsafeBufferPointer { buffer in
+                let cColumn = CBatchColumn(type: Int32(MQJS_BATCH_FLOAT64), values: UnsafeRawPointer(buffer.baseAddress),
+                                           offsets: nil, array: undefined)
+                return withCColumns(rest, prepared + [cColumn], body)
+            }
+        case .int32s(let values):
+            return values.withUnsafeBufferPointer { buffer in
+                let cColumn = CBatchColumn(type: Int32(MQJS_BATCH_INT32), values: UnsafeRawPointer(buffer.baseAddress),
+                                           offsets: nil, array: undefined)
+                return withCColumns(rest, prepared + [cColumn], body)
+            }
+        case .strings(let strings):
+            // All the strings back to back, string i being bytes offsets[i]..<offsets[i + 1]
+            var bytes = [UInt8]()
+            var offsets = [Int]()
+            offsets.reserveCapacity(strings.count + 1)
+            for string in strings {
+                offsets.append(bytes.count)
+                bytes.append(contentsOf: string.utf8)
+            }
+            offsets.append(bytes.count)
+            bytes.append(0)  // never empty, so the base address is never nil
+            return bytes.withUnsafeBufferPointer { buffer in
+                offsets.withUnsafeBufferPointer { offsetBuffer in
+                    let cColumn = CBatchColumn(type: Int32(MQJS_BATCH_UTF8), values: UnsafeRawPointer(buffer.baseAddress),
+                                               offsets: offsetBuffer.baseAddress, array: undefined)
+                    return withCColumns(rest, prepared + [cColumn], body)
+                }
+            }
+        case .elements(let array):
+            let cColumn = CBatchColumn(type: Int32(MQJS_BATCH_ELEMENTS), values: nil, offsets: nil, array: array.jsValue)
+            return withCColumns(rest, prepared + [cColumn], body)
+        }
+    }
+}
@@ -0,0 +1,275 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Binary Types
+
+/// The kind of binary JavaScript object: an `ArrayBuffer` or a typed array view.
+public enum MQJSBinaryType: CaseIterable {
+    case arrayBuffer
+    case int8Array
+    case uint8Array
+    case uint8ClampedArray
+    case int16Array
+    case uint16Array
+    case int32Array
+    case uint32Array
+    case float32Array
+    case float64Array
+
+    /// Size of one element in bytes (1 for `arrayBuffer`)
+    public var elementSize: Int {
+        switch self {
+        case .arrayBuffer, .int8Array, .uint8Array, .uint8ClampedArray:
+            return 1
+        case .int16Array, .uint16Array:
+            return 2
+        case .int32Array, .uint32Array, .float32Array:
+            return 4
+        case .float64Array:
+            return 8
+        }
+    }
+
+    /// Engine class ID of the object
+    internal var classId: JSObjectClassEnum {
+        switch self {
+        case .arrayBuffer: return JS_CLASS_ARRAY_BUFFER
+        case .int8Array: return JS_CLASS_INT8_ARRAY
+        case .uint8Array: return JS_CLASS_UINT8_ARRAY
+        case .uint8ClampedArray: return JS_CLASS_UINT8C_ARRAY
+        case .int16Array: return JS_CLASS_INT16_ARRAY
+        case .uint16Array: return JS_CLASS_UINT16_ARRAY
+        case .int32Array: return JS_CLASS_INT32_ARRAY
+        case .uint32Array: return JS_CLASS_UINT32_ARRAY
+        case .float32Array: return JS_CLASS_FLOAT32_ARRAY
+        case .float64Array: return JS_CLASS_FLOAT64_ARRAY
+        }
+    }
+
+    /// Look up the binary type for an engine class ID
+    internal init?(classId: Int32) {
+        guard let type = MQJSBinaryType.allCases.first(where: { Int32($0.classId.rawValue) == classId }) else {
+            return nil
+        }
+        self = type
+    }
+}
+
+/// Swift numeric types that map to a JavaScript typed array element type.
+public protocol MQJSTypedArrayElement {
+    /// The typed array type holding elements of this Swift type
+    static var typedArrayType: MQJSBinaryType { get }
+}
+
+extension Int8: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .int8Array }
+}
+
+extension UInt8: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .uint8Array }
+}
+
+extension Int16: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .int16Array }
+}
+
+extension UInt16: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .uint16Array }
+}
+
+extension Int32: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .int32Array }
+}
+
+extension UInt32: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .uint32Array }
+}
+
+extension Float: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .float32Array }
+}
+
+extension Double: MQJSTypedArrayElement {
+    public static var typedArrayType: MQJSBinaryType { return .float64Array }
+}
+
+// MARK: - Creating Binary Values
+
+extension MQJSValue {
+    /// Creates an `ArrayBuffer` or typed array holding a copy of the given bytes.
+    ///
+    /// The bytes are copied into the JavaScript heap with a single `memcpy`.
+    ///
+    /// ```swift
+    /// let payload = try MQJSValue(bytes: data, in: context)  // Uint8Array
+    /// context.globalObject["payload"] = payload
+    /// try context.eval("payload[0]")
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - bytes: The bytes to copy (`Data`, `[UInt8]`, a raw buffer, ...)
+    ///   - type: The kind of object to create (default: `Uint8Array`)
+    ///   - context: The JavaScript context
+    /// - Throws: `MQJSError.typeConversionError` if the byte count is not a multiple of
+    ///           the element size, or MQJSError if allocation fails
+    public convenience init<Bytes: ContiguousBytes>(
+        bytes: Bytes,
+        as type: MQJSBinaryType = .uint8Array,
+        in context: MQJSContext
+    ) throws {
+        let value = try bytes.withUnsafeBytes { raw in
+            try MQJSValue.makeBinary(raw, as: type, in: context)
+        }
+        self.init(context: context, jsValue: value)
+    }
+
+    /// Creates a typed array holding a copy of the given elements.
+    ///
+    /// ```swift
+    /// let samples = try MQJSValue(typedArray: [0.5, 0.25] as [Float], in: context)  // Float32Array
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - elements: The elements to copy
+    ///   - context: The JavaScript context
+    /// - Throws: MQJSError if allocation fails
+    public convenience init<Element: MQJSTypedArrayElement>(
+        typedArray elements: [Element],
+        in context: MQJSContext
+    ) throws {
+        let value = try elements.withUnsafeBytes { raw in
+            try MQJSValue.makeBinary(raw, as: Element.typedArrayType, in: context)
+        }
+        self.init(context: context, jsValue: value)
+    }
+
+    /// Allocate a binary object holding a copy of raw
+    private static func makeBinary(
+        _ raw: UnsafeRawBufferPointer,
+        as type: MQJSBinaryType,
+        in context: MQJSContext
+    ) throws -> JSValue {
+        try context.checkValid()
+
+        guard raw.count % type.elementSize == 0 else {
+            throw MQJSError.typeConversionError("Byte count \(raw.count) is not a multiple of the element size \(type.elementSize)")
+        }
+
+        let buffer = mqjs_new_array_buffer_copy(context.ctx, raw.baseAddress, raw.count)
+        if JS_IsException(buffer) != 0 {
+            throw try context.extractError()
+        }
+
+        if type == .arrayBuffer {
+            return buffer
+        }
+
+        // The typed array constructor roots the buffer while allocating the view
+        let array = mqjs_new_typed_array(context.ctx, Int32(type.classId.rawValue), buffer)
+        if JS_IsException(array) != 0 {
+            throw try context.extractError()
+        }
+        return array
+    }
+
+    // MARK: - Accessing Binary Values
+
+    /// The binary type of this value, or nil if it is not an `ArrayBuffer` or typed array
+    public var binaryType: MQJSBinaryType? {
+        guard isObject, let ctx = context else { return nil }
+        return MQJSBinaryType(classId: JS_GetClassID(ctx.ctx, jsValue))
+    }
+
+    /// Returns true if the value is an `ArrayBuffer`
+    public var isArrayBuffer: Bool {
+        return binaryType == .arrayBuffer
+    }
+
+    /// Returns true if the value is a typed array (`Uint8Array`, `Float64Array`, ...)
+    public var isTypedArray: Bool {
+        guard let type = binaryType else { return false }
+        return type != .arrayBuffer
+    }
+
+    /// Borrows the bytes of an `ArrayBuffer` or typed array without copying.
+    ///
+    /// For a typed array, only the bytes of its view are exposed.
+    ///
+    /// ```swift
+    /// let checksum = try value.withUnsafeBytes { bytes in
+    ///     bytes.reduce(0) { $0 &+ UInt32($1) }
+    /// }
+    /// ```
+    ///
+    /// - Important: The bytes live in the JavaScript heap, which the GC can move. Do not
+    ///   use the context (evaluate code, create values, access properties) inside `body`,
+    ///   and do not let the pointer escape it.
+    /// - Parameter body: A closure receiving the bytes
+    /// - Returns: The value returned by `body`
+    /// - Throws: `MQJSError.typeConversionError` if the value is not binary data
+    public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) throws -> R {
+        return try withUnsafeMutableBytes { bytes in
+            try body(UnsafeRawBufferPointer(bytes))
+        }
+    }
+
+    /// Borrows the bytes of an `ArrayBuffer` or typed array for in-place modification.
+    ///
+    /// - Important: The same restrictions as for `withUnsafeBytes(_:)` apply.
+    /// - Parameter body: A closure receiving the mutable bytes
+    /// - Returns: The value returned by `body`
+    /// - Throws: `MQJSError.typeConversionError` if the value is not binary data
+    public func withUnsafeMutableBytes<R>(_ body: (UnsafeMutableRawBufferPointer) throws -> R) throws -> R {
+        let ctx = try binaryContext()
+
+        var length: Int = 0
+        guard let pointer = mqjs_get_array_buffer_ptr(ctx.ctx, jsValue, &length) else {
+            throw MQJSError.typeConversionError("Value is not an ArrayBuffer or typed array")
+        }
+
+        return try body(UnsafeMutableRawBufferPointer(start: pointer, count: length))
+    }
+
+    /// Copies the bytes of an `ArrayBuffer` or typed array into `Data`.
+    ///
+    /// - Returns: A copy of the bytes
+    /// - Throws: `MQJSError.typeConversionError` if the value is not binary data
+    public func toData() throws -> Data {
+        return try withUnsafeBytes { bytes in
+            Data(bytes)
+        }
+    }
+
+    /// Copies the elements of a typed array into a Swift array.
+    ///
+    /// ```swift
+    /// let values: [Double] = try context.eval("new Float64Array([1, 2, 3])").toTypedArray()
+    /// ```
+    ///
+    /// - Returns: The elements
+    /// - Throws: `MQJSError.typeConversionError` if the value is not a typed array of
+    ///           the matching element type
+    public func toTypedArray<Element: MQJSTypedArrayElement>(of type: Element.Type = Element.self) throws -> [Element] {
+        guard binaryType == Element.typedArrayType else {
+            throw MQJSError.typeConversionError("Value is not a typed array of \(Element.self)")
+        }
+
+        // Copy rather than bind: the heap only guarantees word alignment
+        return try withUnsafeBytes { bytes in
+            let count = bytes.count / MemoryLayout<Element>.stride
+            return [Element](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+                UnsafeMutableRawBufferPointer(buffer).copyMemory(from: bytes)
+                initializedCount = count
+            }
+        }
+    }
+
+    /// Validates state for binary access and returns the context
+    private func binaryContext() throws -> MQJSContext {
+        let ctx = try checkedContext()
+        guard isObject else {
+            throw MQJSError.typeConversionError("Value is not an ArrayBuffer or typed array")
+        }
+        return ctx
+    }
+}
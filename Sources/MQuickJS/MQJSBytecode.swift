@@ -0,0 +1,530 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Bytecode Compilation and Loading
+
+extension MQJSContext {
+    /// Compiles JavaScript code to a relocatable bytecode image.
+    ///
+    /// Compilation runs in a private scratch context, so the result does not depend on
+    /// any context state and can be loaded into any number of contexts with
+    /// `loadBytecode(_:)`, skipping the parser entirely.
+    ///
+    /// ```swift
+    /// let bytecode = try MQJSContext.compileBytecode(bundleSource, filename: "bundle.js")
+    ///
+    /// let context = try MQJSContext()
+    /// let main = try context.loadBytecode(bytecode)
+    /// try context.run(main)
+    /// ```
+    ///
+    /// The image is only valid for the engine build and pointer width that produced it.
+    ///
+    /// - Parameters:
+    ///   - script: The JavaScript code to compile
+    ///   - filename: Filename recorded for error messages (default: "<bytecode>")
+    ///   - flags: Parse flags (default: returns last value)
+    ///   - memorySize: Size of the scratch memory used for compilation
+    /// - Returns: The bytecode image (header followed by the relocatable heap image)
+    /// - Throws: MQJSError if compilation fails
+    public static func compileBytecode(
+        _ script: String,
+        filename: String = "<bytecode>",
+        flags: Int32 = JS_EVAL_RETVAL,
+        memorySize: Int = memoryForDevelopment
+    ) throws -> Data {
+        let memBuf = try MQJSMemoryBuffer(size: memorySize)
+
+        // A compilation context holds the atoms in RAM and no stdlib objects
+        guard let compileCtx = JS_NewContext2(
+            memBuf.baseAddress,
+            memBuf.size,
+            mqjs_get_stdlib(),
+            1
+        ) else {
+            throw MQJSError.contextCreationFailed
+        }
+        defer { JS_FreeContext(compileCtx) }
+
+        let mainFunction = script.withCString { scriptCStr in
+            filename.withCString { filenameCStr in
+                JS_Parse(
+                    compileCtx,
+                    scriptCStr,
+                    script.utf8.count,
+                    filenameCStr,
+                    flags
+                )
+            }
+        }
+
+        if JS_IsException(mainFunction) != 0 {
+            // The parser reports every error as a SyntaxError; the compilation
+            // context has no Error.prototype, so only the message is formatted
+            throw MQJSError.evaluationError("SyntaxError: " + pendingErrorMessage(in: compileCtx))
+        }
+
+        var header = JSBytecodeHeader()
+        var dataPtr: UnsafePointer<UInt8>?
+        var dataLen: UInt32 = 0
+        JS_PrepareBytecode(compileCtx, &header, &dataPtr, &dataLen, mainFunction)
+
+        var bytecode = Data(capacity: MemoryLayout<JSBytecodeHeader>.size + Int(dataLen))
+        withUnsafeBytes(of: header) { bytecode.append(contentsOf: $0) }
+        if let dataPtr = dataPtr {
+            bytecode.append(dataPtr, count: Int(dataLen))
+        }
+        return bytecode
+    }
+
+    /// Whether `loadBytecode(_:)` can still be used on this context.
+    ///
+    /// Bytecode must be loaded before anything defines new atoms in the context
+    /// (evaluating scripts, setting properties with new names, registering functions),
+    /// and at most one image can be loaded per context.
+    public var canLoadBytecode: Bool {
+        guard (try? checkValid()) != nil else { return false }
+        return JS_CanLoadBytecode(ctx) != 0
+    }
+
+    /// Loads a bytecode image produced by `compileBytecode(_:filename:flags:memorySize:)`.
+    ///
+    /// The image is copied and relocated, and the copy is kept alive for the context
+    /// lifetime because the engine executes it in place. Use `run(_:)` on the returned
+    /// function to execute it. To load the same image into many contexts, prefer
+    /// `loadBytecode(_:)` with an `MQJSSharedBytecode`, which is never copied.
+    ///
+    /// ```swift
+    /// let main = try context.loadBytecode(bytecode)
+    /// let result = try context.run(main)
+    /// ```
+    ///
+    /// - Parameter bytecode: The bytecode image
+    /// - Returns: The compiled main function
+    /// - Throws: `MQJSError.bytecodeError` if the image is invalid or the context
+    ///           can no longer load bytecode (see `canLoadBytecode`)
+    public func loadBytecode(_ bytecode: Data) throws -> MQJSValue {
+        try checkValid()
+        try checkCanLoadBytecode()
+
+        let image = try MQJSMemoryBuffer(copying: bytecode)
+        let bytes = image.baseAddress.assumingMemoryBound(to: UInt8.self)
+
+        guard JS_IsBytecode(bytes, image.size) != 0,
+              JS_RelocateBytecode(ctx, bytes, UInt32(image.size)) == 0 else {
+            throw MQJSError.bytecodeError("Invalid or incompatible bytecode image")
+        }
+
+        return try loadRelocatedBytecode(bytes, owner: image)
+    }
+
+    /// Loads a shared bytecode image in place.
+    ///
+    /// The image is already relocated, so loading costs no copy and no relocation:
+    /// the context only references the read-only pages of the image, which are shared
+    /// with every other context that loaded it. The context keeps the image alive.
+    ///
+    /// ```swift
+    /// let library = try MQJSSharedBytecode(contentsOf: libraryURL)
+    ///
+    /// for _ in 0..<workerCount {
+    ///     let context = try MQJSContext()
+    ///     try context.run(context.loadBytecode(library))
+    /// }
+    /// ```
+    ///
+    /// - Parameter bytecode: The shared image
+    /// - Returns: The compiled main function
+    /// - Throws: `MQJSError.bytecodeError` if the context can no longer load bytecode
+    ///           (see `canLoadBytecode`)
+    public func loadBytecode(_ bytecode: MQJSSharedBytecode) throws -> MQJSValue {
+        try checkValid()
+        try checkCanLoadBytecode()
+        return try loadRelocatedBytecode(bytecode.baseAddress, owner: bytecode)
+    }
+
+    private func checkCanLoadBytecode() throws {
+        guard JS_CanLoadBytecode(ctx) != 0 else {
+            throw MQJSError.bytecodeError("Bytecode must be loaded before any atom is defined in the context")
+        }
+    }
+
+    private func loadRelocatedBytecode(_ bytes: UnsafePointer<UInt8>, owner: AnyObject) throws -> MQJSValue {
+        let result = JS_LoadBytecode(ctx, bytes)
+        if JS_IsException(result) != 0 {
+            throw try extractError()
+        }
+
+        bytecodeBuffers.append(owner)
+        return MQJSValue(context: self, jsValue: result)
+    }
+
+    /// Evaluates JavaScript code, using a bytecode cache to skip parsing.
+    ///
+    /// When the context can still load bytecode (see `canLoadBytecode`), the shared
+    /// image is fetched from `cache` (compiling it on a miss) and run in place, so
+    /// contexts running the same script share a single copy of its bytecode.
+    /// Otherwise this behaves like `eval(_:filename:flags:)`.
+    ///
+    /// ```swift
+    /// let cache = MQJSBytecodeCache()
+    ///
+    /// for _ in 0..<workerCount {
+    ///     let context = try MQJSContext()
+    ///     try context.eval(bundleSource, filename: "bundle.js", cache: cache)
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - script: The JavaScript code to evaluate
+    ///   - filename: Optional filename for error messages (default: "<eval>")
+    ///   - flags: Evaluation flags (default: returns last value)
+    ///   - cache: The bytecode cache to consult
+    /// - Returns: The result of evaluating the script
+    /// - Throws: MQJSError if compilation or evaluation fails
+    @discardableResult
+    public func eval(
+        _ script: String,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL,
+        cache: MQJSBytecodeCache
+    ) throws -> MQJSValue {
+        try checkValid()
+
+        guard JS_CanLoadBytecode(ctx) != 0 else {
+            return try eval(script, filename: filename, flags: flags)
+        }
+
+        let bytecode = try cache.sharedBytecode(for: script, filename: filename, flags: flags)
+        return try run(loadBytecode(bytecode))
+    }
+}
+
+// MARK: - Shared Bytecode
+
+/// A bytecode image relocated once and shared read-only by any number of contexts.
+///
+/// Relocating an image only depends on its address and on the built-in atoms, which
+/// are the same in every context of the process. A shared image is relocated when it
+/// is created, then made read-only: the engine executes it in place like ROM, so
+/// loading it into a context costs neither a copy nor a relocation, and its pages are
+/// resident once however many contexts use it.
+///
+/// Images created from a file are memory-mapped: only the pages patched by the
+/// relocation become private, the rest stay backed by the file.
+///
+/// A shared image is immutable and can be used from any thread. It stays alive as
+/// long as a context (or snapshot) that loaded it exists.
+///
+/// ```swift
+/// let library = try MQJSSharedBytecode(contentsOf: bundleURL)
+/// let context = try MQJSContext()
+/// try context.run(context.loadBytecode(library))
+/// ```
+public final class MQJSSharedBytecode {
+    /// Start of the read-only image
+    internal let baseAddress: UnsafePointer<UInt8>
+
+    /// Size of the image in bytes
+    public let size: Int
+
+    /// Memory-maps a bytecode file written from `MQJSContext.compileBytecode`.
+    ///
+    /// - Parameter url: The file URL of the bytecode image
+    /// - Throws: `MQJSError.bytecodeError` if the file cannot be mapped or is not valid
+    ///           bytecode for this engine build
+    public init(contentsOf url: URL) throws {
+        var size = 0
+        let image = try Self.withRelocationContext { ctx in
+            url.withUnsafeFileSystemRepresentation { path in
+                path.flatMap { mqjs_map_bytecode_file(ctx, $0, &size) }
+            }
+        }
+        guard let image = image else {
+            throw MQJSError.bytecodeError("Cannot map bytecode file '\(url.path)'")
+        }
+        self.baseAddress = UnsafePointer(image)
+        self.size = size
+    }
+
+    /// Memory-maps a bytecode cache entry: the image followed by `tag`.
+    ///
+    /// The tag is checked on the mapped file itself, so an entry written for another
+    /// script or build is rejected before it is relocated.
+    internal init(cacheEntry url: URL, tag: Data) throws {
+        var size = 0
+        let image = try Self.withRelocationContext { ctx in
+            tag.withUnsafeBytes { tagBytes in
+                url.withUnsafeFileSystemRepresentation { path in
+                    path.flatMap {
+                        mqjs_map_bytecode_cache_file(
+                            ctx, $0, tagBytes.bindMemory(to: UInt8.self).baseAddress, tagBytes.count, &size)
+                    }
+                }
+            }
+        }
+        guard let image = image else {
+            throw MQJSError.bytecodeError("Cannot map bytecode cache entry '\(url.path)'")
+        }
+        self.baseAddress = UnsafePointer(image)
+        self.size = size
+    }
+
+    /// Creates a shared image from bytecode in memory, copying it once.
+    ///
+    /// - Parameter bytecode: An image produced by `MQJSContext.compileBytecode`
+    /// - Throws: `MQJSError.bytecodeError` if the image is invalid or incompatible
+    public init(_ bytecode: Data) throws {
+        let image = try Self.withRelocationContext { ctx in
+            bytecode.withUnsafeBytes { bytes -> UnsafeMutablePointer<UInt8>? in
+                guard let base = bytes.bindMemory(to: UInt8.self).baseAddress else { return nil }
+                return mqjs_map_bytecode(ctx, base, bytes.count)
+            }
+        }
+        guard let image = image else {
+            throw MQJSError.bytecodeError("Invalid or incompatible bytecode image")
+        }
+        self.baseAddress = UnsafePointer(image)
+        self.size = bytecode.count
+    }
+
+    deinit {
+        mqjs_unmap_bytecode(UnsafeMutablePointer(mutating: baseAddress), size)
+    }
+
+    /// Runs body with a scratch context, used to look up the built-in atoms
+    private static func withRelocationContext<T>(_ body: (OpaquePointer) throws -> T) throws -> T {
+        let memBuf = try MQJSMemoryBuffer(size: MQJSMemoryBuffer.minimumSize)
+        guard let ctx = JS_NewContext(memBuf.baseAddress, memBuf.size, mqjs_get_stdlib()) else {
+            throw MQJSError.contextCreationFailed
+        }
+        defer { JS_FreeContext(ctx) }
+        return try body(ctx)
+    }
+}
+
+// MARK: - Bytecode Cache
+
+/// A content-hash keyed cache of compiled bytecode images.
+///
+/// Keys are SHA-256 digests of the script source, filename and flags and of the engine
+/// build (version, word size and stdlib), so an edited script or an updated engine never
+/// hits a stale entry. Images are kept in memory and, when a directory is given, also
+/// stored on disk so later processes skip compilation too. Each stored entry ends with
+/// its key, which is checked before the image is loaded.
+///
+/// The cache is thread-safe and is meant to be shared by all contexts that run the
+/// same scripts.
+///
+/// ```swift
+/// let cache = MQJSBytecodeCache(directory: cachesURL.appendingPathComponent("bytecode"))
+/// let bytecode = try cache.bytecode(for: bundleSource, filename: "bundle.js")
+/// ```
+public final class MQJSBytecodeCache {
+    /// Directory for persisted images, or nil for an in-memory cache
+    public let directory: URL?
+
+    /// Memory size used to compile scripts on a cache miss
+    public let compileMemorySize: Int
+
+    /// In-memory images keyed by digest
+    private var entries: [Data: Data] = [:]
+
+    /// Shared images keyed by digest
+    private var sharedEntries: [Data: MQJSSharedBytecode] = [:]
+
+    /// Lock for thread-safe access to entries
+    private let lock = NSLock()
+
+    /// File extension of persisted images
+    private static let fileExtension = "mqjsbc"
+
+    /// Creates a bytecode cache.
+    ///
+    /// - Parameters:
+    ///   - directory: Directory to persist images in (created if needed), or nil to
+    ///     keep images in memory only
+    ///   - compileMemorySize: Memory size used to compile scripts on a cache miss
+    public init(directory: URL? = nil, compileMemorySize: Int = MQJSContext.memoryForDevelopment) {
+        self.directory = directory
+        self.compileMemorySize = compileMemorySize
+
+        if let directory = directory {
+            try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        }
+    }
+
+    /// Number of images held in memory
+    public var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+
+    /// Returns the bytecode image for a script, compiling it on a miss.
+    ///
+    /// - Parameters:
+    ///   - script: The JavaScript code
+    ///   - filename: Filename recorded for error messages
+    ///   - flags: Parse flags
+    /// - Returns: The bytecode image
+    /// - Throws: MQJSError if compilation fails
+    public func bytecode(
+        for script: String,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL
+    ) throws -> Data {
+        let key = Self.key(for: script, filename: filename, flags: flags)
+
+        lock.lock()
+        let cached = entries[key]
+        lock.unlock()
+
+        if let cached = cached {
+            return cached
+        }
+
+        let fileURL = self.fileURL(for: key)
+        if let fileURL = fileURL,
+           let stored = try? Data(contentsOf: fileURL),
+           let image = Self.image(fromEntry: stored, key: key) {
+            store(image, for: key)
+            return image
+        }
+
+        let compiled = try MQJSContext.compileBytecode(
+            script,
+            filename: filename,
+            flags: flags,
+            memorySize: compileMemorySize
+        )
+        store(compiled, for: key)
+
+        if let fileURL = fileURL {
+            try? (compiled + Self.tag(for: key)).write(to: fileURL, options: .atomic)
+        }
+
+        return compiled
+    }
+
+    /// Returns the shared image for a script, compiling it on a miss.
+    ///
+    /// The image is created once per script and returned to every caller, so all the
+    /// contexts that load it use the same read-only pages. Persisted images are
+    /// memory-mapped instead of read.
+    ///
+    /// - Parameters:
+    ///   - script: The JavaScript code
+    ///   - filename: Filename recorded for error messages
+    ///   - flags: Parse flags
+    /// - Returns: The shared image
+    /// - Throws: MQJSError if compilation fails
+    public func sharedBytecode(
+        for script: String,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL
+    ) throws -> MQJSSharedBytecode {
+        let key = Self.key(for: script, filename: filename, flags: flags)
+
+        lock.lock()
+        let cached = sharedEntries[key]
+        lock.unlock()
+
+        if let cached = cached {
+            return cached
+        }
+
+        let shared: MQJSSharedBytecode
+        if let fileURL = fileURL(for: key),
+           let mapped = try? MQJSSharedBytecode(cacheEntry: fileURL, tag: Self.tag(for: key)) {
+            shared = mapped
+        } else {
+            shared = try MQJSSharedBytecode(bytecode(for: script, filename: filename, flags: flags))
+        }
+
+        // Another thread may have created the image meanwhile: keep a single one
+        lock.lock()
+        defer { lock.unlock() }
+        if let existing = sharedEntries[key] {
+            return existing
+        }
+        sharedEntries[key] = shared
+        return shared
+    }
+
+    /// Removes all in-memory images. Persisted images are left on disk, and
+    /// shared images stay alive while contexts use them.
+    public func removeAll() {
+        lock.lock()
+        entries.removeAll()
+        sharedEntries.removeAll()
+        lock.unlock()
+    }
+
+    // MARK: - Private Helpers
+
+    private func store(_ bytecode: Data, for key: Data) {
+        lock.lock()
+        entries[key] = bytecode
+        lock.unlock()
+    }
+
+    private func fileURL(for key: Data) -> URL? {
+        guard let directory = directory else { return nil }
+        let name = key.map { String(format: "%02x", $0) }.joined()
+        return directory.appendingPathComponent(name).appendingPathExtension(Self.fileExtension)
+    }
+
+    /// Marks the end of a stored entry, followed by its key
+    private static let entryMagic = Data("MQJSBC01".utf8)
+
+    /// Trailer of the stored entry for key
+    private static func tag(for key: Data) -> Data {
+        return entryMagic + key
+    }
+
+    /// Returns the image of a stored entry if it was written for key and holds
+    /// bytecode for this build
+    private static func image(fromEntry entry: Data, key: Data) -> Data? {
+        let trailer = tag(for: key)
+        guard entry.count > trailer.count, entry.suffix(trailer.count) == trailer else { return nil }
+
+        let image = Data(entry.prefix(entry.count - trailer.count))
+        let valid = image.withUnsafeBytes { bytes -> Bool in
+            guard let base = bytes.bindMemory(to: UInt8.self).baseAddress else { return false }
+            return JS_IsBytecode(base, bytes.count) != 0
+        }
+        return valid ? image : nil
+    }
+
+    /// Digest of the engine build, which images are specific to
+    private static let buildID: [UInt8] = {
+        var digest = [UInt8](repeating: 0, count: 32)
+        mqjs_get_build_id(&digest)
+        return digest
+    }()
+
+    /// SHA-256 of everything that affects the compiled image
+    private static func key(for script: String, filename: String, flags: Int32) -> Data {
+        var sha = MQJSSHA256()
+        mqjs_sha256_init(&sha)
+
+        func mix<S: Sequence>(_ bytes: S) where S.Element == UInt8 {
+            let array = Array(bytes)
+            array.withUnsafeBytes { mqjs_sha256_update(&sha, $0.baseAddress, $0.count) }
+        }
+
+        // Length-prefix the variable fields so they cannot run into each other
+        mix(buildID)
+        withUnsafeBytes(of: flags) { mix($0) }
+        withUnsafeBytes(of: UInt64(filename.utf8.count)) { mix($0) }
+        mix(filename.utf8)
+        withUnsafeBytes(of: UInt64(script.utf8.count)) { mix($0) }
+        var source = script
+        source.withUTF8 { mqjs_sha256_update(&sha, $0.baseAddress, $0.count) }
+
+        var digest = [UInt8](repeating: 0, count: 32)
+        mqjs_sha256_final(&sha, &digest)
+        return Data(digest)
+    }
+}
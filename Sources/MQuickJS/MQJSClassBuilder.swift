@@ -3,8 +3,8 @@ import CMQuickJS
 
 /// Builder for defining a Swift class to expose to JavaScript.
 ///
-/// Use this builder to define the constructor and methods for a class
-/// that will be accessible from JavaScript via the `new` keyword.
+/// Use this builder to define the constructor, methods and properties for a
+/// class that will be accessible from JavaScript via the `new` keyword.
 ///
 /// ```swift
 /// try context.registerClass("Counter") { builder in
@@ -16,11 +16,15 @@ import CMQuickJS
 ///         this.increment()
 ///         return nil
 ///     }
-///     builder.method("getValue") { this, args in
-///         return this.getValue()
-///     }
+///     builder.property("value", get: { this in this.value }, set: { this, value in
+///         this.value = Int(try value.toInt32())
+///     })
 /// }
 /// ```
+///
+/// Each JavaScript object holds a strong reference to its Swift instance, which
+/// is released when the object is garbage collected or the context is freed.
+/// The `deinit` of the class must not use the context.
 public final class MQJSClassBuilder<T: AnyObject> {
     // MARK: - Type Aliases
 
@@ -30,6 +34,15 @@ public final class MQJSClassBuilder<T: AnyObject> {
     /// Method function type: receives Swift instance and JS arguments, returns value
     public typealias Method = (T, [MQJSValue]) throws -> Any?
 
+    /// Fast method function type: receives Swift instance and borrowed JS arguments
+    public typealias FastMethod = (T, MQJSArguments) throws -> MQJSNativeResult
+
+    /// Property getter type: receives Swift instance, returns value
+    public typealias Getter = (T) throws -> Any?
+
+    /// Property setter type: receives Swift instance and the assigned JS value
+    public typealias Setter = (T, MQJSValue) throws -> Void
+
     // MARK: - Stored Definitions
 
     /// The constructor function for creating instances
@@ -38,6 +51,12 @@ public final class MQJSClassBuilder<T: AnyObject> {
     /// Dictionary of method name to method implementation
     internal var methods: [String: Method] = [:]
 
+    /// Dictionary of method name to fast method implementation
+    internal var fastMethods: [String: FastMethod] = [:]
+
+    /// Dictionary of property name to accessors
+    internal var properties: [String: (getter: Getter, setter: Setter?)] = [:]
+
     // MARK: - Builder Methods
 
     /// Define the constructor for this class.
@@ -76,4 +95,44 @@ public final class MQJSClassBuilder<T: AnyObject> {
         self.methods[name] = fn
         return self
     }
+
+    /// Define a fast method for this class.
+    ///
+    /// Like `MQJSContext.setFastFunction(_:_:)`, the method reads its arguments
+    /// from the JavaScript stack and returns a typed result, so a call allocates
+    /// nothing on the Swift side.
+    ///
+    /// ```swift
+    /// builder.fastMethod("add") { this, args in
+    ///     this.value += Int(try args.int32(at: 0))
+    ///     return .undefined
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - name: The method name as it appears in JavaScript
+    ///   - fn: A closure that receives the Swift instance and the borrowed arguments
+    @discardableResult
+    public func fastMethod(_ name: String, _ fn: @escaping FastMethod) -> Self {
+        self.fastMethods[name] = fn
+        return self
+    }
+
+    /// Define a property for this class, backed by native accessors.
+    ///
+    /// ```swift
+    /// builder.property("name", get: { this in this.name }, set: { this, value in
+    ///     this.name = try value.toString()
+    /// })
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - name: The property name as it appears in JavaScript
+    ///   - get: A closure that returns the property value of the Swift instance
+    ///   - set: A closure that receives the assigned value (nil for a read-only property)
+    @discardableResult
+    public func property(_ name: String, get: @escaping Getter, set: Setter? = nil) -> Self {
+        self.properties[name] = (getter: get, setter: set)
+        return self
+    }
 }
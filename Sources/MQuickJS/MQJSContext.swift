@@ -40,11 +40,16 @@ public let JS_EVAL_JSON = mqjs_eval_flag_json()
 public final class MQJSContext {
     // MARK: - Internal State
 
-    /// The underlying C context (opaque pointer)
-    internal let ctx: OpaquePointer
+    /// The underlying C context (opaque pointer). Changes when the memory buffer
+    /// is resized, so it must not be cached across calls into JavaScript.
+    internal private(set) var ctx: OpaquePointer
 
-    /// Memory buffer - MUST stay alive for context lifetime
-    internal let memoryBuffer: MQJSMemoryBuffer
+    /// Memory buffer - MUST stay alive while the context uses it
+    internal private(set) var memoryBuffer: MQJSMemoryBuffer
+
+    /// Loaded bytecode images (`MQJSMemoryBuffer` copies or `MQJSSharedBytecode`) -
+    /// referenced in place by the engine, so they MUST stay alive for context lifetime
+    internal var bytecodeBuffers: [AnyObject] = []
 
     /// Track if context is valid (not freed)
     private var isValid: Bool = true
@@ -52,31 +57,115 @@ public final class MQJSContext {
     /// Weak references to all live values to coordinate cleanup
     private var liveValues = NSHashTable<MQJSValue>.weakObjects()
 
+    /// The open `withScope` scopes, innermost last
+    internal var scopes: [MQJSScope] = []
+
+    /// Incremented each time the live values are invalidated (snapshot, restore),
+    /// so that cached handles such as `MQJSPropertyKey` can re-create them
+    internal private(set) var valueGeneration = 0
+
     // MARK: - Native Function Binding
 
     /// Type alias for native function handlers
     public typealias NativeFunction = ([MQJSValue]) throws -> Any?
 
-    /// Registry of native functions keyed by ID
-    private var nativeFunctions: [Int32: NativeFunction] = [:]
+    /// Type alias for fast native function handlers (borrowed arguments, typed result)
+    public typealias FastNativeFunction = (MQJSArguments) throws -> MQJSNativeResult
+
+    /// Method of a registered class: receives the Swift instance of `this`
+    fileprivate typealias InstanceMethod = (UnsafeMutableRawPointer, MQJSArguments) throws -> MQJSNativeResult
+
+    /// A registered native function
+    fileprivate enum NativeHandler {
+        case boxed(NativeFunction)
+        case fast(FastNativeFunction)
+        case constructor(classId: Int32, ([MQJSValue]) throws -> AnyObject)
+        case method(classId: Int32, InstanceMethod)
+    }
+
+    /// Native functions indexed by ID.
+    ///
+    /// IDs are allocated sequentially from 0, so dispatching a call is an array access.
+    fileprivate struct NativeFunctionTable {
+        private var handlers: [NativeHandler?] = []
+
+        subscript(id: Int32) -> NativeHandler? {
+            get {
+                let index = Int(id)
+                return index >= 0 && index < handlers.count ? handlers[index] : nil
+            }
+            set {
+                let index = Int(id)
+                if index >= handlers.count {
+                    handlers.append(contentsOf: repeatElement(nil, count: index - handlers.count + 1))
+                }
+                handlers[index] = newValue
+            }
+        }
+
+        mutating func removeValue(forKey id: Int32) {
+            self[id] = nil
+        }
+
+        mutating func removeAll() {
+            handlers.removeAll()
+        }
+
+        /// Number of slots, including the ones of removed or failed registrations
+        var capacity: Int {
+            return handlers.count
+        }
+    }
+
+    /// Registry of native functions of this context
+    private var nativeFunctions = NativeFunctionTable()
 
     /// Counter for generating unique function IDs
     private var nextFunctionId: Int32 = 0
 
-    // MARK: - Custom Class Registration
+    /// Number of slots in the native function table (for tests)
+    internal var nativeFunctionCapacity: Int {
+        return nativeFunctions.capacity
+    }
+
+    // MARK: - Garbage Collection Tuning
+
+    /// Backing store for `gcCompactionThreshold` (the engine has no getter)
+    private var compactionThreshold: Int = 0
 
-    /// Registry of Swift object instances keyed by instance ID
-    private var instanceRegistry: [Int32: AnyObject] = [:]
+    /// Backing store for `gcAllocationBudget`
+    private var allocationBudget: Int = 0
 
-    /// Counter for generating unique instance IDs
-    private var nextInstanceId: Int32 = 0
+    /// Measured cost of the last compaction, used by `collectGarbage(budgetMicroseconds:)`
+    private var lastCompactionNanoseconds: UInt64?
 
-    /// Static registry to look up context by opaque pointer
-    /// This is needed because C callbacks can't capture Swift context
-    private static var contextRegistry: [UnsafeMutableRawPointer: MQJSContext] = [:]
+    // MARK: - Execution Limits State
 
-    /// Lock for thread-safe access to contextRegistry
-    private static let registryLock = NSLock()
+    /// Backing store for `interruptInterval` (the engine has no getter)
+    private var checkInterval: Int = 10000
+
+    /// Deadline of the running limited calls, in uptime nanoseconds
+    private var activeDeadline: UInt64?
+
+    /// Instruction budget left for the running limited calls
+    private var remainingBudget: Int?
+
+    /// Nesting depth of limited calls (the interrupt handler is installed while > 0)
+    private var limitDepth = 0
+
+    /// Set once a limit is exceeded, until the outermost limited call returns
+    private var isInterrupting = false
+
+    // MARK: - Profiling State
+
+    /// Collector of the running profile, if any
+    private var profiler: MQJSProfiler?
+
+    // MARK: - Custom Class Registration
+
+    /// Class ID of the next registered class. The instances of a class are objects
+    /// of this class ID holding a retained pointer to their Swift instance.
+    private var nextClassId = Int32(JS_CLASS_USER.rawValue)
 
     // MARK: - Memory Size Constants
 
@@ -102,13 +191,24 @@ public final class MQJSContext {
 
     /// Creates a new JavaScript context.
     ///
+    /// By default the memory buffer has a fixed size. With a `maximumMemorySize`
+    /// larger than `memorySize`, the context starts small and moves to a larger
+    /// buffer between calls when its heap gets full (see `maximumMemorySize`).
+    ///
+    /// ```swift
+    /// // Start at 256KB, grow up to 8MB if the script needs it
+    /// let context = try MQJSContext(memorySize: 256 * 1024, maximumMemorySize: 8 * 1024 * 1024)
+    /// ```
+    ///
     /// - Parameters:
     ///   - memorySize: Size of memory buffer in bytes (default: 1MB, minimum: 64KB)
+    ///   - maximumMemorySize: Size up to which the buffer can grow (default: no growth)
     /// - Throws: MQJSError if context creation fails
-    public init(memorySize: Int = defaultMemorySize) throws {
+    public init(memorySize: Int = defaultMemorySize, maximumMemorySize: Int? = nil) throws {
         guard memorySize >= Self.minimumMemorySize else {
             throw MQJSError.invalidMemorySize(memorySize)
         }
+        self.maximumMemorySize = max(maximumMemorySize ?? memorySize, memorySize)
 
         // Allocate memory buffer
         let memBuf = try MQJSMemoryBuffer(size: memorySize)
@@ -128,56 +228,55 @@ public final class MQJSContext {
         self.ctx = context
 
         // Set up native function callback support
-        Self.initializeNativeCallback()
-        registerWithContextRegistry()
+        _ = Self.callbacksInstalled
+        mqjs_set_context_opaque(ctx, Unmanaged.passUnretained(self).toOpaque())
     }
 
-    /// Initialize the native callback (only once globally)
-    private static var nativeCallbackInitialized = false
-
-    private static func initializeNativeCallback() {
-        guard !nativeCallbackInitialized else { return }
-        nativeCallbackInitialized = true
-
-        // Set the C callback that will be invoked when JS calls native functions
+    /// Installs the C callbacks invoked when JS calls native functions and when class
+    /// instances are finalized. A static `let` is initialized once, even when contexts
+    /// are created on several threads.
+    private static let callbacksInstalled: Void = {
         mqjs_set_native_callback(nativeCallbackHandler)
+        mqjs_set_finalizer_callback(finalizerHandler)
+    }()
+
+    /// Returns the context whose engine context passed `opaque` to a C callback.
+    ///
+    /// The opaque is the unretained context pointer, so callbacks resolve their context
+    /// without any global table or lock. It is cleared in `invalidate()` before the
+    /// engine context is freed, so a callback never sees a context being deinitialized.
+    private static func context(fromOpaque opaque: UnsafeMutableRawPointer?) -> MQJSContext? {
+        guard let opaque = opaque else { return nil }
+        return Unmanaged<MQJSContext>.fromOpaque(opaque).takeUnretainedValue()
     }
 
     /// Static callback handler for native function calls from C
     private static let nativeCallbackHandler: MQJSNativeCallback = { opaque, functionId, argc, argv, thisVal in
-        guard let opaque = opaque else {
-            return mqjs_get_exception()
-        }
-
-        // Look up the context
-        registryLock.lock()
-        let context = contextRegistry[opaque]
-        registryLock.unlock()
-
-        guard let context = context else {
+        guard let context = MQJSContext.context(fromOpaque: opaque) else {
             return mqjs_get_exception()
         }
 
         return context.handleNativeCall(functionId: functionId, argc: argc, argv: argv, thisVal: thisVal)
     }
 
-    /// Register this context in the static registry
-    private func registerWithContextRegistry() {
-        let opaquePtr = Unmanaged.passUnretained(self).toOpaque()
-        mqjs_set_context_opaque(ctx, opaquePtr)
+    /// Static handler releasing the Swift instance of a collected class instance object
+    private static let finalizerHandler: MQJSFinalizerCallback = { instance in
+        guard let instance = instance else { return }
+        Unmanaged<AnyObject>.fromOpaque(instance).release()
+    }
 
-        Self.registryLock.lock()
-        Self.contextRegistry[opaquePtr] = self
-        Self.registryLock.unlock()
+    /// Static interrupt handler, polled by the interpreter during limited calls
+    private static let interruptHandler: @convention(c) (OpaquePointer?, UnsafeMutableRawPointer?) -> Int32 = { _, opaque in
+        return MQJSContext.context(fromOpaque: opaque)?.checkExecutionLimits() == true ? 1 : 0
     }
 
-    /// Unregister this context from the static registry
-    private func unregisterFromContextRegistry() {
-        let opaquePtr = Unmanaged.passUnretained(self).toOpaque()
+    /// Static handler for the call stack samples of the profiler
+    private static let profileHandler: @convention(c) (
+        OpaquePointer?, UnsafeMutableRawPointer?, UnsafePointer<JSProfileFrame>?, Int32
+    ) -> Void = { _, opaque, frames, frameCount in
+        guard let frames = frames else { return }
 
-        Self.registryLock.lock()
-        Self.contextRegistry.removeValue(forKey: opaquePtr)
-        Self.registryLock.unlock()
+        MQJSContext.context(fromOpaque: opaque)?.profiler?.record(frames, count: Int(frameCount))
     }
 
     deinit {
@@ -191,66 +290,60 @@ public final class MQJSContext {
         guard isValid else { return }
         isValid = false
 
-        // Unregister from context registry
-        unregisterFromContextRegistry()
+        // Detach from the engine context: callbacks run from now on (e.g. by
+        // finalizers) find no Swift context
+        mqjs_set_context_opaque(ctx, nil)
 
         // Clear native functions
         nativeFunctions.removeAll()
 
-        // Clear instance registry (Swift ARC will deallocate objects)
-        instanceRegistry.removeAll()
-
         // Invalidate all live values first
-        for value in liveValues.allObjects {
-            value.invalidate()
-        }
-        liveValues.removeAllObjects()
+        invalidateValues()
 
-        // Free context (triggers GC cleanup and finalizers)
+        // Free context (the finalizers release the class instances)
         JS_FreeContext(ctx)
 
         // Memory buffer deallocates automatically in deinit
     }
 
+    /// Invalidate all live values, releasing their GC references
+    private func invalidateValues() {
+        for value in liveValues.allObjects {
+            value.invalidate()
+        }
+        liveValues.removeAllObjects()
+        valueGeneration += 1
+    }
+
     // MARK: - Native Function Handling
 
     /// Handle a native function call from JavaScript
     private func handleNativeCall(functionId: Int32, argc: Int32, argv: UnsafeMutablePointer<JSValue>?, thisVal: JSValue) -> JSValue {
         // Look up the function
-        guard let function = nativeFunctions[functionId] else {
+        let function: NativeFunction
+        switch nativeFunctions[functionId] {
+        case .boxed(let boxed)?:
+            function = boxed
+        case .fast(let fast)?:
+            return handleFastNativeCall(fast, argc: argc, argv: argv)
+        case .method(let classId, let method)?:
+            return handleMethodCall(method, classId: classId, argc: argc, argv: argv, thisVal: thisVal)
+        case .constructor(let classId, let constructor)?:
+            return handleConstructorCall(constructor, classId: classId, argc: argc, argv: argv)
+        case nil:
             _ = mqjs_throw_internal_error(ctx, "Native function not found")
             return mqjs_get_exception()
         }
 
-        // Convert arguments to MQJSValue array
-        var args: [MQJSValue] = []
-        if let argv = argv, argc > 0 {
-            for i in 0..<Int(argc) {
-                let jsValue = argv[i]
-                args.append(MQJSValue(context: self, jsValue: jsValue))
-            }
-        }
+        nativeCallDepth += 1
+        defer { nativeCallDepth -= 1 }
 
-        // Store thisVal for method calls that need it
-        let thisValue = MQJSValue(context: self, jsValue: thisVal)
-        currentThisValue = thisValue
+        // Boxed after entering the call, so a scope of the caller does not root them
+        let args = boxedArguments(argc: argc, argv: argv)
 
         // Call the Swift function
         do {
-            let result = try function(args)
-
-            // Convert result back to JSValue
-            if let result = result {
-                if let jsValue = result as? MQJSValue {
-                    return jsValue.jsValue
-                } else {
-                    // Convert Swift value to JS
-                    let converted = try convertToJSValue(result)
-                    return converted.jsValue
-                }
-            } else {
-                return mqjs_get_undefined()
-            }
+            return try nativeResult(function(args)).toJSValue(in: self)
         } catch {
             // Throw JS error
             let message = "\(error)"
@@ -259,63 +352,124 @@ public final class MQJSContext {
         }
     }
 
-    /// Current 'this' value during native function calls (for method binding)
-    internal var currentThisValue: MQJSValue?
+    /// Handle a call to a fast native function.
+    ///
+    /// Arguments are borrowed from the JavaScript stack and the result is converted
+    /// without boxing, so no MQJSValue is created on this path.
+    private func handleFastNativeCall(_ function: FastNativeFunction, argc: Int32, argv: UnsafeMutablePointer<JSValue>?) -> JSValue {
+        nativeCallDepth += 1
+        defer { nativeCallDepth -= 1 }
 
-    /// Convert a Swift value to MQJSValue
-    private func convertToJSValue(_ value: Any) throws -> MQJSValue {
-        switch value {
-        case let jsValue as MQJSValue:
-            return jsValue
-        case let boolValue as Bool:
-            return try boolValue.toJSValue(in: self)
-        case let intValue as Int:
-            return try intValue.toJSValue(in: self)
-        case let int32Value as Int32:
-            return try int32Value.toJSValue(in: self)
-        case let doubleValue as Double:
-            return try doubleValue.toJSValue(in: self)
-        case let stringValue as String:
-            return try stringValue.toJSValue(in: self)
-        case let arrayValue as [Any]:
-            // Convert array elements recursively
-            let jsArray = JS_NewArray(ctx, Int32(arrayValue.count))
-            let arrayWrapper = MQJSValue(context: self, jsValue: jsArray)
-            for (index, element) in arrayValue.enumerated() {
-                arrayWrapper[index] = try convertToJSValue(element)
-            }
-            return arrayWrapper
-        case let dictValue as [String: Any]:
-            // Convert dictionary entries recursively
-            let jsObject = JS_NewObject(ctx)
-            let objectWrapper = MQJSValue(context: self, jsValue: jsObject)
-            for (key, element) in dictValue {
-                objectWrapper[key] = try convertToJSValue(element)
+        do {
+            let result = try function(MQJSArguments(context: self, argc: argc, argv: argv))
+            return result.toJSValue(in: self)
+        } catch {
+            let message = "\(error)"
+            _ = mqjs_throw_internal_error(ctx, message)
+            return mqjs_get_exception()
+        }
+    }
+
+    /// Handle a call to a method of a registered class.
+    ///
+    /// The Swift instance is read from `this` with a class ID check, so dispatching
+    /// costs a C call and no lookup.
+    private func handleMethodCall(
+        _ method: InstanceMethod,
+        classId: Int32,
+        argc: Int32,
+        argv: UnsafeMutablePointer<JSValue>?,
+        thisVal: JSValue
+    ) -> JSValue {
+        guard let instance = mqjs_get_class_instance(ctx, thisVal, classId) else {
+            return mqjs_throw_type_error(ctx, "Method called on an incompatible object")
+        }
+
+        nativeCallDepth += 1
+        defer { nativeCallDepth -= 1 }
+
+        do {
+            return try method(instance, MQJSArguments(context: self, argc: argc, argv: argv)).toJSValue(in: self)
+        } catch {
+            let message = "\(error)"
+            _ = mqjs_throw_internal_error(ctx, message)
+            return mqjs_get_exception()
+        }
+    }
+
+    /// Handle `new` on a registered class: the new object holds the retained instance
+    private func handleConstructorCall(
+        _ constructor: ([MQJSValue]) throws -> AnyObject,
+        classId: Int32,
+        argc: Int32,
+        argv: UnsafeMutablePointer<JSValue>?
+    ) -> JSValue {
+        nativeCallDepth += 1
+        defer { nativeCallDepth -= 1 }
+
+        // Boxed after entering the call, so a scope of the caller does not root them
+        let args = boxedArguments(argc: argc, argv: argv)
+
+        do {
+            let object = try constructor(args)
+            let instance = Unmanaged.passRetained(object).toOpaque()
+            let jsObject = mqjs_new_class_instance(ctx, classId, instance)
+            if JS_IsException(jsObject) != 0 {
+                Unmanaged<AnyObject>.fromOpaque(instance).release()
             }
-            return objectWrapper
-        default:
-            throw MQJSError.typeConversionError("Cannot convert \(type(of: value)) to JavaScript value")
+            return jsObject
+        } catch {
+            let message = "\(error)"
+            _ = mqjs_throw_internal_error(ctx, message)
+            return mqjs_get_exception()
+        }
+    }
+
+    /// Wrap the arguments of a native call in MQJSValues
+    private func boxedArguments(argc: Int32, argv: UnsafeMutablePointer<JSValue>?) -> [MQJSValue] {
+        guard let argv = argv, argc > 0 else { return [] }
+        return (0..<Int(argc)).map { MQJSValue(context: self, jsValue: argv[$0]) }
+    }
+
+    /// Convert the result of a boxed native function
+    fileprivate func nativeResult(_ result: Any?) throws -> MQJSNativeResult {
+        guard let result = result else { return .undefined }
+        if let value = result as? MQJSValue {
+            return .value(value)
         }
+        return .value(try convertToJSValue(result))
     }
 
-    // MARK: - Instance Registry (Internal)
+    /// Number of native function calls in progress (JavaScript is running)
+    internal private(set) var nativeCallDepth = 0
 
-    /// Register a Swift object instance and return its ID
-    internal func registerInstance(_ instance: AnyObject) -> Int32 {
-        let instanceId = nextInstanceId
-        nextInstanceId += 1
-        instanceRegistry[instanceId] = instance
-        return instanceId
+    /// Convert a Swift value to MQJSValue
+    private func convertToJSValue(_ value: Any) throws -> MQJSValue {
+        return try MQJSValueBuilder(context: self).makeValue(value)
     }
 
-    /// Retrieve a Swift object instance by ID
-    internal func getInstance<T: AnyObject>(_ instanceId: Int32, as type: T.Type) -> T? {
-        return instanceRegistry[instanceId] as? T
+    // MARK: - Class Instances (Internal)
+
+    /// The Swift instances held by the class instance objects of the heap
+    private func classInstances() -> [AnyObject] {
+        var instances: [AnyObject] = []
+        withUnsafeMutablePointer(to: &instances) { pointer in
+            JS_EnumUserObjects(ctx, { _, arg, _, instance in
+                guard let arg = arg, let instance = instance else { return }
+                let instances = arg.assumingMemoryBound(to: [AnyObject].self)
+                instances.pointee.append(Unmanaged<AnyObject>.fromOpaque(instance).takeUnretainedValue())
+            }, pointer)
+        }
+        return instances
     }
 
-    /// Remove an instance from the registry
-    internal func removeInstance(_ instanceId: Int32) {
-        instanceRegistry.removeValue(forKey: instanceId)
+    /// Retain the Swift instances of the class instance objects of the heap, after
+    /// they were brought back by restoring a snapshot
+    private func retainClassInstances() {
+        JS_EnumUserObjects(ctx, { _, _, _, instance in
+            guard let instance = instance else { return }
+            _ = Unmanaged<AnyObject>.fromOpaque(instance).retain()
+        }, nil)
     }
 
     // MARK: - Value Tracking (Internal)
@@ -348,10 +502,17 @@ public final class MQJSContext {
 
     /// Extract error message from context after an exception
     internal func extractError() throws -> MQJSError {
+        if isInterrupting {
+            return .interrupted
+        }
+        return .evaluationError(Self.pendingErrorMessage(in: ctx))
+    }
+
+    /// Format the pending exception of a raw engine context
+    internal static func pendingErrorMessage(in ctx: OpaquePointer) -> String {
         var buffer = [CChar](repeating: 0, count: 1024)
         _ = JS_GetErrorStr(ctx, &buffer, 1024)
-        let errorMessage = String(cString: buffer)
-        return .evaluationError(errorMessage)
+        return String(cString: buffer)
     }
 
     // MARK: - Script Execution
@@ -379,6 +540,7 @@ public final class MQJSContext {
         flags: Int32 = JS_EVAL_RETVAL
     ) throws -> MQJSValue {
         try checkValid()
+        growMemoryIfNeeded()
 
         let result = script.withCString { scriptCStr in
             filename.withCString { filenameCStr in
@@ -400,6 +562,72 @@ public final class MQJSContext {
         return MQJSValue(context: self, jsValue: result)
     }
 
+    /// Evaluates JavaScript source given as UTF-8 bytes, without creating a Swift `String`.
+    ///
+    /// ```swift
+    /// let source = try Data(contentsOf: scriptURL)
+    /// try source.withUnsafeBytes { raw in
+    ///     try context.eval(utf8: raw.bindMemory(to: UInt8.self), filename: "app.js")
+    /// }
+    /// ```
+    ///
+    /// The bytes are copied once into a NUL-terminated buffer for the parser and
+    /// are not validated: they must be valid UTF-8.
+    ///
+    /// - Parameters:
+    ///   - script: The UTF-8 encoded JavaScript code to evaluate
+    ///   - filename: Optional filename for error messages (default: "<eval>")
+    ///   - flags: Evaluation flags (default: returns last value)
+    /// - Returns: The result of evaluating the script
+    /// - Throws: MQJSError if evaluation fails or produces an exception
+    @discardableResult
+    public func eval(
+        utf8 script: UnsafeBufferPointer<UInt8>,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL
+    ) throws -> MQJSValue {
+        try checkValid()
+        growMemoryIfNeeded()
+
+        let count = script.count
+        let source = UnsafeMutablePointer<CChar>.allocate(capacity: count + 1)
+        defer { source.deallocate() }
+        if let bytes = script.baseAddress {
+            UnsafeMutableRawPointer(source).copyMemory(from: bytes, byteCount: count)
+        }
+        source[count] = 0
+
+        let result = filename.withCString { filenameCStr in
+            JS_Eval(ctx, source, count, filenameCStr, flags)
+        }
+
+        if JS_IsException(result) != 0 {
+            throw try extractError()
+        }
+
+        return MQJSValue(context: self, jsValue: result)
+    }
+
+    /// Evaluates JavaScript source stored as UTF-8 in `Data`, for example a script
+    /// loaded from disk or the network.
+    ///
+    /// - Parameters:
+    ///   - data: The UTF-8 encoded JavaScript code to evaluate
+    ///   - filename: Optional filename for error messages (default: "<eval>")
+    ///   - flags: Evaluation flags (default: returns last value)
+    /// - Returns: The result of evaluating the script
+    /// - Throws: MQJSError if evaluation fails or produces an exception
+    @discardableResult
+    public func eval(
+        data: Data,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL
+    ) throws -> MQJSValue {
+        try data.withUnsafeBytes { raw in
+            try eval(utf8: raw.bindMemory(to: UInt8.self), filename: filename, flags: flags)
+        }
+    }
+
     /// Parses JavaScript code without executing it (for compilation).
     ///
     /// - Parameters:
@@ -414,6 +642,7 @@ public final class MQJSContext {
         flags: Int32 = JS_EVAL_RETVAL
     ) throws -> MQJSValue {
         try checkValid()
+        growMemoryIfNeeded()
 
         let result = script.withCString { scriptCStr in
             filename.withCString { filenameCStr in
@@ -442,6 +671,7 @@ public final class MQJSContext {
     @discardableResult
     public func run(_ compiledFunction: MQJSValue) throws -> MQJSValue {
         try checkValid()
+        growMemoryIfNeeded()
 
         let result = JS_Run(ctx, compiledFunction.jsValue)
 
@@ -452,6 +682,174 @@ public final class MQJSContext {
         return MQJSValue(context: self, jsValue: result)
     }
 
+    /// Evaluates JavaScript code, interrupting it when a limit is exceeded.
+    ///
+    /// ```swift
+    /// let limits = MQJSExecutionLimits(deadline: .now() + .milliseconds(50), instructionBudget: 1_000_000)
+    /// let result = try context.eval(tenantScript, limits: limits)
+    /// ```
+    ///
+    /// - Throws: `MQJSError.interrupted` if a limit was exceeded, MQJSError if evaluation fails
+    @discardableResult
+    public func eval(
+        _ script: String,
+        filename: String = "<eval>",
+        flags: Int32 = JS_EVAL_RETVAL,
+        limits: MQJSExecutionLimits
+    ) throws -> MQJSValue {
+        return try withExecutionLimits(limits) {
+            try eval(script, filename: filename, flags: flags)
+        }
+    }
+
+    /// Runs a previously parsed JavaScript function, interrupting it when a limit is exceeded.
+    ///
+    /// - Throws: `MQJSError.interrupted` if a limit was exceeded, MQJSError if execution fails
+    @discardableResult
+    public func run(_ compiledFunction: MQJSValue, limits: MQJSExecutionLimits) throws -> MQJSValue {
+        return try withExecutionLimits(limits) {
+            try run(compiledFunction)
+        }
+    }
+
+    // MARK: - Execution Limits
+
+    /// Number of function calls and loop iterations between two checks of the
+    /// execution limits (1 to 32767, default 10000).
+    ///
+    /// Lower values make deadlines more precise; higher values lower the overhead
+    /// of limited calls. Calls without limits are not affected. The setting is kept
+    /// across `restore(_:)`.
+    public var interruptInterval: Int {
+        get { return checkInterval }
+        set {
+            checkInterval = min(max(newValue, 1), 32767)
+            JS_SetInterruptInterval(ctx, Int32(checkInterval))
+        }
+    }
+
+    /// Runs `body` with the interrupt handler enforcing `limits`. Nested limited
+    /// calls (from native functions) are bounded by the limits of the outer calls.
+    internal func withExecutionLimits<R>(_ limits: MQJSExecutionLimits, _ body: () throws -> R) throws -> R {
+        try checkValid()
+        let savedDeadline = activeDeadline
+        let savedBudget = remainingBudget
+
+        if let deadline = limits.deadline {
+            activeDeadline = min(deadline.uptimeNanoseconds, savedDeadline ?? .max)
+        }
+        let startBudget = limits.instructionBudget.map { min(max($0, 0), savedBudget ?? .max) }
+        if let startBudget = startBudget {
+            remainingBudget = startBudget
+        }
+        if limitDepth == 0 {
+            JS_SetInterruptHandler(ctx, Self.interruptHandler)
+        }
+        limitDepth += 1
+
+        defer {
+            limitDepth -= 1
+            activeDeadline = savedDeadline
+            if let startBudget = startBudget, let left = remainingBudget {
+                // Charge what the nested call used to the outer budget
+                remainingBudget = savedBudget.map { $0 - (startBudget - left) }
+            }
+            if limitDepth == 0 {
+                JS_SetInterruptHandler(ctx, nil)
+                isInterrupting = false
+            }
+        }
+        return try body()
+    }
+
+    /// Called by the interpreter every `interruptInterval` calls and loop iterations.
+    /// Returns true to abort the running script.
+    private func checkExecutionLimits() -> Bool {
+        if isInterrupting {
+            return true
+        }
+        if let budget = remainingBudget {
+            remainingBudget = budget - checkInterval
+            if budget - checkInterval <= 0 {
+                isInterrupting = true
+            }
+        }
+        if let deadline = activeDeadline, DispatchTime.now().uptimeNanoseconds >= deadline {
+            isInterrupting = true
+        }
+        return isInterrupting
+    }
+
+    // MARK: - Memory Size
+
+    /// Current size of the memory buffer in bytes
+    public var memorySize: Int {
+        return memoryBuffer.size
+    }
+
+    /// Size up to which the memory buffer grows automatically.
+    ///
+    /// When it is larger than `memorySize`, the context checks before each top-level
+    /// `eval`, `parse`, `run` or function call whether the last collection left more
+    /// than half of the memory in use, or whether an out of memory error occurred
+    /// since the previous check. If so, it doubles its buffer (up to this size).
+    ///
+    /// The buffer cannot grow while JavaScript code is running, so a single call that
+    /// needs more than the current buffer still fails with an out of memory error; the
+    /// next call then runs with the larger buffer.
+    public var maximumMemorySize: Int
+
+    /// Out of memory count seen by the last `growMemoryIfNeeded()`
+    private var lastOutOfMemoryCount: UInt32 = 0
+
+    /// Moves the context to a memory buffer of the given size.
+    ///
+    /// The heap is garbage collected and copied to the new buffer, then its pointers
+    /// are updated. Existing `MQJSValue`s and snapshots stay valid.
+    ///
+    /// - Parameter size: New buffer size in bytes (minimum: 64KB). Can be smaller
+    ///   than the current size if the live heap fits.
+    /// - Throws: `MQJSError.invalidMemorySize` if the size is too small for the heap,
+    ///           `MQJSError.memoryResizeError` if JavaScript code is running
+    public func resizeMemory(to size: Int) throws {
+        try checkValid()
+        guard size >= Self.minimumMemorySize else {
+            throw MQJSError.invalidMemorySize(size)
+        }
+        guard nativeCallDepth == 0 else {
+            throw MQJSError.memoryResizeError("Cannot resize the memory while JavaScript code is running")
+        }
+        guard size != memoryBuffer.size else { return }
+
+        let newBuffer = try MQJSMemoryBuffer(size: size)
+        guard let newContext = JS_RelocateContext(ctx, newBuffer.baseAddress, newBuffer.size) else {
+            throw MQJSError.invalidMemorySize(size)
+        }
+
+        ctx = newContext
+        memoryBuffer = newBuffer
+    }
+
+    /// Grows the memory buffer if the heap is getting full (see `maximumMemorySize`).
+    /// Only acts at top level, when no JavaScript frame is live.
+    internal func growMemoryIfNeeded() {
+        guard isValid, nativeCallDepth == 0, memoryBuffer.size < maximumMemorySize else {
+            return
+        }
+
+        var stats = JSMemoryStats()
+        mqjs_get_memory_stats(ctx, &stats, 0)
+        let ranOutOfMemory = stats.oom_count != lastOutOfMemoryCount
+        lastOutOfMemoryCount = stats.oom_count
+
+        guard ranOutOfMemory || stats.gc_live_size * 2 > stats.memory_size else {
+            return
+        }
+
+        let newSize = min(memoryBuffer.size * 2, maximumMemorySize)
+        try? resizeMemory(to: newSize)
+    }
+
     /// Manually triggers garbage collection.
     ///
     /// This is normally not needed as mquickjs handles GC automatically,
@@ -460,6 +858,271 @@ public final class MQJSContext {
         JS_GC(ctx)
     }
 
+    /// Heap fragmentation (in percent) above which the automatic GC compacts the heap.
+    ///
+    /// With 0 (the default), every collection compacts the heap. With a higher value,
+    /// the memory of dead objects is reused in place and the heap is only compacted
+    /// when fragmentation reaches the threshold or a large block does not fit. This
+    /// keeps GC pauses short for latency-sensitive workloads.
+    ///
+    /// The setting is kept across `restore(_:)`.
+    public var gcCompactionThreshold: Int {
+        get { return compactionThreshold }
+        set {
+            compactionThreshold = min(max(newValue, 0), 100)
+            JS_SetGCCompactThreshold(ctx, Int32(compactionThreshold))
+        }
+    }
+
+    /// Number of bytes allocated between two automatic collections (0 = disabled).
+    ///
+    /// By default the GC only runs when the heap is exhausted, so each pause
+    /// scales with the whole heap. With a budget, collections run early and often
+    /// while the live set is small. Combine with `gcCompactionThreshold`.
+    ///
+    /// ```swift
+    /// context.gcAllocationBudget = 64 * 1024
+    /// context.gcCompactionThreshold = 50
+    /// ```
+    ///
+    /// The setting is kept across `restore(_:)`.
+    public var gcAllocationBudget: Int {
+        get { return allocationBudget }
+        set {
+            allocationBudget = max(newValue, 0)
+            JS_SetGCAllocationBudget(ctx, allocationBudget)
+        }
+    }
+
+    /// Current heap fragmentation in percent: the share of free memory that lies
+    /// in holes between live objects rather than in the contiguous free area.
+    public var gcFragmentation: Int {
+        guard isValid else { return 0 }
+        return Int(JS_GetGCFragmentation(ctx))
+    }
+
+    /// Heap usage and GC counters (cheap: no heap walk).
+    public var memoryStats: MQJSMemoryStats {
+        return memoryStats(countingBlocks: false)
+    }
+
+    /// Returns the heap usage and GC counters.
+    ///
+    /// - Parameter countingBlocks: Also count the heap blocks per kind. This walks the
+    ///   whole heap, so prefer the `memoryStats` property for frequent sampling.
+    /// - Returns: The statistics (all zero if the context was freed)
+    public func memoryStats(countingBlocks: Bool) -> MQJSMemoryStats {
+        var stats = JSMemoryStats()
+        if isValid {
+            mqjs_get_memory_stats(ctx, &stats, countingBlocks ? 1 : 0)
+        }
+        return MQJSMemoryStats(stats, countingBlocks: countingBlocks && isValid)
+    }
+
+    /// Collects garbage, compacting the heap only if it fits in the given time budget.
+    ///
+    /// Marking and sweeping always run (they cannot be split, since the engine has
+    /// no write barrier). The heap is then compacted if it is fragmented and the
+    /// expected compaction time, based on previous compactions, fits in what is
+    /// left of the budget. Call this from idle points such as the end of a frame.
+    ///
+    /// - Parameter budgetMicroseconds: Time budget for the whole collection
+    /// - Returns: true if the heap is compacted when the call returns
+    @discardableResult
+    public func collectGarbage(budgetMicroseconds: Int) -> Bool {
+        guard isValid else { return false }
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        JS_GCCollect(ctx)
+        if JS_GetGCFragmentation(ctx) == 0 {
+            return true
+        }
+
+        let markEnd = DispatchTime.now().uptimeNanoseconds
+        let elapsed = markEnd - start
+        let budget = UInt64(max(budgetMicroseconds, 0)) * 1000
+        // Without history, assume compaction costs about as much as marking
+        let estimate = lastCompactionNanoseconds ?? elapsed
+        guard elapsed + estimate <= budget else {
+            return false
+        }
+
+        JS_GCCompact(ctx)
+        lastCompactionNanoseconds = DispatchTime.now().uptimeNanoseconds - markEnd
+        return true
+    }
+
+    // MARK: - Profiling
+
+    /// Starts sampling the JavaScript call stack, discarding any previous profile.
+    ///
+    /// The interpreter takes a sample every `sampleInterval` function calls or loop
+    /// iterations, so the number of samples is proportional to the work done rather
+    /// than to wall clock time. With `countOpcodes`, every executed opcode is also
+    /// counted, which slows execution down noticeably.
+    ///
+    /// ```swift
+    /// try context.startProfiling(sampleInterval: 10, countOpcodes: true)
+    /// try context.eval(script)
+    /// let profile = context.stopProfiling()
+    /// print(profile.selfSamples.sorted { $0.value > $1.value }.prefix(5))
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - sampleInterval: Number of calls and backward jumps between two samples
+    ///     (1 to 10000)
+    ///   - countOpcodes: Also build an opcode histogram
+    /// - Throws: MQJSError.profilerError if the engine was built without the profiler
+    public func startProfiling(sampleInterval: Int = 100, countOpcodes: Bool = false) throws {
+        try checkValid()
+        let newProfiler = MQJSProfiler(countOpcodes: countOpcodes)
+        let interval = Int32(min(max(sampleInterval, 1), 10000))
+        guard JS_SetProfiler(ctx, Self.profileHandler, interval, newProfiler.opcodeCounts) == 0 else {
+            throw MQJSError.profilerError("the engine was built without CONFIG_PROFILER")
+        }
+        profiler = newProfiler
+    }
+
+    /// Stops profiling and returns the collected profile.
+    @discardableResult
+    public func stopProfiling() -> MQJSProfile {
+        if isValid {
+            JS_SetProfiler(ctx, nil, 0, nil)
+        }
+        let result = profile()
+        profiler = nil
+        return result
+    }
+
+    /// Returns the profile collected so far (empty if profiling was not started).
+    public func profile() -> MQJSProfile {
+        return profiler?.profile ?? MQJSProfile(samples: [:], opcodeCounts: [:])
+    }
+
+    // MARK: - Snapshots
+
+    /// A saved copy of a context's complete state.
+    ///
+    /// Created with `makeSnapshot()` and restored with `restore(_:)` on the same context.
+    public final class Snapshot {
+        /// Copy of the start of the context memory buffer (context, heap)
+        fileprivate let image: Data
+
+        /// Context the image was taken from
+        fileprivate weak var owner: MQJSContext?
+
+        /// Swift-side state referenced from the heap image
+        fileprivate let nativeFunctions: NativeFunctionTable
+        fileprivate let nextFunctionId: Int32
+        fileprivate let classInstances: [AnyObject]
+        fileprivate let nextClassId: Int32
+        fileprivate let bytecodeBuffers: [AnyObject]
+
+        /// Size of the saved heap image in bytes
+        public var size: Int {
+            return image.count
+        }
+
+        fileprivate init(image: Data, context: MQJSContext) {
+            self.image = image
+            self.owner = context
+            self.nativeFunctions = context.nativeFunctions
+            self.nextFunctionId = context.nextFunctionId
+            self.classInstances = context.classInstances()
+            self.nextClassId = context.nextClassId
+            self.bytecodeBuffers = context.bytecodeBuffers
+        }
+    }
+
+    /// Saves the current state of the context.
+    ///
+    /// The heap is garbage collected and the used part of the memory buffer is copied,
+    /// together with the registered native functions. Restoring the snapshot later with
+    /// `restore(_:)` costs a single `memcpy` of that image.
+    ///
+    /// The snapshot keeps the Swift instances of the live class instances alive. They
+    /// are shared, not copied: a restored object refers to the same Swift instance,
+    /// with the state it has at that time.
+    ///
+    /// ```swift
+    /// try context.eval(bootstrapScript)
+    /// let snapshot = try context.makeSnapshot()
+    ///
+    /// try context.eval("var requestState = {}")
+    /// try context.restore(snapshot) // requestState is gone
+    /// ```
+    ///
+    /// - Important: All existing `MQJSValue`s of the context are invalidated, because
+    ///   their GC references cannot be part of the image.
+    /// - Returns: The snapshot
+    /// - Throws: `MQJSError.snapshotError` if JavaScript code is running
+    public func makeSnapshot() throws -> Snapshot {
+        try checkValid()
+        guard nativeCallDepth == 0 else {
+            throw MQJSError.snapshotError("Cannot snapshot a context while JavaScript code is running")
+        }
+        guard scopes.isEmpty else {
+            throw MQJSError.snapshotError("Cannot snapshot a context inside withScope")
+        }
+
+        invalidateValues()
+        JS_GC(ctx)
+
+        let imageSize = JS_GetContextImageSize(ctx)
+        guard imageSize > 0 else {
+            throw MQJSError.snapshotError("Context state cannot be saved")
+        }
+
+        let image = Data(bytes: memoryBuffer.baseAddress, count: imageSize)
+        return Snapshot(image: image, context: self)
+    }
+
+    /// Restores the context to a state saved with `makeSnapshot()`.
+    ///
+    /// Everything done since the snapshot is discarded, including native functions and
+    /// classes registered afterwards.
+    ///
+    /// - Important: All existing `MQJSValue`s of the context are invalidated.
+    /// - Parameter snapshot: A snapshot taken from this context
+    /// - Throws: `MQJSError.snapshotError` if the snapshot belongs to another context
+    ///           or JavaScript code is running
+    public func restore(_ snapshot: Snapshot) throws {
+        try checkValid()
+        guard snapshot.owner === self else {
+            throw MQJSError.snapshotError("Snapshot was taken from a different context")
+        }
+        guard nativeCallDepth == 0 else {
+            throw MQJSError.snapshotError("Cannot restore a context while JavaScript code is running")
+        }
+        guard scopes.isEmpty else {
+            throw MQJSError.snapshotError("Cannot restore a context inside withScope")
+        }
+
+        invalidateValues()
+
+        guard JS_GetContextImageSize(ctx) > 0 else {
+            throw MQJSError.snapshotError("Context state cannot be restored")
+        }
+
+        let status = snapshot.image.withUnsafeBytes { bytes in
+            JS_RestoreContextImage(ctx, bytes.baseAddress, bytes.count)
+        }
+        guard status == 0 else {
+            throw MQJSError.snapshotError("Snapshot does not fit in the memory buffer")
+        }
+
+        // The objects discarded by the restore were finalized, the restored
+        // ones hold a reference again
+        retainClassInstances()
+
+        // The restored heap only refers to function IDs allocated before the
+        // snapshot, so the later ones can be handed out again
+        nativeFunctions = snapshot.nativeFunctions
+        nextFunctionId = snapshot.nextFunctionId
+        nextClassId = snapshot.nextClassId
+        bytecodeBuffers = snapshot.bytecodeBuffers
+    }
+
     // MARK: - Native Function Registration
 
     /// Registers a Swift function that can be called from JavaScript.
@@ -493,25 +1156,7 @@ public final class MQJSContext {
     /// - Throws: MQJSError if registration fails
     public func setFunction(_ name: String, _ function: @escaping NativeFunction) throws {
         try checkValid()
-
-        // Generate unique function ID
-        let functionId = nextFunctionId
-        nextFunctionId += 1
-
-        // Store the function
-        nativeFunctions[functionId] = function
-
-        // Create the JS function
-        let jsFunction = mqjs_new_native_function(ctx, functionId)
-
-        if JS_IsException(jsFunction) != 0 {
-            nativeFunctions.removeValue(forKey: functionId)
-            throw try extractError()
-        }
-
-        // Set it on the global object
-        let jsFunctionValue = MQJSValue(context: self, jsValue: jsFunction)
-        globalObject[name] = jsFunctionValue
+        globalObject[name] = try newNativeFunction(.boxed(function))
     }
 
     /// Registers a Swift function on a specific object.
@@ -531,31 +1176,75 @@ public final class MQJSContext {
     /// - Throws: MQJSError if registration fails
     public func setFunction(_ name: String, on object: MQJSValue, _ function: @escaping NativeFunction) throws {
         try checkValid()
+        object[name] = try newNativeFunction(.boxed(function))
+    }
+
+    /// Registers a fast Swift function that can be called from JavaScript.
+    ///
+    /// Unlike `setFunction(_:_:)`, the function reads its arguments directly from the
+    /// JavaScript stack through `MQJSArguments` and returns a typed `MQJSNativeResult`.
+    /// No `MQJSValue` is allocated per call and the result is not boxed in `Any`, which
+    /// makes this the right choice for callbacks invoked in tight loops.
+    ///
+    /// ```swift
+    /// try context.setFastFunction("clamp") { args in
+    ///     let value = try args.double(at: 0)
+    ///     return .double(min(max(value, 0), 1))
+    /// }
+    ///
+    /// try context.setFastFunction("log") { args in
+    ///     logger.info(try args.utf8String(at: 0))
+    ///     return .undefined
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - name: The name of the function in JavaScript's global scope
+    ///   - function: The Swift closure to call when the function is invoked
+    /// - Throws: MQJSError if registration fails
+    public func setFastFunction(_ name: String, _ function: @escaping FastNativeFunction) throws {
+        try checkValid()
+        globalObject[name] = try newNativeFunction(.fast(function))
+    }
+
+    /// Registers a fast Swift function on a specific object.
+    ///
+    /// - Parameters:
+    ///   - name: The name of the function property
+    ///   - object: The object to set the function on
+    ///   - function: The Swift closure to call when the function is invoked
+    /// - Throws: MQJSError if registration fails
+    public func setFastFunction(_ name: String, on object: MQJSValue, _ function: @escaping FastNativeFunction) throws {
+        try checkValid()
+        object[name] = try newNativeFunction(.fast(function))
+    }
 
+    /// Register a native function handler and create its JavaScript function
+    private func newNativeFunction(_ handler: NativeHandler) throws -> MQJSValue {
         let functionId = nextFunctionId
         nextFunctionId += 1
 
-        nativeFunctions[functionId] = function
-
-        let jsFunction = mqjs_new_native_function(ctx, functionId)
+        nativeFunctions[functionId] = handler
 
+        let jsFunction: JSValue
+        if case .constructor = handler {
+            jsFunction = mqjs_new_native_constructor(ctx, functionId)
+        } else {
+            jsFunction = mqjs_new_native_function(ctx, functionId)
+        }
         if JS_IsException(jsFunction) != 0 {
             nativeFunctions.removeValue(forKey: functionId)
             throw try extractError()
         }
 
-        let jsFunctionValue = MQJSValue(context: self, jsValue: jsFunction)
-        object[name] = jsFunctionValue
+        return MQJSValue(context: self, jsValue: jsFunction)
     }
 
     // MARK: - Custom Class Registration
 
-    /// Hidden property name for storing instance IDs on JavaScript objects
-    private static let instanceIdProperty = "__swiftInstanceId__"
-
     /// Registers a Swift class that can be instantiated from JavaScript.
     ///
-    /// Use the builder to define the constructor and methods for the class.
+    /// Use the builder to define the constructor, methods and properties of the class.
     /// Once registered, JavaScript code can use `new ClassName(args)` to create
     /// instances and call methods on them.
     ///
@@ -564,7 +1253,6 @@ public final class MQJSContext {
     ///     var value: Int
     ///     init(start: Int) { self.value = start }
     ///     func increment() { value += 1 }
-    ///     func getValue() -> Int { return value }
     /// }
     ///
     /// try context.registerClass("Counter") { builder in
@@ -576,18 +1264,21 @@ public final class MQJSContext {
     ///         this.increment()
     ///         return nil
     ///     }
-    ///     builder.method("getValue") { this, args in
-    ///         return this.getValue()
-    ///     }
+    ///     builder.property("value", get: { this in this.value })
     /// }
     ///
     /// let result = try context.eval("""
-    ///     let c = new Counter(10);
+    ///     var c = new Counter(10);
     ///     c.increment();
-    ///     c.getValue();  // 11
+    ///     c.value;  // 11
     /// """)
     /// ```
     ///
+    /// Instances are objects of a native class: each one holds a retained pointer to
+    /// its Swift instance, which methods and accessors read directly from `this`. The
+    /// Swift instance is released when the object is garbage collected. Up to 32
+    /// classes can be registered per context (`MQJS_USER_CLASS_COUNT` in the C bridge).
+    ///
     /// - Parameters:
     ///   - name: The class name as it appears in JavaScript
     ///   - configure: A closure that receives a builder to define the class
@@ -604,120 +1295,62 @@ public final class MQJSContext {
             throw MQJSError.classRegistrationError("Constructor not defined for class '\(name)'")
         }
 
-        // Create the prototype object with methods
-        let prototypeJs = JS_NewObject(ctx)
-        let prototype = MQJSValue(context: self, jsValue: prototypeJs)
-
-        // Register each method on the prototype
-        for (methodName, methodFn) in builder.methods {
-            try registerMethod(methodName, on: prototype, for: T.self, methodFn)
-        }
-
-        // Create a native function that initializes instances
-        let initFunctionName = "__\(name)_init__"
-        let initFunctionId = nextFunctionId
-        nextFunctionId += 1
-
-        // The init function receives 'this' and sets it up
-        nativeFunctions[initFunctionId] = { [weak self] args in
-            guard let self = self else {
-                throw MQJSError.invalidContext
-            }
-
-            // 'this' is available via currentThisValue
-            guard let thisValue = self.currentThisValue else {
-                throw MQJSError.nativeFunctionError("Constructor called without 'this' context")
-            }
-
-            // Call the Swift constructor
-            let instance = try constructorFn(args)
-
-            // Register the instance and get its ID
-            let instanceId = self.registerInstance(instance)
-
-            // Store the instance ID on 'this'
-            thisValue[Self.instanceIdProperty] = try Int32(instanceId).toJSValue(in: self)
-
-            return nil
+        let classId = nextClassId
+        guard classId < Int32(JS_CLASS_USER.rawValue) + mqjs_get_user_class_count() else {
+            throw MQJSError.classRegistrationError("Too many classes registered, cannot register '\(name)'")
         }
 
-        // Create the native init function
-        let initFunctionJs = mqjs_new_native_function(ctx, initFunctionId)
-        if JS_IsException(initFunctionJs) != 0 {
-            nativeFunctions.removeValue(forKey: initFunctionId)
+        // Create the prototype object with methods and properties
+        let jsPrototype = JS_NewObject(ctx)
+        if JS_IsException(jsPrototype) != 0 {
             throw try extractError()
         }
+        let prototype = MQJSValue(context: self, jsValue: jsPrototype)
+
+        for (methodName, method) in builder.methods {
+            prototype[methodName] = try newNativeFunction(.method(classId: classId) { instance, args in
+                let this = Unmanaged<T>.fromOpaque(instance).takeUnretainedValue()
+                let values = (0..<args.count).map { args.value(at: $0) }
+                return try args.context.nativeResult(method(this, values))
+            })
+        }
 
-        // Set the init function on global (temporarily)
-        let initFunctionValue = MQJSValue(context: self, jsValue: initFunctionJs)
-        globalObject[initFunctionName] = initFunctionValue
-
-        // Create a JavaScript constructor function that calls our init function
-        // and set up the prototype
-        let constructorScript = """
-            (function() {
-                function \(name)() {
-                    \(initFunctionName).apply(this, arguments);
-                }
-                return \(name);
-            })()
-        """
-
-        let constructorValue = try eval(constructorScript)
-
-        // Set the prototype with methods on the constructor
-        constructorValue["prototype"] = prototype
-
-        // Set the constructor on the global object
-        globalObject[name] = constructorValue
-    }
-
-    /// Register a method on a prototype object
-    private func registerMethod<T: AnyObject>(
-        _ name: String,
-        on prototype: MQJSValue,
-        for type: T.Type,
-        _ method: @escaping MQJSClassBuilder<T>.Method
-    ) throws {
-        let methodId = nextFunctionId
-        nextFunctionId += 1
-
-        nativeFunctions[methodId] = { [weak self] args in
-            guard let self = self else {
-                throw MQJSError.invalidContext
-            }
-
-            // Get 'this' from the current call
-            guard let thisValue = self.currentThisValue else {
-                throw MQJSError.nativeFunctionError("Method called without 'this' context")
-            }
+        for (methodName, method) in builder.fastMethods {
+            prototype[methodName] = try newNativeFunction(.method(classId: classId) { instance, args in
+                return try method(Unmanaged<T>.fromOpaque(instance).takeUnretainedValue(), args)
+            })
+        }
 
-            // Get the instance ID from 'this'
-            guard let instanceIdValue = thisValue[Self.instanceIdProperty],
-                  !instanceIdValue.isUndefined else {
-                throw MQJSError.nativeFunctionError("Method called on object without instance ID")
+        for (propertyName, accessors) in builder.properties {
+            let getter = try newNativeFunction(.method(classId: classId) { instance, args in
+                return try args.context.nativeResult(accessors.getter(Unmanaged<T>.fromOpaque(instance).takeUnretainedValue()))
+            })
+            var setter: MQJSValue?
+            if let setterFn = accessors.setter {
+                setter = try newNativeFunction(.method(classId: classId) { instance, args in
+                    try setterFn(Unmanaged<T>.fromOpaque(instance).takeUnretainedValue(), args.value(at: 0))
+                    return .undefined
+                })
             }
-
-            let instanceId = try instanceIdValue.toInt32()
-
-            // Look up the Swift instance
-            guard let instance = self.getInstance(instanceId, as: type) else {
-                throw MQJSError.nativeFunctionError("Swift instance not found for ID \(instanceId)")
+            let result = JS_DefinePropertyGetSetStr(ctx, prototype.jsValue, propertyName, getter.jsValue,
+                                                    setter?.jsValue ?? mqjs_get_undefined())
+            if JS_IsException(result) != 0 {
+                throw try extractError()
             }
-
-            // Call the method
-            return try method(instance, args)
         }
 
-        // Create the method function
-        let methodJs = mqjs_new_native_function(ctx, methodId)
-        if JS_IsException(methodJs) != 0 {
-            nativeFunctions.removeValue(forKey: methodId)
-            throw try extractError()
-        }
+        // Create the native constructor, which creates the instance objects
+        let constructor = try newNativeFunction(.constructor(classId: classId) { args in
+            return try constructorFn(args)
+        })
+        constructor["prototype"] = prototype
+        prototype["constructor"] = constructor
 
-        let methodValue = MQJSValue(context: self, jsValue: methodJs)
-        prototype[name] = methodValue
+        JS_SetUserClass(ctx, classId, constructor.jsValue, prototype.jsValue)
+        nextClassId += 1
+
+        // Set the constructor on the global object
+        globalObject[name] = constructor
     }
 
     // MARK: - JSC Compatibility
@@ -0,0 +1,230 @@
+import Foundation
+
+/// A pool of pre-warmed JavaScript contexts.
+///
+/// Each context is created and bootstrapped once, then snapshotted. Checking a context
+/// back in restores it to that post-bootstrap state with a single copy of its heap
+/// image, so every checkout starts from the same clean state without paying for
+/// memory allocation, stdlib setup or the bootstrap script again.
+///
+/// ## Thread Safety
+/// The pool itself is thread-safe. A checked-out context is owned by the caller until
+/// it is checked back in and must not be used concurrently.
+///
+/// ## Usage
+/// ```swift
+/// let pool = try MQJSContextPool(count: 8, memorySize: 4 * 1024 * 1024) { context in
+///     try context.eval(bootstrapScript)
+/// }
+///
+/// let score = try pool.withContext { context in
+///     try context.callFunction("score", withArguments: [request]).toDouble()
+/// }
+/// ```
+public final class MQJSContextPool {
+    // MARK: - Types
+
+    /// Closure run once on each new context before it is snapshotted
+    public typealias Bootstrap = (MQJSContext) throws -> Void
+
+    // MARK: - Configuration
+
+    /// Number of contexts owned by the pool.
+    ///
+    /// Starts at the count given to `init` and only drops if a context that failed to
+    /// restore cannot be replaced (`checkin(_:)` reports this with an error).
+    public var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return capacity
+    }
+
+    /// Initial memory size of each context
+    public let memorySize: Int
+
+    /// Size up to which the memory of each context can grow
+    public let maximumMemorySize: Int?
+
+    /// Bootstrap closure, kept to rebuild a context whose restore failed
+    private let bootstrap: Bootstrap?
+
+    // MARK: - State
+
+    /// Contexts ready to be checked out
+    private var available: [MQJSContext] = []
+
+    /// Contexts currently owned by callers
+    private var checkedOut: Set<ObjectIdentifier> = []
+
+    /// Post-bootstrap snapshot of every pooled context
+    private var snapshots: [ObjectIdentifier: MQJSContext.Snapshot] = [:]
+
+    /// Number of contexts owned by the pool (available or checked out)
+    private var capacity: Int
+
+    /// Lock for thread-safe access to the state above
+    private let lock = NSLock()
+
+    /// Counts available contexts so checkout can wait for one
+    private let semaphore: DispatchSemaphore
+
+    // MARK: - Initialization
+
+    /// Creates a pool of bootstrapped contexts.
+    ///
+    /// - Parameters:
+    ///   - count: Number of contexts to create
+    ///   - memorySize: Memory size of each context (default: 1MB)
+    ///   - maximumMemorySize: Size up to which each context can grow (default: no growth,
+    ///     see `MQJSContext.maximumMemorySize`). A context keeps its grown buffer across
+    ///     checkins.
+    ///   - bootstrap: Optional closure that prepares each context (evaluate libraries,
+    ///     register native functions, ...). Values created in it are invalidated when
+    ///     the context is snapshotted.
+    /// - Throws: MQJSError if a context cannot be created or bootstrapped
+    public init(
+        count: Int,
+        memorySize: Int = MQJSContext.defaultMemorySize,
+        maximumMemorySize: Int? = nil,
+        bootstrap: Bootstrap? = nil
+    ) throws {
+        precondition(count > 0, "Pool must contain at least one context")
+
+        self.capacity = count
+        self.memorySize = memorySize
+        self.maximumMemorySize = maximumMemorySize
+        self.bootstrap = bootstrap
+        self.semaphore = DispatchSemaphore(value: count)
+
+        for _ in 0..<count {
+            let (context, snapshot) = try makeContext()
+            available.append(context)
+            snapshots[ObjectIdentifier(context)] = snapshot
+        }
+    }
+
+    /// Number of contexts currently available for checkout
+    public var availableCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return available.count
+    }
+
+    // MARK: - Checkout / Checkin
+
+    /// Checks out a context, waiting until one is available.
+    ///
+    /// - Returns: A context in its post-bootstrap state
+    public func checkout() -> MQJSContext {
+        precondition(count > 0, "Pool has no contexts left")
+        semaphore.wait()
+        return takeAvailable()
+    }
+
+    /// Checks out a context, waiting at most until `timeout`.
+    ///
+    /// - Parameter timeout: The latest time to wait until
+    /// - Returns: A context in its post-bootstrap state, or nil on timeout
+    public func checkout(timeout: DispatchTime) -> MQJSContext? {
+        guard semaphore.wait(timeout: timeout) == .success else {
+            return nil
+        }
+        return takeAvailable()
+    }
+
+    /// Returns a context to the pool, restoring its post-bootstrap state.
+    ///
+    /// All values created from the context become invalid.
+    ///
+    /// If the context cannot be restored, it is dropped and the pool creates a new one
+    /// in its place. If that fails too, the pool shrinks by one context (see `count`).
+    ///
+    /// - Parameter context: A context currently checked out from this pool
+    /// - Throws: `MQJSError.snapshotError` if the context is not checked out from this
+    ///           pool (a foreign context, or one already checked in), or if it could be
+    ///           neither restored nor replaced
+    public func checkin(_ context: MQJSContext) throws {
+        let id = ObjectIdentifier(context)
+
+        lock.lock()
+        guard checkedOut.remove(id) != nil, let snapshot = snapshots[id] else {
+            lock.unlock()
+            throw MQJSError.snapshotError("Context is not checked out from this pool")
+        }
+        lock.unlock()
+
+        var replacement: (MQJSContext, MQJSContext.Snapshot)?
+        var replacementError: Error?
+
+        do {
+            try context.restore(snapshot)
+        } catch {
+            // Replace a context that cannot be reset so the pool keeps its size
+            do {
+                replacement = try makeContext()
+            } catch {
+                replacementError = error
+            }
+        }
+
+        lock.lock()
+        if let replacement = replacement {
+            snapshots.removeValue(forKey: id)
+            snapshots[ObjectIdentifier(replacement.0)] = replacement.1
+            available.append(replacement.0)
+        } else if replacementError != nil {
+            snapshots.removeValue(forKey: id)
+            capacity -= 1
+        } else {
+            available.append(context)
+        }
+        let remaining = capacity
+        lock.unlock()
+
+        if let replacementError = replacementError {
+            throw MQJSError.snapshotError(
+                "Context could not be restored or replaced (\(replacementError)); " +
+                "the pool now holds \(remaining) contexts")
+        }
+        semaphore.signal()
+    }
+
+    /// Runs a closure with a checked-out context and checks it back in afterwards.
+    ///
+    /// - Parameter body: The closure to run
+    /// - Returns: The value returned by `body`
+    /// - Throws: Rethrows errors from `body` or from checkin
+    public func withContext<R>(_ body: (MQJSContext) throws -> R) throws -> R {
+        let context = checkout()
+
+        let result: R
+        do {
+            result = try body(context)
+        } catch {
+            try checkin(context)
+            throw error
+        }
+
+        try checkin(context)
+        return result
+    }
+
+    // MARK: - Private Helpers
+
+    /// Create, bootstrap and snapshot a new context
+    private func makeContext() throws -> (MQJSContext, MQJSContext.Snapshot) {
+        let context = try MQJSContext(memorySize: memorySize, maximumMemorySize: maximumMemorySize)
+        try bootstrap?(context)
+        let snapshot = try context.makeSnapshot()
+        return (context, snapshot)
+    }
+
+    /// Pop an available context (the semaphore guarantees there is one)
+    private func takeAvailable() -> MQJSContext {
+        lock.lock()
+        defer { lock.unlock() }
+        let context = available.removeLast()
+        checkedOut.insert(ObjectIdentifier(context))
+        return context
+    }
+}
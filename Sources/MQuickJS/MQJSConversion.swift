@@ -100,8 +100,13 @@ extension Float: MQJSInitializable {
 extension String: MQJSConvertible {
     public func toJSValue(in context: MQJSContext) throws -> MQJSValue {
         try context.checkValid()
-        let jsVal = self.withCString { cStr in
-            JS_NewString(context.ctx, cStr)
+        // Native Swift strings are already contiguous UTF-8: copy the bytes
+        // directly instead of going through a NUL-terminated C string
+        var string = self
+        let jsVal = string.withUTF8 { bytes in
+            bytes.withMemoryRebound(to: CChar.self) { chars in
+                JS_NewStringLen(context.ctx, chars.baseAddress, chars.count)
+            }
         }
         return MQJSValue(context: context, jsValue: jsVal)
     }
@@ -137,15 +142,7 @@ extension Bool: MQJSInitializable {
 extension Array: MQJSConvertible where Element: MQJSConvertible {
     public func toJSValue(in context: MQJSContext) throws -> MQJSValue {
         try context.checkValid()
-        let jsArray = JS_NewArray(context.ctx, Int32(count))
-        let arrayValue = MQJSValue(context: context, jsValue: jsArray)
-
-        for (index, element) in enumerated() {
-            let jsElement = try element.toJSValue(in: context)
-            arrayValue[index] = jsElement
-        }
-
-        return arrayValue
+        return try MQJSValueBuilder(context: context).makeValue(self)
     }
 }
 
@@ -185,15 +182,7 @@ extension Array: MQJSInitializable where Element: MQJSInitializable {
 extension Dictionary: MQJSConvertible where Key == String, Value: MQJSConvertible {
     public func toJSValue(in context: MQJSContext) throws -> MQJSValue {
         try context.checkValid()
-        let jsObject = JS_NewObject(context.ctx)
-        let objectValue = MQJSValue(context: context, jsValue: jsObject)
-
-        for (key, value) in self {
-            let jsValue = try value.toJSValue(in: context)
-            objectValue[key] = jsValue
-        }
-
-        return objectValue
+        return try MQJSValueBuilder(context: context).makeValue(self)
     }
 }
 
@@ -203,10 +192,27 @@ extension Dictionary: MQJSInitializable where Key == String, Value: MQJSInitiali
             throw MQJSError.typeConversionError("Value is not an object")
         }
 
-        // Note: mquickjs doesn't provide a standard way to enumerate object properties
-        // This is a limitation - users would need to know the keys in advance
-        // For a complete implementation, we'd need to add property enumeration to the C bridge
-        throw MQJSError.typeConversionError("Dictionary conversion from JSValue not fully supported - property enumeration not available in mquickjs")
+        let ctx = try jsValue.checkedContext()
+
+        var result: [String: Value] = [:]
+        var position: Int32 = 0
+        var key: JSValue = 0
+        var value: JSValue = 0
+        while true {
+            // Read the object through its GC reference on each step, converting a
+            // value may move it
+            let status = JS_GetOwnPropertyNext(ctx.ctx, jsValue.jsValue, &position, &key, &value)
+            if status == 0 {
+                break
+            }
+            if status < 0 {
+                throw try ctx.extractError()
+            }
+            let name = MQJSValueReader.propertyName(key, in: ctx.ctx)
+            result[name] = try Value(from: MQJSValue(context: ctx, jsValue: value))
+        }
+
+        self = result
     }
 }
 
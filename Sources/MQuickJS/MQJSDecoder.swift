@@ -0,0 +1,424 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Decoder
+
+/// Decodes `Decodable` types directly from JavaScript values.
+///
+/// Properties and elements are read straight from the JavaScript heap: there is no
+/// JSON round-trip and no intermediate `[String: Any]`.
+///
+/// ```swift
+/// struct User: Decodable {
+///     let name: String
+///     let tags: [String]
+/// }
+///
+/// let value = try context.eval("({ name: 'Alice', tags: ['admin'] })")
+/// let user = try MQJSDecoder().decode(User.self, from: value)
+/// ```
+///
+/// Values map like in `JSONDecoder`: `null` and `undefined` decode as `nil`, numbers must
+/// fit the requested type exactly, and arrays and typed arrays decode as unkeyed
+/// containers. Mismatches throw `DecodingError`; exceptions raised by getters throw
+/// `MQJSError`.
+public struct MQJSDecoder {
+    /// Contextual information exposed to `Decodable` implementations
+    public var userInfo: [CodingUserInfoKey: Any] = [:]
+
+    public init() {}
+
+    /// Decodes a value of the given type from a JavaScript value
+    public func decode<T: Decodable>(_ type: T.Type, from value: MQJSValue) throws -> T {
+        let ctx = try value.checkedContext()
+        let decoder = _MQJSDecoder(context: ctx, value: value, codingPath: [], userInfo: userInfo)
+        return try T(from: decoder)
+    }
+}
+
+extension MQJSValue {
+    /// Decodes this value as the given `Decodable` type.
+    ///
+    /// ```swift
+    /// let point = try context.eval("({ x: 1, y: 2 })").decode(Point.self)
+    /// ```
+    public func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        return try MQJSDecoder().decode(type, from: self)
+    }
+}
+
+// MARK: - Decoder Implementation (Internal)
+
+/// Coding key built from a JavaScript property name or an array index
+private struct MQJSCodingKey: CodingKey {
+    let stringValue: String
+    let intValue: Int?
+
+    init(stringValue: String) {
+        self.stringValue = stringValue
+        self.intValue = nil
+    }
+
+    init(intValue: Int) {
+        self.stringValue = String(intValue)
+        self.intValue = intValue
+    }
+}
+
+/// Decoder over a single JavaScript value.
+///
+/// Containers keep their object alive through an `MQJSValue`; leaf values are read and
+/// converted right away, before anything else can allocate.
+private final class _MQJSDecoder: Decoder {
+    let context: MQJSContext
+    let value: MQJSValue
+    let codingPath: [CodingKey]
+    let userInfo: [CodingUserInfoKey: Any]
+
+    init(context: MQJSContext, value: MQJSValue, codingPath: [CodingKey], userInfo: [CodingUserInfoKey: Any]) {
+        self.context = context
+        self.value = value
+        self.codingPath = codingPath
+        self.userInfo = userInfo
+    }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> {
+        let ctx = context.ctx
+        guard JS_GetClassID(ctx, value.jsValue) >= 0, JS_IsFunction(ctx, value.jsValue) == 0 else {
+            throw DecodingError.typeMismatch(
+                [String: Any].self,
+                mismatch(codingPath, "an object", value.jsValue, ctx)
+            )
+        }
+        return KeyedDecodingContainer(MQJSKeyedContainer<Key>(decoder: self))
+    }
+
+    func unkeyedContainer() throws -> UnkeyedDecodingContainer {
+        let length = JS_GetArrayLength(context.ctx, value.jsValue)
+        guard length >= 0 else {
+            throw DecodingError.typeMismatch(
+                [Any].self,
+                mismatch(codingPath, "an array", value.jsValue, context.ctx)
+            )
+        }
+        return MQJSUnkeyedContainer(decoder: self, count: Int(length))
+    }
+
+    func singleValueContainer() throws -> SingleValueDecodingContainer {
+        return MQJSSingleValueContainer(decoder: self)
+    }
+
+    /// Decodes a value read from a container: leaves directly, anything else through a
+    /// nested decoder
+    func decode<T: Decodable>(_ type: T.Type, from jsValue: JSValue, codingPath: [CodingKey]) throws -> T {
+        if let leaf = try decodeLeaf(type, from: jsValue, codingPath: codingPath) {
+            return leaf
+        }
+        let nested = _MQJSDecoder(
+            context: context,
+            value: MQJSValue(context: context, jsValue: jsValue),
+            codingPath: codingPath,
+            userInfo: userInfo
+        )
+        return try T(from: nested)
+    }
+
+    /// Decodes standard library leaf types without creating a nested decoder
+    func decodeLeaf<T>(_ type: T.Type, from jsValue: JSValue, codingPath: [CodingKey]) throws -> T? {
+        switch type {
+        case is String.Type:
+            return try decodeString(jsValue, codingPath: codingPath) as? T
+        case is Bool.Type:
+            return try decodeBool(jsValue, codingPath: codingPath) as? T
+        case is Double.Type:
+            return try decodeDouble(jsValue, codingPath: codingPath) as? T
+        case is Float.Type:
+            return Float(try decodeDouble(jsValue, codingPath: codingPath)) as? T
+        case is Int.Type:
+            return try decodeInteger(Int.self, from: jsValue, codingPath: codingPath) as? T
+        case is Int8.Type:
+            return try decodeInteger(Int8.self, from: jsValue, codingPath: codingPath) as? T
+        case is Int16.Type:
+            return try decodeInteger(Int16.self, from: jsValue, codingPath: codingPath) as? T
+        case is Int32.Type:
+            return try decodeInteger(Int32.self, from: jsValue, codingPath: codingPath) as? T
+        case is Int64.Type:
+            return try decodeInteger(Int64.self, from: jsValue, codingPath: codingPath) as? T
+        case is UInt.Type:
+            return try decodeInteger(UInt.self, from: jsValue, codingPath: codingPath) as? T
+        case is UInt8.Type:
+            return try decodeInteger(UInt8.self, from: jsValue, codingPath: codingPath) as? T
+        case is UInt16.Type:
+            return try decodeInteger(UInt16.self, from: jsValue, codingPath: codingPath) as? T
+        case is UInt32.Type:
+            return try decodeInteger(UInt32.self, from: jsValue, codingPath: codingPath) as? T
+        case is UInt64.Type:
+            return try decodeInteger(UInt64.self, from: jsValue, codingPath: codingPath) as? T
+        default:
+            return nil
+        }
+    }
+
+    func isNull(_ jsValue: JSValue) -> Bool {
+        return JS_IsNull(jsValue) != 0 || JS_IsUndefined(jsValue) != 0
+    }
+
+    func decodeString(_ jsValue: JSValue, codingPath: [CodingKey]) throws -> String {
+        guard JS_IsString(context.ctx, jsValue) != 0 else {
+            throw typeMismatch(String.self, "a string", jsValue, codingPath)
+        }
+        return MQJSValueReader.string(jsValue, in: context.ctx)
+    }
+
+    func decodeBool(_ jsValue: JSValue, codingPath: [CodingKey]) throws -> Bool {
+        guard JS_IsBool(jsValue) != 0 else {
+            throw typeMismatch(Bool.self, "a boolean", jsValue, codingPath)
+        }
+        return jsValue == mqjs_get_true()
+    }
+
+    func decodeDouble(_ jsValue: JSValue, codingPath: [CodingKey]) throws -> Double {
+        var d: Double = 0
+        guard JS_IsNumber(context.ctx, jsValue) != 0, JS_ToNumber(context.ctx, &d, jsValue) == 0 else {
+            throw typeMismatch(Double.self, "a number", jsValue, codingPath)
+        }
+        return d
+    }
+
+    func decodeInteger<T: BinaryInteger>(_ type: T.Type, from jsValue: JSValue, codingPath: [CodingKey]) throws -> T {
+        if JS_IsInt(jsValue) != 0 {
+            var i: Int32 = 0
+            _ = JS_ToInt32(context.ctx, &i, jsValue)
+            if let result = T(exactly: i) {
+                return result
+            }
+        } else {
+            let d = try decodeDouble(jsValue, codingPath: codingPath)
+            if let result = T(exactly: d) {
+                return result
+            }
+        }
+        throw DecodingError.dataCorrupted(DecodingError.Context(
+            codingPath: codingPath,
+            debugDescription: "Number does not fit in \(T.self)"
+        ))
+    }
+
+    func typeMismatch(_ type: Any.Type, _ expected: String, _ jsValue: JSValue, _ codingPath: [CodingKey]) -> DecodingError {
+        if isNull(jsValue) {
+            return DecodingError.valueNotFound(type, DecodingError.Context(
+                codingPath: codingPath,
+                debugDescription: "Expected \(expected) but found null or undefined"
+            ))
+        }
+        return DecodingError.typeMismatch(type, mismatch(codingPath, expected, jsValue, context.ctx))
+    }
+}
+
+/// Context describing a value of the wrong type
+private func mismatch(_ codingPath: [CodingKey], _ expected: String, _ jsValue: JSValue, _ ctx: OpaquePointer) -> DecodingError.Context {
+    let found: String
+    if JS_IsNull(jsValue) != 0 {
+        found = "null"
+    } else if JS_IsUndefined(jsValue) != 0 {
+        found = "undefined"
+    } else if JS_IsBool(jsValue) != 0 {
+        found = "a boolean"
+    } else if JS_IsNumber(ctx, jsValue) != 0 {
+        found = "a number"
+    } else if JS_IsString(ctx, jsValue) != 0 {
+        found = "a string"
+    } else if JS_IsFunction(ctx, jsValue) != 0 {
+        found = "a function"
+    } else if JS_GetArrayLength(ctx, jsValue) >= 0 {
+        found = "an array"
+    } else {
+        found = "an object"
+    }
+    return DecodingError.Context(codingPath: codingPath, debugDescription: "Expected \(expected) but found \(found)")
+}
+
+// MARK: - Containers
+
+private struct MQJSKeyedContainer<Key: CodingKey>: KeyedDecodingContainerProtocol {
+    let decoder: _MQJSDecoder
+
+    var codingPath: [CodingKey] { decoder.codingPath }
+
+    /// Own property names, array elements first
+    var allKeys: [Key] {
+        return propertyNames().compactMap { Key(stringValue: $0) }
+    }
+
+    private func propertyNames() -> [String] {
+        let ctx = decoder.context.ctx
+        var names: [String] = []
+        let length = Int(JS_GetArrayLength(ctx, decoder.value.jsValue))
+        if length > 0 {
+            names += (0..<length).map { String($0) }
+        }
+        var position: Int32 = 0
+        var key: JSValue = 0
+        var value: JSValue = 0
+        // Getters are invoked while enumerating; an exception just ends the list
+        while JS_GetOwnPropertyNext(ctx, decoder.value.jsValue, &position, &key, &value) > 0 {
+            names.append(MQJSValueReader.propertyName(key, in: ctx))
+        }
+        return names
+    }
+
+    /// Reads a property (undefined if missing)
+    private func property(_ key: Key) throws -> JSValue {
+        let ctx = decoder.context.ctx
+        let result: JSValue
+        if let index = key.intValue, index >= 0, key.stringValue == String(index) {
+            result = JS_GetPropertyUint32(ctx, decoder.value.jsValue, UInt32(index))
+        } else {
+            result = JS_GetPropertyStr(ctx, decoder.value.jsValue, key.stringValue)
+        }
+        if JS_IsException(result) != 0 {
+            throw try decoder.context.extractError()
+        }
+        return result
+    }
+
+    func contains(_ key: Key) -> Bool {
+        guard let value = try? property(key) else { return false }
+        return JS_IsUndefined(value) == 0
+    }
+
+    func decodeNil(forKey key: Key) throws -> Bool {
+        return decoder.isNull(try property(key))
+    }
+
+    func decode<T: Decodable>(_ type: T.Type, forKey key: Key) throws -> T {
+        let value = try property(key)
+        if JS_IsUndefined(value) != 0 {
+            throw DecodingError.keyNotFound(key, DecodingError.Context(
+                codingPath: codingPath,
+                debugDescription: "No value associated with key \(key.stringValue)"
+            ))
+        }
+        return try decoder.decode(type, from: value, codingPath: codingPath + [key])
+    }
+
+    func nestedContainer<NestedKey: CodingKey>(keyedBy type: NestedKey.Type, forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> {
+        return try nestedDecoder(forKey: key).container(keyedBy: type)
+    }
+
+    func nestedUnkeyedContainer(forKey key: Key) throws -> UnkeyedDecodingContainer {
+        return try nestedDecoder(forKey: key).unkeyedContainer()
+    }
+
+    func superDecoder() throws -> Decoder {
+        return try nestedDecoder(forKey: Key(stringValue: "super")!)
+    }
+
+    func superDecoder(forKey key: Key) throws -> Decoder {
+        return try nestedDecoder(forKey: key)
+    }
+
+    private func nestedDecoder(forKey key: Key) throws -> _MQJSDecoder {
+        let value = try property(key)
+        return _MQJSDecoder(
+            context: decoder.context,
+            value: MQJSValue(context: decoder.context, jsValue: value),
+            codingPath: codingPath + [key],
+            userInfo: decoder.userInfo
+        )
+    }
+}
+
+private struct MQJSUnkeyedContainer: UnkeyedDecodingContainer {
+    let decoder: _MQJSDecoder
+    let count: Int?
+    private(set) var currentIndex = 0
+
+    init(decoder: _MQJSDecoder, count: Int) {
+        self.decoder = decoder
+        self.count = count
+    }
+
+    var codingPath: [CodingKey] { decoder.codingPath }
+
+    var isAtEnd: Bool { currentIndex >= count! }
+
+    private var currentPath: [CodingKey] {
+        return codingPath + [MQJSCodingKey(intValue: currentIndex)]
+    }
+
+    /// Reads the current element without advancing
+    private func element<T>(_ type: T.Type) throws -> JSValue {
+        guard !isAtEnd else {
+            throw DecodingError.valueNotFound(type, DecodingError.Context(
+                codingPath: currentPath,
+                debugDescription: "Unkeyed container is at end"
+            ))
+        }
+        let result = JS_GetPropertyUint32(decoder.context.ctx, decoder.value.jsValue, UInt32(currentIndex))
+        if JS_IsException(result) != 0 {
+            throw try decoder.context.extractError()
+        }
+        return result
+    }
+
+    mutating func decodeNil() throws -> Bool {
+        if decoder.isNull(try element(Never.self)) {
+            currentIndex += 1
+            return true
+        }
+        return false
+    }
+
+    mutating func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        let value = try element(type)
+        let result = try decoder.decode(type, from: value, codingPath: currentPath)
+        currentIndex += 1
+        return result
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy type: NestedKey.Type) throws -> KeyedDecodingContainer<NestedKey> {
+        let result = try nestedDecoder().container(keyedBy: type)
+        currentIndex += 1
+        return result
+    }
+
+    mutating func nestedUnkeyedContainer() throws -> UnkeyedDecodingContainer {
+        let result = try nestedDecoder().unkeyedContainer()
+        currentIndex += 1
+        return result
+    }
+
+    mutating func superDecoder() throws -> Decoder {
+        let result = try nestedDecoder()
+        currentIndex += 1
+        return result
+    }
+
+    private func nestedDecoder() throws -> _MQJSDecoder {
+        let value = try element(Any.self)
+        return _MQJSDecoder(
+            context: decoder.context,
+            value: MQJSValue(context: decoder.context, jsValue: value),
+            codingPath: currentPath,
+            userInfo: decoder.userInfo
+        )
+    }
+}
+
+private struct MQJSSingleValueContainer: SingleValueDecodingContainer {
+    let decoder: _MQJSDecoder
+
+    var codingPath: [CodingKey] { decoder.codingPath }
+
+    func decodeNil() -> Bool {
+        return decoder.isNull(decoder.value.jsValue)
+    }
+
+    func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        if let leaf = try decoder.decodeLeaf(type, from: decoder.value.jsValue, codingPath: codingPath) {
+            return leaf
+        }
+        return try T(from: decoder)
+    }
+}
@@ -0,0 +1,291 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Encoder
+
+/// Encodes `Encodable` types to JavaScript values.
+///
+/// The value is encoded to a lightweight tree first, then built in the context with
+/// one engine call per object or array: property tables are sized once and no
+/// `MQJSValue` is created per property.
+///
+/// ```swift
+/// struct Request: Encodable {
+///     let path: String
+///     let headers: [String: String]
+/// }
+///
+/// let request = try MQJSEncoder().encode(Request(path: "/", headers: [:]), in: context)
+/// let response = try handler.call(withArguments: [request])
+/// ```
+///
+/// Values map like in `JSONEncoder`: `nil` becomes `null`, integers and floating point
+/// numbers become numbers, and keyed and unkeyed containers become objects and arrays.
+/// `MQJSValue` properties are passed through unchanged.
+public struct MQJSEncoder {
+    /// Contextual information exposed to `Encodable` implementations
+    public var userInfo: [CodingUserInfoKey: Any] = [:]
+
+    public init() {}
+
+    /// Encodes a value to a JavaScript value in the given context
+    public func encode<T: Encodable>(_ value: T, in context: MQJSContext) throws -> MQJSValue {
+        try context.checkValid()
+        if let jsValue = value as? MQJSValue {
+            return jsValue
+        }
+        let encoder = _MQJSEncoder(codingPath: [], userInfo: userInfo)
+        try value.encode(to: encoder)
+        return try MQJSValueBuilder(context: context).makeValue(encoder.result ?? .null)
+    }
+}
+
+extension MQJSContext {
+    /// Encodes an `Encodable` value to a JavaScript value.
+    ///
+    /// ```swift
+    /// context.globalObject["config"] = try context.encode(config)
+    /// ```
+    public func encode<T: Encodable>(_ value: T) throws -> MQJSValue {
+        return try MQJSEncoder().encode(value, in: self)
+    }
+}
+
+extension MQJSValue: Encodable {
+    /// Encoding an `MQJSValue` with `MQJSEncoder` passes it through unchanged; other
+    /// encoders are not supported.
+    public func encode(to encoder: Encoder) throws {
+        guard let encoder = encoder as? _MQJSEncoder else {
+            throw EncodingError.invalidValue(self, EncodingError.Context(
+                codingPath: encoder.codingPath,
+                debugDescription: "MQJSValue can only be encoded with MQJSEncoder"
+            ))
+        }
+        encoder.result = .value(self)
+    }
+}
+
+// MARK: - Encoded Tree (Internal)
+
+/// A Swift value encoded for the JavaScript heap
+internal enum MQJSEncodedNode {
+    case null
+    case bool(Bool)
+    case int(Int64)
+    case double(Double)
+    case string(String)
+    case value(MQJSValue)
+    case array(MQJSEncodedArray)
+    case object(MQJSEncodedObject)
+}
+
+/// Elements of an encoded array (a class so that nested containers can fill it later)
+internal final class MQJSEncodedArray {
+    var elements: [MQJSEncodedNode] = []
+}
+
+/// Properties of an encoded object in encoding order
+internal final class MQJSEncodedObject {
+    var keys: [String] = []
+    var values: [MQJSEncodedNode] = []
+
+    func set(_ key: String, _ value: MQJSEncodedNode) {
+        keys.append(key)
+        values.append(value)
+    }
+}
+
+// MARK: - Encoder Implementation (Internal)
+
+/// Coding key for array indices in coding paths
+private struct MQJSIndexKey: CodingKey {
+    let intValue: Int?
+    var stringValue: String { String(intValue!) }
+
+    init(intValue: Int) {
+        self.intValue = intValue
+    }
+
+    init?(stringValue: String) {
+        return nil
+    }
+}
+
+internal final class _MQJSEncoder: Encoder {
+    let codingPath: [CodingKey]
+    let userInfo: [CodingUserInfoKey: Any]
+
+    /// The encoded value, set by the first container or single value encoded
+    var result: MQJSEncodedNode?
+
+    init(codingPath: [CodingKey], userInfo: [CodingUserInfoKey: Any]) {
+        self.codingPath = codingPath
+        self.userInfo = userInfo
+    }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> {
+        let storage: MQJSEncodedObject
+        if case .object(let existing)? = result {
+            storage = existing
+        } else {
+            storage = MQJSEncodedObject()
+            result = .object(storage)
+        }
+        return KeyedEncodingContainer(MQJSKeyedEncodingContainer<Key>(encoder: self, storage: storage))
+    }
+
+    func unkeyedContainer() -> UnkeyedEncodingContainer {
+        let storage: MQJSEncodedArray
+        if case .array(let existing)? = result {
+            storage = existing
+        } else {
+            storage = MQJSEncodedArray()
+            result = .array(storage)
+        }
+        return MQJSUnkeyedEncodingContainer(encoder: self, storage: storage)
+    }
+
+    func singleValueContainer() -> SingleValueEncodingContainer {
+        return MQJSSingleValueEncodingContainer(encoder: self)
+    }
+
+    /// Encodes a nested value, without a nested encoder for standard library leaves
+    func encodeNode<T: Encodable>(_ value: T, codingPath: [CodingKey]) throws -> MQJSEncodedNode {
+        if let leaf = leafNode(value) {
+            return leaf
+        }
+        let nested = _MQJSEncoder(codingPath: codingPath, userInfo: userInfo)
+        try value.encode(to: nested)
+        return nested.result ?? .object(MQJSEncodedObject())
+    }
+
+    func leafNode<T>(_ value: T) -> MQJSEncodedNode? {
+        switch value {
+        case let v as String: return .string(v)
+        case let v as Bool: return .bool(v)
+        case let v as Double: return .double(v)
+        case let v as Float: return .double(Double(v))
+        case let v as Int: return .int(Int64(v))
+        case let v as Int8: return .int(Int64(v))
+        case let v as Int16: return .int(Int64(v))
+        case let v as Int32: return .int(Int64(v))
+        case let v as Int64: return .int(v)
+        case let v as UInt8: return .int(Int64(v))
+        case let v as UInt16: return .int(Int64(v))
+        case let v as UInt32: return .int(Int64(v))
+        case let v as UInt: return unsignedNode(UInt64(v))
+        case let v as UInt64: return unsignedNode(v)
+        case let v as MQJSValue: return .value(v)
+        default: return nil
+        }
+    }
+
+    private func unsignedNode(_ value: UInt64) -> MQJSEncodedNode {
+        if let exact = Int64(exactly: value) {
+            return .int(exact)
+        }
+        return .double(Double(value))
+    }
+}
+
+private struct MQJSKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProtocol {
+    let encoder: _MQJSEncoder
+    let storage: MQJSEncodedObject
+
+    var codingPath: [CodingKey] { encoder.codingPath }
+
+    mutating func encodeNil(forKey key: Key) throws {
+        storage.set(key.stringValue, .null)
+    }
+
+    mutating func encode<T: Encodable>(_ value: T, forKey key: Key) throws {
+        storage.set(key.stringValue, try encoder.encodeNode(value, codingPath: codingPath + [key]))
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy keyType: NestedKey.Type, forKey key: Key) -> KeyedEncodingContainer<NestedKey> {
+        let nested = MQJSEncodedObject()
+        storage.set(key.stringValue, .object(nested))
+        let nestedEncoder = _MQJSEncoder(codingPath: codingPath + [key], userInfo: encoder.userInfo)
+        nestedEncoder.result = .object(nested)
+        return KeyedEncodingContainer(MQJSKeyedEncodingContainer<NestedKey>(encoder: nestedEncoder, storage: nested))
+    }
+
+    mutating func nestedUnkeyedContainer(forKey key: Key) -> UnkeyedEncodingContainer {
+        let nested = MQJSEncodedArray()
+        storage.set(key.stringValue, .array(nested))
+        let nestedEncoder = _MQJSEncoder(codingPath: codingPath + [key], userInfo: encoder.userInfo)
+        nestedEncoder.result = .array(nested)
+        return MQJSUnkeyedEncodingContainer(encoder: nestedEncoder, storage: nested)
+    }
+
+    mutating func superEncoder() -> Encoder {
+        return superEncoder(forKey: Key(stringValue: "super")!)
+    }
+
+    mutating func superEncoder(forKey key: Key) -> Encoder {
+        let nested = MQJSEncodedObject()
+        storage.set(key.stringValue, .object(nested))
+        let nestedEncoder = _MQJSEncoder(codingPath: codingPath + [key], userInfo: encoder.userInfo)
+        nestedEncoder.result = .object(nested)
+        return nestedEncoder
+    }
+}
+
+private struct MQJSUnkeyedEncodingContainer: UnkeyedEncodingContainer {
+    let encoder: _MQJSEncoder
+    let storage: MQJSEncodedArray
+
+    var codingPath: [CodingKey] { encoder.codingPath }
+
+    var count: Int { storage.elements.count }
+
+    private var nextPath: [CodingKey] {
+        return codingPath + [MQJSIndexKey(intValue: count)]
+    }
+
+    mutating func encodeNil() throws {
+        storage.elements.append(.null)
+    }
+
+    mutating func encode<T: Encodable>(_ value: T) throws {
+        storage.elements.append(try encoder.encodeNode(value, codingPath: nextPath))
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy keyType: NestedKey.Type) -> KeyedEncodingContainer<NestedKey> {
+        let nested = MQJSEncodedObject()
+        let nestedEncoder = _MQJSEncoder(codingPath: nextPath, userInfo: encoder.userInfo)
+        nestedEncoder.result = .object(nested)
+        storage.elements.append(.object(nested))
+        return KeyedEncodingContainer(MQJSKeyedEncodingContainer<NestedKey>(encoder: nestedEncoder, storage: nested))
+    }
+
+    mutating func nestedUnkeyedContainer() -> UnkeyedEncodingContainer {
+        let nested = MQJSEncodedArray()
+        let nestedEncoder = _MQJSEncoder(codingPath: nextPath, userInfo: encoder.userInfo)
+        nestedEncoder.result = .array(nested)
+        storage.elements.append(.array(nested))
+        return MQJSUnkeyedEncodingContainer(encoder: nestedEncoder, storage: nested)
+    }
+
+    mutating func superEncoder() -> Encoder {
+        let nested = MQJSEncodedObject()
+        let nestedEncoder = _MQJSEncoder(codingPath: nextPath, userInfo: encoder.userInfo)
+        nestedEncoder.result = .object(nested)
+        storage.elements.append(.object(nested))
+        return nestedEncoder
+    }
+}
+
+private struct MQJSSingleValueEncodingContainer: SingleValueEncodingContainer {
+    let encoder: _MQJSEncoder
+
+    var codingPath: [CodingKey] { encoder.codingPath }
+
+    mutating func encodeNil() throws {
+        encoder.result = .null
+    }
+
+    mutating func encode<T: Encodable>(_ value: T) throws {
+        encoder.result = try encoder.encodeNode(value, codingPath: codingPath)
+    }
+}
@@ -35,6 +35,21 @@ public enum MQJSError: Error, LocalizedError {
     /// Error occurred during class registration
     case classRegistrationError(String)
 
+    /// Bytecode could not be compiled, relocated or loaded
+    case bytecodeError(String)
+
+    /// A context snapshot could not be taken or restored
+    case snapshotError(String)
+
+    /// The memory buffer of a context could not be resized
+    case memoryResizeError(String)
+
+    /// The profiler could not be started
+    case profilerError(String)
+
+    /// The script was aborted because it exceeded its deadline or instruction budget
+    case interrupted
+
     public var errorDescription: String? {
         switch self {
         case .invalidMemorySize(let size):
@@ -69,6 +84,21 @@ public enum MQJSError: Error, LocalizedError {
 
         case .classRegistrationError(let message):
             return "Class registration error: \(message)"
+
+        case .bytecodeError(let message):
+            return "Bytecode error: \(message)"
+
+        case .snapshotError(let message):
+            return "Snapshot error: \(message)"
+
+        case .memoryResizeError(let message):
+            return "Memory resize error: \(message)"
+
+        case .profilerError(let message):
+            return "Profiler error: \(message)"
+
+        case .interrupted:
+            return "Execution interrupted: deadline or instruction budget exceeded"
         }
     }
 }
@@ -0,0 +1,40 @@
+import Foundation
+
+// MARK: - Execution Limits
+
+/// Limits on how long a script may run before it is interrupted.
+///
+/// Pass limits to `MQJSContext.eval(_:filename:flags:limits:)`, `run(_:limits:)` or
+/// `MQJSValue.call(withArguments:limits:)`. When a limit is exceeded, the script is
+/// aborted with an exception that JavaScript code cannot catch, and the call throws
+/// `MQJSError.interrupted`. The context stays usable.
+///
+/// ```swift
+/// do {
+///     try context.eval(tenantScript, limits: .timeout(0.1))
+/// } catch MQJSError.interrupted {
+///     // The script ran for more than 100ms
+/// }
+/// ```
+///
+/// Limits are checked every `MQJSContext.interruptInterval` function calls and loop
+/// iterations, so a script can run slightly past them.
+public struct MQJSExecutionLimits {
+    /// Point in time (monotonic clock) after which the script is interrupted
+    public var deadline: DispatchTime?
+
+    /// Number of function calls and loop iterations after which the script is
+    /// interrupted (counted in steps of `MQJSContext.interruptInterval`)
+    public var instructionBudget: Int?
+
+    public init(deadline: DispatchTime? = nil, instructionBudget: Int? = nil) {
+        self.deadline = deadline
+        self.instructionBudget = instructionBudget
+    }
+
+    /// Limits the run time to `seconds` from now
+    public static func timeout(_ seconds: TimeInterval) -> MQJSExecutionLimits {
+        let nanoseconds = UInt64(max(seconds, 0) * 1_000_000_000)
+        return MQJSExecutionLimits(deadline: DispatchTime(uptimeNanoseconds: DispatchTime.now().uptimeNanoseconds + nanoseconds))
+    }
+}
@@ -0,0 +1,59 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - JSON Parsing
+
+extension MQJSContext {
+    /// Parses JSON text stored as UTF-8 bytes, like `JSON.parse`.
+    ///
+    /// ```swift
+    /// let config = try bytes.withUnsafeBufferPointer { try context.parseJSON(utf8: $0) }
+    /// print(try config["name"]?.toString())
+    /// ```
+    ///
+    /// The engine parses the bytes in place: no Swift `String` and no JavaScript
+    /// source string are created, and the bytes need not be NUL-terminated.
+    ///
+    /// - Parameter json: The UTF-8 encoded JSON text
+    /// - Returns: The parsed value
+    /// - Throws: `MQJSError.evaluationError` with the `SyntaxError` message and
+    ///           position if the text is not valid JSON or not valid UTF-8
+    public func parseJSON(utf8 json: UnsafeBufferPointer<UInt8>) throws -> MQJSValue {
+        try checkValid()
+        growMemoryIfNeeded()
+
+        let result = json.withMemoryRebound(to: CChar.self) { chars in
+            mqjs_json_parse_utf8(ctx, chars.baseAddress, chars.count)
+        }
+        if JS_IsException(result) != 0 {
+            throw try extractError()
+        }
+        return MQJSValue(context: self, jsValue: result)
+    }
+
+    /// Parses JSON text stored as UTF-8 in `Data`, for example a response body.
+    ///
+    /// ```swift
+    /// let (data, _) = try await URLSession.shared.data(from: url)
+    /// let items = try context.parseJSON(data: data)
+    /// ```
+    ///
+    /// - Parameter data: The UTF-8 encoded JSON text
+    /// - Returns: The parsed value
+    /// - Throws: `MQJSError.evaluationError` if the text is not valid JSON
+    public func parseJSON(data: Data) throws -> MQJSValue {
+        try data.withUnsafeBytes { raw in
+            try parseJSON(utf8: raw.bindMemory(to: UInt8.self))
+        }
+    }
+
+    /// Parses JSON text, like `JSON.parse`.
+    ///
+    /// - Parameter json: The JSON text
+    /// - Returns: The parsed value
+    /// - Throws: `MQJSError.evaluationError` if the text is not valid JSON
+    public func parseJSON(_ json: String) throws -> MQJSValue {
+        var json = json
+        return try json.withUTF8 { try parseJSON(utf8: $0) }
+    }
+}
@@ -23,6 +23,43 @@ internal final class MQJSMemoryBuffer {
             throw MQJSError.invalidMemorySize(size)
         }
 
+        self.size = size
+
+        // Zero out memory for safety and deterministic behavior
+        #if os(Windows)
+        self.baseAddress = try Self.allocate(size: size)
+        memset(baseAddress, 0, size)
+        #else
+        // calloc returns memory aligned for any type, and large blocks are mapped
+        // as zero pages on demand: only the pages the engine touches (heap at the
+        // bottom, stack at the top) become resident
+        guard let buffer = calloc(size, 1) else {
+            throw MQJSError.contextCreationFailed
+        }
+        self.baseAddress = buffer
+        #endif
+    }
+
+    /// Creates an aligned copy of the given bytes.
+    ///
+    /// Used for data that the engine references in place for the lifetime of
+    /// a context, such as loaded bytecode. No minimum size applies.
+    ///
+    /// - Parameter data: The bytes to copy
+    /// - Throws: MQJSError.contextCreationFailed if allocation fails
+    init(copying data: Data) throws {
+        self.baseAddress = try Self.allocate(size: max(data.count, 1))
+        self.size = data.count
+
+        data.withUnsafeBytes { bytes in
+            if let source = bytes.baseAddress {
+                memcpy(baseAddress, source, bytes.count)
+            }
+        }
+    }
+
+    /// Allocates memory aligned to the engine word size
+    private static func allocate(size: Int) throws -> UnsafeMutableRawPointer {
         // Allocate aligned memory for optimal performance
         // MQuickJS may require alignment for certain operations
         let alignment = MemoryLayout<Int>.alignment
@@ -32,6 +69,7 @@ internal final class MQJSMemoryBuffer {
         guard let buffer = _aligned_malloc(size, alignment) else {
             throw MQJSError.contextCreationFailed
         }
+        return buffer
         #else
         // POSIX systems use posix_memalign
         var buffer: UnsafeMutableRawPointer?
@@ -39,17 +77,8 @@ internal final class MQJSMemoryBuffer {
         guard result == 0, let allocatedBuffer = buffer else {
             throw MQJSError.contextCreationFailed
         }
-        self.baseAddress = allocatedBuffer
+        return allocatedBuffer
         #endif
-
-        #if os(Windows)
-        self.baseAddress = buffer
-        #endif
-
-        self.size = size
-
-        // Zero out memory for safety and deterministic behavior
-        memset(baseAddress, 0, size)
     }
 
     deinit {
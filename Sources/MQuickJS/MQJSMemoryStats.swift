@@ -0,0 +1,128 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Memory Statistics
+
+/// A snapshot of the heap usage and garbage collector counters of a context.
+///
+/// The counters are maintained by the engine as it runs, so reading
+/// `MQJSContext.memoryStats` is cheap enough to do after every script.
+///
+/// ```swift
+/// let stats = context.memoryStats
+/// if stats.highWater > stats.memorySize * 3 / 4 {
+///     // Give this tenant a larger context next time
+/// }
+/// ```
+public struct MQJSMemoryStats {
+    /// Size of the context memory, in bytes
+    public let memorySize: Int
+
+    /// Bytes used by the heap, including dead objects that were not collected yet
+    public let heapUsed: Int
+
+    /// Free bytes: reusable holes in the heap plus the space between the heap and the stack
+    public let heapFree: Int
+
+    /// Bytes currently in use on the JavaScript stack
+    public let stackDepth: Int
+
+    /// Largest heap plus stack usage observed (sampled at each collection and on every read)
+    public let highWater: Int
+
+    /// Number of garbage collections since the context was created
+    public let gcCount: Int
+
+    /// Number of heap compactions since the context was created
+    public let compactionCount: Int
+
+    /// Cumulative time spent in the garbage collector, in seconds
+    public let gcTime: TimeInterval
+
+    /// Bytes moved by the last heap compaction
+    public let lastCompactionBytesMoved: Int
+
+    /// Heap bytes still in use after the last collection (the live set)
+    public let liveSizeAfterLastGC: Int
+
+    /// Number of out of memory errors since the context was created
+    public let outOfMemoryCount: Int
+
+    /// Number of numbers allocated on the heap since the context was created.
+    ///
+    /// Integers and most doubles are stored inline in the value; only doubles with a
+    /// magnitude below 2^-127 or above 2^128 need a heap block (NaN and the
+    /// infinities are shared constants). The count only grows: freed blocks are not
+    /// subtracted, so compare two readings to get the allocations of an operation.
+    public let float64Allocations: Int
+
+    /// Block counts and sizes per kind, or nil if they were not requested
+    /// (see `MQJSContext.memoryStats(countingBlocks:)`)
+    public let blocks: [MQJSMemoryBlockKind: MQJSMemoryBlockStats]?
+
+    internal init(_ stats: JSMemoryStats, countingBlocks: Bool) {
+        memorySize = stats.memory_size
+        heapUsed = stats.heap_used
+        heapFree = stats.free_size
+        stackDepth = stats.stack_size
+        highWater = stats.high_water
+        gcCount = Int(stats.gc_count)
+        compactionCount = Int(stats.gc_compact_count)
+        gcTime = TimeInterval(stats.gc_time_ns) / 1_000_000_000
+        lastCompactionBytesMoved = stats.gc_last_moved_size
+        liveSizeAfterLastGC = stats.gc_live_size
+        outOfMemoryCount = Int(stats.oom_count)
+        float64Allocations = Int(stats.float64_count)
+
+        guard countingBlocks else {
+            blocks = nil
+            return
+        }
+
+        // The fixed-size C arrays are imported as tuples
+        var counts = stats.block_count
+        var sizes = stats.block_size
+        let countBuffer = withUnsafeBytes(of: &counts) { Array($0.bindMemory(to: UInt32.self)) }
+        let sizeBuffer = withUnsafeBytes(of: &sizes) { Array($0.bindMemory(to: Int.self)) }
+
+        var result: [MQJSMemoryBlockKind: MQJSMemoryBlockStats] = [:]
+        for kind in MQJSMemoryBlockKind.allCases {
+            let index = kind.memoryTag
+            result[kind] = MQJSMemoryBlockStats(count: Int(countBuffer[index]), bytes: sizeBuffer[index])
+        }
+        blocks = result
+    }
+}
+
+/// The kind of a memory block in the JavaScript heap.
+public enum MQJSMemoryBlockKind: CaseIterable {
+    /// Dead memory waiting to be reused or compacted
+    case free
+    case object
+    case float64
+    case string
+    case functionBytecode
+    case valueArray
+    case byteArray
+    case varRef
+
+    /// Engine memory tag of the block (an anonymous C enum, imported as Int)
+    internal var memoryTag: Int {
+        switch self {
+        case .free: return JS_MTAG_FREE
+        case .object: return JS_MTAG_OBJECT
+        case .float64: return JS_MTAG_FLOAT64
+        case .string: return JS_MTAG_STRING
+        case .functionBytecode: return JS_MTAG_FUNCTION_BYTECODE
+        case .valueArray: return JS_MTAG_VALUE_ARRAY
+        case .byteArray: return JS_MTAG_BYTE_ARRAY
+        case .varRef: return JS_MTAG_VARREF
+        }
+    }
+}
+
+/// Number and total size of the heap blocks of one kind.
+public struct MQJSMemoryBlockStats: Equatable {
+    public let count: Int
+    public let bytes: Int
+}
@@ -0,0 +1,104 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Profile
+
+/// Call stack samples and opcode counts collected by the profiler of a context.
+///
+/// Stacks are recorded in collapsed form: one entry per distinct stack, root frame
+/// first, frames separated by `;`. Each frame is labeled `name (file:line)`, or
+/// `name (native)` for native functions. `collapsedStacks` can be fed directly to
+/// flame graph tools such as `flamegraph.pl` or speedscope.
+///
+/// ```swift
+/// try context.startProfiling(sampleInterval: 10)
+/// try context.eval(script)
+/// let profile = context.stopProfiling()
+/// try profile.collapsedStacks.write(to: url, atomically: true, encoding: .utf8)
+/// ```
+public struct MQJSProfile {
+    /// Number of samples per collapsed stack
+    public let samples: [String: Int]
+
+    /// Number of executed opcodes per opcode name (empty unless opcodes were counted)
+    public let opcodeCounts: [String: Int]
+
+    /// Total number of samples
+    public var sampleCount: Int {
+        return samples.values.reduce(0, +)
+    }
+
+    /// Number of samples per innermost frame (the "self" time of each function line)
+    public var selfSamples: [String: Int] {
+        var result: [String: Int] = [:]
+        for (stack, count) in samples {
+            let leaf = stack.split(separator: ";").last.map(String.init) ?? stack
+            result[leaf, default: 0] += count
+        }
+        return result
+    }
+
+    /// The samples in collapsed stack format: `frame;frame;... count` per line,
+    /// sorted by stack
+    public var collapsedStacks: String {
+        return samples.keys.sorted().map { "\($0) \(samples[$0]!)\n" }.joined()
+    }
+}
+
+// MARK: - Profiler (Internal)
+
+/// Collects the samples reported by the engine while profiling is enabled.
+internal final class MQJSProfiler {
+    /// Number of samples per collapsed stack
+    private(set) var samples: [String: Int] = [:]
+
+    /// Opcode counters written by the interpreter loop, or nil
+    let opcodeCounts: UnsafeMutablePointer<UInt64>?
+
+    init(countOpcodes: Bool) {
+        if countOpcodes {
+            let count = Int(JS_GetOpcodeCount())
+            opcodeCounts = UnsafeMutablePointer<UInt64>.allocate(capacity: count)
+            opcodeCounts!.initialize(repeating: 0, count: count)
+        } else {
+            opcodeCounts = nil
+        }
+    }
+
+    deinit {
+        opcodeCounts?.deallocate()
+    }
+
+    /// Record one sample (frames are innermost first)
+    func record(_ frames: UnsafePointer<JSProfileFrame>, count: Int) {
+        var stack = ""
+        for index in stride(from: count - 1, through: 0, by: -1) {
+            let frame = frames[index]
+            var name = frame.func_name.map { String(cString: $0) } ?? ""
+            if name.isEmpty {
+                name = "<anonymous>"
+            }
+            if !stack.isEmpty {
+                stack += ";"
+            }
+            if let filename = frame.filename {
+                stack += "\(name) (\(String(cString: filename)):\(frame.line_num))"
+            } else {
+                stack += "\(name) (native)"
+            }
+        }
+        samples[stack, default: 0] += 1
+    }
+
+    /// The results collected so far
+    var profile: MQJSProfile {
+        var counts: [String: Int] = [:]
+        if let opcodeCounts = opcodeCounts {
+            for opcode in 0..<Int(JS_GetOpcodeCount()) where opcodeCounts[opcode] != 0 {
+                guard let name = JS_GetOpcodeName(Int32(opcode)) else { continue }
+                counts[String(cString: name)] = Int(opcodeCounts[opcode])
+            }
+        }
+        return MQJSProfile(samples: samples, opcodeCounts: counts)
+    }
+}
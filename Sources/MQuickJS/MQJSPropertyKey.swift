@@ -0,0 +1,118 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Property Key
+
+/// A property name interned once per context, for repeated property access.
+///
+/// Accessing a property by `String` creates a JavaScript string and looks it up in
+/// the atom table on every access. A property key holds the interned atom instead,
+/// so gets, sets and `has` checks go straight to the object's property table.
+///
+/// ```swift
+/// let idKey = try context.propertyKey("id")
+/// for item in items {
+///     let id = item[idKey]
+/// }
+/// ```
+///
+/// The atom is kept alive with a GC reference. It is re-interned on the next access
+/// after a snapshot or restore, which invalidate all values. Keys are only fast in
+/// the context that created them; in another context they fall back to lookup by name.
+public final class MQJSPropertyKey {
+    /// The property name
+    public let name: String
+
+    /// Context the key was interned in
+    internal weak var context: MQJSContext?
+
+    /// The atom (or integer for array indices), rooted by its `MQJSValue`
+    private var atom: MQJSValue?
+
+    /// Context value generation the atom was created in
+    private var generation = 0
+
+    internal init(name: String, context: MQJSContext) throws {
+        self.name = name
+        self.context = context
+        _ = try jsKey(in: context)
+    }
+
+    /// Returns the interned key for the given context, re-interning it if the
+    /// context invalidated its values since
+    internal func jsKey(in context: MQJSContext) throws -> JSValue {
+        if let atom = atom, generation == context.valueGeneration {
+            return atom.jsValue
+        }
+        try context.checkValid()
+        var name = self.name
+        let key = name.withUTF8 { bytes in
+            bytes.withMemoryRebound(to: CChar.self) { chars in
+                JS_NewPropertyKey(context.ctx, chars.baseAddress, chars.count)
+            }
+        }
+        if JS_IsException(key) != 0 {
+            throw try context.extractError()
+        }
+        atom = MQJSValue(context: context, jsValue: key, scope: nil)
+        generation = context.valueGeneration
+        return key
+    }
+}
+
+extension MQJSContext {
+    /// Interns a property name for repeated access with `MQJSValue` subscripts.
+    ///
+    /// ```swift
+    /// let key = try context.propertyKey("count")
+    /// counter[key] = try (counter[key]!.toInt32() + 1).toJSValue(in: context)
+    /// ```
+    public func propertyKey(_ name: String) throws -> MQJSPropertyKey {
+        try checkValid()
+        return try MQJSPropertyKey(name: name, context: self)
+    }
+}
+
+extension MQJSValue {
+    /// Access properties with a pre-interned key.
+    ///
+    /// Behaves like `subscript(propertyName:)` without creating or looking up the
+    /// name string.
+    public subscript(key: MQJSPropertyKey) -> MQJSValue? {
+        get {
+            guard let ctx = try? checkedContext() else { return nil }
+            guard key.context === ctx, let jsKey = try? key.jsKey(in: ctx) else {
+                return self[key.name]
+            }
+
+            let result = JS_GetPropertyKey(ctx.ctx, jsValue, jsKey)
+            if JS_IsException(result) != 0 {
+                return nil
+            }
+            return MQJSValue(context: ctx, jsValue: result)
+        }
+        set {
+            guard let ctx = try? checkedContext() else { return }
+            guard key.context === ctx, let jsKey = try? key.jsKey(in: ctx) else {
+                self[key.name] = newValue
+                return
+            }
+
+            let valueToSet = newValue?.jsValue ?? mqjs_get_undefined()
+            _ = JS_SetPropertyKey(ctx.ctx, jsValue, jsKey, valueToSet)
+        }
+    }
+
+    /// Returns true if the object or its prototype chain has the property (like the
+    /// JavaScript `in` operator)
+    public func hasProperty(_ key: MQJSPropertyKey) -> Bool {
+        guard let ctx = try? checkedContext() else { return false }
+        let localKey = key.context === ctx ? key : try? ctx.propertyKey(key.name)
+        guard let localKey = localKey, let jsKey = try? localKey.jsKey(in: ctx) else {
+            return false
+        }
+        return withExtendedLifetime(localKey) {
+            JS_HasPropertyKey(ctx.ctx, jsValue, jsKey) != 0
+        }
+    }
+}
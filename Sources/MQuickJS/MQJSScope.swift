@@ -0,0 +1,144 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Scopes
+
+/// A scope rooting the temporary values created inside `MQJSContext.withScope`.
+///
+/// A regular `MQJSValue` allocates its own GC reference, links it into the context's
+/// reference list and registers itself for invalidation. Inside a scope, values are
+/// instead rooted in slots pushed on the engine's GC reference stack, which are
+/// allocated in chunks and all released with a single pop when the scope exits.
+///
+/// Values created inside the scope are invalid after it. Use `escape(_:)` for the
+/// values that must outlive it.
+public final class MQJSScope {
+    /// Number of GC reference slots allocated at once
+    private static let chunkSize = 64
+
+    /// The context of the scope (kept alive by `withScope`)
+    private unowned let context: MQJSContext
+
+    /// Native call depth the scope was opened at. Values created at another depth
+    /// (by native functions called from JavaScript) are not part of the scope, as
+    /// their slots would be interleaved with the engine's own.
+    internal let nativeCallDepth: Int
+
+    /// The slot chunks, in push order
+    private var chunks: [UnsafeMutablePointer<JSGCRef>] = []
+
+    /// Slots used in the last chunk
+    private var usedInLastChunk = MQJSScope.chunkSize
+
+    /// The values rooted in the scope, invalidated when it exits
+    private var values: [MQJSValue] = []
+
+    internal init(context: MQJSContext) {
+        self.context = context
+        self.nativeCallDepth = context.nativeCallDepth
+    }
+
+    /// Number of values rooted in the scope
+    public var valueCount: Int {
+        return values.count
+    }
+
+    /// Returns a copy of the value that stays valid after the scope exits.
+    ///
+    /// ```swift
+    /// let user = try context.withScope { scope in
+    ///     let users = context.globalObject["users"]!
+    ///     return try scope.escape(users[0]!)
+    /// }
+    /// ```
+    ///
+    /// Values that were not created in a scope are returned as is.
+    public func escape(_ value: MQJSValue) throws -> MQJSValue {
+        let ctx = try value.checkedContext()
+        guard value.isScoped else { return value }
+        return MQJSValue(context: ctx, jsValue: value.jsValue, scope: nil)
+    }
+
+    // MARK: - Rooting (Internal)
+
+    /// Push a slot holding jsValue on the GC reference stack
+    internal func pushRef(_ jsValue: JSValue) -> UnsafeMutablePointer<JSGCRef> {
+        if usedInLastChunk == MQJSScope.chunkSize {
+            let chunk = UnsafeMutablePointer<JSGCRef>.allocate(capacity: MQJSScope.chunkSize)
+            chunk.initialize(repeating: JSGCRef(val: 0, prev: nil), count: MQJSScope.chunkSize)
+            chunks.append(chunk)
+            usedInLastChunk = 0
+        }
+        let ref = chunks[chunks.count - 1] + usedInLastChunk
+        usedInLastChunk += 1
+        JS_PushGCRef(context.ctx, ref)!.pointee = jsValue
+        return ref
+    }
+
+    /// Keep a value rooted in the scope until it exits
+    internal func adopt(_ value: MQJSValue) {
+        values.append(value)
+    }
+
+    /// Invalidate the values and pop all the slots
+    internal func close() {
+        for value in values {
+            value.invalidate()
+        }
+        values.removeAll()
+
+        // The slots are the top of the stack: popping the first one pops them all
+        if let first = chunks.first {
+            _ = JS_PopGCRef(context.ctx, first)
+        }
+        for chunk in chunks {
+            chunk.deinitialize(count: MQJSScope.chunkSize)
+            chunk.deallocate()
+        }
+        chunks.removeAll()
+        usedInLastChunk = MQJSScope.chunkSize
+    }
+}
+
+extension MQJSContext {
+    /// Runs body with the values created in it rooted in a scope, and releases them
+    /// all at once when it returns.
+    ///
+    /// Use it around code creating many temporary values, such as walking a large
+    /// object graph:
+    ///
+    /// ```swift
+    /// let total = try context.withScope { _ in
+    ///     let items = context.globalObject["items"]!
+    ///     var sum = 0.0
+    ///     for i in 0..<Int(try items["length"]!.toInt32()) {
+    ///         sum += try items[i]!["price"]!.toDouble()
+    ///     }
+    ///     return sum
+    /// }
+    /// ```
+    ///
+    /// - Important: Values created inside the scope are invalid once it exits,
+    ///   including a value returned by body. Return `scope.escape(value)` instead.
+    ///   Snapshots cannot be taken or restored inside a scope.
+    /// - Parameter body: The code to run, receiving the scope
+    /// - Returns: The result of body
+    public func withScope<R>(_ body: (MQJSScope) throws -> R) throws -> R {
+        try checkValid()
+        let scope = MQJSScope(context: self)
+        scopes.append(scope)
+        defer {
+            scope.close()
+            scopes.removeLast()
+        }
+        return try body(scope)
+    }
+
+    /// The scope rooting the values created now, if any
+    internal var activeScope: MQJSScope? {
+        guard let scope = scopes.last, scope.nativeCallDepth == nativeCallDepth else {
+            return nil
+        }
+        return scope
+    }
+}
@@ -24,8 +24,13 @@ public final class MQJSValue {
     /// Weak reference to context (context owns values)
     internal weak var context: MQJSContext?
 
-    /// The actual JavaScript value
-    internal private(set) var jsValue: JSValue
+    /// The actual JavaScript value.
+    ///
+    /// Read through the GC reference, which the moving GC updates when it relocates
+    /// the underlying object.
+    internal var jsValue: JSValue {
+        return gcRefPtr?.pointee.val ?? mqjs_get_undefined()
+    }
 
     /// GC reference to prevent value from being collected/moved
     /// CRITICAL: Must be managed via JS_AddGCRef/JS_DeleteGCRef
@@ -37,6 +42,9 @@ public final class MQJSValue {
     /// Track if value is still valid
     private var isValid: Bool = true
 
+    /// True if the GC reference is a slot of a `withScope` scope instead of our own
+    internal private(set) var isScoped = false
+
     // MARK: - Initialization (Internal)
 
     /// Creates a new JavaScript value wrapper.
@@ -46,14 +54,28 @@ public final class MQJSValue {
     ///   - jsValue: The underlying JSValue
     ///
     /// This initializer is internal and should only be called by MQJSContext or other
-    /// internal APIs. It automatically registers the value with the GC system.
-    internal init(context: MQJSContext, jsValue: JSValue) {
+    /// internal APIs. It automatically registers the value with the GC system, in the
+    /// innermost open `withScope` scope if there is one.
+    internal convenience init(context: MQJSContext, jsValue: JSValue) {
+        self.init(context: context, jsValue: jsValue, scope: context.activeScope)
+    }
+
+    /// Creates a new JavaScript value wrapper rooted in the given scope, or with its
+    /// own GC reference if scope is nil.
+    internal init(context: MQJSContext, jsValue: JSValue, scope: MQJSScope?) {
         self.context = context
-        self.jsValue = jsValue
 
         // Initialize gcRef (value will be overwritten by JS_AddGCRef)
         self.gcRef = JSGCRef(val: 0, prev: nil)
 
+        if let scope = scope {
+            // Rooted on the engine's GC reference stack until the scope exits
+            self.gcRefPtr = scope.pushRef(jsValue)
+            self.isScoped = true
+            scope.adopt(self)
+            return
+        }
+
         // Allocate stable pointer for gcRef
         self.gcRefPtr = UnsafeMutablePointer<JSGCRef>.allocate(capacity: 1)
         self.gcRefPtr!.initialize(to: self.gcRef)
@@ -80,6 +102,12 @@ public final class MQJSValue {
         guard isValid, let ctx = context else { return }
         isValid = false
 
+        // The slot of a scoped value is released by its scope
+        if isScoped {
+            gcRefPtr = nil
+            return
+        }
+
         // CRITICAL: Must remove GC ref before context is freed
         if let ptr = gcRefPtr {
             JS_DeleteGCRef(ctx.ctx, ptr)
@@ -177,11 +205,55 @@ public final class MQJSValue {
             throw try ctx.extractError()
         }
 
-        // Copy to Swift String immediately (C string may be temporary)
-        // Try UTF-8 first, fall back to ISO Latin1 if that fails
-        return String(cString: cString, encoding: .utf8)
-            ?? String(cString: cString, encoding: .isoLatin1)
-            ?? String(cString: cString)
+        // Copy to Swift String immediately (C string may be temporary).
+        // Unpaired surrogates are not valid UTF-8 and become U+FFFD.
+        let bytes = UnsafeRawBufferPointer(start: cString, count: length)
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    /// Borrows the UTF-8 bytes of the value converted to a string, without copying
+    /// when the value already is a string.
+    ///
+    /// ```swift
+    /// let page = try context.eval("renderPage()")
+    /// try page.withUTF8Buffer { bytes in
+    ///     output.write(bytes.baseAddress!, maxLength: bytes.count)
+    /// }
+    /// ```
+    ///
+    /// Strings containing unpaired surrogates are not valid UTF-8; they are passed as
+    /// a converted copy where each surrogate is replaced with U+FFFD.
+    ///
+    /// - Important: The bytes live in the JavaScript heap. Do not use the context
+    ///   inside `body` and do not let the pointer escape it.
+    /// - Throws: MQJSError if the conversion throws in JavaScript
+    public func withUTF8Buffer<R>(_ body: (UnsafeBufferPointer<UInt8>) throws -> R) throws -> R {
+        let ctx = try checkedContext()
+        return try MQJSValue.withUTF8(jsValue, in: ctx, body)
+    }
+
+    /// Borrows the UTF-8 bytes of `value` converted to a string (see `withUTF8Buffer`)
+    internal static func withUTF8<R>(
+        _ value: JSValue,
+        in context: MQJSContext,
+        _ body: (UnsafeBufferPointer<UInt8>) throws -> R
+    ) throws -> R {
+        var buf = JSCStringBuf()
+        var length: Int = 0
+        var isUTF8: Int32 = 0
+
+        guard let cString = JS_ToUTF8StringLen(context.ctx, &length, &isUTF8, value, &buf) else {
+            throw try context.extractError()
+        }
+
+        if isUTF8 == 0 {
+            var string = String(decoding: UnsafeRawBufferPointer(start: cString, count: length),
+                                as: UTF8.self)
+            return try string.withUTF8(body)
+        }
+        return try cString.withMemoryRebound(to: UInt8.self, capacity: length) { bytes in
+            try body(UnsafeBufferPointer(start: bytes, count: length))
+        }
     }
 
     /// Converts the value to a Swift Bool.
@@ -270,6 +342,7 @@ public final class MQJSValue {
     public func call(withArguments arguments: [Any]?) throws -> MQJSValue {
         let ctx = try checkedContext()
         guard isFunction else { throw MQJSError.notAFunction }
+        ctx.growMemoryIfNeeded()
         return try performCall(
             function: self.jsValue,
             thisValue: mqjs_get_undefined(),
@@ -278,6 +351,22 @@ public final class MQJSValue {
         )
     }
 
+    /// Calls this value as a JavaScript function, interrupting it when a limit is exceeded.
+    ///
+    /// ```swift
+    /// let handler = context.globalObject["onRequest"]!
+    /// let response = try handler.call(withArguments: [request], limits: .timeout(0.05))
+    /// ```
+    ///
+    /// - Throws: `MQJSError.interrupted` if a limit was exceeded,
+    ///           `MQJSError.notAFunction` if this value is not callable
+    public func call(withArguments arguments: [Any]?, limits: MQJSExecutionLimits) throws -> MQJSValue {
+        let ctx = try checkedContext()
+        return try ctx.withExecutionLimits(limits) {
+            try call(withArguments: arguments)
+        }
+    }
+
     /// Invokes a method on this object by name.
     ///
     /// This method is compatible with JavaScriptCore's `JSValue.invokeMethod(_:withArguments:)`.
@@ -302,6 +391,7 @@ public final class MQJSValue {
             throw MQJSError.evaluationError("Method '\(name)' not found")
         }
         guard method.isFunction else { throw MQJSError.notAFunction }
+        ctx.growMemoryIfNeeded()
 
         return try performCall(
             function: method.jsValue,
@@ -354,7 +444,9 @@ public final class MQJSValue {
 
     /// Converts this JavaScript array to a Swift array.
     ///
-    /// This method is compatible with JavaScriptCore's `JSValue.toArray()`.
+    /// This method is compatible with JavaScriptCore's `JSValue.toArray()`. Arrays, typed
+    /// arrays and objects with a numeric `length` property are supported. Elements are
+    /// converted as described in `toObject()`; `undefined` and functions become `NSNull`.
     ///
     /// ```swift
     /// let arr = try context.eval("[1, 'hello', true]")
@@ -364,35 +456,19 @@ public final class MQJSValue {
     /// - Returns: A Swift array containing the converted elements
     /// - Throws: `MQJSError.typeConversionError` if conversion fails
     public func toArray() throws -> [Any] {
-        _ = try checkedContext()
+        let ctx = try checkedContext()
         guard isObject else {
             throw MQJSError.typeConversionError("Value is not an array or object")
         }
-
-        guard let lengthValue = self["length"],
-              let length = try? lengthValue.toInt32(),
-              length >= 0 else {
-            throw MQJSError.typeConversionError("Cannot get array length")
-        }
-
-        var result: [Any] = []
-        result.reserveCapacity(Int(length))
-
-        for i in 0..<Int(length) {
-            if let element = self[i] {
-                result.append(try element.toObject())
-            } else {
-                result.append(NSNull())
-            }
-        }
-
-        return result
+        return try MQJSValueReader(context: ctx).array(from: jsValue)
     }
 
     /// Converts this JavaScript object to a Swift dictionary.
     ///
-    /// This method is compatible with JavaScriptCore's `JSValue.toDictionary()`.
-    /// Uses `JSON.stringify` internally since mquickjs doesn't expose property enumeration.
+    /// This method is compatible with JavaScriptCore's `JSValue.toDictionary()`. The own
+    /// properties are read directly from the object (getters are invoked); array elements
+    /// are keyed by their index. Properties whose value is `undefined` or a function are
+    /// omitted, like in `JSON.stringify`, so the result can be passed to `JSONSerialization`.
     ///
     /// ```swift
     /// let obj = try context.eval("({name: 'Alice', age: 30})")
@@ -400,27 +476,14 @@ public final class MQJSValue {
     /// ```
     ///
     /// - Returns: A Swift dictionary with string keys
-    /// - Throws: `MQJSError.typeConversionError` if conversion fails
+    /// - Throws: `MQJSError.typeConversionError` if the value is not an object or contains
+    ///           a cycle
     public func toDictionary() throws -> [String: Any] {
         let ctx = try checkedContext()
         guard isObject else {
             throw MQJSError.typeConversionError("Value is not an object")
         }
-
-        guard let json = ctx.globalObject["JSON"],
-              let stringify = json["stringify"],
-              stringify.isFunction else {
-            throw MQJSError.evaluationError("JSON.stringify not available")
-        }
-
-        let jsonString = try stringify.call(withArguments: [self]).toString()
-
-        guard let data = jsonString.data(using: .utf8),
-              let parsed = try JSONSerialization.jsonObject(with: data) as? [String: Any] else {
-            throw MQJSError.typeConversionError("JSON did not parse to dictionary")
-        }
-
-        return parsed
+        return try MQJSValueReader(context: ctx).dictionary(from: jsValue)
     }
 
     /// Converts this JavaScript value to the appropriate Swift type.
@@ -431,40 +494,29 @@ public final class MQJSValue {
     ///   - `undefined` → `NSNull()`
     ///   - `null` → `NSNull()`
     ///   - `boolean` → `Bool`
-    ///   - `number` → `Double` or `Int` if whole number
+    ///   - `number` → `Int` if whole number, `Double` otherwise (`NSNull()` if not finite)
     ///   - `string` → `String`
+    ///   - `function` → this value
     ///   - `array` → `[Any]`
     ///   - `object` → `[String: Any]`
     public func toObject() throws -> Any {
-        _ = try checkedContext()
-
-        if isUndefined || isNull { return NSNull() }
-        if isBool { return toBool() ?? false }
-
-        if isNumber {
-            let d = try toDouble()
-            // Return Int if it's a whole number
-            if d.truncatingRemainder(dividingBy: 1) == 0 && d >= Double(Int.min) && d <= Double(Int.max) {
-                return Int(d)
-            }
-            return d
-        }
+        let ctx = try checkedContext()
 
-        if isString { return try toString() }
         if isFunction { return self }
-
-        // Check if it's an array (has numeric length property)
-        if let lengthValue = self["length"], lengthValue.isNumber {
-            return try toArray()
+        if isObject {
+            // Array-like objects (with a numeric length property) are converted to arrays
+            if JS_GetArrayLength(ctx.ctx, jsValue) < 0,
+               let lengthValue = self["length"], lengthValue.isNumber {
+                return try toArray()
+            }
         }
-
-        return try toDictionary()
+        return try MQJSValueReader(context: ctx).convert(jsValue) ?? NSNull()
     }
 
     // MARK: - Private Helpers
 
     /// Validates state and returns the context, or throws
-    private func checkedContext() throws -> MQJSContext {
+    internal func checkedContext() throws -> MQJSContext {
         guard isValid else { throw MQJSError.invalidValue }
         guard let ctx = context else { throw MQJSError.invalidContext }
         return ctx
@@ -514,56 +566,6 @@ public final class MQJSValue {
 
     /// Converts a single Swift value to MQJSValue
     private func convertToJSValue(_ value: Any, in ctx: MQJSContext) throws -> MQJSValue {
-        // Note: Order matters - Bool must be checked before NSNumber since Bool bridges to NSNumber
-        switch value {
-        case let jsValue as MQJSValue:
-            return jsValue
-
-        case is NSNull:
-            return MQJSValue(context: ctx, jsValue: mqjs_get_null())
-
-        case let boolValue as Bool:
-            return try boolValue.toJSValue(in: ctx)
-
-        case let intValue as Int:
-            return try intValue.toJSValue(in: ctx)
-
-        case let int32Value as Int32:
-            return try int32Value.toJSValue(in: ctx)
-
-        case let uint32Value as UInt32:
-            return try uint32Value.toJSValue(in: ctx)
-
-        case let doubleValue as Double:
-            return try doubleValue.toJSValue(in: ctx)
-
-        case let floatValue as Float:
-            return try floatValue.toJSValue(in: ctx)
-
-        case let stringValue as String:
-            return try stringValue.toJSValue(in: ctx)
-
-        case let arrayValue as [Any]:
-            let jsArray = JS_NewArray(ctx.ctx, Int32(arrayValue.count))
-            let arrayWrapper = MQJSValue(context: ctx, jsValue: jsArray)
-            for (index, element) in arrayValue.enumerated() {
-                arrayWrapper[index] = try convertToJSValue(element, in: ctx)
-            }
-            return arrayWrapper
-
-        case let dictValue as [String: Any]:
-            let jsObject = JS_NewObject(ctx.ctx)
-            let objectWrapper = MQJSValue(context: ctx, jsValue: jsObject)
-            for (key, element) in dictValue {
-                objectWrapper[key] = try convertToJSValue(element, in: ctx)
-            }
-            return objectWrapper
-
-        case let numberValue as NSNumber:
-            return try numberValue.doubleValue.toJSValue(in: ctx)
-
-        default:
-            throw MQJSError.typeConversionError("Cannot convert \(type(of: value)) to JavaScript value")
-        }
+        return try MQJSValueBuilder(context: ctx).makeValue(value)
     }
 }
@@ -0,0 +1,197 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Value Builder (Internal)
+
+/// Builds JavaScript values from Swift values with one engine call per container.
+///
+/// Values are built depth first on the JavaScript stack, which the GC scans: each
+/// element or property value is pushed as soon as it is created, and a container is
+/// made from its pushed values by `mqjs_new_array_from_values` or
+/// `mqjs_new_object_from_props`, which size the array or property table once and pop
+/// the values. No
+/// `MQJSValue` wrapper is created for the elements and keys are not set one by one.
+internal struct MQJSValueBuilder {
+    let context: MQJSContext
+
+    /// Builds a JavaScript value from a Swift value
+    func makeValue(_ value: Any) throws -> MQJSValue {
+        try push(value)
+        return MQJSValue(context: context, jsValue: JS_PopArg(context.ctx))
+    }
+
+    /// Builds a JavaScript value from an encoded tree
+    func makeValue(_ node: MQJSEncodedNode) throws -> MQJSValue {
+        try push(node)
+        return MQJSValue(context: context, jsValue: JS_PopArg(context.ctx))
+    }
+
+    // MARK: Swift Values
+
+    /// Pushes exactly one value on the JavaScript stack, or nothing when throwing
+    private func push(_ value: Any) throws {
+        let ctx = context.ctx
+        try reserveStack()
+
+        // Note: Order matters - Bool must be checked before NSNumber since Bool bridges to NSNumber
+        switch value {
+        case let jsValue as MQJSValue:
+            JS_PushArg(ctx, jsValue.jsValue)
+
+        case is NSNull:
+            JS_PushArg(ctx, mqjs_get_null())
+
+        case let boolValue as Bool:
+            JS_PushArg(ctx, boolValue ? mqjs_get_true() : mqjs_get_false())
+
+        case let intValue as Int:
+            try pushChecked(JS_NewInt64(ctx, Int64(intValue)))
+
+        case let int32Value as Int32:
+            JS_PushArg(ctx, JS_NewInt32(ctx, int32Value))
+
+        case let uint32Value as UInt32:
+            try pushChecked(JS_NewUint32(ctx, uint32Value))
+
+        case let doubleValue as Double:
+            try pushChecked(JS_NewFloat64(ctx, doubleValue))
+
+        case let floatValue as Float:
+            try pushChecked(JS_NewFloat64(ctx, Double(floatValue)))
+
+        case let stringValue as String:
+            try pushString(stringValue)
+
+        case let arrayValue as [Any]:
+            try pushElements(arrayValue) { try push($0) }
+            try pushChecked(mqjs_new_array_from_values(ctx, Int32(arrayValue.count)))
+
+        case let dictValue as [String: Any]:
+            var keys = MQJSKeyBuffer(capacity: dictValue.count)
+            try pushElements(dictValue) { key, element in
+                keys.append(key)
+                try push(element)
+            }
+            try pushChecked(keys.makeObject(in: ctx))
+
+        case let numberValue as NSNumber:
+            try pushChecked(JS_NewFloat64(ctx, numberValue.doubleValue))
+
+        case let convertible as MQJSConvertible:
+            JS_PushArg(ctx, try convertible.toJSValue(in: context).jsValue)
+
+        default:
+            throw MQJSError.typeConversionError("Cannot convert \(type(of: value)) to JavaScript value")
+        }
+    }
+
+    // MARK: Encoded Values
+
+    private func push(_ node: MQJSEncodedNode) throws {
+        let ctx = context.ctx
+        try reserveStack()
+
+        switch node {
+        case .null:
+            JS_PushArg(ctx, mqjs_get_null())
+        case .bool(let value):
+            JS_PushArg(ctx, value ? mqjs_get_true() : mqjs_get_false())
+        case .int(let value):
+            try pushChecked(JS_NewInt64(ctx, value))
+        case .double(let value):
+            try pushChecked(JS_NewFloat64(ctx, value))
+        case .string(let value):
+            try pushString(value)
+        case .value(let value):
+            JS_PushArg(ctx, value.jsValue)
+        case .array(let storage):
+            let elements = storage.elements
+            try pushElements(elements) { try push($0) }
+            try pushChecked(mqjs_new_array_from_values(ctx, Int32(elements.count)))
+        case .object(let storage):
+            var keys = MQJSKeyBuffer(capacity: storage.keys.count)
+            try pushElements(zip(storage.keys, storage.values)) { key, element in
+                keys.append(key)
+                try push(element)
+            }
+            try pushChecked(keys.makeObject(in: ctx))
+        }
+    }
+
+    // MARK: Stack
+
+    /// Ensures there is room for one more value on the stack
+    private func reserveStack() throws {
+        if JS_StackCheck(context.ctx, 1) != 0 {
+            throw try context.extractError()
+        }
+    }
+
+    /// Pushes a newly created value, throwing if its creation failed
+    private func pushChecked(_ value: JSValue) throws {
+        if JS_IsException(value) != 0 {
+            throw try context.extractError()
+        }
+        JS_PushArg(context.ctx, value)
+    }
+
+    private func pushString(_ string: String) throws {
+        var string = string
+        let value = string.withUTF8 { bytes in
+            bytes.withMemoryRebound(to: CChar.self) { chars in
+                JS_NewStringLen(context.ctx, chars.baseAddress, chars.count)
+            }
+        }
+        try pushChecked(value)
+    }
+
+    /// Pushes the elements of a container with `pushElement`, one value each. The
+    /// values already pushed are dropped on failure.
+    private func pushElements<Elements: Sequence>(
+        _ elements: Elements,
+        _ pushElement: (Elements.Element) throws -> Void
+    ) throws {
+        var pushed: Int32 = 0
+        do {
+            for element in elements {
+                try pushElement(element)
+                pushed += 1
+            }
+        } catch {
+            JS_DropArgs(context.ctx, pushed)
+            throw error
+        }
+    }
+}
+
+// MARK: - Key Buffer
+
+/// Property keys stored back to back, as expected by `mqjs_new_object_from_props`
+internal struct MQJSKeyBuffer {
+    private var bytes: [CChar] = []
+    private var lengths: [UInt32] = []
+
+    init(capacity: Int) {
+        lengths.reserveCapacity(capacity)
+        bytes.reserveCapacity(capacity * 8)
+    }
+
+    mutating func append(_ key: String) {
+        var key = key
+        key.withUTF8 { utf8 in
+            utf8.withMemoryRebound(to: CChar.self) { chars in
+                bytes.append(contentsOf: chars)
+            }
+            lengths.append(UInt32(utf8.count))
+        }
+    }
+
+    /// Creates the object from the values pushed for the keys
+    func makeObject(in ctx: OpaquePointer) -> JSValue {
+        return bytes.withUnsafeBufferPointer { keys in
+            lengths.withUnsafeBufferPointer { lens in
+                mqjs_new_object_from_props(ctx, keys.baseAddress, lens.baseAddress, Int32(lens.count))
+            }
+        }
+    }
+}
@@ -0,0 +1,220 @@
+import Foundation
+import CMQuickJS
+
+// MARK: - Value Reader (Internal)
+
+/// Converts JavaScript values to Swift collections in a single pass over the heap.
+///
+/// The reader walks arrays element by element and objects through the engine's own
+/// property list, so no intermediate JSON string or `MQJSValue` wrapper is created.
+/// The result follows JSON semantics, which keeps it valid for `JSONSerialization`:
+/// - `undefined` and functions are omitted from objects and become `NSNull` in arrays
+/// - `NaN` and infinities become `NSNull`
+/// - whole numbers become `Int`, other numbers `Double`
+/// - arrays and typed arrays become `[Any]`, other objects `[String: Any]`
+/// - cyclic structures throw `MQJSError.typeConversionError`
+///
+/// Containers being converted are rooted in a stack of GC references, one per nesting
+/// level, and re-read after every step that may allocate (getters, typed array reads),
+/// since the moving GC can relocate them.
+internal final class MQJSValueReader {
+    /// Maximum nesting depth before conversion fails
+    static let maxDepth = 256
+
+    private let context: MQJSContext
+
+    /// GC references rooting the containers on the current path, reused between siblings
+    private var roots: [UnsafeMutablePointer<JSGCRef>] = []
+
+    /// Number of roots in use
+    private var depth = 0
+
+    init(context: MQJSContext) {
+        self.context = context
+    }
+
+    deinit {
+        for root in roots {
+            root.deallocate()
+        }
+    }
+
+    // MARK: Entry Points
+
+    /// Converts an object to a dictionary (array elements use their index as key)
+    func dictionary(from value: JSValue) throws -> [String: Any] {
+        return try withRoot(value) { root in
+            try readDictionary(root)
+        }
+    }
+
+    /// Converts an array-like object to an array
+    func array(from value: JSValue) throws -> [Any] {
+        return try withRoot(value) { root in
+            try readArray(root)
+        }
+    }
+
+    /// Converts any value; nil for values JSON cannot represent (undefined, functions)
+    func convert(_ value: JSValue) throws -> Any? {
+        let ctx = context.ctx
+
+        if JS_IsInt(value) != 0 {
+            var result: Int32 = 0
+            _ = JS_ToInt32(ctx, &result, value)
+            return Int(result)
+        }
+        if JS_IsNull(value) != 0 {
+            return NSNull()
+        }
+        if JS_IsUndefined(value) != 0 {
+            return nil
+        }
+        if JS_IsBool(value) != 0 {
+            return value == mqjs_get_true()
+        }
+        if JS_IsNumber(ctx, value) != 0 {
+            var d: Double = 0
+            _ = JS_ToNumber(ctx, &d, value)
+            return MQJSValueReader.number(d)
+        }
+        if JS_IsString(ctx, value) != 0 {
+            return MQJSValueReader.string(value, in: ctx)
+        }
+        if JS_IsFunction(ctx, value) != 0 || JS_GetClassID(ctx, value) < 0 {
+            return nil
+        }
+
+        return try withRoot(value) { root in
+            if JS_GetArrayLength(ctx, root.pointee.val) >= 0 {
+                return try readArray(root)
+            }
+            return try readDictionary(root)
+        }
+    }
+
+    // MARK: Containers
+
+    /// Reads the elements of the rooted array-like object
+    private func readArray(_ root: UnsafeMutablePointer<JSGCRef>) throws -> [Any] {
+        let ctx = context.ctx
+        var length = Int(JS_GetArrayLength(ctx, root.pointee.val))
+        if length < 0 {
+            // Array-like object: use its length property
+            let lengthValue = JS_GetPropertyStr(ctx, root.pointee.val, "length")
+            var result: Int32 = 0
+            guard JS_IsException(lengthValue) == 0, JS_IsNumber(ctx, lengthValue) != 0,
+                  JS_ToInt32(ctx, &result, lengthValue) == 0, result >= 0 else {
+                throw MQJSError.typeConversionError("Cannot get array length")
+            }
+            length = Int(result)
+        }
+
+        var result: [Any] = []
+        result.reserveCapacity(length)
+        for index in 0..<length {
+            let element = JS_GetPropertyUint32(ctx, root.pointee.val, UInt32(index))
+            if JS_IsException(element) != 0 {
+                throw try context.extractError()
+            }
+            result.append(try convert(element) ?? NSNull())
+        }
+        return result
+    }
+
+    /// Reads the elements and own properties of the rooted object
+    private func readDictionary(_ root: UnsafeMutablePointer<JSGCRef>) throws -> [String: Any] {
+        let ctx = context.ctx
+        var result: [String: Any] = [:]
+
+        let length = Int(JS_GetArrayLength(ctx, root.pointee.val))
+        if length > 0 {
+            for index in 0..<length {
+                let element = JS_GetPropertyUint32(ctx, root.pointee.val, UInt32(index))
+                if JS_IsException(element) != 0 {
+                    throw try context.extractError()
+                }
+                if let converted = try convert(element) {
+                    result[String(index)] = converted
+                }
+            }
+        }
+
+        var position: Int32 = 0
+        var key: JSValue = 0
+        var value: JSValue = 0
+        while true {
+            let status = JS_GetOwnPropertyNext(ctx, root.pointee.val, &position, &key, &value)
+            if status == 0 {
+                break
+            }
+            if status < 0 {
+                throw try context.extractError()
+            }
+            // Read the key before converting the value, which may move it
+            let name = MQJSValueReader.propertyName(key, in: ctx)
+            if let converted = try convert(value) {
+                result[name] = converted
+            }
+        }
+        return result
+    }
+
+    // MARK: Leaves
+
+    /// Copies a string value (does not allocate in the JS heap)
+    static func string(_ value: JSValue, in ctx: OpaquePointer) -> String {
+        var buf = JSCStringBuf()
+        var length: Int = 0
+        guard let cString = JS_ToCStringLen(ctx, &length, value, &buf) else {
+            return ""
+        }
+        let bytes = UnsafeRawBufferPointer(start: cString, count: length)
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    /// Converts a property key (string or integer) to a Swift string
+    static func propertyName(_ key: JSValue, in ctx: OpaquePointer) -> String {
+        if JS_IsInt(key) != 0 {
+            var index: Int32 = 0
+            _ = JS_ToInt32(ctx, &index, key)
+            return String(index)
+        }
+        return string(key, in: ctx)
+    }
+
+    /// Swift representation of a JavaScript number
+    static func number(_ d: Double) -> Any {
+        guard d.isFinite else { return NSNull() }
+        if d.rounded(.towardZero) == d && d >= -9.007_199_254_740_992e15 && d <= 9.007_199_254_740_992e15 {
+            return Int(d)
+        }
+        return d
+    }
+
+    // MARK: Rooting
+
+    /// Roots a container for the duration of `body`, failing on cycles and deep nesting
+    private func withRoot<T>(_ value: JSValue, _ body: (UnsafeMutablePointer<JSGCRef>) throws -> T) throws -> T {
+        for index in 0..<depth where roots[index].pointee.val == value {
+            throw MQJSError.typeConversionError("Cyclic object value")
+        }
+        guard depth < MQJSValueReader.maxDepth else {
+            throw MQJSError.typeConversionError("Object nesting too deep")
+        }
+        if depth == roots.count {
+            let root = UnsafeMutablePointer<JSGCRef>.allocate(capacity: 1)
+            root.initialize(to: JSGCRef(val: 0, prev: nil))
+            roots.append(root)
+        }
+
+        let root = roots[depth]
+        JS_PushGCRef(context.ctx, root)!.pointee = value
+        depth += 1
+        defer {
+            depth -= 1
+            _ = JS_PopGCRef(context.ctx, root)
+        }
+        return try body(root)
+    }
+}
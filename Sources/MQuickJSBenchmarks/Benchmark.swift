@@ -0,0 +1,146 @@
+import Dispatch
+import Foundation
+
+// MARK: - Benchmarks
+
+/// A named measurement.
+///
+/// Timed benchmarks run `operation` `iterations` times per sample and report the time
+/// per operation, where one call of `operation` may do `batch` operations (for example
+/// a script loop calling a native function `batch` times). Recorded benchmarks produce
+/// their own samples, for example one GC pause per sample.
+struct Benchmark {
+    enum Body {
+        /// Returns the operation to time; the setup itself is not measured
+        case timed(iterations: Int, batch: Int, setUp: () throws -> () throws -> Void)
+        /// Returns the samples (in nanoseconds) and extra counters
+        case recorded(run: (_ scale: Double) throws -> (samples: [Double], counters: [String: Double]))
+    }
+
+    let name: String
+    let body: Body
+
+    /// Number of measured samples of a timed benchmark
+    var samples = 20
+
+    /// Time `operation`, run `iterations` times per sample.
+    static func timed(
+        _ name: String,
+        iterations: Int,
+        batch: Int = 1,
+        samples: Int = 20,
+        setUp: @escaping () throws -> () throws -> Void
+    ) -> Benchmark {
+        var benchmark = Benchmark(name: name, body: .timed(iterations: iterations, batch: batch, setUp: setUp))
+        benchmark.samples = samples
+        return benchmark
+    }
+
+    /// Report the samples measured by `run`, which should do `scale` times its
+    /// default amount of work.
+    static func recorded(
+        _ name: String,
+        run: @escaping (_ scale: Double) throws -> (samples: [Double], counters: [String: Double])
+    ) -> Benchmark {
+        return Benchmark(name: name, body: .recorded(run: run))
+    }
+}
+
+// MARK: - Results
+
+/// Summary of the samples of one benchmark, in nanoseconds
+struct BenchmarkResult: Codable {
+    let name: String
+    /// "ns/op" for timed benchmarks, "ns" for recorded samples
+    let unit: String
+    /// Operations per sample (1 for recorded benchmarks)
+    let iterations: Int
+    let samples: Int
+    let min: Double
+    let median: Double
+    let mean: Double
+    let p90: Double
+    let p99: Double
+    let max: Double
+    let stddev: Double
+    let counters: [String: Double]
+
+    init(name: String, unit: String, iterations: Int, samples values: [Double], counters: [String: Double] = [:]) {
+        let sorted = values.sorted()
+        let mean = sorted.isEmpty ? 0 : sorted.reduce(0, +) / Double(sorted.count)
+        let variance = sorted.isEmpty ? 0 : sorted.reduce(0) { $0 + ($1 - mean) * ($1 - mean) } / Double(sorted.count)
+
+        func percentile(_ p: Double) -> Double {
+            guard !sorted.isEmpty else { return 0 }
+            let index = Int((p * Double(sorted.count - 1)).rounded())
+            return sorted[index]
+        }
+
+        self.name = name
+        self.unit = unit
+        self.iterations = iterations
+        self.samples = sorted.count
+        self.min = sorted.first ?? 0
+        self.median = percentile(0.5)
+        self.mean = mean
+        self.p90 = percentile(0.9)
+        self.p99 = percentile(0.99)
+        self.max = sorted.last ?? 0
+        self.stddev = variance.squareRoot()
+        self.counters = counters
+    }
+}
+
+/// A complete run, as written with `--format json`
+struct BenchmarkReport: Codable {
+    /// Version of this format
+    let schema: Int
+    let date: String
+    let platform: String
+    let configuration: String
+    let scale: Double
+    let results: [BenchmarkResult]
+}
+
+// MARK: - Runner
+
+struct BenchmarkRunner {
+    /// Multiplies the number of samples and the amount of recorded work
+    var scale = 1.0
+    /// Unmeasured samples run before a timed benchmark
+    var warmupSamples = 3
+
+    func run(_ benchmark: Benchmark) throws -> BenchmarkResult {
+        switch benchmark.body {
+        case .timed(let iterations, let batch, let setUp):
+            let operation = try setUp()
+            let sampleCount = Swift.max(3, Int(Double(benchmark.samples) * scale))
+            var samples: [Double] = []
+            samples.reserveCapacity(sampleCount)
+
+            for index in 0..<(warmupSamples + sampleCount) {
+                let start = DispatchTime.now().uptimeNanoseconds
+                for _ in 0..<iterations {
+                    try operation()
+                }
+                let elapsed = DispatchTime.now().uptimeNanoseconds - start
+                if index >= warmupSamples {
+                    samples.append(Double(elapsed) / Double(iterations * batch))
+                }
+            }
+            return BenchmarkResult(name: benchmark.name, unit: "ns/op", iterations: iterations * batch,
+                                   samples: samples)
+
+        case .recorded(let run):
+            let (samples, counters) = try run(scale)
+            return BenchmarkResult(name: benchmark.name, unit: "ns", iterations: 1, samples: samples, counters: counters)
+        }
+    }
+}
+
+/// Measures the time of `body` in nanoseconds
+func measureNanoseconds(_ body: () throws -> Void) rethrows -> Double {
+    let start = DispatchTime.now().uptimeNanoseconds
+    try body()
+    return Double(DispatchTime.now().uptimeNanoseconds - start)
+}
@@ -0,0 +1,90 @@
+import Foundation
+import MQuickJS
+
+/// Returns an operation running a script loop that calls the native function `add`
+/// `calls` times, after `install` has registered it
+private func nativeCallLoop(calls: Int, install: (MQJSContext) throws -> Void) throws -> () throws -> Void {
+    let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+    try install(context)
+    return try workload("""
+        function run() {
+            var total = 0;
+            for (var i = 0; i < \(calls); i++) total = add(total, i) & 0xffff;
+            return total;
+        }
+        """, calling: "run", in: context)
+}
+
+/// Calls across the Swift/JavaScript boundary and property access from Swift
+let bridgeBenchmarks: [Benchmark] = [
+    // MARK: Native calls from JavaScript
+
+    .timed("bridge.native.call", iterations: 10, batch: 1000) {
+        return try nativeCallLoop(calls: 1000) { context in
+            try context.setFunction("add") { args in
+                return Int(try args[0].toInt32()) + Int(try args[1].toInt32())
+            }
+        }
+    },
+    .timed("bridge.native.fastCall", iterations: 10, batch: 1000) {
+        return try nativeCallLoop(calls: 1000) { context in
+            try context.setFastFunction("add") { args in
+                return .int32(try args.int32(at: 0) &+ args.int32(at: 1))
+            }
+        }
+    },
+
+    // MARK: JavaScript calls from Swift
+
+    .timed("bridge.call.fromSwift", iterations: 1000) {
+        let context = try MQJSContext()
+        let add = try context.eval("(function (a, b) { return a + b; })")
+        return {
+            _ = try withExtendedLifetime(context) { try add.call(withArguments: [1, 2]) }
+        }
+    },
+    .timed("bridge.callBatch", iterations: 10, batch: 1000) {
+        let context = try MQJSContext()
+        let add = try context.eval("(function (a, b) { return a + b; })")
+        let xs = (0..<1000).map(Double.init)
+        let columns: [MQJSBatchColumn] = [.doubles(xs), .doubles(xs)]
+        return {
+            _ = try withExtendedLifetime(context) { try add.callBatch(columns) }
+        }
+    },
+
+    // MARK: Property access from Swift
+
+    .timed("property.get", iterations: 10_000) {
+        let context = try MQJSContext()
+        let object = try context.eval("({ id: 1, name: 'item', score: 2.5 })")
+        return {
+            _ = withExtendedLifetime(context) { object["score"] }
+        }
+    },
+    .timed("property.set", iterations: 10_000) {
+        let context = try MQJSContext()
+        let object = try context.eval("({ id: 1, name: 'item', score: 2.5 })")
+        let value = try 42.toJSValue(in: context)
+        return {
+            withExtendedLifetime(context) { object["score"] = value }
+        }
+    },
+    .timed("property.get.key", iterations: 10_000) {
+        let context = try MQJSContext()
+        let object = try context.eval("({ id: 1, name: 'item', score: 2.5 })")
+        let key = try context.propertyKey("score")
+        return {
+            _ = withExtendedLifetime(context) { object[key] }
+        }
+    },
+    .timed("property.set.key", iterations: 10_000) {
+        let context = try MQJSContext()
+        let object = try context.eval("({ id: 1, name: 'item', score: 2.5 })")
+        let key = try context.propertyKey("score")
+        let value = try 42.toJSValue(in: context)
+        return {
+            withExtendedLifetime(context) { object[key] = value }
+        }
+    },
+]
@@ -0,0 +1,87 @@
+import Foundation
+import MQuickJS
+
+/// The record type of the Codable benchmarks
+private struct Record: Codable {
+    let id: Int
+    let name: String
+    let score: Double
+    let tags: [String]
+    let active: Bool
+}
+
+private let recordScript = """
+    var records = [];
+    for (var i = 0; i < 1000; i++)
+        records.push({ id: i, name: 'user' + i, score: i * 0.25, tags: ['a', 'b'], active: i % 2 == 0 });
+    records;
+    """
+
+/// Converting large values between JavaScript and Swift
+let conversionBenchmarks: [Benchmark] = [
+    // MARK: JavaScript to Swift
+
+    .timed("convert.toArray.numbers", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let array = try context.eval("var a = []; for (var i = 0; i < 10000; i++) a.push(i * 0.5); a")
+        return {
+            _ = try withExtendedLifetime(context) { try array.toArray() }
+        }
+    },
+    .timed("convert.toArray.objects", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let records = try context.eval(recordScript)
+        return {
+            _ = try withExtendedLifetime(context) { try records.toArray() }
+        }
+    },
+    .timed("convert.toDictionary.flat", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let object = try context.eval("var o = {}; for (var i = 0; i < 1000; i++) o['key' + i] = i; o")
+        return {
+            _ = try withExtendedLifetime(context) { try object.toDictionary() }
+        }
+    },
+    .timed("convert.toDictionary.nested", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let object = try context.eval("""
+            var o = {};
+            for (var i = 0; i < 200; i++)
+                o['user' + i] = { id: i, profile: { name: 'user' + i, langs: ['js', 'swift'] }, score: i / 3 };
+            o
+            """)
+        return {
+            _ = try withExtendedLifetime(context) { try object.toDictionary() }
+        }
+    },
+    .timed("convert.decode", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let records = try context.eval(recordScript)
+        return {
+            _ = try withExtendedLifetime(context) { try records.decode([Record].self) }
+        }
+    },
+
+    // MARK: Swift to JavaScript
+
+    .timed("convert.toJSValue.numbers", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let numbers = Array(0..<10_000)
+        return { _ = try numbers.toJSValue(in: context) }
+    },
+    .timed("convert.encode", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let records = (0..<1000).map {
+            Record(id: $0, name: "user\($0)", score: Double($0) * 0.25, tags: ["a", "b"], active: $0 % 2 == 0)
+        }
+        return { _ = try context.encode(records) }
+    },
+    .timed("convert.parseJSON", iterations: 10) {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let records = (0..<1000).map {
+            Record(id: $0, name: "user\($0)", score: Double($0) * 0.25, tags: ["a", "b"], active: $0 % 2 == 0)
+        }
+        let data = try JSONEncoder().encode(records)
+        return { _ = try context.parseJSON(data: data) }
+    },
+]
@@ -0,0 +1,173 @@
+import Foundation
+import MQuickJS
+
+/// A script with enough functions and literals for parsing to matter
+let startupScript: String = {
+    var source = "var handlers = {};\n"
+    for index in 0..<40 {
+        source += """
+            function rule\(index)(input) {
+                var total = 0, names = ['a\(index)', 'b\(index)', 'c\(index)'];
+                for (var i = 0; i < input.length; i++) {
+                    if (input[i] % \(index + 2) == 0) total += input[i] * \(index);
+                    else total -= names[i % 3].length;
+                }
+                return { rule: \(index), total: total, label: 'rule-' + \(index) };
+            }
+            handlers['rule\(index)'] = rule\(index);
+
+            """
+    }
+    source += "Object.keys(handlers).length;\n"
+    return source
+}()
+
+/// Evaluates `setUpScript` in a new context and returns an operation calling its
+/// function `name` without arguments
+func workload(_ setUpScript: String, calling name: String,
+              memorySize: Int = MQJSContext.memoryForDevelopment) throws -> () throws -> Void {
+    return try workload(setUpScript, calling: name, in: MQJSContext(memorySize: memorySize))
+}
+
+/// Evaluates `setUpScript` in `context` and returns an operation calling its function
+/// `name` without arguments
+func workload(_ setUpScript: String, calling name: String,
+              in context: MQJSContext) throws -> () throws -> Void {
+    try context.eval(setUpScript)
+    guard let function = context.globalObject[name], function.isFunction else {
+        throw MQJSError.evaluationError("\(name) is not a function")
+    }
+    return {
+        // Values do not keep their context alive
+        _ = try withExtendedLifetime(context) { try function.call(withArguments: nil) }
+    }
+}
+
+/// Context creation, script loading and interpreter workloads
+let engineBenchmarks: [Benchmark] = [
+    // MARK: Context creation
+
+    .timed("context.create.64KB", iterations: 100) {
+        return { _ = try MQJSContext(memorySize: MQJSContext.memoryForSimpleScripts) }
+    },
+    .timed("context.create.1MB", iterations: 100) {
+        return { _ = try MQJSContext(memorySize: MQJSContext.memoryForComplexScripts) }
+    },
+    .timed("context.pool.checkout", iterations: 100) {
+        let pool = try MQJSContextPool(count: 1, memorySize: MQJSContext.memoryForComplexScripts) { context in
+            _ = try context.eval(startupScript)
+        }
+        return {
+            try pool.withContext { context in
+                _ = try context.eval("handlers.rule1([1, 2, 3]).total")
+            }
+        }
+    },
+
+    // MARK: Loading a script into a new context
+
+    .timed("load.eval", iterations: 20) {
+        return {
+            let context = try MQJSContext()
+            try context.eval(startupScript)
+        }
+    },
+    .timed("load.parseAndRun", iterations: 20) {
+        return {
+            let context = try MQJSContext()
+            try context.run(context.parse(startupScript))
+        }
+    },
+    .timed("load.bytecode", iterations: 20) {
+        let bytecode = try MQJSContext.compileBytecode(startupScript)
+        return {
+            let context = try MQJSContext()
+            try context.run(context.loadBytecode(bytecode))
+        }
+    },
+    .timed("load.sharedBytecode", iterations: 20) {
+        let shared = try MQJSSharedBytecode(MQJSContext.compileBytecode(startupScript))
+        return {
+            let context = try MQJSContext()
+            try context.run(context.loadBytecode(shared))
+        }
+    },
+    .timed("eval.expression", iterations: 1000) {
+        let context = try MQJSContext()
+        return { _ = try context.eval("1 + 2") }
+    },
+
+    // MARK: Interpreter workloads
+
+    .timed("string.concat", iterations: 10) {
+        return try workload("""
+            function build() {
+                var s = '';
+                for (var i = 0; i < 10000; i++) s += 'item ' + i + ';';
+                return s.length;
+            }
+            """, calling: "build")
+    },
+    .timed("string.join", iterations: 10) {
+        return try workload("""
+            function build() {
+                var parts = [];
+                for (var i = 0; i < 10000; i++) parts.push('item ' + i);
+                return parts.join(';').length;
+            }
+            """, calling: "build")
+    },
+    .timed("json.parse", iterations: 10) {
+        return try workload("""
+            var items = [];
+            for (var i = 0; i < 1000; i++)
+                items.push({ id: i, name: 'user' + i, score: i * 0.25, tags: ['a', 'b'], active: i % 2 == 0 });
+            var payload = JSON.stringify(items);
+            function parse() { return JSON.parse(payload).length; }
+            """, calling: "parse")
+    },
+    .timed("json.stringify", iterations: 10) {
+        return try workload("""
+            var items = [];
+            for (var i = 0; i < 1000; i++)
+                items.push({ id: i, name: 'user' + i, score: i * 0.25, tags: ['a', 'b'], active: i % 2 == 0 });
+            function stringify() { return JSON.stringify(items).length; }
+            """, calling: "stringify")
+    },
+    .timed("sort.numbers.comparator", iterations: 10) {
+        return try workload("""
+            var seed = 1;
+            var data = [];
+            for (var i = 0; i < 10000; i++) { seed = (seed * 16807) % 2147483647; data.push(seed % 100000); }
+            function sort() { return data.slice().sort(function (a, b) { return a - b; })[0]; }
+            """, calling: "sort")
+    },
+    .timed("sort.strings", iterations: 10) {
+        return try workload("""
+            var data = [];
+            for (var i = 0; i < 5000; i++) data.push('key' + ((i * 7919) % 5000));
+            function sort() { return data.slice().sort()[0]; }
+            """, calling: "sort")
+    },
+    .timed("regexp.exec", iterations: 10) {
+        return try workload("""
+            var lines = [];
+            for (var i = 0; i < 500; i++)
+                lines.push(i % 10 == 0 ? 'ERROR: disk' + i + ' full at ' + i : 'INFO: request ' + i + ' ok in ' + (i % 50) + 'ms');
+            var log = lines.join('\\n');
+            function scan() {
+                var re = /ERROR: (\\w+)/g, m, n = 0;
+                while ((m = re.exec(log)) != null) n++;
+                return n;
+            }
+            """, calling: "scan")
+    },
+    .timed("regexp.replace", iterations: 10) {
+        return try workload("""
+            var text = [];
+            for (var i = 0; i < 500; i++) text.push('user-' + i + '@example.com');
+            text = text.join(', ');
+            function replace() { return text.replace(/(\\w+)-(\\d+)@/g, '$2.$1@').length; }
+            """, calling: "replace")
+    },
+]
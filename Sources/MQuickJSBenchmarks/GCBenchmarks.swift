@@ -0,0 +1,91 @@
+import Foundation
+import MQuickJS
+
+/// A live set that can be grown and a function producing short-lived garbage
+private let gcScript = """
+    var live = [];
+    function grow(n) {
+        for (var i = 0; i < n; i++) live.push({ id: live.length, name: 'live' + live.length });
+    }
+    function churn() {
+        var t = 0;
+        for (var i = 0; i < 200; i++) { var o = { id: i, tags: [i, i + 1], name: 'tmp' + i }; t += o.tags.length; }
+        return t;
+    }
+    """
+
+/// Creates a context whose live set fills a fifth of its memory and returns it with
+/// its `churn` function
+private func gcContext(memorySize: Int, configure: (MQJSContext) -> Void = { _ in })
+    throws -> (context: MQJSContext, churn: MQJSValue) {
+    let context = try MQJSContext(memorySize: memorySize)
+    configure(context)
+    try context.eval(gcScript)
+    guard let grow = context.globalObject["grow"], let churn = context.globalObject["churn"] else {
+        throw MQJSError.evaluationError("GC script did not define grow and churn")
+    }
+    while true {
+        context.collectGarbage()
+        if context.memoryStats.liveSizeAfterLastGC >= memorySize / 5 {
+            break
+        }
+        _ = try grow.call(withArguments: [100])
+    }
+    return (context, churn)
+}
+
+/// Records the automatic GC pauses while garbage is produced. Each sample is one
+/// pause (the average pause if a step triggered several collections).
+private func gcPauses(memorySize: Int, configure: @escaping (MQJSContext) -> Void = { _ in })
+    -> (_ scale: Double) throws -> (samples: [Double], counters: [String: Double]) {
+    return { scale in
+        let (context, churn) = try gcContext(memorySize: memorySize, configure: configure)
+        let sampleCount = max(10, Int(100 * scale))
+        var samples: [Double] = []
+        samples.reserveCapacity(sampleCount)
+
+        var last = context.memoryStats
+        var steps = 0
+        while samples.count < sampleCount && steps < 1_000_000 {
+            try withExtendedLifetime(context) { _ = try churn.call(withArguments: nil) }
+            steps += 1
+            let stats = context.memoryStats
+            if stats.gcCount != last.gcCount {
+                let pause = (stats.gcTime - last.gcTime) / Double(stats.gcCount - last.gcCount)
+                samples.append(pause * 1_000_000_000)
+                last = stats
+            }
+        }
+
+        return (samples, [
+            "memorySize": Double(memorySize),
+            "liveSize": Double(last.liveSizeAfterLastGC),
+            "compactions": Double(last.compactionCount),
+            "stepsPerGC": Double(steps) / Double(max(samples.count, 1)),
+        ])
+    }
+}
+
+private let gcMemorySizes: [(label: String, size: Int)] = [
+    ("64KB", MQJSContext.memoryForSimpleScripts),
+    ("256KB", MQJSContext.memoryForModerateScripts),
+    ("1MB", MQJSContext.memoryForComplexScripts),
+    ("4MB", MQJSContext.memoryForDevelopment),
+]
+
+/// GC pause distribution and full collections at several memory sizes
+let gcBenchmarks: [Benchmark] =
+    gcMemorySizes.map { entry -> Benchmark in
+        .recorded("gc.pause.\(entry.label)", run: gcPauses(memorySize: entry.size))
+    } + [
+        // Early collections with in-place reuse, for comparison with gc.pause.4MB
+        .recorded("gc.pause.4MB.budget64KB", run: gcPauses(memorySize: MQJSContext.memoryForDevelopment) { context in
+            context.gcAllocationBudget = 64 * 1024
+            context.gcCompactionThreshold = 50
+        }),
+    ] + gcMemorySizes.map { entry -> Benchmark in
+        .timed("gc.collect.\(entry.label)", iterations: 10) {
+            let (context, _) = try gcContext(memorySize: entry.size)
+            return { context.collectGarbage() }
+        }
+    }
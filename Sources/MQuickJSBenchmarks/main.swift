@@ -0,0 +1,221 @@
+import Foundation
+import MQuickJS
+
+// Benchmarks for the engine, the Swift bridge and value conversion.
+//
+//   swift run -c release MQuickJSBenchmarks [options]
+//
+//   --filter <text>   Only run the benchmarks whose name contains <text>
+//   --format <fmt>    text (default), json or csv
+//   --output <path>   Write the report to <path> instead of stdout
+//   --quick           Take a quarter of the samples
+//   --scale <n>       Multiply the number of samples by <n>
+//   --list            Print the benchmark names and exit
+
+let allBenchmarks = engineBenchmarks + bridgeBenchmarks + conversionBenchmarks + gcBenchmarks
+
+enum OutputFormat: String {
+    case text, json, csv
+}
+
+struct Options {
+    var filters: [String] = []
+    var format = OutputFormat.text
+    var output: String?
+    var scale = 1.0
+    var list = false
+
+    init(arguments: [String]) throws {
+        var iterator = arguments.makeIterator()
+
+        func value(for option: String) throws -> String {
+            guard let value = iterator.next() else {
+                throw UsageError("\(option) needs a value")
+            }
+            return value
+        }
+
+        while let argument = iterator.next() {
+            switch argument {
+            case "--filter":
+                filters.append(try value(for: argument))
+            case "--format":
+                let name = try value(for: argument)
+                guard let format = OutputFormat(rawValue: name) else {
+                    throw UsageError("Unknown format '\(name)' (expected text, json or csv)")
+                }
+                self.format = format
+            case "--output":
+                output = try value(for: argument)
+            case "--quick":
+                scale = 0.25
+            case "--scale":
+                let text = try value(for: argument)
+                guard let scale = Double(text), scale > 0 else {
+                    throw UsageError("Invalid scale '\(text)'")
+                }
+                self.scale = scale
+            case "--list":
+                list = true
+            default:
+                throw UsageError("Unknown option '\(argument)'")
+            }
+        }
+    }
+}
+
+struct UsageError: Error, CustomStringConvertible {
+    let description: String
+
+    init(_ description: String) {
+        self.description = description
+    }
+}
+
+var platform: String {
+    #if os(macOS)
+    let system = "macOS"
+    #elseif os(iOS)
+    let system = "iOS"
+    #elseif os(Linux)
+    let system = "Linux"
+    #else
+    let system = "unknown"
+    #endif
+
+    #if arch(arm64)
+    let architecture = "arm64"
+    #elseif arch(x86_64)
+    let architecture = "x86_64"
+    #else
+    let architecture = "unknown"
+    #endif
+
+    let version = ProcessInfo.processInfo.operatingSystemVersion
+    return "\(system) \(version.majorVersion).\(version.minorVersion).\(version.patchVersion) \(architecture)"
+}
+
+var configuration: String {
+    #if DEBUG
+    return "debug"
+    #else
+    return "release"
+    #endif
+}
+
+// MARK: - Formatting
+
+func formatted(_ nanoseconds: Double) -> String {
+    switch nanoseconds {
+    case ..<1_000:
+        return String(format: "%.1f ns", nanoseconds)
+    case ..<1_000_000:
+        return String(format: "%.2f µs", nanoseconds / 1_000)
+    case ..<1_000_000_000:
+        return String(format: "%.2f ms", nanoseconds / 1_000_000)
+    default:
+        return String(format: "%.2f s", nanoseconds / 1_000_000_000)
+    }
+}
+
+func textHeader(scale: Double) -> String {
+    let columns = ["median", "min", "p90", "p99"].map { $0.leftPadded(to: 11) }
+    return "\(platform), \(configuration), scale \(scale)\n"
+        + (["name".padding(toLength: 32, withPad: " ", startingAt: 0) + "unit  "] + columns).joined(separator: " ")
+}
+
+func textLine(_ result: BenchmarkResult) -> String {
+    let name = result.name.padding(toLength: 32, withPad: " ", startingAt: 0)
+    let columns = [result.median, result.min, result.p90, result.p99].map {
+        formatted($0).leftPadded(to: 11)
+    }
+    let counters = result.counters.keys.sorted().map { key -> String in
+        let value = result.counters[key]!
+        return value == value.rounded() ? "\(key)=\(Int(value))" : "\(key)=" + String(format: "%.2f", value)
+    }
+    return ([name + result.unit.padding(toLength: 6, withPad: " ", startingAt: 0)] + columns + counters)
+        .joined(separator: " ")
+}
+
+extension String {
+    func leftPadded(to length: Int) -> String {
+        return count >= length ? self : String(repeating: " ", count: length - count) + self
+    }
+}
+
+func csv(_ report: BenchmarkReport) -> String {
+    var lines = ["name,unit,iterations,samples,min,median,mean,p90,p99,max,stddev"]
+    for result in report.results {
+        let values = [result.min, result.median, result.mean, result.p90, result.p99, result.max, result.stddev]
+        lines.append(([result.name, result.unit, "\(result.iterations)", "\(result.samples)"]
+            + values.map { String(format: "%.1f", $0) }).joined(separator: ","))
+    }
+    return lines.joined(separator: "\n") + "\n"
+}
+
+// MARK: - Main
+
+func runBenchmarks() throws {
+    let options = try Options(arguments: Array(CommandLine.arguments.dropFirst()))
+    let selected = allBenchmarks.filter { benchmark in
+        options.filters.isEmpty || options.filters.contains { benchmark.name.contains($0) }
+    }
+
+    if options.list {
+        selected.forEach { print($0.name) }
+        return
+    }
+
+    let runner = BenchmarkRunner(scale: options.scale)
+    var results: [BenchmarkResult] = []
+
+    if options.format == .text && options.output == nil {
+        print(textHeader(scale: options.scale))
+    }
+    for benchmark in selected {
+        let result = try runner.run(benchmark)
+        results.append(result)
+        if options.format == .text && options.output == nil {
+            print(textLine(result))
+        } else {
+            // Progress goes to stderr so stdout stays machine-readable
+            FileHandle.standardError.write("\(result.name): \(formatted(result.median))\n".data(using: .utf8)!)
+        }
+    }
+
+    let report = BenchmarkReport(
+        schema: 1,
+        date: ISO8601DateFormatter().string(from: Date()),
+        platform: platform,
+        configuration: configuration,
+        scale: options.scale,
+        results: results
+    )
+
+    let data: Data
+    switch options.format {
+    case .text:
+        guard options.output != nil else { return }
+        data = ([textHeader(scale: options.scale)] + results.map(textLine)).joined(separator: "\n")
+            .appending("\n").data(using: .utf8)!
+    case .json:
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        data = try encoder.encode(report) + "\n".data(using: .utf8)!
+    case .csv:
+        data = csv(report).data(using: .utf8)!
+    }
+
+    if let output = options.output {
+        try data.write(to: URL(fileURLWithPath: output))
+    } else {
+        FileHandle.standardOutput.write(data)
+    }
+}
+
+do {
+    try runBenchmarks()
+} catch {
+    FileHandle.standardError.write("error: \(error)\n".data(using: .utf8)!)
+    exit(1)
+}
@@ -0,0 +1,60 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the hashed unique string (atom) table
+final class AtomTableTests: XCTestCase {
+
+    func testManyDynamicKeys() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let result = try context.eval("""
+            var o = {};
+            for (var i = 0; i < 10000; i++) o['key' + i] = i;
+            var sum = 0;
+            for (var i = 0; i < 10000; i++) sum += o['key' + i];
+            [sum, Object.keys(o).length, o.key9999, 'key77' in o].join()
+        """)
+        XCTAssertEqual(try result.toString(), "49995000,10000,9999,true")
+    }
+
+    func testKeysSurviveCollection() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        try context.eval("""
+            var keep = {};
+            for (var r = 0; r < 30; r++) {
+                var tmp = {};
+                for (var i = 0; i < 200; i++) tmp['r' + r + '_' + i] = i;
+                if (r % 10 == 0) keep['round' + r] = tmp;
+            }
+        """)
+        context.collectGarbage()
+
+        let result = try context.eval("keep.round20.r20_199 + keep['round' + 10]['r10_' + 5] + Object.keys(keep).length")
+        XCTAssertEqual(try result.toInt32(), 207)
+    }
+
+    func testJSONRoundTripWithDistinctKeys() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let result = try context.eval("""
+            var src = {};
+            for (var i = 0; i < 3000; i++) src['field_' + i] = { id: i };
+            var copy = JSON.parse(JSON.stringify(src));
+            var n = 0;
+            for (var k in copy) if (copy[k].id === src[k].id) n++;
+            n
+        """)
+        XCTAssertEqual(try result.toInt32(), 3000)
+    }
+
+    func testBytecodeAtomsMatchRuntimeKeys() throws {
+        // The saved atom table is searched as a sorted ROM table once loaded
+        let bytecode = try MQJSContext.compileBytecode(
+            "var table = { zeta: 1, alpha: 2, mike: 3, bravo: 4, yankee: 5, x10: 6, x9: 7 };",
+            filename: "atoms.js"
+        )
+        let context = try MQJSContext()
+        try context.run(context.loadBytecode(bytecode))
+
+        let result = try context.eval("[table.zeta, table.alpha, table.mike, table['bra' + 'vo'], table.yankee, table.x10, table.x9].join()")
+        XCTAssertEqual(try result.toString(), "1,2,3,4,5,6,7")
+    }
+}
@@ -0,0 +1,86 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for calling a function over columns of arguments with callBatch
+final class BatchCallTests: XCTestCase {
+
+    func testMixedColumns() throws {
+        let context = try MQJSContext()
+        let function = try context.eval("(function(x, n, s) { return x * n + s.length; })")
+        let strings = ["a", "bb", "café", ""]
+
+        var results = [Double](repeating: 0, count: 4)
+        try results.withUnsafeMutableBufferPointer { buffer in
+            try function.callBatch([.doubles([0.5, 1.5, 2, -1]), .int32s([2, 2, 3, 7]), .strings(strings)], into: buffer)
+        }
+        XCTAssertEqual(results, [2, 5, 10, -7])
+    }
+
+    func testInt32Results() throws {
+        let context = try MQJSContext()
+        let function = try context.eval("(function(s) { return s.toUpperCase() == 'OK' ? 1 : 2.9; })")
+
+        var results = [Int32](repeating: 0, count: 3)
+        try results.withUnsafeMutableBufferPointer { buffer in
+            try function.callBatch([.strings(["ok", "no", "Ok"])], into: buffer)
+        }
+        XCTAssertEqual(results, [1, 2, 1])
+    }
+
+    func testElementsColumnAndThisValue() throws {
+        let context = try MQJSContext()
+        let scaler = try context.eval("({ factor: 3, apply: function(x, y) { return this.factor * x + y; } })")
+        let xs = try context.eval("new Float64Array([1, 2, 3])")
+        let ys = try context.eval("[10, 20, 30]")
+
+        let results = try scaler["apply"]!.callBatch([.elements(xs), .elements(ys)], this: scaler)
+        XCTAssertEqual(results, [13, 26, 39])
+    }
+
+    func testManyCallsWithAllocation() throws {
+        let context = try MQJSContext(memorySize: 64 * 1024)
+        let function = try context.eval("(function(i) { var o = { v: [i, i + 1] }; return o.v[1] + ('' + i).length; })")
+        let count = 20_000
+        let indices = (0..<Int32(count)).map { $0 }
+
+        let results = try function.callBatch([.int32s(indices)])
+        XCTAssertEqual(results.count, count)
+        XCTAssertEqual(results[0], 2)
+        XCTAssertEqual(results[count - 1], Double(count + 5))
+    }
+
+    func testExceptionStopsBatch() throws {
+        let context = try MQJSContext()
+        let function = try context.eval("""
+            var calls = 0;
+            (function(x) { calls++; if (x == 3) throw new Error('bad row'); return x; })
+        """)
+
+        var results = [Double](repeating: 0, count: 5)
+        XCTAssertThrowsError(try results.withUnsafeMutableBufferPointer { buffer in
+            try function.callBatch([.doubles([1, 2, 3, 4, 5])], into: buffer)
+        }) { error in
+            guard case MQJSError.evaluationError(let message) = error else {
+                return XCTFail("Unexpected error: \(error)")
+            }
+            XCTAssertTrue(message.contains("bad row"))
+        }
+        XCTAssertEqual(Array(results[0..<2]), [1, 2])
+        XCTAssertEqual(try context.eval("calls").toInt32(), 3)
+    }
+
+    func testColumnLengthMismatch() throws {
+        let context = try MQJSContext()
+        let function = try context.eval("(function(x, y) { return x + y; })")
+        let short = try context.eval("[1]")
+
+        XCTAssertThrowsError(try function.callBatch([.doubles([1, 2]), .int32s([1])]))
+        XCTAssertThrowsError(try function.callBatch([.doubles([1, 2]), .elements(short)]))
+        XCTAssertThrowsError(try function.callBatch([]))
+        XCTAssertThrowsError(try context.eval("42").callBatch([.doubles([1])])) { error in
+            guard case MQJSError.notAFunction = error else {
+                return XCTFail("Unexpected error: \(error)")
+            }
+        }
+    }
+}
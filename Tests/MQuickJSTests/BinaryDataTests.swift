@@ -0,0 +1,126 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for ArrayBuffer / typed array bridging
+final class BinaryDataTests: XCTestCase {
+
+    // MARK: - Swift → JavaScript
+
+    func testUint8ArrayFromData() throws {
+        let context = try MQJSContext()
+        let data = Data([1, 2, 3, 250])
+
+        let value = try MQJSValue(bytes: data, in: context)
+        XCTAssertTrue(value.isTypedArray)
+        XCTAssertEqual(value.binaryType, .uint8Array)
+
+        context.globalObject["payload"] = value
+        XCTAssertEqual(try context.eval("payload.length").toInt32(), 4)
+        XCTAssertEqual(try context.eval("payload[3]").toInt32(), 250)
+    }
+
+    func testArrayBufferFromBytes() throws {
+        let context = try MQJSContext()
+
+        let value = try MQJSValue(bytes: [UInt8](repeating: 7, count: 16), as: .arrayBuffer, in: context)
+        XCTAssertTrue(value.isArrayBuffer)
+        XCTAssertFalse(value.isTypedArray)
+
+        context.globalObject["buf"] = value
+        XCTAssertEqual(try context.eval("buf.byteLength").toInt32(), 16)
+        XCTAssertEqual(try context.eval("new Uint8Array(buf)[15]").toInt32(), 7)
+    }
+
+    func testTypedArrayFromElements() throws {
+        let context = try MQJSContext()
+
+        let value = try MQJSValue(typedArray: [1.5, 2.5, -3.0] as [Double], in: context)
+        XCTAssertEqual(value.binaryType, .float64Array)
+
+        context.globalObject["samples"] = value
+        XCTAssertEqual(try context.eval("samples[0] + samples[1] + samples[2]").toDouble(), 1.0)
+    }
+
+    func testMisalignedByteCountThrows() throws {
+        let context = try MQJSContext()
+
+        XCTAssertThrowsError(try MQJSValue(bytes: Data([1, 2, 3]), as: .float32Array, in: context)) { error in
+            guard case MQJSError.typeConversionError = error else {
+                XCTFail("Expected typeConversionError, got \(error)")
+                return
+            }
+        }
+    }
+
+    func testLargeBuffer() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let data = Data((0..<(1024 * 1024)).map { UInt8(truncatingIfNeeded: $0) })
+
+        let value = try MQJSValue(bytes: data, in: context)
+        XCTAssertEqual(try value.toData(), data)
+    }
+
+    // MARK: - JavaScript → Swift
+
+    func testWithUnsafeBytesBorrowsTypedArray() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("var u = new Uint8Array(8); for (var i = 0; i < 8; i++) u[i] = i * 2; u")
+
+        let sum = try value.withUnsafeBytes { bytes in
+            bytes.reduce(0) { $0 + Int($1) }
+        }
+        XCTAssertEqual(sum, 56)
+    }
+
+    func testWithUnsafeMutableBytesWritesInPlace() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("var out = new Uint8Array(4); out")
+
+        try value.withUnsafeMutableBytes { bytes in
+            for i in 0..<bytes.count {
+                bytes[i] = UInt8(10 + i)
+            }
+        }
+
+        XCTAssertEqual(try context.eval("out[0] + out[3]").toInt32(), 23)
+    }
+
+    func testToTypedArray() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("new Float32Array([0.5, 1.5, 2.5])")
+
+        let floats: [Float] = try value.toTypedArray()
+        XCTAssertEqual(floats, [0.5, 1.5, 2.5])
+
+        XCTAssertThrowsError(try value.toTypedArray(of: Double.self))
+    }
+
+    func testSubarrayExposesOnlyItsView() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("""
+            var u = new Uint8Array(8);
+            for (var i = 0; i < 8; i++) u[i] = i;
+            u.subarray(2, 5)
+        """)
+
+        XCTAssertEqual(try value.toData(), Data([2, 3, 4]))
+    }
+
+    func testBytesSurviveGC() throws {
+        let context = try MQJSContext()
+        let value = try MQJSValue(bytes: Data([9, 8, 7]), in: context)
+
+        try context.eval("var garbage = []; for (var i = 0; i < 1000; i++) garbage.push({ i: i }); garbage = null;")
+        context.collectGarbage()
+
+        XCTAssertEqual(try value.toData(), Data([9, 8, 7]))
+    }
+
+    func testNonBinaryValueThrows() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("({ length: 3 })")
+
+        XCTAssertNil(value.binaryType)
+        XCTAssertThrowsError(try value.toData())
+    }
+}
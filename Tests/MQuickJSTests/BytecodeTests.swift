@@ -0,0 +1,222 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for bytecode compilation, loading and caching
+final class BytecodeTests: XCTestCase {
+
+    private let bundle = """
+        function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+        var config = { name: 'rules', version: 3 };
+        fib(10) + config.version;
+    """
+
+    // MARK: - Compile and Load
+
+    func testCompileAndLoadBytecode() throws {
+        let bytecode = try MQJSContext.compileBytecode(bundle, filename: "bundle.js")
+        XCTAssertFalse(bytecode.isEmpty)
+
+        let context = try MQJSContext()
+        XCTAssertTrue(context.canLoadBytecode)
+
+        let main = try context.loadBytecode(bytecode)
+        let result = try context.run(main)
+        XCTAssertEqual(try result.toInt32(), 58)  // 55 + 3
+    }
+
+    func testBytecodeLoadsIntoManyContexts() throws {
+        let bytecode = try MQJSContext.compileBytecode(bundle)
+
+        for _ in 0..<3 {
+            let context = try MQJSContext()
+            try context.run(context.loadBytecode(bytecode))
+
+            // Definitions from the bytecode are usable from later scripts
+            let result = try context.eval("fib(12) + config.name.length")
+            XCTAssertEqual(try result.toInt32(), 149)  // 144 + 5
+        }
+    }
+
+    func testLoadedBytecodeSurvivesGC() throws {
+        let context = try MQJSContext()
+        try context.run(context.loadBytecode(MQJSContext.compileBytecode(bundle)))
+
+        context.collectGarbage()
+
+        let result = try context.eval("config.name")
+        XCTAssertEqual(try result.toString(), "rules")
+    }
+
+    func testCompileSyntaxError() throws {
+        XCTAssertThrowsError(try MQJSContext.compileBytecode("function broken(", filename: "broken.js")) { error in
+            guard case MQJSError.evaluationError(let message) = error else {
+                XCTFail("Expected evaluationError, got \(error)")
+                return
+            }
+            XCTAssertTrue(message.hasPrefix("SyntaxError: "), message)
+            XCTAssertTrue(message.contains("broken.js:1"), message)
+        }
+    }
+
+    func testLoadRejectsInvalidData() throws {
+        let context = try MQJSContext()
+
+        XCTAssertThrowsError(try context.loadBytecode(Data([1, 2, 3, 4]))) { error in
+            guard case MQJSError.bytecodeError = error else {
+                XCTFail("Expected bytecodeError, got \(error)")
+                return
+            }
+        }
+    }
+
+    func testLoadAfterEvalIsRejected() throws {
+        let bytecode = try MQJSContext.compileBytecode(bundle)
+        let context = try MQJSContext()
+        try context.eval("var someNewName = 1")
+
+        XCTAssertFalse(context.canLoadBytecode)
+        XCTAssertThrowsError(try context.loadBytecode(bytecode))
+    }
+
+    // MARK: - Shared Images
+
+    func testSharedBytecodeLoadsIntoManyContexts() throws {
+        let shared = try MQJSSharedBytecode(MQJSContext.compileBytecode(bundle))
+
+        let contexts = try (0..<8).map { _ in try MQJSContext() }
+        for context in contexts {
+            XCTAssertEqual(try context.run(context.loadBytecode(shared)).toInt32(), 58)
+        }
+        for context in contexts {
+            context.collectGarbage()
+            XCTAssertEqual(try context.eval("fib(12) + config.name.length").toInt32(), 149)
+        }
+    }
+
+    func testSharedBytecodeFromFile() throws {
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent("MQJSSharedBytecodeTests-\(UUID().uuidString).mqjsbc")
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        let bytecode = try MQJSContext.compileBytecode(bundle)
+        try bytecode.write(to: url)
+
+        var shared: MQJSSharedBytecode? = try MQJSSharedBytecode(contentsOf: url)
+        XCTAssertEqual(shared?.size, bytecode.count)
+
+        let context = try MQJSContext()
+        try context.run(context.loadBytecode(shared!))
+
+        // The context keeps the image alive
+        shared = nil
+        context.collectGarbage()
+        XCTAssertEqual(try context.eval("config.name").toString(), "rules")
+    }
+
+    func testSharedBytecodeFromThreads() throws {
+        let shared = try MQJSSharedBytecode(MQJSContext.compileBytecode(bundle))
+        var results = [Int32](repeating: 0, count: 8)
+        let lock = NSLock()
+
+        DispatchQueue.concurrentPerform(iterations: results.count) { index in
+            let value: Int32? = try? {
+                let context = try MQJSContext()
+                try context.run(context.loadBytecode(shared))
+                return try context.eval("fib(15)").toInt32()
+            }()
+            lock.lock()
+            results[index] = value ?? -1
+            lock.unlock()
+        }
+        XCTAssertEqual(results, [Int32](repeating: 610, count: 8))
+    }
+
+    func testSharedBytecodeRejectsInvalidData() throws {
+        XCTAssertThrowsError(try MQJSSharedBytecode(Data([1, 2, 3, 4])))
+        XCTAssertThrowsError(try MQJSSharedBytecode(contentsOf: URL(fileURLWithPath: "/nonexistent.mqjsbc")))
+    }
+
+    // MARK: - Cache
+
+    func testEvalWithCache() throws {
+        let cache = MQJSBytecodeCache()
+
+        for _ in 0..<3 {
+            let context = try MQJSContext()
+            let result = try context.eval(bundle, filename: "bundle.js", cache: cache)
+            XCTAssertEqual(try result.toInt32(), 58)
+        }
+
+        XCTAssertEqual(cache.count, 1)
+    }
+
+    func testEvalWithCacheFallsBackToParsing() throws {
+        let cache = MQJSBytecodeCache()
+        let context = try MQJSContext()
+        try context.eval("var counter = 41")
+
+        let result = try context.eval("counter + 1", cache: cache)
+        XCTAssertEqual(try result.toInt32(), 42)
+        XCTAssertEqual(cache.count, 0)
+    }
+
+    func testCacheKeyDependsOnContent() throws {
+        let cache = MQJSBytecodeCache()
+        let first = try cache.bytecode(for: "1 + 1")
+        let again = try cache.bytecode(for: "1 + 1")
+        _ = try cache.bytecode(for: "2 + 2")
+
+        XCTAssertEqual(first, again)
+        XCTAssertEqual(cache.count, 2)
+    }
+
+    func testDiskCache() throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("MQJSBytecodeCacheTests-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let compiled = try MQJSBytecodeCache(directory: directory).bytecode(for: bundle)
+
+        let files = try FileManager.default.contentsOfDirectory(atPath: directory.path)
+        XCTAssertEqual(files.count, 1)
+
+        // A fresh cache picks up the persisted image
+        let reloaded = try MQJSBytecodeCache(directory: directory).bytecode(for: bundle)
+        XCTAssertEqual(compiled, reloaded)
+    }
+
+    func testDiskCacheRejectsEntryOfAnotherScript() throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("MQJSBytecodeCacheTests-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        _ = try MQJSBytecodeCache(directory: directory).bytecode(for: "1 + 1")
+        let first = try FileManager.default.contentsOfDirectory(atPath: directory.path)[0]
+        _ = try MQJSBytecodeCache(directory: directory).bytecode(for: "2 + 2")
+        let second = try FileManager.default.contentsOfDirectory(atPath: directory.path).first { $0 != first }!
+
+        // Put the entry of the first script under the key of the second one
+        func replaceSecondEntry() throws {
+            let secondURL = directory.appendingPathComponent(second)
+            try FileManager.default.removeItem(at: secondURL)
+            try FileManager.default.copyItem(at: directory.appendingPathComponent(first), to: secondURL)
+        }
+
+        try replaceSecondEntry()
+        let bytecode = try MQJSBytecodeCache(directory: directory).bytecode(for: "2 + 2")
+        let context = try MQJSContext()
+        XCTAssertEqual(try context.run(context.loadBytecode(bytecode)).toInt32(), 4)
+
+        try replaceSecondEntry()
+        let shared = try MQJSBytecodeCache(directory: directory).sharedBytecode(for: "2 + 2")
+        let sharedContext = try MQJSContext()
+        XCTAssertEqual(try sharedContext.run(sharedContext.loadBytecode(shared)).toInt32(), 4)
+    }
+
+    func testCacheReturnsOneSharedImage() throws {
+        let cache = MQJSBytecodeCache()
+        let first = try cache.sharedBytecode(for: bundle)
+        let again = try cache.sharedBytecode(for: bundle)
+        XCTAssertTrue(first === again)
+    }
+}
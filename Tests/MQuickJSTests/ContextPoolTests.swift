@@ -0,0 +1,187 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for context snapshots and the context pool
+final class ContextPoolTests: XCTestCase {
+
+    // MARK: - Snapshots
+
+    func testSnapshotRestoresState() throws {
+        let context = try MQJSContext()
+        try context.eval("var counter = 10; function bump() { return ++counter; }")
+
+        let snapshot = try context.makeSnapshot()
+        XCTAssertGreaterThan(snapshot.size, 0)
+
+        try context.eval("bump(); bump(); var scratch = [1, 2, 3];")
+        XCTAssertEqual(try context.eval("counter").toInt32(), 12)
+
+        try context.restore(snapshot)
+
+        XCTAssertEqual(try context.eval("counter").toInt32(), 10)
+        XCTAssertEqual(try context.eval("typeof scratch").toString(), "undefined")
+        XCTAssertEqual(try context.eval("bump()").toInt32(), 11)
+    }
+
+    func testSnapshotCanBeRestoredRepeatedly() throws {
+        let context = try MQJSContext()
+        try context.eval("var log = [];")
+        let snapshot = try context.makeSnapshot()
+
+        for i in 0..<5 {
+            try context.eval("for (var i = 0; i < 1000; i++) log.push({ i: i, s: 'x' + i });")
+            context.collectGarbage()
+            try context.restore(snapshot)
+            XCTAssertEqual(try context.eval("log.length").toInt32(), 0, "iteration \(i)")
+        }
+    }
+
+    func testSnapshotInvalidatesValues() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("({ x: 1 })")
+
+        _ = try context.makeSnapshot()
+
+        XCTAssertThrowsError(try value.toInt32()) { error in
+            guard case MQJSError.invalidValue = error else {
+                XCTFail("Expected invalidValue, got \(error)")
+                return
+            }
+        }
+    }
+
+    func testSnapshotKeepsNativeFunctions() throws {
+        let context = try MQJSContext()
+        try context.setFunction("twice") { args in
+            return try args[0].toInt32() * 2
+        }
+        let snapshot = try context.makeSnapshot()
+
+        try context.setFunction("thrice") { args in
+            return try args[0].toInt32() * 3
+        }
+        try context.restore(snapshot)
+
+        XCTAssertEqual(try context.eval("twice(21)").toInt32(), 42)
+        XCTAssertEqual(try context.eval("typeof thrice").toString(), "undefined")
+    }
+
+    func testRestoreRejectsForeignSnapshot() throws {
+        let first = try MQJSContext()
+        let second = try MQJSContext()
+        let snapshot = try first.makeSnapshot()
+
+        XCTAssertThrowsError(try second.restore(snapshot)) { error in
+            guard case MQJSError.snapshotError = error else {
+                XCTFail("Expected snapshotError, got \(error)")
+                return
+            }
+        }
+    }
+
+    // MARK: - Pool
+
+    func testPoolCheckoutAndCheckin() throws {
+        let pool = try MQJSContextPool(count: 2) { context in
+            try context.eval("var requests = 0; function handle() { return ++requests; }")
+        }
+        XCTAssertEqual(pool.availableCount, 2)
+
+        let context = pool.checkout()
+        XCTAssertEqual(pool.availableCount, 1)
+        XCTAssertEqual(try context.eval("handle(); handle()").toInt32(), 2)
+
+        try pool.checkin(context)
+        XCTAssertEqual(pool.availableCount, 2)
+    }
+
+    func testPoolResetsStateBetweenCheckouts() throws {
+        let pool = try MQJSContextPool(count: 1) { context in
+            try context.eval("var requests = 0; function handle() { return ++requests; }")
+        }
+
+        for _ in 0..<3 {
+            let result = try pool.withContext { context in
+                try context.eval("var leaked = true; handle()").toInt32()
+            }
+            XCTAssertEqual(result, 1)
+        }
+
+        try pool.withContext { context in
+            XCTAssertEqual(try context.eval("typeof leaked").toString(), "undefined")
+        }
+    }
+
+    func testPoolCheckoutTimeout() throws {
+        let pool = try MQJSContextPool(count: 1)
+        let context = pool.checkout()
+
+        XCTAssertNil(pool.checkout(timeout: .now() + .milliseconds(10)))
+
+        try pool.checkin(context)
+        XCTAssertNotNil(pool.checkout(timeout: .now() + .milliseconds(10)))
+    }
+
+    func testPoolRejectsForeignContext() throws {
+        let pool = try MQJSContextPool(count: 1)
+        let context = try MQJSContext()
+
+        XCTAssertThrowsError(try pool.checkin(context))
+    }
+
+    func testPoolRejectsDoubleCheckin() throws {
+        let pool = try MQJSContextPool(count: 2)
+        let context = pool.checkout()
+
+        try pool.checkin(context)
+        XCTAssertThrowsError(try pool.checkin(context))
+        XCTAssertEqual(pool.availableCount, 2)
+
+        // The context is only handed out once
+        let first = pool.checkout()
+        let second = pool.checkout()
+        XCTAssertFalse(first === second)
+        try pool.checkin(first)
+        try pool.checkin(second)
+        XCTAssertEqual(pool.count, 2)
+    }
+
+    func testPoolReusesFunctionIdsAcrossCheckins() throws {
+        let pool = try MQJSContextPool(count: 1) { context in
+            try context.setFunction("base") { _ in 1 }
+        }
+
+        var capacities = Set<Int>()
+        for i in 0..<100 {
+            try pool.withContext { context in
+                try context.setFunction("perRequest") { _ in i }
+                XCTAssertEqual(try context.eval("base() + perRequest()").toInt32(), Int32(i + 1))
+                capacities.insert(context.nativeFunctionCapacity)
+            }
+        }
+
+        // Every checkout registers into the same slot
+        XCTAssertEqual(capacities, [2])
+    }
+
+    func testPoolConcurrentUse() throws {
+        let pool = try MQJSContextPool(count: 4) { context in
+            try context.eval("function square(n) { return n * n; }")
+        }
+
+        let results = NSLock()
+        var total = 0
+
+        DispatchQueue.concurrentPerform(iterations: 32) { i in
+            let value = (try? pool.withContext { context in
+                try context.callFunction("square", withArguments: [i]).toInt32()
+            }) ?? -1
+            results.lock()
+            total += Int(value)
+            results.unlock()
+        }
+
+        XCTAssertEqual(total, (0..<32).reduce(0) { $0 + $1 * $1 })
+        XCTAssertEqual(pool.availableCount, 4)
+    }
+}
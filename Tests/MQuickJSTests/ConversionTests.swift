@@ -115,6 +115,95 @@ final class ConversionTests: XCTestCase {
         XCTAssertTrue(dict.isEmpty)
     }
 
+    func testToDictionaryFollowsJSONSemantics() throws {
+        let context = try MQJSContext()
+        let obj = try context.eval("""
+            ({ a: 1, skipped: undefined, fn: function() {}, list: [undefined, Infinity], 5: 'five' })
+        """)
+
+        let dict = try obj.toDictionary()
+
+        XCTAssertEqual(Set(dict.keys), ["a", "list", "5"])
+        XCTAssertEqual(dict["5"] as? String, "five")
+        let list = try XCTUnwrap(dict["list"] as? [Any])
+        XCTAssertTrue(list[0] is NSNull)
+        XCTAssertTrue(list[1] is NSNull)
+        XCTAssertTrue(JSONSerialization.isValidJSONObject(dict))
+    }
+
+    func testToDictionaryInvokesGetters() throws {
+        let context = try MQJSContext()
+        let obj = try context.eval("""
+            var o = { base: 20, get doubled() { return { value: this.base * 2 }; } };
+            delete o.missing;
+            o
+        """)
+
+        let dict = try obj.toDictionary()
+
+        XCTAssertEqual(dict["base"] as? Int, 20)
+        XCTAssertEqual((dict["doubled"] as? [String: Any])?["value"] as? Int, 40)
+    }
+
+    func testToDictionarySkipsDeletedProperties() throws {
+        let context = try MQJSContext()
+        let obj = try context.eval("var o = { a: 1, b: 2, c: 3 }; delete o.b; o.d = 4; o")
+
+        let dict = try obj.toDictionary()
+
+        XCTAssertEqual(dict.count, 3)
+        XCTAssertNil(dict["b"])
+        XCTAssertEqual(dict["d"] as? Int, 4)
+    }
+
+    func testToDictionaryRejectsCycles() throws {
+        let context = try MQJSContext()
+        let obj = try context.eval("var o = { child: {} }; o.child.parent = o; o")
+
+        XCTAssertThrowsError(try obj.toDictionary()) { error in
+            guard case MQJSError.typeConversionError = error else {
+                XCTFail("Expected typeConversionError, got \(error)")
+                return
+            }
+        }
+    }
+
+    func testToDictionaryLargeObject() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        let obj = try context.eval("""
+            var o = {};
+            for (var i = 0; i < 2000; i++) o['k' + i] = { index: i, name: 'item' + i, scores: [i, i / 2] };
+            o
+        """)
+
+        let dict = try obj.toDictionary()
+
+        XCTAssertEqual(dict.count, 2000)
+        let item = try XCTUnwrap(dict["k1999"] as? [String: Any])
+        XCTAssertEqual(item["name"] as? String, "item1999")
+        XCTAssertEqual((item["scores"] as? [Any])?[1] as? Double, 999.5)
+    }
+
+    func testToArrayTypedArray() throws {
+        let context = try MQJSContext()
+        let arr = try context.eval("new Float64Array([1.5, 2, -3])")
+
+        let swiftArray = try arr.toArray()
+
+        XCTAssertEqual(swiftArray.count, 3)
+        XCTAssertEqual(swiftArray[0] as? Double, 1.5)
+        XCTAssertEqual(swiftArray[1] as? Int, 2)
+    }
+
+    func testDictionaryInitializable() throws {
+        let context = try MQJSContext()
+        let obj = try context.eval("({ x: 1, y: 2, z: 3 })")
+
+        let dict: [String: Int] = try context.extract(obj)
+
+        XCTAssertEqual(dict, ["x": 1, "y": 2, "z": 3])
+    }
+
     // MARK: - toObject()
 
     func testToObjectNumber() throws {
@@ -52,6 +52,24 @@ final class CustomClassTests: XCTestCase {
         }
     }
 
+    /// Class counting its live instances, for testing their release
+    class Resource {
+        let tracker: Tracker
+
+        init(tracker: Tracker) {
+            self.tracker = tracker
+            tracker.live += 1
+        }
+
+        deinit {
+            tracker.live -= 1
+        }
+    }
+
+    class Tracker {
+        var live = 0
+    }
+
     // MARK: - Basic Class Registration
 
     func testBasicClassRegistration() throws {
@@ -334,6 +352,120 @@ final class CustomClassTests: XCTestCase {
         XCTAssertEqual(try result.toInt32(), 6)
     }
 
+    // MARK: - Properties and Fast Methods
+
+    func testPropertyAccessors() throws {
+        let context = try MQJSContext()
+
+        try context.registerClass("Greeter") { (builder: MQJSClassBuilder<Greeter>) in
+            builder.constructor { args in
+                return Greeter(name: (try? args.first?.toString()) ?? "World")
+            }
+            builder.property("name", get: { this in this.name }, set: { this, value in
+                this.name = try value.toString()
+            })
+            builder.property("greeting", get: { this in this.greet() })
+        }
+
+        let result = try context.eval("""
+            var g = new Greeter('Ann'), error = '';
+            g.name = 'Bob';
+            try { g.greeting = 'read-only'; } catch (e) { error = e.name; }
+            [g.name, g.greeting, error, 'name' in g, g.hasOwnProperty('name')].join()
+        """)
+        XCTAssertEqual(try result.toString(), "Bob,Hello, Bob!,TypeError,true,false")
+    }
+
+    func testFastMethod() throws {
+        let context = try MQJSContext()
+
+        try context.registerClass("Counter") { (builder: MQJSClassBuilder<Counter>) in
+            builder.constructor { _ in Counter() }
+            builder.fastMethod("add") { this, args in
+                this.add(Int(try args.int32(at: 0)))
+                return .int32(Int32(this.value))
+            }
+        }
+
+        let result = try context.eval("""
+            var c = new Counter(), last = 0;
+            for (var i = 0; i < 1000; i++) last = c.add(2);
+            last
+        """)
+        XCTAssertEqual(try result.toInt32(), 2000)
+    }
+
+    // MARK: - Native Objects
+
+    func testInstancesAreNativeObjects() throws {
+        let context = try MQJSContext()
+
+        try context.registerClass("Counter") { (builder: MQJSClassBuilder<Counter>) in
+            builder.constructor { _ in Counter() }
+            builder.method("getValue") { this, _ in this.getValue() }
+        }
+
+        let result = try context.eval("""
+            var c = new Counter(), errors = [];
+            try { Counter(); } catch (e) { errors.push(e.name); }
+            try { c.getValue.call({}); } catch (e) { errors.push(e.name); }
+            [c instanceof Counter, c.constructor === Counter, c.hasOwnProperty('__swiftInstanceId__'),
+             errors.join()].join()
+        """)
+        XCTAssertEqual(try result.toString(), "true,true,false,TypeError,TypeError")
+    }
+
+    func testInstancesReleasedByGarbageCollector() throws {
+        let context = try MQJSContext()
+        let tracker = Tracker()
+
+        try context.registerClass("Resource") { (builder: MQJSClassBuilder<Resource>) in
+            builder.constructor { _ in Resource(tracker: tracker) }
+        }
+
+        try context.eval("var kept = new Resource(); for (var i = 0; i < 100; i++) new Resource();")
+        context.collectGarbage()
+        XCTAssertEqual(tracker.live, 1)
+
+        try context.eval("kept = null;")
+        context.collectGarbage()
+        XCTAssertEqual(tracker.live, 0)
+    }
+
+    func testInstancesReleasedWithContext() throws {
+        let tracker = Tracker()
+        var context: MQJSContext? = try MQJSContext()
+
+        try context?.registerClass("Resource") { (builder: MQJSClassBuilder<Resource>) in
+            builder.constructor { _ in Resource(tracker: tracker) }
+        }
+        try context?.eval("var a = [new Resource(), new Resource()];")
+        XCTAssertEqual(tracker.live, 2)
+
+        context = nil
+        XCTAssertEqual(tracker.live, 0)
+    }
+
+    func testSnapshotKeepsInstances() throws {
+        let context = try MQJSContext()
+        let tracker = Tracker()
+
+        try context.registerClass("Resource") { (builder: MQJSClassBuilder<Resource>) in
+            builder.constructor { _ in Resource(tracker: tracker) }
+            builder.property("live", get: { this in this.tracker.live })
+        }
+        try context.eval("var r = new Resource();")
+        let snapshot = try context.makeSnapshot()
+
+        try context.eval("r = null; var more = [new Resource(), new Resource()];")
+        context.collectGarbage()
+        XCTAssertEqual(tracker.live, 3) // r is kept by the snapshot
+
+        try context.restore(snapshot)
+        XCTAssertEqual(tracker.live, 1)
+        XCTAssertEqual(try context.eval("r.live").toInt32(), 1)
+    }
+
     // MARK: - Error Handling
 
     func testMissingConstructor() throws {
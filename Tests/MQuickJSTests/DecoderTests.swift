@@ -0,0 +1,119 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for decoding Decodable types from JavaScript values
+final class DecoderTests: XCTestCase {
+
+    private struct Address: Decodable, Equatable {
+        let city: String
+        let zip: String?
+    }
+
+    private struct User: Decodable, Equatable {
+        let name: String
+        let age: Int
+        let score: Double
+        let admin: Bool
+        let tags: [String]
+        let address: Address
+        let nickname: String?
+    }
+
+    private enum Role: String, Decodable {
+        case reader, writer
+    }
+
+    func testDecodeStruct() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("""
+            ({ name: 'Alice', age: 30, score: 4.5, admin: true, tags: ['a', 'b'],
+               address: { city: 'Oslo', zip: null } })
+        """)
+
+        let user = try value.decode(User.self)
+
+        XCTAssertEqual(user, User(
+            name: "Alice", age: 30, score: 4.5, admin: true, tags: ["a", "b"],
+            address: Address(city: "Oslo", zip: nil), nickname: nil
+        ))
+    }
+
+    func testDecodeCollections() throws {
+        let context = try MQJSContext()
+
+        let matrix = try MQJSDecoder().decode([[Int]].self, from: context.eval("[[1, 2], [3], []]"))
+        XCTAssertEqual(matrix, [[1, 2], [3], []])
+
+        let counts = try context.eval("({ apples: 3, pears: 7 })").decode([String: Int].self)
+        XCTAssertEqual(counts, ["apples": 3, "pears": 7])
+
+        let bytes = try context.eval("new Uint8Array([1, 2, 255])").decode([UInt8].self)
+        XCTAssertEqual(bytes, [1, 2, 255])
+
+        let roles = try context.eval("['reader', 'writer']").decode([Role].self)
+        XCTAssertEqual(roles, [.reader, .writer])
+    }
+
+    func testDecodeIntegerExactness() throws {
+        let context = try MQJSContext()
+
+        XCTAssertEqual(try context.eval("2147483648").decode(Int64.self), 2_147_483_648)
+        XCTAssertThrowsError(try context.eval("1.5").decode(Int.self))
+        XCTAssertThrowsError(try context.eval("300").decode(UInt8.self))
+        XCTAssertThrowsError(try context.eval("-1").decode(UInt.self))
+    }
+
+    func testMissingKey() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("({ city: 'Oslo' })")
+
+        XCTAssertThrowsError(try value.decode(User.self)) { error in
+            guard case DecodingError.keyNotFound(let key, _) = error else {
+                XCTFail("Expected keyNotFound, got \(error)")
+                return
+            }
+            XCTAssertEqual(key.stringValue, "name")
+        }
+    }
+
+    func testTypeMismatchReportsPath() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("({ city: 'Oslo', zip: 1234 })")
+
+        XCTAssertThrowsError(try value.decode(Address.self)) { error in
+            guard case DecodingError.typeMismatch(_, let errorContext) = error else {
+                XCTFail("Expected typeMismatch, got \(error)")
+                return
+            }
+            XCTAssertEqual(errorContext.codingPath.map { $0.stringValue }, ["zip"])
+        }
+    }
+
+    func testGetterException() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("({ get city() { throw new Error('no city'); } })")
+
+        XCTAssertThrowsError(try value.decode(Address.self)) { error in
+            guard case MQJSError.evaluationError(let message) = error else {
+                XCTFail("Expected evaluationError, got \(error)")
+                return
+            }
+            XCTAssertTrue(message.contains("no city"))
+        }
+    }
+
+    func testDecodeManyObjectsUnderMemoryPressure() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        let value = try context.eval("""
+            var list = [];
+            for (var i = 0; i < 500; i++) list.push({ city: 'c' + i, zip: i % 2 ? null : 'z' + i });
+            list
+        """)
+
+        let addresses = try value.decode([Address].self)
+
+        XCTAssertEqual(addresses.count, 500)
+        XCTAssertEqual(addresses[499], Address(city: "c499", zip: nil))
+        XCTAssertEqual(addresses[498], Address(city: "c498", zip: "z498"))
+    }
+}
@@ -0,0 +1,102 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for encoding Encodable types and bulk building of objects
+final class EncoderTests: XCTestCase {
+
+    private struct Header: Encodable {
+        let name: String
+        let value: String
+    }
+
+    private struct Request: Encodable {
+        let method: String
+        let path: String
+        let status: Int
+        let latency: Double
+        let secure: Bool
+        let headers: [Header]
+        let query: [String: String]
+        let body: String?
+    }
+
+    func testEncodeStruct() throws {
+        let context = try MQJSContext()
+        let request = Request(
+            method: "GET", path: "/items", status: 200, latency: 1.25, secure: true,
+            headers: [Header(name: "Accept", value: "*/*")], query: ["page": "2"], body: nil
+        )
+
+        context.globalObject["req"] = try context.encode(request)
+
+        let result = try context.eval("""
+            [req.method, req.path, req.status + 1, req.latency * 2, req.secure,
+             req.headers[0].name, req.headers.length, req.query.page, req.body === null,
+             Object.keys(req).join('/')].join()
+        """)
+        XCTAssertEqual(
+            try result.toString(),
+            "GET,/items,201,2.5,true,Accept,1,2,true,method/path/status/latency/secure/headers/query/body"
+        )
+    }
+
+    func testEncodeRoundTripsThroughDecoder() throws {
+        struct Point: Codable, Equatable {
+            let x: Int
+            let y: Int
+            let label: String
+        }
+
+        let context = try MQJSContext()
+        let points = (0..<100).map { Point(x: $0, y: -$0, label: "p\($0)") }
+
+        let value = try MQJSEncoder().encode(points, in: context)
+
+        XCTAssertEqual(try value.decode([Point].self), points)
+    }
+
+    func testEncodeLargeIntegers() throws {
+        let context = try MQJSContext()
+
+        XCTAssertEqual(try context.encode(Int64(1) << 40).toDouble(), 1_099_511_627_776)
+        XCTAssertEqual(try context.encode(UInt64.max).toDouble(), Double(UInt64.max))
+        XCTAssertEqual(try context.encode([Int.max]).toArray().count, 1)
+    }
+
+    func testEncodePassesThroughValues() throws {
+        struct Wrapper: Encodable {
+            let callback: MQJSValue
+        }
+
+        let context = try MQJSContext()
+        let function = try context.eval("(function(x) { return x * 3; })")
+
+        context.globalObject["w"] = try context.encode(Wrapper(callback: function))
+
+        XCTAssertEqual(try context.eval("w.callback(5)").toInt32(), 15)
+    }
+
+    func testLargeDictionaryArgument() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForDevelopment)
+        try context.eval("function count(o) { var n = 0; for (var k in o) n += o[k].v; return n; }")
+
+        var payload: [String: Any] = [:]
+        for index in 0..<5000 {
+            payload["key\(index)"] = ["v": 1, "name": "n\(index)", "flags": [true, NSNull()]]
+        }
+
+        let result = try context.callFunction("count", withArguments: [payload])
+        XCTAssertEqual(try result.toInt32(), 5000)
+    }
+
+    func testConversionFailureLeavesContextUsable() throws {
+        let context = try MQJSContext()
+        try context.eval("function id(x) { return x; }")
+
+        XCTAssertThrowsError(try context.callFunction("id", withArguments: [["a": [1, Date()]]]))
+
+        let result = try context.callFunction("id", withArguments: [["a": [1, 2]]])
+        XCTAssertEqual((try result.toDictionary()["a"] as? [Any])?.count, 2)
+        XCTAssertEqual(try context.eval("[1, 2, 3].length").toInt32(), 3)
+    }
+}
@@ -0,0 +1,92 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for deadlines and instruction budgets
+final class ExecutionLimitsTests: XCTestCase {
+
+    private func assertInterrupted<T>(_ expression: @autoclosure () throws -> T, file: StaticString = #file, line: UInt = #line) {
+        XCTAssertThrowsError(try expression(), file: file, line: line) { error in
+            guard case MQJSError.interrupted = error else {
+                XCTFail("Expected interrupted, got \(error)", file: file, line: line)
+                return
+            }
+        }
+    }
+
+    func testDeadlineStopsInfiniteLoop() throws {
+        let context = try MQJSContext()
+        let start = Date()
+
+        assertInterrupted(try context.eval("for (;;) {}", limits: .timeout(0.05)))
+        XCTAssertLessThan(Date().timeIntervalSince(start), 2)
+
+        // The context is still usable
+        XCTAssertEqual(try context.eval("1 + 2").toInt32(), 3)
+    }
+
+    func testInstructionBudget() throws {
+        let context = try MQJSContext()
+        context.interruptInterval = 100
+
+        assertInterrupted(try context.eval("while (true) {}", limits: MQJSExecutionLimits(instructionBudget: 10_000)))
+
+        let result = try context.eval(
+            "var s = 0; for (var i = 0; i < 1000; i++) s += i; s",
+            limits: MQJSExecutionLimits(instructionBudget: 1_000_000)
+        )
+        XCTAssertEqual(try result.toInt32(), 499500)
+    }
+
+    func testInterruptCannotBeCaught() throws {
+        let context = try MQJSContext()
+        assertInterrupted(try context.eval("""
+            var caught = false;
+            try { for (;;) {} } catch (e) { caught = true; }
+            caught
+        """, limits: .timeout(0.02)))
+        XCTAssertEqual(try context.eval("caught").toBool(), false)
+    }
+
+    func testCallWithLimits() throws {
+        let context = try MQJSContext()
+        try context.eval("function spin(n) { while (n > 0) {} return n; }")
+        let spin = try XCTUnwrap(context.globalObject["spin"])
+
+        assertInterrupted(try spin.call(withArguments: [1], limits: .timeout(0.02)))
+        XCTAssertEqual(try spin.call(withArguments: [0], limits: .timeout(1)).toInt32(), 0)
+    }
+
+    func testRunWithLimits() throws {
+        let context = try MQJSContext()
+        let compiled = try context.parse("for (;;) {}")
+        assertInterrupted(try context.run(compiled, limits: MQJSExecutionLimits(instructionBudget: 50_000)))
+    }
+
+    func testNestedCallIsBoundedByOuterLimits() throws {
+        let context = try MQJSContext()
+        try context.setFunction("nested") { [unowned context] _ in
+            try context.eval("for (;;) {}", limits: .timeout(60))
+        }
+
+        let start = Date()
+        assertInterrupted(try context.eval("nested(); for (;;) {}", limits: .timeout(0.05)))
+        XCTAssertLessThan(Date().timeIntervalSince(start), 2)
+    }
+
+    func testUnlimitedCallsAfterInterrupt() throws {
+        let context = try MQJSContext()
+        assertInterrupted(try context.eval("for (;;) {}", limits: MQJSExecutionLimits(instructionBudget: 0)))
+
+        let result = try context.eval("var n = 0; for (var i = 0; i < 100000; i++) n++; n")
+        XCTAssertEqual(try result.toInt32(), 100000)
+    }
+
+    func testInterruptIntervalIsClamped() throws {
+        let context = try MQJSContext()
+        XCTAssertEqual(context.interruptInterval, 10000)
+        context.interruptInterval = 0
+        XCTAssertEqual(context.interruptInterval, 1)
+        context.interruptInterval = 1_000_000
+        XCTAssertEqual(context.interruptInterval, 32767)
+    }
+}
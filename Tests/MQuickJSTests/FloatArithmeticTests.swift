@@ -0,0 +1,70 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the unboxed float64 paths of the interpreter
+final class FloatArithmeticTests: XCTestCase {
+
+    /// Runs `script` and returns the number of float64 heap allocations per loop iteration
+    private func allocationsPerIteration(_ context: MQJSContext, _ script: String, iterations: Int) throws -> Double {
+        let before = context.memoryStats.float64Allocations
+        try context.eval(script)
+        let after = context.memoryStats.float64Allocations
+        return Double(after - before) / Double(iterations)
+    }
+
+    func testNaNAndInfinityDoNotAllocate() throws {
+        let context = try MQJSContext(memorySize: 64 * 1024)
+        try context.eval("""
+            var data = [];
+            for (var i = 0; i < 1000; i++) data.push(i % 50 == 7 ? NaN : i * 0.25);
+        """)
+
+        let movingAverage = try allocationsPerIteration(context, """
+            var s = 0, lo = Infinity, hi = -Infinity;
+            for (var i = 0; i < 1000; i++) {
+                s += data[i];
+                if (i >= 16) s -= data[i - 16];
+                var x = s / 16 + 1 / (i % 2);
+                if (x < lo) lo = x;
+                if (x > hi) hi = x;
+            }
+        """, iterations: 1000)
+        XCTAssertEqual(movingAverage, 0)
+    }
+
+    func testMixedOperandsUseFloatPath() throws {
+        let context = try MQJSContext()
+        let geo = try allocationsPerIteration(context, """
+            var d = 0;
+            for (var i = 1; i < 500; i++) {
+                var p1 = (45 + i / 1000) * Math.PI / 180, p2 = p1 + 0.001, dl = 0.002 * i / 180;
+                var a = Math.pow(Math.sin((p2 - p1) / 2), 2) + Math.cos(p1) * Math.cos(p2) * Math.pow(Math.sin(dl / 2), 2);
+                d += 2 * 6371 * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a));
+            }
+        """, iterations: 500)
+        XCTAssertEqual(geo, 0)
+        XCTAssertEqual(try context.eval("Math.round(d)").toInt32(), 7246)
+    }
+
+    func testOutOfRangeValuesStillAllocate() throws {
+        let context = try MQJSContext()
+        let tiny = try allocationsPerIteration(context, "var t = 1e-200; for (var i = 0; i < 100; i++) t = t * 0.5;", iterations: 100)
+        // The literal constants are allocated when the script is compiled
+        XCTAssertEqual(tiny, 1, accuracy: 0.05)
+        XCTAssertEqual(try context.eval("t * Math.pow(2, 100) == 1e-200").toBool(), true)
+    }
+
+    func testSemantics() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var n = NaN, z = -0, x = 1.5, y = 0.5;
+            x++; --y;
+            [n == n, n !== n, n < 1, z === 0, 1 / z, 1 / (0 * -1), 1.5 + 1, 1 - 1.5, 2 * 0.25,
+             7 / 2, 6 / 3, 2.5 / 0, 0 / 0, x, y, 2 == 2.0, 1.5 < 2, -1e300 * 1e10,
+             'a' + 1.5, 1.5 * { valueOf: function () { return 2; } }, '2' > 1.5].join()
+        """)
+        XCTAssertEqual(try result.toString(),
+                       "false,true,false,true,-Infinity,-Infinity,2.5,-0.5,0.5,3.5,2,Infinity,NaN,2.5,-0.5," +
+                       "true,true,-Infinity,a1.5,3,true")
+    }
+}
@@ -0,0 +1,85 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for GC tuning (allocation budget, compaction threshold)
+final class GarbageCollectionTests: XCTestCase {
+
+    /// Allocates short-lived objects while keeping a live structure around
+    private let churnScript = """
+        var keep = [];
+        for (var i = 0; i < 200; i++) keep.push({ id: i, name: 'item' + i });
+        var sum = 0;
+        for (var n = 0; n < 20000; n++) {
+            var tmp = { a: n, b: [n, n + 1], s: 'x' + n };
+            sum += tmp.b[1] - tmp.a;
+            if ((n % 100) == 0) keep[n % 200] = { id: n, name: 'item' + n };
+        }
+        sum + keep.length
+    """
+
+    func testDefaultSettings() throws {
+        let context = try MQJSContext()
+        XCTAssertEqual(context.gcCompactionThreshold, 0)
+        XCTAssertEqual(context.gcAllocationBudget, 0)
+    }
+
+    func testChurnWithAllocationBudget() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        context.gcAllocationBudget = 16 * 1024
+        context.gcCompactionThreshold = 50
+
+        XCTAssertEqual(try context.eval(churnScript).toInt32(), 20200)
+        XCTAssertEqual(try context.eval("keep[199].name").toString(), "item199")
+    }
+
+    func testResultsMatchAcrossModes() throws {
+        let reference = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        let expected = try reference.eval(churnScript).toInt32()
+
+        for threshold in [1, 50, 100] {
+            let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+            context.gcCompactionThreshold = threshold
+            XCTAssertEqual(try context.eval(churnScript).toInt32(), expected, "threshold \(threshold)")
+        }
+    }
+
+    func testThresholdIsClamped() throws {
+        let context = try MQJSContext()
+        context.gcCompactionThreshold = 250
+        XCTAssertEqual(context.gcCompactionThreshold, 100)
+        context.gcCompactionThreshold = -1
+        XCTAssertEqual(context.gcCompactionThreshold, 0)
+    }
+
+    func testCollectLeavesHolesAndCompactRemovesThem() throws {
+        let context = try MQJSContext()
+        context.gcCompactionThreshold = 100
+        let value = try context.eval("""
+            var parts = [];
+            for (var i = 0; i < 500; i++) parts.push({ i: i });
+            var survivor = { tag: 'kept' };
+            parts = null;
+            survivor
+        """)
+
+        XCTAssertFalse(context.collectGarbage(budgetMicroseconds: 0))
+        XCTAssertGreaterThan(context.gcFragmentation, 0)
+        XCTAssertEqual(try value["tag"]?.toString(), "kept")
+
+        XCTAssertTrue(context.collectGarbage(budgetMicroseconds: 1_000_000))
+        XCTAssertEqual(context.gcFragmentation, 0)
+        XCTAssertEqual(try value["tag"]?.toString(), "kept")
+    }
+
+    func testSettingsSurviveRestore() throws {
+        let context = try MQJSContext()
+        let snapshot = try context.makeSnapshot()
+
+        context.gcAllocationBudget = 8 * 1024
+        context.gcCompactionThreshold = 30
+        try context.restore(snapshot)
+
+        XCTAssertEqual(try context.eval(churnScript).toInt32(), 20200)
+        XCTAssertEqual(context.gcCompactionThreshold, 30)
+    }
+}
@@ -0,0 +1,98 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests that property access stays correct with the interpreter's inline caches
+final class InlineCacheTests: XCTestCase {
+
+    func testCachedReadSeesUpdates() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var o = { a: 1, b: 2 }, sum = 0;
+            for (var i = 0; i < 100; i++) {
+                sum += o.a;
+                o.a = i;
+            }
+            sum
+        """)
+        XCTAssertEqual(try result.toInt32(), 1 + (0..<99).reduce(0, +))
+    }
+
+    func testDeleteAndRedefineInvalidates() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var o = { a: 1, b: 2 }, sum = 0;
+            for (var i = 0; i < 100; i++) {
+                sum += o.b;
+                if (i == 10) { delete o.b; }
+                if (i == 20) { o.b = 100; }
+            }
+            sum
+        """)
+        // 11 * 2, then NaN once undefined is added
+        XCTAssertTrue(try result.toDouble().isNaN)
+
+        let counted = try context.eval("""
+            var p = { x: 1 }, hits = 0;
+            for (var i = 0; i < 50; i++) {
+                if (p.x !== undefined) hits++;
+                if (i == 25) delete p.x;
+            }
+            hits
+        """)
+        XCTAssertEqual(try counted.toInt32(), 26)
+    }
+
+    func testAccessorIsNotCached() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var calls = 0, o = {};
+            Object.defineProperty(o, 'v', { get: function() { calls++; return 10; } });
+            var sum = 0;
+            for (var i = 0; i < 20; i++) sum += o.v;
+            sum + calls
+        """)
+        XCTAssertEqual(try result.toInt32(), 200 + 20)
+    }
+
+    func testGrowingObjectAndGC() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var o = { a: 1 }, sum = 0;
+            for (var i = 0; i < 200; i++) {
+                sum += o.a;
+                o['k' + i] = i;
+                if (i % 50 == 0) {
+                    var junk = [];
+                    for (var j = 0; j < 200; j++) junk.push({ j: j });
+                    gc();
+                }
+            }
+            sum + o.k199
+        """)
+        XCTAssertEqual(try result.toInt32(), 200 + 199)
+    }
+
+    func testSameSiteManyObjects() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            function get(o) { return o.v; }
+            var objs = [], total = 0;
+            for (var i = 0; i < 50; i++) objs.push(i % 2 ? { v: i } : { w: 0, v: i });
+            for (var r = 0; r < 4; r++)
+                for (var i = 0; i < 50; i++) total += get(objs[i]);
+            total
+        """)
+        XCTAssertEqual(try result.toInt32(), 4 * (0..<50).reduce(0, +))
+    }
+
+    func testCacheAfterSnapshotRestore() throws {
+        let context = try MQJSContext()
+        try context.eval("var o = { n: 1 }; function read() { var s = 0; for (var i = 0; i < 10; i++) s += o.n; return s; }")
+        let snapshot = try context.makeSnapshot()
+
+        try context.eval("read(); o = { pad: 0, n: 5 }; read()")
+        try context.restore(snapshot)
+
+        XCTAssertEqual(try context.eval("read()").toInt32(), 10)
+    }
+}
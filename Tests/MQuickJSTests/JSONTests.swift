@@ -0,0 +1,97 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for JSON.parse, JSON.stringify and parseJSON
+final class JSONTests: XCTestCase {
+
+    func testParseFromData() throws {
+        let context = try MQJSContext()
+        let data = Data(#"{"name": "café", "tags": ["a", "b"], "n": -2.5e3, "ok": true, "none": null}"#.utf8)
+
+        let value = try context.parseJSON(data: data)
+        XCTAssertEqual(try value["name"]!.toString(), "café")
+        XCTAssertEqual(try value["tags"]![1]!.toString(), "b")
+        XCTAssertEqual(try value["n"]!.toDouble(), -2500)
+        XCTAssertEqual(value["ok"]!.toBool(), true)
+        XCTAssertTrue(value["none"]!.isNull)
+    }
+
+    func testParseUnterminatedBuffer() throws {
+        let context = try MQJSContext()
+        // Only the first 7 bytes are JSON
+        let bytes: [UInt8] = Array("[1, 23]4567".utf8)
+
+        let value = try bytes.withUnsafeBufferPointer { buffer in
+            try context.parseJSON(utf8: UnsafeBufferPointer(rebasing: buffer[0..<7]))
+        }
+        XCTAssertEqual(try value["length"]!.toInt32(), 2)
+        XCTAssertEqual(try value[1]!.toInt32(), 23)
+    }
+
+    func testParseErrors() throws {
+        let context = try MQJSContext()
+        let invalid = ["", "{\"a\":}", "[1,]", "01", "1.", "\"\\x\"", "\"a\nb\"", "{\"a\" 1}", "[1] x"]
+        for text in invalid {
+            XCTAssertThrowsError(try context.parseJSON(text), "\(text)") { error in
+                guard case MQJSError.evaluationError(let message) = error else {
+                    return XCTFail("Unexpected error: \(error)")
+                }
+                XCTAssertTrue(message.contains("SyntaxError"), message)
+            }
+        }
+        XCTAssertThrowsError(try context.parseJSON(data: Data([0x22, 0xff, 0x22])))
+        XCTAssertThrowsError(try context.eval("JSON.parse('{\"a\": tru}')"))
+    }
+
+    func testParseStringsAndNumbers() throws {
+        let context = try MQJSContext()
+        let value = try context.parseJSON(#"["\u00e9\ud83d\ude00\n", "\ud800", 9007199254740993, 0.1, 1e400, -0, 123456789012]"#)
+
+        XCTAssertEqual(try value[0]!.toString(), "é😀\n")
+        XCTAssertEqual(try context.eval("(function(a) { return a[1].charCodeAt(0); })").call(withArguments: [value]).toInt32(), 0xd800)
+        XCTAssertEqual(try value[2]!.toDouble(), 9007199254740992)
+        XCTAssertEqual(try value[3]!.toDouble(), 0.1)
+        XCTAssertEqual(try value[4]!.toDouble(), .infinity)
+        XCTAssertEqual(try value[5]!.toDouble().sign, .minus)
+        XCTAssertEqual(try value[6]!.toDouble(), 123456789012)
+    }
+
+    func testKeysAndDuplicates() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var o = JSON.parse('{"length": 1, "b": 2, "0": 3, "": 4, "b": 5}');
+            Object.keys(o).join() + '|' + o.b + '|' + o[0]
+        """)
+        XCTAssertEqual(try result.toString(), "length,b,0,|5|3")
+    }
+
+    func testDeepNesting() throws {
+        let context = try MQJSContext(memorySize: 1024 * 1024)
+        let depth = 10_000
+        let json = String(repeating: "[", count: depth) + "1" + String(repeating: "]", count: depth)
+
+        var value = try context.parseJSON(json)
+        for _ in 0..<depth {
+            value = value[0]!
+        }
+        XCTAssertEqual(try value.toInt32(), 1)
+    }
+
+    func testStringifyRoundTrip() throws {
+        let context = try MQJSContext(memorySize: 256 * 1024)
+        let result = try context.eval("""
+            var items = [];
+            for (var i = 0; i < 500; i++)
+                items.push({ id: i, label: 'item "' + i + '"\\n', v: [i / 4, true, null], skip: undefined, f: function() {} });
+            var s = JSON.stringify(items);
+            s == JSON.stringify(JSON.parse(s)) ? s.slice(0, 60) : 'mismatch'
+        """)
+        XCTAssertEqual(try result.toString(), #"[{"id":0,"label":"item \"0\"\n","v":[0,true,null]},{"id":1,"#)
+    }
+
+    func testStringifyEscapes() throws {
+        let context = try MQJSContext()
+        let result = try context.eval(#"JSON.stringify({ s: "tab\t\u0001 é 😀 \ud800", 1: [NaN, 1e21], t: new Uint8Array(2) })"#)
+        XCTAssertEqual(try result.toString(), #"{"s":"tab\t\u0001 é 😀 \ud800","1":[null,1e+21],"t":{"0":0,"1":0}}"#)
+    }
+}
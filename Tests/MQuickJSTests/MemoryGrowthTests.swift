@@ -0,0 +1,113 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for growable context memory
+final class MemoryGrowthTests: XCTestCase {
+
+    func testFixedSizeByDefault() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForSimpleScripts)
+        XCTAssertEqual(context.maximumMemorySize, MQJSContext.memoryForSimpleScripts)
+
+        try context.eval("var data = []; for (var i = 0; i < 200; i++) data.push({ i: i });")
+        XCTAssertEqual(context.memorySize, MQJSContext.memoryForSimpleScripts)
+    }
+
+    func testGrowsBetweenCalls() throws {
+        let context = try MQJSContext(
+            memorySize: MQJSContext.memoryForSimpleScripts,
+            maximumMemorySize: MQJSContext.memoryForDevelopment
+        )
+        try context.eval("var data = [];")
+
+        for step in 0..<100 {
+            try context.eval("for (var i = 0; i < 50; i++) data.push({ step: \(step), name: 'item' + i });")
+        }
+
+        XCTAssertGreaterThan(context.memorySize, MQJSContext.memoryForSimpleScripts)
+        XCTAssertLessThanOrEqual(context.memorySize, MQJSContext.memoryForDevelopment)
+        XCTAssertEqual(try context.eval("data.length").toInt32(), 5000)
+        XCTAssertEqual(try context.eval("data[4999].step + ':' + data[4999].name").toString(), "99:item49")
+    }
+
+    func testNextCallSucceedsAfterOutOfMemory() throws {
+        let context = try MQJSContext(
+            memorySize: MQJSContext.memoryForSimpleScripts,
+            maximumMemorySize: MQJSContext.memoryForDevelopment
+        )
+        let script = "var big = []; for (var i = 0; i < 3000; i++) big.push({ i: i }); big.length"
+
+        XCTAssertThrowsError(try context.eval(script))
+        XCTAssertGreaterThan(context.memoryStats.outOfMemoryCount, 0)
+
+        var result: Int32?
+        for _ in 0..<6 where result == nil {
+            result = try? context.eval(script).toInt32()
+        }
+        XCTAssertEqual(result, 3000)
+    }
+
+    func testResizeKeepsValues() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForSimpleScripts)
+        let object = try context.eval("({ name: 'kept', list: [1, 2, 3], lookup: { a: 1, b: 2 } })")
+        try context.setFunction("twice") { args in
+            return try args[0].toInt32() * 2
+        }
+
+        try context.resizeMemory(to: MQJSContext.memoryForModerateScripts)
+        XCTAssertEqual(context.memorySize, MQJSContext.memoryForModerateScripts)
+
+        XCTAssertEqual(try object["name"]?.toString(), "kept")
+        XCTAssertEqual(try object["list"]?[2]?.toInt32(), 3)
+        context.globalObject["obj"] = object
+        XCTAssertEqual(try context.eval("obj.lookup.b + twice(obj.list.length)").toInt32(), 8)
+
+        try context.resizeMemory(to: MQJSContext.memoryForSimpleScripts)
+        XCTAssertEqual(try context.eval("obj.lookup.a").toInt32(), 1)
+    }
+
+    func testShrinkBelowLiveHeapThrows() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        try context.eval("var data = []; for (var i = 0; i < 2000; i++) data.push({ s: 'value' + i });")
+
+        XCTAssertThrowsError(try context.resizeMemory(to: MQJSContext.memoryForSimpleScripts)) { error in
+            guard case MQJSError.invalidMemorySize = error else {
+                XCTFail("Expected invalidMemorySize, got \(error)")
+                return
+            }
+        }
+        XCTAssertEqual(try context.eval("data.length").toInt32(), 2000)
+    }
+
+    func testResizeWhileRunningThrows() throws {
+        let context = try MQJSContext()
+        var thrown: Error?
+        try context.setFunction("resize") { [unowned context] _ in
+            do {
+                try context.resizeMemory(to: MQJSContext.memoryForDevelopment)
+            } catch {
+                thrown = error
+            }
+            return nil
+        }
+
+        try context.eval("resize()")
+        guard case MQJSError.memoryResizeError? = thrown else {
+            XCTFail("Expected memoryResizeError, got \(String(describing: thrown))")
+            return
+        }
+    }
+
+    func testSnapshotRestoresAfterGrowth() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForSimpleScripts)
+        try context.eval("var counter = 1;")
+        let snapshot = try context.makeSnapshot()
+
+        try context.resizeMemory(to: MQJSContext.memoryForComplexScripts)
+        try context.eval("counter = 50; var extra = {};")
+        try context.restore(snapshot)
+
+        XCTAssertEqual(try context.eval("counter").toInt32(), 1)
+        XCTAssertEqual(try context.eval("typeof extra").toString(), "undefined")
+        XCTAssertEqual(context.memorySize, MQJSContext.memoryForComplexScripts)
+    }
+}
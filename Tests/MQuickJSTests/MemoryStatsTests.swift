@@ -0,0 +1,67 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for heap and GC statistics
+final class MemoryStatsTests: XCTestCase {
+
+    func testFreshContext() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        let stats = context.memoryStats
+
+        XCTAssertEqual(stats.memorySize, MQJSContext.memoryForModerateScripts)
+        XCTAssertGreaterThan(stats.heapUsed, 0)
+        XCTAssertLessThan(stats.heapUsed + stats.heapFree, stats.memorySize)
+        XCTAssertGreaterThanOrEqual(stats.highWater, stats.heapUsed)
+        XCTAssertNil(stats.blocks)
+    }
+
+    func testGCCountersAdvance() throws {
+        let context = try MQJSContext()
+        let before = context.memoryStats
+
+        context.collectGarbage()
+        let after = context.memoryStats
+
+        XCTAssertEqual(after.gcCount, before.gcCount + 1)
+        XCTAssertEqual(after.compactionCount, before.compactionCount + 1)
+        XCTAssertGreaterThan(after.gcTime, before.gcTime)
+    }
+
+    func testHighWaterTracksPeakUsage() throws {
+        let context = try MQJSContext()
+        try context.eval("var big = []; for (var i = 0; i < 5000; i++) big.push({ i: i });")
+        let peak = context.memoryStats.heapUsed
+
+        try context.eval("big = null;")
+        context.collectGarbage()
+        let stats = context.memoryStats
+
+        XCTAssertLessThan(stats.heapUsed, peak)
+        XCTAssertGreaterThanOrEqual(stats.highWater, peak)
+        XCTAssertGreaterThan(stats.lastCompactionBytesMoved, 0)
+    }
+
+    func testBlockCountsCoverTheHeap() throws {
+        let context = try MQJSContext()
+        try context.eval("var objects = []; for (var i = 0; i < 100; i++) objects.push({ name: 'o' + i });")
+
+        let stats = context.memoryStats(countingBlocks: true)
+        let blocks = try XCTUnwrap(stats.blocks)
+
+        XCTAssertGreaterThanOrEqual(blocks[.object]?.count ?? 0, 100)
+        XCTAssertGreaterThan(blocks[.string]?.bytes ?? 0, 0)
+        XCTAssertEqual(blocks.values.reduce(0) { $0 + $1.bytes }, stats.heapUsed + (blocks[.free]?.bytes ?? 0))
+    }
+
+    func testCountersSurviveRestore() throws {
+        let context = try MQJSContext()
+        let snapshot = try context.makeSnapshot()
+
+        context.collectGarbage()
+        context.collectGarbage()
+        let count = context.memoryStats.gcCount
+        try context.restore(snapshot)
+
+        XCTAssertEqual(context.memoryStats.gcCount, count)
+    }
+}
@@ -252,4 +252,144 @@ final class NativeFunctionTests: XCTestCase {
         let result = try context.eval("getFullName({ firstName: 'John', lastName: 'Doe' })")
         XCTAssertEqual(try result.toString(), "John Doe")
     }
+
+    // MARK: - Fast Native Functions
+
+    func testFastFunctionTypedArguments() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("mix") { args in
+            let a = try args.int32(at: 0)
+            let b = try args.double(at: 1)
+            return .double(Double(a) * b)
+        }
+
+        XCTAssertEqual(try context.eval("mix(3, 1.5)").toDouble(), 4.5)
+        XCTAssertEqual(try context.eval("mix('4', '0.25')").toDouble(), 1.0)
+    }
+
+    func testFastFunctionStringArguments() throws {
+        let context = try MQJSContext()
+        var logged: [String] = []
+
+        try context.setFastFunction("log") { args in
+            logged.append(try args.utf8String(at: 0))
+            return .undefined
+        }
+
+        try context.eval("log('héllo'); log(42); log({ toString: function() { return 'obj'; } })")
+        XCTAssertEqual(logged, ["héllo", "42", "obj"])
+    }
+
+    func testFastFunctionBorrowedUTF8() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("byteLength") { args in
+            return .int32(try args.withUTF8(at: 0) { Int32($0.count) })
+        }
+
+        XCTAssertEqual(try context.eval("byteLength('abc')").toInt32(), 3)
+        XCTAssertEqual(try context.eval("byteLength('é')").toInt32(), 2)
+    }
+
+    func testFastFunctionMissingArguments() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("describe") { args in
+            return .string("\(args.count):\(args.isUndefined(at: 0)):\(args.bool(at: 1) as Any)")
+        }
+
+        XCTAssertEqual(try context.eval("describe()").toString(), "0:true:nil")
+        XCTAssertEqual(try context.eval("describe(1, true)").toString(), "2:false:Optional(true)")
+    }
+
+    func testFastFunctionLiteralResults() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("answer") { _ in 42 }
+        try context.setFastFunction("name") { _ in "mquickjs" }
+        try context.setFastFunction("nothing") { _ in .null }
+
+        XCTAssertEqual(try context.eval("answer()").toInt32(), 42)
+        XCTAssertEqual(try context.eval("name()").toString(), "mquickjs")
+        XCTAssertTrue(try context.eval("nothing()").isNull)
+    }
+
+    func testFastFunctionValueArgument() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("first") { args in
+            return .value(args.value(at: 0)[0]!)
+        }
+
+        XCTAssertEqual(try context.eval("first([7, 8, 9])").toInt32(), 7)
+    }
+
+    func testFastFunctionThrows() throws {
+        let context = try MQJSContext()
+
+        try context.setFastFunction("fail") { _ in
+            throw MQJSError.nativeFunctionError("nope")
+        }
+
+        let result = try context.eval("try { fail(); 'no' } catch (e) { 'caught' }")
+        XCTAssertEqual(try result.toString(), "caught")
+    }
+
+    func testFastFunctionOnObject() throws {
+        let context = try MQJSContext()
+        let math = try context.eval("var fastMath = {}; fastMath")
+
+        try context.setFastFunction("square", on: math) { args in
+            let n = try args.int32(at: 0)
+            return .int32(n &* n)
+        }
+
+        XCTAssertEqual(try context.eval("fastMath.square(12)").toInt32(), 144)
+    }
+
+    func testFastFunctionInLoop() throws {
+        let context = try MQJSContext()
+        var calls = 0
+
+        try context.setFastFunction("tick") { args in
+            calls += 1
+            return .int32(try args.int32(at: 0) + 1)
+        }
+
+        let result = try context.eval("var n = 0; for (var i = 0; i < 10000; i++) n = tick(n); n")
+        XCTAssertEqual(try result.toInt32(), 10000)
+        XCTAssertEqual(calls, 10000)
+    }
+
+    func testNativeCallsFromConcurrentContexts() throws {
+        let results = NSLock()
+        var totals: [Int32] = []
+
+        DispatchQueue.concurrentPerform(iterations: 8) { i in
+            guard let context = try? MQJSContext() else { return }
+            let offset = Int32(i)
+            try? context.setFastFunction("add") { args in
+                return .int32(try args.int32(at: 0) + offset)
+            }
+            let total = try? context.eval("var n = 0; for (var i = 0; i < 5000; i++) n = add(n); n").toInt32()
+            results.lock()
+            totals.append(total ?? -1)
+            results.unlock()
+        }
+
+        XCTAssertEqual(totals.sorted(), (0..<8).map { Int32($0 * 5000) })
+    }
+
+    func testNativeFunctionsAreResolvedPerContext() throws {
+        let first = try MQJSContext()
+        let second = try MQJSContext()
+        try first.setFunction("which") { _ in "first" }
+        try second.setFunction("other") { _ in "other" }
+        try second.setFunction("which") { _ in "second" }
+
+        // IDs are per context: first.which and second.other share ID 0
+        XCTAssertEqual(try first.eval("which()").toString(), "first")
+        XCTAssertEqual(try second.eval("which() + other()").toString(), "secondother")
+    }
 }
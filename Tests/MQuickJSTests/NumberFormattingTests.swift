@@ -0,0 +1,63 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for number to string conversion
+final class NumberFormattingTests: XCTestCase {
+
+    func testShortestRoundTrip() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            [0.1, 0.1 + 0.2, 1 / 3, -2.5, 123.456, 5e-324, 1.7976931348623157e308,
+             2.2250738585072014e-308, 2 ** -1017, 9007199254740993, 1.5e300].join(' ')
+        """)
+        XCTAssertEqual(try result.toString(),
+                       "0.1 0.30000000000000004 0.3333333333333333 -2.5 123.456 5e-324 " +
+                       "1.7976931348623157e+308 2.2250738585072014e-308 7.120236347223045e-307 " +
+                       "9007199254740992 1.5e+300")
+    }
+
+    func testExponentThresholds() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            [1e21, 1e20, 123e18, 1e-6, 1e-7, 1.25e-7, -0, 0, NaN, -Infinity].join(' ')
+        """)
+        XCTAssertEqual(try result.toString(),
+                       "1e+21 100000000000000000000 123000000000000000000 0.000001 1e-7 " +
+                       "1.25e-7 0 0 NaN -Infinity")
+    }
+
+    func testRoundTripThroughParse() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            (function () {
+                var seed = 1, bad = 0;
+                for (var i = 0; i < 20000; i++) {
+                    seed = (seed * 1103515245 + 12345) % 2147483648;
+                    var x = (seed / 2147483648 - 0.5) * Math.pow(10, (i % 40) - 20);
+                    if (parseFloat(String(x)) !== x)
+                        bad++;
+                }
+                return bad;
+            })()
+        """)
+        XCTAssertEqual(try result.toInt32(), 0)
+    }
+
+    func testIntegersAndRadixFormats() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            [0, 7, 10, 99, 100, 12345, -2147483648, 4294967295, 2 ** 53 + 2,
+             (255).toString(16), (0.5).toString(2), (1.5).toExponential(),
+             (123.456).toFixed(1), (123.456).toPrecision(4)].join(' ')
+        """)
+        XCTAssertEqual(try result.toString(),
+                       "0 7 10 99 100 12345 -2147483648 4294967295 9007199254740994 " +
+                       "ff 0.1 1.5e+0 123.5 123.5")
+    }
+
+    func testStringifyNumbers() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("JSON.stringify({ a: 0.1, b: [1e21, -0, 1e-7, 42, NaN], c: 2 ** 31 })")
+        XCTAssertEqual(try result.toString(), #"{"a":0.1,"b":[1e+21,0,1e-7,42,null],"c":2147483648}"#)
+    }
+}
@@ -0,0 +1,93 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the sampling profiler and opcode counters
+final class ProfilerTests: XCTestCase {
+
+    private let script = """
+        function leaf(x) { return x * 2; }
+        function middle(n) {
+            var s = 0;
+            for (var i = 0; i < n; i++) s += leaf(i);
+            return s;
+        }
+        function outer() {
+            var t = 0;
+            for (var k = 0; k < 200; k++) t += middle(100);
+            return t;
+        }
+        outer();
+    """
+
+    func testEmptyWithoutProfiling() throws {
+        let context = try MQJSContext()
+        try context.eval("1 + 2")
+
+        let profile = context.profile()
+        XCTAssertEqual(profile.sampleCount, 0)
+        XCTAssertTrue(profile.opcodeCounts.isEmpty)
+        XCTAssertEqual(profile.collapsedStacks, "")
+    }
+
+    func testSamplesCallStacks() throws {
+        let context = try MQJSContext()
+        try context.startProfiling(sampleInterval: 10)
+        XCTAssertEqual(try context.eval(script, filename: "profiled.js").toInt32(), 1980000)
+        let profile = context.stopProfiling()
+
+        XCTAssertGreaterThan(profile.sampleCount, 100)
+        XCTAssertTrue(profile.samples.keys.contains { stack in
+            stack.hasPrefix("<eval> (profiled.js:") && stack.contains(";outer (profiled.js:")
+                && stack.contains(";middle (profiled.js:")
+        })
+        XCTAssertTrue(profile.selfSamples.keys.contains { $0.hasPrefix("middle (profiled.js:") })
+    }
+
+    func testCollapsedStacksFormat() throws {
+        let context = try MQJSContext()
+        try context.startProfiling(sampleInterval: 10)
+        try context.eval(script, filename: "profiled.js")
+        let profile = context.stopProfiling()
+
+        let lines = profile.collapsedStacks.split(separator: "\n")
+        XCTAssertEqual(lines.count, profile.samples.count)
+        var total = 0
+        for line in lines {
+            let count = try XCTUnwrap(line.split(separator: " ").last.flatMap { Int($0) })
+            total += count
+        }
+        XCTAssertEqual(total, profile.sampleCount)
+    }
+
+    func testOpcodeCounts() throws {
+        let context = try MQJSContext()
+        try context.startProfiling(countOpcodes: true)
+        try context.eval(script)
+        let profile = context.stopProfiling()
+
+        XCTAssertGreaterThanOrEqual(profile.opcodeCounts["call"] ?? 0, 20000)
+        XCTAssertGreaterThan(profile.opcodeCounts.values.reduce(0, +), 100000)
+    }
+
+    func testStopDisablesSampling() throws {
+        let context = try MQJSContext()
+        try context.startProfiling(sampleInterval: 1)
+        try context.eval(script)
+        context.stopProfiling()
+
+        try context.eval(script)
+        XCTAssertEqual(context.profile().sampleCount, 0)
+    }
+
+    func testProfilingSurvivesRestoreAndResize() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForModerateScripts)
+        let snapshot = try context.makeSnapshot()
+        try context.startProfiling(sampleInterval: 10)
+
+        try context.restore(snapshot)
+        try context.resizeMemory(to: MQJSContext.memoryForComplexScripts)
+        try context.eval(script)
+
+        XCTAssertGreaterThan(context.stopProfiling().sampleCount, 0)
+    }
+}
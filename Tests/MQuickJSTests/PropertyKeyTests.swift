@@ -0,0 +1,107 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for pre-interned property keys
+final class PropertyKeyTests: XCTestCase {
+
+    func testGetAndSet() throws {
+        let context = try MQJSContext()
+        let object = try context.eval("({ count: 1 })")
+        let key = try context.propertyKey("count")
+
+        XCTAssertEqual(key.name, "count")
+        XCTAssertEqual(try object[key]?.toInt32(), 1)
+
+        for _ in 0..<100 {
+            let count = try object[key]!.toInt32()
+            object[key] = try (count + 1).toJSValue(in: context)
+        }
+        XCTAssertEqual(try object["count"]?.toInt32(), 101)
+    }
+
+    func testNewPropertyAndMissingProperty() throws {
+        let context = try MQJSContext()
+        let object = try context.eval("({})")
+        let key = try context.propertyKey("added")
+
+        XCTAssertTrue(object[key]?.isUndefined ?? false)
+        object[key] = try "value".toJSValue(in: context)
+        XCTAssertEqual(try object["added"]?.toString(), "value")
+    }
+
+    func testHasProperty() throws {
+        let context = try MQJSContext()
+        let object = try context.eval("({ own: 1, __proto__: { inherited: 2 } })")
+
+        XCTAssertTrue(object.hasProperty(try context.propertyKey("own")))
+        XCTAssertTrue(object.hasProperty(try context.propertyKey("inherited")))
+        XCTAssertTrue(object.hasProperty(try context.propertyKey("toString")))
+        XCTAssertFalse(object.hasProperty(try context.propertyKey("missing")))
+
+        let number = try context.eval("42")
+        XCTAssertFalse(number.hasProperty(try context.propertyKey("own")))
+    }
+
+    func testIndexKeys() throws {
+        let context = try MQJSContext()
+        let array = try context.eval("[10, 20, 30]")
+        let index = try context.propertyKey("1")
+        let length = try context.propertyKey("length")
+
+        XCTAssertEqual(try array[index]?.toInt32(), 20)
+        XCTAssertEqual(try array[length]?.toInt32(), 3)
+        XCTAssertTrue(array.hasProperty(index))
+        XCTAssertFalse(array.hasProperty(try context.propertyKey("3")))
+
+        array[index] = try 99.toJSValue(in: context)
+        XCTAssertEqual(try array[1]?.toInt32(), 99)
+    }
+
+    func testKeySurvivesGarbageCollection() throws {
+        let context = try MQJSContext()
+        let key = try context.propertyKey("value")
+        let object = try context.eval("({ value: 'kept' })")
+
+        _ = try context.eval("var junk = []; for (var i = 0; i < 1000; i++) junk.push({ i: i }); junk = null;")
+        context.collectGarbage()
+
+        XCTAssertEqual(try object[key]?.toString(), "kept")
+    }
+
+    func testKeyAfterRestore() throws {
+        let context = try MQJSContext()
+        _ = try context.eval("var state = { n: 1 };")
+        let key = try context.propertyKey("n")
+        let snapshot = try context.makeSnapshot()
+
+        _ = try context.eval("state.n = 2;")
+        try context.restore(snapshot)
+
+        let state = try context.eval("state")
+        XCTAssertEqual(try state[key]?.toInt32(), 1)
+    }
+
+    func testKeyFromOtherContext() throws {
+        let context = try MQJSContext()
+        let other = try MQJSContext()
+        let key = try other.propertyKey("x")
+        let object = try context.eval("({ x: 5 })")
+
+        XCTAssertEqual(try object[key]?.toInt32(), 5)
+        XCTAssertTrue(object.hasProperty(key))
+        object[key] = try 6.toJSValue(in: context)
+        XCTAssertEqual(try object["x"]?.toInt32(), 6)
+    }
+
+    func testGetterAndSetter() throws {
+        let context = try MQJSContext()
+        let object = try context.eval("""
+            ({ _v: 1, get v() { return this._v * 10; }, set v(x) { this._v = x; } })
+        """)
+        let key = try context.propertyKey("v")
+
+        XCTAssertEqual(try object[key]?.toInt32(), 10)
+        object[key] = try 3.toJSValue(in: context)
+        XCTAssertEqual(try object[key]?.toInt32(), 30)
+    }
+}
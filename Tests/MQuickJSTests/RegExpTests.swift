@@ -0,0 +1,69 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for regular expression matching, including the start position scan
+/// and the RegExp constructor cache
+final class RegExpTests: XCTestCase {
+
+    func testLiteralPrefix() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var line = '';
+            for (var i = 0; i < 500; i++) line += 'ok ';
+            var m = /ERROR: (\\w+)/.exec(line + 'ERROR: timeout');
+            [m.index, m[1], /ERROR/.exec(line), /RR/.exec('ERROR').index, /OR$/.exec('ERROR').index].join()
+        """)
+        XCTAssertEqual(try result.toString(), "1500,timeout,,1,3")
+    }
+
+    func testFirstCharacterSet() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var line = '';
+            for (var i = 0; i < 500; i++) line += 'ok ';
+            [(line + 'Warn').search(/[Ww]arn/),
+             'an ERROR, an Error'.match(/error/gi).join(),
+             'a1b22c333'.split(/\\d+/).join('|')].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "1500;ERROR,Error;a|b|c|")
+    }
+
+    func testNonASCIIFirstCharacter() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("'café crème'.replace(/é/g, 'e')")
+        XCTAssertEqual(try result.toString(), "cafe crème")
+    }
+
+    func testEmptyMatchesAndAssertions() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            ['abc'.replace(/x*/, '-'), 'xaxbx'.search(/x*b/),
+             'abc abc'.replace(/^abc/g, 'X'), 'sword word'.search(/\\bword/),
+             'ab ac'.replace(/a(?!b)/, 'X'), 'line1\\nabc'.search(/^abc/m)].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "-abc;2;X abc;6;ab Xc;6")
+    }
+
+    func testConstructorInLoop() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var res = [];
+            for (var i = 0; i < 3; i++) {
+                var re = new RegExp('b', i == 1 ? 'gi' : 'g');
+                res.push('aBcb'.replace(re, '-'));
+            }
+            res.join()
+        """)
+        XCTAssertEqual(try result.toString(), "aBc-,a-c-,aBc-")
+    }
+
+    func testCachedRegExpsAreDistinctObjects() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = new RegExp('o', 'g'), b = new RegExp('o', 'g');
+            a.exec('foo');
+            [a.lastIndex, b.lastIndex, a === b, b.source, b.flags].join()
+        """)
+        XCTAssertEqual(try result.toString(), "2,0,false,o,g")
+    }
+}
@@ -0,0 +1,90 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the values rooted in withScope scopes
+final class ScopeTests: XCTestCase {
+
+    func testValuesAreRootedInScope() throws {
+        let context = try MQJSContext(memorySize: 64 * 1024)
+        try context.eval("var items = []; for (var i = 0; i < 500; i++) items.push({ price: i, name: 'item' + i })")
+
+        let total = try context.withScope { scope -> Double in
+            let items = context.globalObject["items"]!
+            var sum = 0.0
+            for i in 0..<500 {
+                let item = items[i]!
+                _ = try item["name"]!.toString()
+                sum += try item["price"]!.toDouble()
+            }
+            context.collectGarbage()
+            XCTAssertEqual(try items[499]!["name"]!.toString(), "item499")
+            XCTAssertGreaterThan(scope.valueCount, 1500)
+            return sum
+        }
+        XCTAssertEqual(total, 124_750)
+    }
+
+    func testValuesAreInvalidAfterScope() throws {
+        let context = try MQJSContext()
+        var leaked: MQJSValue?
+        let escaped = try context.withScope { scope -> MQJSValue in
+            let value = try context.eval("({ answer: 42 })")
+            leaked = value
+            return try scope.escape(value)
+        }
+        context.collectGarbage()
+
+        XCTAssertThrowsError(try leaked!.toString()) { error in
+            guard case MQJSError.invalidValue = error else {
+                return XCTFail("Unexpected error: \(error)")
+            }
+        }
+        XCTAssertEqual(try escaped["answer"]!.toInt32(), 42)
+    }
+
+    func testNestedScopes() throws {
+        let context = try MQJSContext()
+        let result = try context.withScope { outer -> String in
+            let a = try context.eval("'outer'")
+            let inner = try context.withScope { inner -> MQJSValue in
+                _ = try context.eval("[1, 2, 3]")
+                return try inner.escape(try context.eval("'inner'"))
+            }
+            _ = try context.eval("({})")
+            XCTAssertEqual(outer.valueCount, 2)
+            return try a.toString() + "," + inner.toString()
+        }
+        XCTAssertEqual(result, "outer,inner")
+    }
+
+    func testNativeCallbackInsideScope() throws {
+        let context = try MQJSContext()
+        var captured: MQJSValue?
+        try context.setFunction("keep") { args in
+            captured = args[0]
+            return args[0]
+        }
+
+        let length = try context.withScope { _ in
+            try context.eval("keep([1, 2, 3, 4])")["length"]!.toInt32()
+        }
+        context.collectGarbage()
+
+        // The arguments of the native call are not part of the caller's scope
+        XCTAssertEqual(length, 4)
+        XCTAssertEqual(try captured!["length"]!.toInt32(), 4)
+    }
+
+    func testScopeIsReleasedOnError() throws {
+        let context = try MQJSContext()
+        XCTAssertThrowsError(try context.withScope { _ in
+            _ = try context.eval("({ a: 1 })")
+            _ = try context.eval("throw new Error('boom')")
+        })
+        XCTAssertThrowsError(try context.withScope { _ in try context.makeSnapshot() })
+
+        let snapshot = try context.makeSnapshot()
+        try context.restore(snapshot)
+        XCTAssertEqual(try context.eval("1 + 1").toInt32(), 2)
+    }
+}
@@ -0,0 +1,108 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for Array.prototype.sort and TypedArray.prototype.sort
+final class SortTests: XCTestCase {
+
+    func testDefaultOrderComparesStrings() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("[5, 3, 10, 1, 100, -2, 20, 'b', 'a', undefined].sort().join()")
+        XCTAssertEqual(try result.toString(), "-2,1,10,100,20,3,5,a,b,")
+    }
+
+    func testNumericComparators() throws {
+        let context = try MQJSContext()
+        let ascending = try context.eval("[5, 3.5, 10, -1, 100].sort(function(a, b) { return a - b; }).join()")
+        XCTAssertEqual(try ascending.toString(), "-1,3.5,5,10,100")
+
+        let descending = try context.eval("[5, 3.5, 10, -1, 100].sort(function(a, b) { return b - a; }).join()")
+        XCTAssertEqual(try descending.toString(), "100,10,5,3.5,-1")
+
+        // Not numbers: the comparator is called and converts its operands
+        let strings = try context.eval("['10', '9', '1'].sort(function(a, b) { return a - b; }).join()")
+        XCTAssertEqual(try strings.toString(), "1,9,10")
+    }
+
+    func testStable() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = [];
+            for (var i = 0; i < 2000; i++) a.push({ key: i % 7, index: i });
+            a.sort(function(x, y) { return x.key - y.key; });
+            var ok = true;
+            for (var i = 1; i < a.length; i++) {
+                if (a[i - 1].key > a[i].key ||
+                    (a[i - 1].key == a[i].key && a[i - 1].index > a[i].index)) ok = false;
+            }
+            ok
+        """)
+        XCTAssertTrue(result.toBool() ?? false)
+    }
+
+    func testLargeAndNearlySorted() throws {
+        let context = try MQJSContext(memorySize: MQJSContext.memoryForComplexScripts)
+        let result = try context.eval("""
+            function isSorted(a) {
+                for (var i = 1; i < a.length; i++) if (a[i - 1] > a[i]) return false;
+                return true;
+            }
+            var seed = 1;
+            function random() { seed = (seed * 1103515245 + 12345) % 2147483648; return seed; }
+            var nearly = [], reversed = [], shuffled = [];
+            for (var i = 0; i < 10000; i++) {
+                nearly.push(i);
+                reversed.push(10000 - i);
+                shuffled.push(random() % 1000);
+            }
+            nearly[100] = 5; nearly[7500] = 3;
+            var byValue = function(a, b) { return a < b ? -1 : a > b ? 1 : 0; };
+            isSorted(nearly.sort(byValue)) && isSorted(reversed.sort(byValue)) &&
+                isSorted(shuffled.sort(function(a, b) { return a - b; }))
+        """)
+        XCTAssertTrue(result.toBool() ?? false)
+    }
+
+    func testComparatorExceptionPropagates() throws {
+        let context = try MQJSContext()
+        XCTAssertThrowsError(try context.eval("[3, 2, 1].sort(function() { throw new Error('boom'); })"))
+        XCTAssertThrowsError(try context.eval("new Int8Array(3).sort(function() { throw new Error('boom'); })"))
+    }
+
+    func testInconsistentComparator() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = [];
+            for (var i = 0; i < 500; i++) a.push(i % 13);
+            var n = 0;
+            a.sort(function() { n++; return n % 3 - 1; });
+            a.length
+        """)
+        XCTAssertEqual(try result.toInt32(), 500)
+    }
+
+    func testTypedArraySort() throws {
+        let context = try MQJSContext()
+        let ints = try context.eval("Array.prototype.join.call(new Int16Array([5, -3, 10, 1, 100]).sort())")
+        XCTAssertEqual(try ints.toString(), "-3,1,5,10,100")
+
+        // Numeric order with -0 before +0 and NaN last
+        let floats = try context.eval("""
+            var f = new Float64Array([3.5, NaN, 0, -0, -Infinity, 1.25]).sort();
+            [f[0], f[1], 1 / f[1], f[2], 1 / f[2], f[5]].join()
+        """)
+        XCTAssertEqual(try floats.toString(), "-Infinity,0,-Infinity,0,Infinity,NaN")
+
+        let custom = try context.eval("""
+            var u = new Uint32Array([4000000000, 1, 3000000000, 2]);
+            Array.prototype.join.call(u.sort(function(a, b) { return a < b ? 1 : a > b ? -1 : 0; }))
+        """)
+        XCTAssertEqual(try custom.toString(), "4000000000,3000000000,2,1")
+
+        let view = try context.eval("""
+            var bytes = new Uint8Array([9, 8, 7, 6, 5, 4]);
+            bytes.subarray(1, 5).sort();
+            Array.prototype.join.call(bytes)
+        """)
+        XCTAssertEqual(try view.toString(), "9,5,6,7,8,4")
+    }
+}
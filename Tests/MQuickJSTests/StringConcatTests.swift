@@ -0,0 +1,68 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for in-place string building with `+=` on local variables
+final class StringConcatTests: XCTestCase {
+
+    func testAppendInLoop() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            (function () {
+                var s = '';
+                for (var i = 0; i < 2000; i++) s += '<td>' + i + '</td>';
+                return [s.length, s.slice(0, 10), s.slice(-13)].join();
+            })()
+        """)
+        XCTAssertEqual(try result.toString(), "24890,<td>0</td>,<td>1999</td>")
+    }
+
+    func testIntermediateValuesAreUnchanged() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            (function () {
+                var s = new Array(301).join('a'), parts = [], t;
+                for (var i = 0; i < 3; i++) {
+                    s += i;
+                    parts.push(s);
+                }
+                t = s;
+                s += 'end';
+                var r = (s += '!');
+                return [parts[0].length, parts[2].length, t.length, s.length, r === s].join();
+            })()
+        """)
+        XCTAssertEqual(try result.toString(), "301,303,303,307,true")
+    }
+
+    func testClosuresAndConversions() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            (function () {
+                var s = new Array(301).join('b');
+                function len() { return s.length; }
+                var o = { toString: function () { return '[' + len() + ']'; } };
+                s += 'x';
+                s += o;
+                s += len();
+                s += (s = 'y');
+                return s.slice(-12);
+            })()
+        """)
+        XCTAssertEqual(try result.toString(), "bbx[301]306y")
+    }
+
+    func testNumbersAndSurrogatePairs() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            (function () {
+                var n = 1, s = new Array(301).join('c'), p = '😀';
+                n += 0.5;
+                n += 0x7fffffff;
+                s += p[0];
+                s += p[1];
+                return [n, s.length, s.codePointAt(300)].join();
+            })()
+        """)
+        XCTAssertEqual(try result.toString(), "2147483648.5,302,128512")
+    }
+}
@@ -0,0 +1,57 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the string search, trim and case conversion functions and for
+/// string conversion between Swift and JavaScript
+final class StringSearchTests: XCTestCase {
+
+    func testIndexOfLongASCIIString() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var line = '';
+            for (var i = 0; i < 500; i++) line += 'key' + i + '=v; ';
+            [line.indexOf('key499='), line.indexOf('key1', 10), line.lastIndexOf('key0='),
+             line.lastIndexOf('key1', 30), line.indexOf('missing'), line.split('; ').length].join()
+        """)
+        XCTAssertEqual(try result.toString(), "4880,80,0,8,-1,501")
+    }
+
+    func testIndexOfNonASCII() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var s = 'crème brûlée, café, 😀 crème';
+            [s.indexOf('crème'), s.lastIndexOf('crème'), s.indexOf('café'), s.indexOf('😀'),
+             s.indexOf('\\ude00'), s.lastIndexOf('\\ud83d'), s.split('é').length].join()
+        """)
+        XCTAssertEqual(try result.toString(), "0,23,14,20,21,20,3")
+    }
+
+    func testTrim() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            JSON.stringify([' \\t a b \\n'.trim(), '\\u3000\\u00a0é \\u2028'.trim(),
+                            '  x  '.trimStart(), '  x  '.trimEnd(), '   '.trim()])
+        """)
+        XCTAssertEqual(try result.toString(), #"["a b","é","x  ","  x",""]"#)
+    }
+
+    func testCaseConversion() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var s = '';
+            for (var i = 0; i < 10; i++) s += 'Hello, World [@`{] é ';
+            var u = s.toUpperCase(), l = s.toLowerCase();
+            [u.slice(0, 21), l.slice(0, 21), u.length, 'z'.toUpperCase(), '😀'.toLowerCase()].join('|')
+        """)
+        XCTAssertEqual(try result.toString(), "HELLO, WORLD [@`{] é |hello, world [@`{] é |210|Z|😀")
+    }
+
+    func testSwiftStringRoundTrip() throws {
+        let context = try MQJSContext()
+        let string = "héllo\u{0}wörld 😀"
+        let value = try string.toJSValue(in: context)
+        XCTAssertEqual(try value.toString(), string)
+        context.globalObject["s"] = value
+        XCTAssertEqual(try context.eval("s.length").toInt32(), 14)
+    }
+}
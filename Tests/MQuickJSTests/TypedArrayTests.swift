@@ -0,0 +1,91 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for the typed array bulk operations (set, fill, slice, subarray,
+/// copyWithin) and element access
+final class TypedArrayTests: XCTestCase {
+
+    func testFill() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var f = new Float64Array(6); f.fill(1.5); f.fill(-2, 1, 3); f.fill(0, -2);
+            var u = new Uint8Array(3).fill(300), c = new Uint8ClampedArray(3).fill(300);
+            [f.join(), u.join(), c.join(), new Int16Array(2).fill(0x10203).join()].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "1.5,-2,-2,1.5,0,0;44,44,44;255,255,255;515,515")
+    }
+
+    func testSliceCopiesAndSubarrayShares() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = new Int32Array([1, 2, 3, 4, 5, 6, 7, 8]);
+            var s = a.slice(2, 5), sub = a.subarray(2, 6);
+            s[0] = 0; sub[0] = 30;
+            [s.join(), s instanceof Int32Array, sub.join(), sub.byteOffset, a.subarray(8).length, a[2]].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "0,4,5;true;30,4,5,6;8;0;30")
+    }
+
+    func testCopyWithin() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = new Int32Array([1, 2, 3, 4, 5, 6, 7, 8]), b = new Int32Array([1, 2, 3, 4, 5, 6, 7, 8]);
+            a.copyWithin(0, 3); b.copyWithin(3, 0, 4);
+            [a.join(), b.join(), new Int32Array([1, 2, 3, 4, 5]).copyWithin(-2, -4, -3).join()].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "4,5,6,7,8,6,7,8;1,2,3,1,2,3,4,8;1,2,3,2,5")
+    }
+
+    func testSetConvertsElements() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var d = new Float64Array(6);
+            d.set([1, 2.5, '3', true]); d.set(new Int8Array([-1, 9]), 4);
+            var u8 = new Uint8Array(3), cl = new Uint8ClampedArray(3), i32 = new Int32Array(3);
+            u8.set(new Int8Array([-1, -128, 5])); cl.set(new Int8Array([-1, -128, 5]));
+            i32.set(new Float64Array([1.7, -2.9, 4294967297]));
+            var err = ''; try { d.set([1, 2, 3], 4); } catch (e) { err = e.name; }
+            [d.join(), u8.join(), cl.join(), i32.join(), err].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "1,2.5,3,1,-1,9;255,128,5;0,0,5;1,-2,1;RangeError")
+    }
+
+    func testSetFromPrimitives() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var a = new Uint8Array(4);
+            a.set(5); a.set(5, 4); a.set(true);
+            var before = a.join();
+            a.set('12'); a.set('9', 3);
+            var errors = [];
+            try { a.set('12', 3); } catch (e1) { errors.push(e1.name); }
+            try { a.set(null); } catch (e2) { errors.push(e2.name); }
+            try { a.set(); } catch (e3) { errors.push(e3.name); }
+            [before, a.join(), errors.join()].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "0,0,0,0;1,2,0,9;RangeError,TypeError,TypeError")
+    }
+
+    func testSetOverlappingViews() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var bytes = new Uint8Array(8);
+            for (var i = 0; i < 8; i++) bytes[i] = i + 1;
+            bytes.set(new Uint16Array(bytes.buffer, 0, 2), 1);
+            var same = new Uint8Array([1, 2, 3, 4, 5, 6]); same.set(same.subarray(0, 4), 2);
+            [bytes.join(), same.join()].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "1,1,3,4,5,6,7,8;1,2,1,2,3,4")
+    }
+
+    func testElementAccess() throws {
+        let context = try MQJSContext()
+        let result = try context.eval("""
+            var x = new Float32Array(4), y = new Uint8ClampedArray(2), z = new Int16Array(2);
+            x[0] = 0.5; x[1] = 1 / 3; x[2] = '2'; x[3] = { valueOf: function() { return 7; } };
+            y[0] = -3; y[1] = 254.5; z[0] = 40000; z[1] = -1.9;
+            [x.join(), y.join(), z.join(), x[4], x[-1]].join(';')
+        """)
+        XCTAssertEqual(try result.toString(), "0.5,0.3333333432674408,2,7;0,254;-25536,-1;;")
+    }
+}
@@ -0,0 +1,46 @@
+import XCTest
+@testable import MQuickJS
+
+/// Tests for borrowed UTF-8 string access and evaluation of UTF-8 source bytes
+final class UTF8BufferTests: XCTestCase {
+
+    func testWithUTF8Buffer() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("'caf\\u00e9 ' + '\\ud83d\\ude00'")
+        let bytes = try value.withUTF8Buffer { Array($0) }
+        XCTAssertEqual(bytes, Array("café 😀".utf8))
+    }
+
+    func testWithUTF8BufferConvertsNonStrings() throws {
+        let context = try MQJSContext()
+        let number = try context.eval("6 * 7")
+        XCTAssertEqual(try number.withUTF8Buffer { String(decoding: $0, as: UTF8.self) }, "42")
+        let char = try context.eval("'x'")
+        XCTAssertEqual(try char.withUTF8Buffer { $0.count }, 1)
+    }
+
+    func testWithUTF8BufferUnpairedSurrogate() throws {
+        let context = try MQJSContext()
+        let value = try context.eval("'a\\ud800b'")
+        let string = try value.withUTF8Buffer { String(decoding: $0, as: UTF8.self) }
+        XCTAssertEqual(string, "a\u{FFFD}b")
+    }
+
+    func testEvalUTF8() throws {
+        let context = try MQJSContext()
+        let source = Array("var greeting = 'hé' + 'llo'; greeting.length".utf8)
+        let result = try source.withUnsafeBufferPointer { bytes in
+            try context.eval(utf8: bytes)
+        }
+        XCTAssertEqual(try result.toInt32(), 5)
+        XCTAssertEqual(try context.eval("greeting").toString(), "héllo")
+    }
+
+    func testEvalData() throws {
+        let context = try MQJSContext()
+        let data = Data("[1, 2, 3].map(function (x) { return x * 2; }).join()".utf8)
+        XCTAssertEqual(try context.eval(data: data).toString(), "2,4,6")
+        XCTAssertThrowsError(try context.eval(data: Data("function (".utf8), filename: "bad.js"))
+        XCTAssertTrue(try context.eval(data: Data()).isUndefined)
+    }
+}
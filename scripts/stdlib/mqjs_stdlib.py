@@ -0,0 +1,487 @@
+# Definition of the JavaScript standard library installed by JS_NewContext.
+#
+# scripts/stdlib/mquickjs_build.py turns this file into
+# Sources/CMQuickJS/include/mqjs_stdlib.h. The entries follow the JS_*_DEF
+# macros of the upstream mqjs_stdlib.c; the order of the properties is the
+# order in which for-in and Object.keys() list them.
+
+js_object = [
+    CFUNC("defineProperty", 3, "js_object_defineProperty"),
+    CFUNC("getPrototypeOf", 1, "js_object_getPrototypeOf"),
+    CFUNC("setPrototypeOf", 2, "js_object_setPrototypeOf"),
+    CFUNC("create", 2, "js_object_create"),
+    CFUNC("keys", 1, "js_object_keys"),
+]
+
+js_object_proto = [
+    CFUNC("hasOwnProperty", 1, "js_object_hasOwnProperty"),
+    CFUNC("toString", 0, "js_object_toString"),
+]
+
+js_object_class = CLASS("Object", 1, "js_object_constructor", JS_CLASS_OBJECT,
+    props=js_object,
+    proto=js_object_proto)
+
+js_function_proto = [
+    CGETSET("prototype", "js_function_get_prototype", "js_function_set_prototype"),
+    CFUNC("call", 1, "js_function_call"),
+    CFUNC("apply", 2, "js_function_apply"),
+    CFUNC("bind", 1, "js_function_bind"),
+    CFUNC("toString", 0, "js_function_toString"),
+    CGETSET_MAGIC("length", "js_function_get_length_name", None, 0),
+    CGETSET_MAGIC("name", "js_function_get_length_name", None, 1),
+]
+
+js_function_class = CLASS("Function", 1, "js_function_constructor", JS_CLASS_CLOSURE,
+    props=[],
+    proto=js_function_proto)
+
+js_number = [
+    CFUNC("parseInt", 2, "js_number_parseInt"),
+    CFUNC("parseFloat", 1, "js_number_parseFloat"),
+    PROP_DOUBLE("MAX_VALUE", 1.7976931348623157e+308),
+    PROP_DOUBLE("MIN_VALUE", 5e-324),
+    PROP_DOUBLE("NaN", NAN),
+    PROP_DOUBLE("NEGATIVE_INFINITY", -INFINITY),
+    PROP_DOUBLE("POSITIVE_INFINITY", INFINITY),
+    PROP_DOUBLE("EPSILON", 2.220446049250313e-16),
+    PROP_DOUBLE("MAX_SAFE_INTEGER", 9007199254740991.0),
+    PROP_DOUBLE("MIN_SAFE_INTEGER", -9007199254740991.0),
+]
+
+js_number_proto = [
+    CFUNC("toExponential", 1, "js_number_toExponential"),
+    CFUNC("toFixed", 1, "js_number_toFixed"),
+    CFUNC("toPrecision", 1, "js_number_toPrecision"),
+    CFUNC("toString", 1, "js_number_toString"),
+]
+
+js_number_class = CLASS("Number", 1, "js_number_constructor", JS_CLASS_NUMBER,
+    props=js_number,
+    proto=js_number_proto)
+
+js_boolean_class = CLASS("Boolean", 1, "js_boolean_constructor", JS_CLASS_BOOLEAN,
+    props=[],
+    proto=[])
+
+js_string = [
+    CFUNC_MAGIC("fromCharCode", 1, "js_string_fromCharCode", 0),
+    CFUNC_MAGIC("fromCodePoint", 1, "js_string_fromCharCode", 1),
+]
+
+js_string_proto = [
+    CGETSET("length", "js_string_get_length", "js_string_set_length"),
+    CFUNC_MAGIC("charAt", 1, "js_string_charAt", "magic_charAt"),
+    CFUNC_MAGIC("charCodeAt", 1, "js_string_charAt", "magic_charCodeAt"),
+    CFUNC_MAGIC("codePointAt", 1, "js_string_charAt", "magic_codePointAt"),
+    CFUNC("slice", 2, "js_string_slice"),
+    CFUNC("substring", 2, "js_string_substring"),
+    CFUNC("concat", 1, "js_string_concat"),
+    CFUNC_MAGIC("indexOf", 1, "js_string_indexOf", 0),
+    CFUNC_MAGIC("lastIndexOf", 1, "js_string_indexOf", 1),
+    CFUNC("match", 1, "js_string_match"),
+    CFUNC_MAGIC("replace", 2, "js_string_replace", 0),
+    CFUNC_MAGIC("replaceAll", 2, "js_string_replace", 1),
+    CFUNC("search", 1, "js_string_search"),
+    CFUNC("split", 2, "js_string_split"),
+    CFUNC_MAGIC("toLowerCase", 0, "js_string_toLowerCase", 1),
+    CFUNC_MAGIC("toUpperCase", 0, "js_string_toLowerCase", 0),
+    CFUNC_MAGIC("trim", 0, "js_string_trim", 3),
+    CFUNC_MAGIC("trimEnd", 0, "js_string_trim", 2),
+    CFUNC_MAGIC("trimStart", 0, "js_string_trim", 1),
+]
+
+js_string_class = CLASS("String", 1, "js_string_constructor", JS_CLASS_STRING,
+    props=js_string,
+    proto=js_string_proto)
+
+js_array = [
+    CFUNC("isArray", 1, "js_array_isArray"),
+]
+
+js_array_proto = [
+    CFUNC("concat", 1, "js_array_concat"),
+    CGETSET("length", "js_array_get_length", "js_array_set_length"),
+    CFUNC_MAGIC("push", 1, "js_array_push", 0),
+    CFUNC("pop", 0, "js_array_pop"),
+    CFUNC("join", 1, "js_array_join"),
+    CFUNC("toString", 0, "js_array_toString"),
+    CFUNC("reverse", 0, "js_array_reverse"),
+    CFUNC("shift", 0, "js_array_shift"),
+    CFUNC("slice", 2, "js_array_slice"),
+    CFUNC("splice", 2, "js_array_splice"),
+    CFUNC_MAGIC("unshift", 1, "js_array_push", 1),
+    CFUNC_MAGIC("indexOf", 1, "js_array_indexOf", 0),
+    CFUNC_MAGIC("lastIndexOf", 1, "js_array_indexOf", 1),
+    CFUNC_MAGIC("every", 1, "js_array_every", "js_special_every"),
+    CFUNC_MAGIC("some", 1, "js_array_every", "js_special_some"),
+    CFUNC_MAGIC("forEach", 1, "js_array_every", "js_special_forEach"),
+    CFUNC_MAGIC("map", 1, "js_array_every", "js_special_map"),
+    CFUNC_MAGIC("filter", 1, "js_array_every", "js_special_filter"),
+    CFUNC_MAGIC("reduce", 1, "js_array_reduce", "js_special_reduce"),
+    CFUNC_MAGIC("reduceRight", 1, "js_array_reduce", "js_special_reduceRight"),
+    CFUNC("sort", 1, "js_array_sort"),
+]
+
+js_array_class = CLASS("Array", 1, "js_array_constructor", JS_CLASS_ARRAY,
+    props=js_array,
+    proto=js_array_proto)
+
+js_math = [
+    CFUNC_MAGIC("min", 2, "js_math_min_max", 0),
+    CFUNC_MAGIC("max", 2, "js_math_min_max", 1),
+    CFUNC_F_F("sign", "js_math_sign"),
+    CFUNC_F_F("abs", "js_fabs"),
+    CFUNC_F_F("floor", "js_floor"),
+    CFUNC_F_F("ceil", "js_ceil"),
+    CFUNC_F_F("round", "js_round_inf"),
+    CFUNC_F_F("sqrt", "js_sqrt"),
+    PROP_DOUBLE("E", 2.718281828459045),
+    PROP_DOUBLE("LN10", 2.302585092994046),
+    PROP_DOUBLE("LN2", 0.6931471805599453),
+    PROP_DOUBLE("LOG2E", 1.4426950408889634),
+    PROP_DOUBLE("LOG10E", 0.4342944819032518),
+    PROP_DOUBLE("PI", 3.141592653589793),
+    PROP_DOUBLE("SQRT1_2", 0.7071067811865476),
+    PROP_DOUBLE("SQRT2", 1.4142135623730951),
+    CFUNC_F_F("sin", "js_sin"),
+    CFUNC_F_F("cos", "js_cos"),
+    CFUNC_F_F("tan", "js_tan"),
+    CFUNC_F_F("asin", "js_asin"),
+    CFUNC_F_F("acos", "js_acos"),
+    CFUNC_F_F("atan", "js_atan"),
+    CFUNC("atan2", 2, "js_math_atan2"),
+    CFUNC_F_F("exp", "js_exp"),
+    CFUNC_F_F("log", "js_log"),
+    CFUNC("pow", 2, "js_math_pow"),
+    CFUNC("random", 0, "js_math_random"),
+    CFUNC("imul", 2, "js_math_imul"),
+    CFUNC("clz32", 1, "js_math_clz32"),
+    CFUNC_F_F("fround", "js_math_fround"),
+    CFUNC_F_F("trunc", "js_trunc"),
+    CFUNC_F_F("log2", "js_log2"),
+    CFUNC_F_F("log10", "js_log10"),
+]
+
+js_date = [
+    CFUNC("now", 0, "js_date_now"),
+]
+
+js_date_class = CLASS("Date", 7, "js_date_constructor", JS_CLASS_DATE,
+    props=js_date,
+    proto=[])
+
+js_json = [
+    CFUNC("parse", 2, "js_json_parse"),
+    CFUNC("stringify", 3, "js_json_stringify"),
+]
+
+js_regexp_proto = [
+    CGETSET("lastIndex", "js_regexp_get_lastIndex", "js_regexp_set_lastIndex"),
+    CGETSET("source", "js_regexp_get_source", None),
+    CGETSET("flags", "js_regexp_get_flags", None),
+    CFUNC_MAGIC("exec", 1, "js_regexp_exec", 0),
+    CFUNC_MAGIC("test", 1, "js_regexp_exec", 1),
+]
+
+js_regexp_class = CLASS("RegExp", 2, "js_regexp_constructor", JS_CLASS_REGEXP,
+    props=[],
+    proto=js_regexp_proto)
+
+js_error_proto = [
+    CFUNC("toString", 0, "js_error_toString"),
+    PROP_STRING("name", "Error"),
+    CGETSET_MAGIC("message", "js_error_get_message", None, 0),
+    CGETSET_MAGIC("stack", "js_error_get_message", None, 1),
+]
+
+js_error_class = CLASS("Error", 1, "js_error_constructor", JS_CLASS_ERROR,
+    props=[],
+    proto=js_error_proto,
+    magic=True)
+
+js_eval_error_proto = [
+    PROP_STRING("name", "EvalError"),
+]
+
+js_eval_error_class = CLASS("EvalError", 1, "js_error_constructor", JS_CLASS_EVAL_ERROR,
+    props=[],
+    proto=js_eval_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_range_error_proto = [
+    PROP_STRING("name", "RangeError"),
+]
+
+js_range_error_class = CLASS("RangeError", 1, "js_error_constructor", JS_CLASS_RANGE_ERROR,
+    props=[],
+    proto=js_range_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_reference_error_proto = [
+    PROP_STRING("name", "ReferenceError"),
+]
+
+js_reference_error_class = CLASS("ReferenceError", 1, "js_error_constructor", JS_CLASS_REFERENCE_ERROR,
+    props=[],
+    proto=js_reference_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_syntax_error_proto = [
+    PROP_STRING("name", "SyntaxError"),
+]
+
+js_syntax_error_class = CLASS("SyntaxError", 1, "js_error_constructor", JS_CLASS_SYNTAX_ERROR,
+    props=[],
+    proto=js_syntax_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_type_error_proto = [
+    PROP_STRING("name", "TypeError"),
+]
+
+js_type_error_class = CLASS("TypeError", 1, "js_error_constructor", JS_CLASS_TYPE_ERROR,
+    props=[],
+    proto=js_type_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_uri_error_proto = [
+    PROP_STRING("name", "URIError"),
+]
+
+js_uri_error_class = CLASS("URIError", 1, "js_error_constructor", JS_CLASS_URI_ERROR,
+    props=[],
+    proto=js_uri_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_internal_error_proto = [
+    PROP_STRING("name", "InternalError"),
+]
+
+js_internal_error_class = CLASS("InternalError", 1, "js_error_constructor", JS_CLASS_INTERNAL_ERROR,
+    props=[],
+    proto=js_internal_error_proto,
+    parent=js_error_class,
+    magic=True)
+
+js_array_buffer_proto = [
+    CGETSET("byteLength", "js_array_buffer_get_byteLength", None),
+]
+
+js_array_buffer_class = CLASS("ArrayBuffer", 1, "js_array_buffer_constructor", JS_CLASS_ARRAY_BUFFER,
+    props=[],
+    proto=js_array_buffer_proto)
+
+js_typed_array_proto = [
+    CGETSET_MAGIC("length", "js_typed_array_get_length", None, 0),
+    CGETSET_MAGIC("byteLength", "js_typed_array_get_length", None, 1),
+    CGETSET_MAGIC("byteOffset", "js_typed_array_get_length", None, 2),
+    CGETSET_MAGIC("buffer", "js_typed_array_get_length", None, 3),
+    CFUNC("join", 1, "js_array_join"),
+    CFUNC("toString", 0, "js_array_toString"),
+    CFUNC("subarray", 2, "js_typed_array_subarray"),
+    CFUNC("sort", 1, "js_typed_array_sort"),
+    CFUNC("set", 1, "js_typed_array_set"),
+    CFUNC("fill", 1, "js_typed_array_fill"),
+    CFUNC("slice", 2, "js_typed_array_slice"),
+    CFUNC("copyWithin", 2, "js_typed_array_copyWithin"),
+]
+
+js_typed_array_class = CLASS("TypedArray", 0, "js_typed_array_base_constructor", JS_CLASS_TYPED_ARRAY,
+    props=[],
+    proto=js_typed_array_proto)
+
+js_uint8_clamped_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_uint8_clamped_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_uint8_clamped_array_class = CLASS("Uint8ClampedArray", 3, "js_typed_array_constructor", JS_CLASS_UINT8C_ARRAY,
+    props=js_uint8_clamped_array,
+    proto=js_uint8_clamped_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_int8_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_int8_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_int8_array_class = CLASS("Int8Array", 3, "js_typed_array_constructor", JS_CLASS_INT8_ARRAY,
+    props=js_int8_array,
+    proto=js_int8_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_uint8_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_uint8_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 1),
+]
+
+js_uint8_array_class = CLASS("Uint8Array", 3, "js_typed_array_constructor", JS_CLASS_UINT8_ARRAY,
+    props=js_uint8_array,
+    proto=js_uint8_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_int16_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 2),
+]
+
+js_int16_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 2),
+]
+
+js_int16_array_class = CLASS("Int16Array", 3, "js_typed_array_constructor", JS_CLASS_INT16_ARRAY,
+    props=js_int16_array,
+    proto=js_int16_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_uint16_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 2),
+]
+
+js_uint16_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 2),
+]
+
+js_uint16_array_class = CLASS("Uint16Array", 3, "js_typed_array_constructor", JS_CLASS_UINT16_ARRAY,
+    props=js_uint16_array,
+    proto=js_uint16_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_int32_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_int32_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_int32_array_class = CLASS("Int32Array", 3, "js_typed_array_constructor", JS_CLASS_INT32_ARRAY,
+    props=js_int32_array,
+    proto=js_int32_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_uint32_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_uint32_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_uint32_array_class = CLASS("Uint32Array", 3, "js_typed_array_constructor", JS_CLASS_UINT32_ARRAY,
+    props=js_uint32_array,
+    proto=js_uint32_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_float32_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_float32_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 4),
+]
+
+js_float32_array_class = CLASS("Float32Array", 3, "js_typed_array_constructor", JS_CLASS_FLOAT32_ARRAY,
+    props=js_float32_array,
+    proto=js_float32_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_float64_array = [
+    PROP_INT("BYTES_PER_ELEMENT", 8),
+]
+
+js_float64_array_proto = [
+    PROP_INT("BYTES_PER_ELEMENT", 8),
+]
+
+js_float64_array_class = CLASS("Float64Array", 3, "js_typed_array_constructor", JS_CLASS_FLOAT64_ARRAY,
+    props=js_float64_array,
+    proto=js_float64_array_proto,
+    parent=js_typed_array_class,
+    magic=True)
+
+js_console = [
+    CFUNC("log", 1, "js_print"),
+]
+
+js_performance = [
+    CFUNC("now", 0, "js_performance_now"),
+]
+
+js_global_object = [
+    PROP_CLASS("Object", js_object_class),
+    PROP_CLASS("Function", js_function_class),
+    PROP_CLASS("Number", js_number_class),
+    PROP_CLASS("Boolean", js_boolean_class),
+    PROP_CLASS("String", js_string_class),
+    PROP_CLASS("Array", js_array_class),
+    PROP_CLASS("Math", OBJECT(js_math)),
+    PROP_CLASS("Date", js_date_class),
+    PROP_CLASS("JSON", OBJECT(js_json)),
+    PROP_CLASS("RegExp", js_regexp_class),
+    PROP_CLASS("Error", js_error_class),
+    PROP_CLASS("EvalError", js_eval_error_class),
+    PROP_CLASS("RangeError", js_range_error_class),
+    PROP_CLASS("ReferenceError", js_reference_error_class),
+    PROP_CLASS("SyntaxError", js_syntax_error_class),
+    PROP_CLASS("TypeError", js_type_error_class),
+    PROP_CLASS("URIError", js_uri_error_class),
+    PROP_CLASS("InternalError", js_internal_error_class),
+    PROP_CLASS("ArrayBuffer", js_array_buffer_class),
+    PROP_CLASS("Uint8ClampedArray", js_uint8_clamped_array_class),
+    PROP_CLASS("Int8Array", js_int8_array_class),
+    PROP_CLASS("Uint8Array", js_uint8_array_class),
+    PROP_CLASS("Int16Array", js_int16_array_class),
+    PROP_CLASS("Uint16Array", js_uint16_array_class),
+    PROP_CLASS("Int32Array", js_int32_array_class),
+    PROP_CLASS("Uint32Array", js_uint32_array_class),
+    PROP_CLASS("Float32Array", js_float32_array_class),
+    PROP_CLASS("Float64Array", js_float64_array_class),
+    CFUNC("parseInt", 2, "js_number_parseInt"),
+    CFUNC("parseFloat", 1, "js_number_parseFloat"),
+    CFUNC("eval", 1, "js_global_eval"),
+    CFUNC("isNaN", 1, "js_global_isNaN"),
+    CFUNC("isFinite", 1, "js_global_isFinite"),
+    PROP_DOUBLE("Infinity", INFINITY),
+    PROP_DOUBLE("NaN", NAN),
+    PROP_UNDEFINED("undefined"),
+    PROP_GLOBAL_OBJECT("globalThis"),
+    PROP_CLASS("console", OBJECT(js_console)),
+    PROP_CLASS("performance", OBJECT(js_performance)),
+    CFUNC("print", 1, "js_print"),
+    CFUNC("gc", 0, "js_gc"),
+    CFUNC("load", 1, "js_load"),
+    CFUNC("setTimeout", 2, "js_setTimeout"),
+    CFUNC("clearTimeout", 1, "js_clearTimeout"),
+]
+
+
+# Functions that are not bound to a property. The bridge instantiates them
+# with JS_NewCFunctionParams() using the JS_CFUNCTION_* index macros.
+js_extra_functions = [
+    CFUNC_PARAMS("js_swift_trampoline", "swift_trampoline"),
+    CONSTRUCTOR_PARAMS("js_swift_constructor_trampoline", "swift_constructor_trampoline"),
+]
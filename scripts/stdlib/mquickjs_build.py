@@ -0,0 +1,631 @@
+#!/usr/bin/env python3
+"""
+Generates Sources/CMQuickJS/include/mqjs_stdlib.h, the ROM image of the
+JavaScript standard library, from the declarative definition in
+mqjs_stdlib.py.
+
+The output layout is the one produced by the upstream mquickjs build tool
+(mquickjs_build.c): the atom table, the sorted atom table, the property
+tables of every class and object, the global object properties and the C
+function table. JS_NewContext installs the global object from this image and
+stdlib_init_class() copies the prototypes and constructors of each class into
+the context heap, so every class that is left out saves init time and heap in
+every context.
+
+An optional configuration file customizes the definition:
+
+    # comments start with '#'
+    exclude Date                        # a global property
+    exclude typed-arrays                # a group (see GROUPS)
+    exclude String.prototype.replaceAll # a property of a class or object
+    function hash js_native_hash 1      # a global function
+    function Native.hash js_native_hash 1 [magic]
+
+'function' adds a ROM JSCFunction entry calling the given C function
+(JSValue f(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv), or
+with an extra 'int magic' argument when a magic value is given). A missing
+object in the path is created as a plain global object.
+
+Usage: mquickjs_build.py [--config FILE] [--definition FILE] [-o FILE] [--check]
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+PROJECT_ROOT = os.path.dirname(os.path.dirname(SCRIPT_DIR))
+ENGINE_DIR = os.path.join(PROJECT_ROOT, "Sources", "CMQuickJS")
+DEFAULT_OUTPUT = os.path.join(ENGINE_DIR, "include", "mqjs_stdlib.h")
+DEFAULT_DEFINITION = os.path.join(SCRIPT_DIR, "mqjs_stdlib.py")
+
+# Atoms known to the parser and the interpreter. Their offsets are fixed by
+# mquickjs_atom.h, which is checked before generating.
+FIXED_ATOMS = [
+    "null", "false", "true", "if", "else", "return", "var", "this",
+    "delete", "void", "typeof", "new", "in", "instanceof", "do", "while",
+    "for", "break", "continue", "switch", "case", "default", "throw", "try",
+    "catch", "finally", "function", "debugger", "with", "class", "const",
+    "enum", "export", "extends", "import", "super", "implements",
+    "interface", "let", "package", "private", "protected", "public",
+    "static", "yield", "", "toString", "valueOf", "number", "object",
+    "undefined", "string", "boolean", "<ret>", "<eval>", "eval",
+    "arguments", "value", "get", "set", "prototype", "constructor",
+    "length", "target", "of", "NaN", "Infinity", "-Infinity", "name",
+    "Error", "__proto__", "index", "input",
+]
+
+# Classes the engine itself allocates objects of: they cannot be excluded.
+CORE_GLOBALS = {
+    "Object", "Function", "Number", "Boolean", "String", "Array",
+    "Error", "EvalError", "RangeError", "ReferenceError", "SyntaxError",
+    "TypeError", "URIError", "InternalError",
+}
+
+GROUPS = {
+    "typed-arrays": [
+        "Uint8ClampedArray", "Int8Array", "Uint8Array", "Int16Array",
+        "Uint16Array", "Int32Array", "Uint32Array", "Float32Array",
+        "Float64Array",
+    ],
+}
+
+ATOM_HEADER = ("(JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (%d << (JS_MTAG_BITS + 1)) | "
+               "(%d << (JS_MTAG_BITS + 2)) | (%d << (JS_MTAG_BITS + 3))")
+
+JS_TAG_SPECIAL = 3
+JS_TAG_STRING_CHAR = JS_TAG_SPECIAL | (6 << 2)
+JS_TAG_SPECIAL_BITS = 5
+
+
+class BuildError(Exception):
+    pass
+
+
+# ----------------------------------------------------------------------------
+# Definition language (mirrors the JS_*_DEF macros of upstream mqjs_stdlib.c)
+
+class Func:
+    """A C function table entry"""
+    def __init__(self, name, length, cfunc, kind, magic=0):
+        self.name = name            # None for functions not bound to a property
+        self.length = length
+        self.cfunc = cfunc
+        self.kind = kind            # JSCFunctionDef union member
+        self.magic = magic
+
+    def key(self):
+        return (self.kind, self.cfunc, self.name, self.length, str(self.magic))
+
+    def has_params(self):
+        return self.kind.endswith("_params")
+
+
+class Prop:
+    def __init__(self, name, kind, value=None, getter=None, setter=None):
+        self.name = name
+        self.kind = kind            # func, getset, double, int, string, undefined, null, object
+        self.value = value
+        self.getter = getter
+        self.setter = setter
+
+
+class Object:
+    """A plain object, or a class when 'ctor' is set"""
+    def __init__(self, name, props, ctor=None, class_id=None, proto=None, parent=None):
+        self.name = name
+        self.props = list(props)
+        self.ctor = ctor
+        self.class_id = class_id
+        self.proto = list(proto) if proto is not None else None
+        self.parent = parent
+
+    def is_class(self):
+        return self.ctor is not None
+
+
+def CFUNC(name, length, cfunc):
+    return Prop(name, "func", Func(name, length, cfunc, "generic"))
+
+
+def CFUNC_MAGIC(name, length, cfunc, magic):
+    return Prop(name, "func", Func(name, length, cfunc, "generic_magic", magic))
+
+
+def CFUNC_F_F(name, cfunc):
+    return Prop(name, "func", Func(name, 1, cfunc, "f_f"))
+
+
+def CGETSET(name, getter, setter):
+    return Prop(name, "getset",
+                getter=getter and Func("get " + name, 0, getter, "generic"),
+                setter=setter and Func("set " + name, 1, setter, "generic"))
+
+
+def CGETSET_MAGIC(name, getter, setter, magic):
+    return Prop(name, "getset",
+                getter=getter and Func("get " + name, 0, getter, "generic_magic", magic),
+                setter=setter and Func("set " + name, 1, setter, "generic_magic", magic))
+
+
+def PROP_DOUBLE(name, value):
+    return Prop(name, "double", float(value))
+
+
+def PROP_INT(name, value):
+    return Prop(name, "int", int(value))
+
+
+def PROP_STRING(name, value):
+    return Prop(name, "string", value)
+
+
+def PROP_UNDEFINED(name):
+    return Prop(name, "undefined")
+
+
+def PROP_GLOBAL_OBJECT(name):
+    # the engine replaces the null value with the global object
+    return Prop(name, "null")
+
+
+def PROP_CLASS(name, obj):
+    return Prop(name, "object", obj)
+
+
+def OBJECT(props):
+    return Object(None, props)
+
+
+def CLASS(name, length, cfunc, class_id, props=(), proto=(), parent=None, magic=False):
+    kind = "constructor_magic" if magic else "constructor"
+    return Object(name, props, Func(name, length, cfunc, kind, class_id), class_id, proto, parent)
+
+
+def CFUNC_PARAMS(cfunc, index_name):
+    """A function that is not bound to a property and is instantiated with
+    JS_NewCFunctionParams(); its index is exported as JS_CFUNCTION_<index_name>"""
+    f = Func(None, 0, cfunc, "generic_params")
+    f.index_name = index_name
+    return f
+
+
+def CONSTRUCTOR_PARAMS(cfunc, index_name):
+    f = Func(None, 0, cfunc, "constructor_params")
+    f.index_name = index_name
+    return f
+
+
+DSL = {name: obj for name, obj in list(globals().items())
+       if name.isupper() and callable(obj)}
+DSL.update(NAN=float("nan"), INFINITY=float("inf"))
+
+
+def load_definition(path):
+    namespace = dict(DSL)
+    # class ids are written symbolically in the output
+    for line in open(os.path.join(ENGINE_DIR, "include", "mquickjs.h")):
+        m = re.match(r"\s+(JS_CLASS_\w+),", line)
+        if m:
+            namespace[m.group(1)] = m.group(1)
+    with open(path) as f:
+        exec(compile(f.read(), path, "exec"), namespace)
+    if "js_global_object" not in namespace:
+        raise BuildError("%s: js_global_object is not defined" % path)
+    return namespace["js_global_object"], namespace.get("js_extra_functions", [])
+
+
+# ----------------------------------------------------------------------------
+# Configuration
+
+def find_prop(props, name):
+    for p in props:
+        if p.name == name:
+            return p
+    return None
+
+
+def lookup(global_props, path, where, create=False):
+    """Returns the property list holding the last component of 'path'"""
+    parts = path.split(".")
+    props = global_props
+    i = 0
+    while i < len(parts) - 1:
+        p = find_prop(props, parts[i])
+        if p is None and create:
+            p = PROP_CLASS(parts[i], OBJECT([]))
+            props.append(p)
+        if p is None or p.kind != "object":
+            raise BuildError("%s: %s is not an object" % (where, ".".join(parts[:i + 1])))
+        if parts[i + 1] == "prototype" and i + 2 < len(parts):
+            if not p.value.is_class():
+                raise BuildError("%s: %s is not a class" % (where, parts[i]))
+            props = p.value.proto
+            i += 2
+        else:
+            props = p.value.props
+            i += 1
+    return props, parts[-1]
+
+
+def apply_config(path, global_props):
+    for lineno, line in enumerate(open(path), 1):
+        words = line.split("#", 1)[0].split()
+        if not words:
+            continue
+        where = "%s:%d" % (path, lineno)
+        if words[0] == "exclude" and len(words) == 2:
+            for name in GROUPS.get(words[1], [words[1]]):
+                if name in CORE_GLOBALS:
+                    raise BuildError("%s: %s is required by the engine" % (where, name))
+                props, last = lookup(global_props, name, where)
+                p = find_prop(props, last)
+                if p is None:
+                    raise BuildError("%s: unknown property %s" % (where, name))
+                props.remove(p)
+        elif words[0] == "function" and len(words) in (4, 5):
+            props, last = lookup(global_props, words[1], where, create=True)
+            if find_prop(props, last):
+                raise BuildError("%s: %s is already defined" % (where, words[1]))
+            if len(words) == 5:
+                props.append(CFUNC_MAGIC(last, int(words[3]), words[2], words[4]))
+            else:
+                props.append(CFUNC(last, int(words[3]), words[2]))
+        else:
+            raise BuildError("%s: syntax error" % where)
+
+
+# ----------------------------------------------------------------------------
+# ROM image
+
+def is_numeric(s):
+    """True if 's' is the canonical string of a number"""
+    return (s in ("NaN", "Infinity", "-Infinity") or
+            (re.fullmatch(r"-?(0|[1-9][0-9]*)", s) is not None and s != "-0"))
+
+
+def c_comment(s):
+    """Label of the atom in the sorted atom table"""
+    if s == "":
+        return "empty"
+    return re.sub(r"[^0-9A-Za-z_ ]", "_", s)
+
+
+def c_string(s):
+    return s.replace("\\", "\\\\").replace("\"", "\\\"")
+
+
+class Builder:
+    def __init__(self, global_props, extra_functions):
+        self.global_props = global_props
+        self.extra_functions = extra_functions
+        self.out = []               # lines of the table
+        self.size = 0               # in 64-bit words
+        self.atoms = {}             # string -> offset
+        self.atom_list = []
+        self.funcs = []
+        self.func_index = {}
+        self.emitted = {}           # id(Object) -> class offset
+
+    def emit(self, line, words=1):
+        self.out.append("  " + line)
+        self.size += words
+
+    # atoms
+
+    def add_atom(self, s):
+        if s in self.atoms:
+            return
+        data = s.encode("utf-8")
+        ascii = int(all(c < 0x80 for c in data))
+        self.atoms[s] = self.size
+        self.atom_list.append(s)
+        self.emit(ATOM_HEADER % (ascii, int(is_numeric(s)), len(data)) +
+                  ", /* \"%s\" (offset=%d) */" % (c_string(s), self.size))
+        data += b"\0" * (8 - len(data) % 8)
+        for i in range(0, len(data), 8):
+            self.emit("0x%016x," % struct.unpack("<Q", data[i:i + 8])[0])
+
+    def collect_props(self, props):
+        seen = set()
+        for p in props:
+            if p.name in seen:
+                raise BuildError("duplicate property '%s'" % p.name)
+            seen.add(p.name)
+            self.add_atom(p.name)
+            if p.kind == "func":
+                self.add_atom(p.value.name)
+            elif p.kind == "getset":
+                for f in (p.getter, p.setter):
+                    if f:
+                        self.add_atom(f.name)
+            elif p.kind == "string":
+                self.add_atom(p.value)
+            elif p.kind == "object":
+                self.collect_object(p.value)
+
+    def collect_object(self, obj):
+        if obj.is_class():
+            self.add_atom(obj.name)
+            if obj.parent:
+                self.collect_object(obj.parent)
+            self.collect_props(obj.props)
+            self.collect_props(obj.proto)
+        else:
+            self.collect_props(obj.props)
+
+    # values
+
+    def atom_value(self, s):
+        return "JS_ROM_VALUE(%d)" % self.atoms[s]
+
+    def key_value(self, s):
+        if len(s) == 1:
+            return "JS_VALUE_MAKE_SPECIAL(JS_TAG_STRING_CHAR, %d)" % ord(s)
+        return self.atom_value(s)
+
+    def key_hash(self, s):
+        if len(s) == 1:
+            v = JS_TAG_STRING_CHAR | (ord(s) << JS_TAG_SPECIAL_BITS)
+            return (v >> 3) ^ (v & 7)
+        # JS_ROM_VALUE() is '(table + 8 * offset) | JS_TAG_PTR' and the table
+        # is 64 byte aligned, so the low bits of the hash only depend on the offset
+        return self.atoms[s] ^ 1
+
+    def add_func(self, f):
+        k = f.key()
+        if k not in self.func_index:
+            self.func_index[k] = len(self.funcs)
+            self.funcs.append(f)
+        return self.func_index[k]
+
+    def func_value(self, f):
+        return "JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, %d)" % self.add_func(f)
+
+    def emit_deps(self, props):
+        """Emits the objects referenced by 'props'; returns their values"""
+        values = {}
+        for p in props:
+            if p.kind == "getset":
+                get = self.func_value(p.getter) if p.getter else "JS_UNDEFINED"
+                set = self.func_value(p.setter) if p.setter else "JS_UNDEFINED"
+                values[p.name] = "JS_ROM_VALUE(%d)" % self.size
+                self.emit("/* getset (offset=%d) */" % self.size, 0)
+                self.emit("JS_VALUE_ARRAY_HEADER(2),")
+                self.emit(get + ",")
+                self.emit(set + ",")
+                self.out.append("")
+            elif p.kind == "double":
+                values[p.name] = "JS_ROM_VALUE(%d)" % self.size
+                self.emit("/* float64 (offset=%d) */" % self.size, 0)
+                self.emit("JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),")
+                self.emit("0x%016x," % struct.unpack("<Q", struct.pack("<d", p.value))[0])
+                self.out.append("")
+            elif p.kind == "object":
+                values[p.name] = "JS_ROM_VALUE(%d)" % self.emit_object(p.value)
+        for p in props:
+            if p.kind == "func":
+                values[p.name] = self.func_value(p.value)
+            elif p.kind == "int":
+                values[p.name] = ("%d << 1" % p.value if p.value >= 0
+                                  else "(uint64_t)(%d) << 1" % p.value)
+            elif p.kind == "string":
+                values[p.name] = "%s /* %s */" % (self.atom_value(p.value), p.value)
+            elif p.kind == "undefined":
+                values[p.name] = "JS_UNDEFINED"
+            elif p.kind == "null":
+                values[p.name] = "JS_NULL"
+        return values
+
+    def emit_props(self, props, special=None):
+        """Emits a property table; 'special' is the (name, value) of the
+        prototype or constructor link of a class"""
+        values = self.emit_deps(props)
+        entries = [(p.name, values[p.name],
+                    "JS_PROP_GETSET" if p.kind == "getset" else "JS_PROP_NORMAL")
+                   for p in props]
+        if special:
+            entries.append((special[0], special[1], "JS_PROP_SPECIAL"))
+        n = len(entries)
+        buckets = 1
+        while buckets < min(8, (n + 1) // 2):
+            buckets *= 2
+        mask = buckets - 1
+        heads = [0] * buckets
+        links = []
+        for i, (name, value, flags) in enumerate(entries):
+            h = self.key_hash(name) & mask
+            links.append(heads[h])
+            heads[h] = 2 + buckets + 3 * i
+
+        offset = self.size
+        self.emit("/* properties (offset=%d) */" % offset, 0)
+        self.emit("JS_VALUE_ARRAY_HEADER(%d)," % (2 + buckets + 3 * n))
+        self.emit("%d << 1, /* n_props */" % n)
+        self.emit("%d << 1, /* hash_mask */" % mask)
+        for h in heads:
+            self.emit("%d << 1," % h)
+        for (name, value, flags), link in zip(entries, links):
+            self.emit("%s /* %s */," % (self.key_value(name), c_string(name)))
+            self.emit(value + ",")
+            self.emit("(%d << 1) | (%s << 30)," % (link, flags))
+        return offset
+
+    def emit_object(self, obj):
+        if id(obj) in self.emitted:
+            return self.emitted[id(obj)]
+        if obj.is_class():
+            if obj.parent:
+                self.emit_object(obj.parent)
+            ctor = self.add_func(obj.ctor)
+            props = self.emit_props(obj.props, ("prototype", "%s << 1" % obj.class_id))
+            proto = self.emit_props(obj.proto, ("constructor",
+                                                "(uint32_t)(-%s - 1) << 1" % obj.class_id))
+            values = ["JS_ROM_VALUE(%d)" % props, "%d" % ctor, "JS_ROM_VALUE(%d)" % proto,
+                      "JS_ROM_VALUE(%d)" % self.emitted[id(obj.parent)] if obj.parent else "JS_NULL"]
+        else:
+            values = ["JS_ROM_VALUE(%d)" % self.emit_props(obj.props), "-1", "JS_NULL", "JS_NULL"]
+        offset = self.size
+        self.emitted[id(obj)] = offset
+        self.emit("/* class (offset=%d) */" % offset, 0)
+        self.emit("JS_MB_HEADER_DEF(JS_MTAG_OBJECT),")
+        for v in values:
+            self.emit(v + ",")
+        self.out.append("")
+        return offset
+
+    def build(self):
+        self.emit("/* atom_table */", 0)
+        for s in FIXED_ATOMS:
+            self.add_atom(s)
+        self.add_atom("bound")
+        self.add_func(Func("bound", 0, "js_function_bound", "generic_params"))
+        self.collect_props(self.global_props)
+
+        self.out.append("")
+        self.sorted_offset = self.size
+        self.emit("/* sorted atom table (offset=%d) */" % self.size, 0)
+        self.emit("JS_VALUE_ARRAY_HEADER(%d)," % len(self.atom_list))
+        for s in sorted(self.atom_list, key=lambda s: s.encode("utf-8")):
+            self.emit("JS_ROM_VALUE(%d), /* %s */" % (self.atoms[s], c_comment(s)))
+        self.out.append("")
+
+        values = self.emit_deps(self.global_props)
+        self.global_offset = self.size
+        self.emit("/* global object properties (offset=%d) */" % self.size, 0)
+        self.emit("JS_VALUE_ARRAY_HEADER(%d)," % (2 * len(self.global_props)))
+        for p in self.global_props:
+            self.emit("%s /* %s */," % (self.key_value(p.name), c_string(p.name)))
+            self.emit(values[p.name] + ",")
+
+        for f in self.extra_functions:
+            f.index = len(self.funcs)
+            self.funcs.append(f)
+
+
+def declared_functions():
+    names = set()
+    for header in ("mquickjs_priv.h", "libm.h", os.path.join("include", "mquickjs.h")):
+        text = open(os.path.join(ENGINE_DIR, header)).read()
+        names.update(re.findall(r"\b(\w+)\s*\(", text))
+    return names
+
+
+def check_fixed_atoms(builder):
+    defined = {}
+    for line in open(os.path.join(ENGINE_DIR, "mquickjs_atom.h")):
+        m = re.match(r"#define JS_ATOM_(\w+) (\d+)", line)
+        if m:
+            defined[m.group(1)] = int(m.group(2))
+    for s in FIXED_ATOMS:
+        name = {"<ret>": "_ret_", "<eval>": "_eval_", "-Infinity": "_Infinity"}.get(s, s)
+        if name in defined and defined[name] != builder.atoms[s]:
+            raise BuildError("atom '%s' is at offset %d, mquickjs_atom.h expects %d"
+                             % (s, builder.atoms[s], defined[name]))
+    if defined.get("END") != builder.atoms["bound"]:
+        raise BuildError("mquickjs_atom.h does not match the fixed atom list")
+
+
+def generate(global_props, extra_functions):
+    b = Builder(global_props, extra_functions)
+    b.build()
+    check_fixed_atoms(b)
+
+    known = declared_functions()
+    lines = ["/* this file is automatically generated - do not edit */",
+             "/* generated by scripts/stdlib/mquickjs_build.py from scripts/stdlib/mqjs_stdlib.py */",
+             "",
+             "#include \"mquickjs_priv.h\"",
+             ""]
+    decls = []
+    for f in b.funcs:
+        if f.cfunc in known or f.cfunc in (d[0] for d in decls):
+            continue
+        args = "JSContext *ctx, JSValue *this_val, int argc, JSValue *argv"
+        if f.kind.endswith("_magic"):
+            args += ", int magic"
+        elif f.has_params():
+            args += ", JSValue params"
+        decls.append((f.cfunc, "JSValue %s(%s);" % (f.cfunc, args)))
+    if decls:
+        lines.append("/* Forward declarations for functions referenced in this file */")
+        lines += [d[1] for d in decls]
+        lines.append("")
+    if extra_functions:
+        lines.append("/* C function table indices for JS_NewCFunctionParams() */")
+        for f in extra_functions:
+            lines.append("#define JS_CFUNCTION_%s %d" % (f.index_name, f.index))
+        lines.append("")
+
+    lines.append("static const uint64_t __attribute((aligned(64))) js_stdlib_table[] = {")
+    lines += b.out
+    lines.append("};")
+    lines.append("")
+    lines.append("static const JSCFunctionDef js_c_function_table[] = {")
+    for f in b.funcs:
+        lines.append("  { { .%s = %s }," % (f.kind, f.cfunc))
+        if f.name is None:
+            lines.append("    JS_NULL /* %s */," % f.index_name)
+        else:
+            lines.append("    %s /* %s */," % (b.atom_value(f.name), c_string(f.name)))
+        lines.append("    JS_CFUNC_%s, %d, %s }," % (f.kind, f.length, f.magic))
+    lines.append("};")
+    lines.append("")
+    lines += [
+        "#ifndef JS_CLASS_COUNT",
+        "#define JS_CLASS_COUNT JS_CLASS_USER /* total number of classes */",
+        "#endif",
+        "",
+        "static const JSCFinalizer js_c_finalizer_table[JS_CLASS_COUNT - JS_CLASS_USER] = {",
+        "#ifdef JS_USER_CLASS_FINALIZERS",
+        "  JS_USER_CLASS_FINALIZERS",
+        "#endif",
+        "};",
+        "",
+        "__attribute__((weak)) const JSSTDLibraryDef js_stdlib = {",
+        "  js_stdlib_table,",
+        "  js_c_function_table,",
+        "  js_c_finalizer_table,",
+        "  %d," % b.size,
+        "  64,",
+        "  %d," % b.sorted_offset,
+        "  %d," % b.global_offset,
+        "  JS_CLASS_COUNT,",
+        "};",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the mquickjs stdlib ROM header")
+    parser.add_argument("--config", help="stdlib configuration file")
+    parser.add_argument("--definition", default=DEFAULT_DEFINITION,
+                        help="stdlib definition (default: %(default)s)")
+    parser.add_argument("-o", "--output", default=DEFAULT_OUTPUT,
+                        help="output header (default: %(default)s)")
+    parser.add_argument("--check", action="store_true",
+                        help="fail if the output is not up to date instead of writing it")
+    args = parser.parse_args()
+
+    try:
+        global_props, extra_functions = load_definition(args.definition)
+        if args.config:
+            apply_config(args.config, global_props)
+        text = generate(global_props, extra_functions)
+    except BuildError as e:
+        sys.exit("error: %s" % e)
+
+    if args.check:
+        current = open(args.output).read() if os.path.exists(args.output) else ""
+        if current != text:
+            sys.exit("error: %s is out of date" % args.output)
+        return
+    with open(args.output, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
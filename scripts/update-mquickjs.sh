@@ -43,8 +43,10 @@ echo ""
 echo "Note: The following files are NOT updated (local customizations):"
 echo "  - mqjs_bridge.c (Swift bridge code)"
 echo "  - mquickjs_atom.h (may need manual update if atoms changed)"
+echo "  - include/mqjs_stdlib.h (generated by scripts/stdlib/mquickjs_build.py)"
 echo ""
 echo "Next steps:"
-echo "  1. Run 'swift build' to verify compilation"
+echo "  1. Run 'python3 scripts/stdlib/mquickjs_build.py' if the stdlib changed"
+echo "     upstream, then 'swift build' to verify compilation"
 echo "  2. Run 'swift test' to verify functionality"
 echo "  3. Check Changelog for breaking changes"